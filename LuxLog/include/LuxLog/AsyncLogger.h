@@ -7,40 +7,172 @@
 
 #pragma once
 
+#include <LuxLog/LogFile.h>
 #include <LuxLog/LogStream.h>  // FixedBuffer
+#include <LuxLog/LogWriter.h>
+#include <LuxLog/Logger.h>
+#include <LuxLog/MappedBuffers.h>
+#include <LuxUtils/AdaptiveMutex.h>
+#include <LuxUtils/Config.h>
 #include <LuxUtils/Mutex.h>
 #include <LuxUtils/Thread.h>
+#include <LuxUtils/Timestamp.h>
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
 #include <vector>
 
 namespace Lux {
+
+class LogSite;
+
+/// @brief 异步日志，前端线程按 tid 哈希到 kBuckets 个桶，每个桶有自己的锁和
+/// 缓冲，后端线程定期收集各桶的缓冲，按首条日志的时间排序后写入文件。
 class AsyncLogger {
     AsyncLogger(const AsyncLogger&) = delete;
     AsyncLogger& operator=(AsyncLogger&) = delete;
 
+public:
+    /// @brief 二进制日志记录 (LOG_*_FMT) 在哪里格式化
+    enum class RecordFormat {
+        kText,      ///< 前端线程，缓冲中只有文本 (默认)
+        kDeferred,  ///< 后端线程，日志文件是文本
+        kBinary,    ///< 离线由 logDecoder 格式化，日志文件是记录
+    };
+
+    /// @brief 后端写入过慢 (例如磁盘卡顿) 时如何处理新日志
+    enum class OverflowPolicy {
+        /// 不限制缓冲数目，积压超过 100MB 时后端丢弃较新的大部分 (默认)
+        kDiscardBacklog,
+        /// 限制缓冲数目，前端线程等待后端写完
+        kBlock,
+        /// 限制缓冲数目，丢弃新日志
+        kDropNewest,
+        /// 限制缓冲数目，丢弃 WARN 以下的新日志，WARN 及以上等待
+        kDropBelowWarn,
+    };
+
+    /// 运行中可以修改的设置，见 setConfig()
+    struct Tunables {
+        /// 后端线程两次写入的最长间隔，秒
+        int flushInterval = 3;
+        /// 限制策略下缓冲的最大数目，同 setOverflowPolicy()
+        int maxBuffers = 200;
+    };
+
 private:
     void threadFunc();
 
-    using Buffer = Lux::detail::FixedBuffer<Lux::detail::kLargeBuffer>;
-    using BufferVector = std::vector<std::unique_ptr<Buffer>>;
+    static const int kBuckets = 16;
+
+    /// 缓冲，记录第一条日志的时间，用于后端排序
+    struct Buffer : Lux::detail::FixedBuffer<detail::kMediumBuffer> {
+        Timestamp firstTime;
+        /// 在内存映射文件中的缓冲，见 setCrashRecovery()
+        MappedBuffers* mapped = nullptr;
+        MappedBuffers::Slot* slot = nullptr;
+
+        /// 前端写入后，把长度写入 slot，崩溃后可以恢复
+        void publish() {
+            if (slot) {
+                slot->firstTime = firstTime.microSecondsSinceEpoch();
+                slot->length.store(length(), std::memory_order_release);
+            }
+        }
+        /// 后端写入文件后，slot 不再需要恢复
+        void markWritten() {
+            if (slot) slot->length.store(0, std::memory_order_release);
+        }
+    };
+    /// 映射文件中的缓冲归还给 MappedBuffers
+    struct BufferDeleter {
+        void operator()(Buffer* buffer) const;
+    };
+    using BufferVector = std::vector<std::unique_ptr<Buffer, BufferDeleter>>;
     using BufferPtr = BufferVector::value_type;
 
-    const int flushInterval_;
+    /// 前端缓冲，同一个桶的线程共享一把锁，临界区很短，先自旋再睡眠
+    struct Bucket {
+        Lux::AdaptiveMutex mutex;
+        /// 当前缓冲
+        BufferPtr currentBuffer GUARDED_BY(mutex);
+        /// 预备缓冲，由后端线程补充
+        BufferPtr nextBuffer GUARDED_BY(mutex);
+        /// 待写入文件的已填满的缓冲
+        BufferVector buffers GUARDED_BY(mutex);
+        /// 有线程写过日志
+        bool used GUARDED_BY(mutex) = false;
+    };
+
+    /// 把 header 和 data 连续放入所在桶的缓冲，header 可以为空
+    /// @param level 日志级别，kDropBelowWarn 溢出时按它决定丢弃还是等待
+    void appendToBucket(const char* header, int headerLen, const char* data,
+                        int len, Logger::LogLevel level);
+    /// 前端等待缓冲之前，在 mutex_ 下检查 bucket 是否已经能放入日志
+    bool hasSpace(Bucket& bucket);
+    /// 申请缓冲，超过 maxBuffers_ 时返回空
+    BufferPtr newBuffer();
+    /// 优先使用映射文件中空闲的 slot
+    BufferPtr allocBuffer();
+    /// 创建 basename.YYYYmmdd-HHMMSS.hostname.pid.buffers
+    void openMappedBuffers();
+    /// 把 site 的 kSite 记录写入映射文件，在它的第一条记录之前
+    void addMappedSite(const LogSite& site);
+    /// 释放不再使用的缓冲
+    void deleteBuffers(BufferVector::iterator first,
+                       BufferVector::iterator last);
+    /// 把一行提示写入文件，kBinary 时需要分帧
+    void writeNotice(const char* msg, LogFile* output);
+    /// 读取 config_ 中新的设置
+    void applyConfig();
+    /// 取走各桶的缓冲，并补充预备缓冲
+    void collect(BufferVector* buffersToWrite, BufferVector* spareBuffers);
+    /// 写完一批后把空闲缓冲补充给缺少缓冲的桶
+    void refill(BufferVector* spareBuffers);
+    /// 按 recordFormat_ 把缓冲写入文件
+    void writeBuffer(const Buffer& buffer, LogFile* output,
+                     std::vector<bool>* writtenSites);
+
+    /// 只在后端线程中修改
+    int flushInterval_;
     std::atomic<bool> running_;
     const string basename_;
     const off_t rollSize_;
+    RecordFormat recordFormat_;
     Lux::Thread thread_;
     Lux::CountDownLatch latch_;
+    /// 只在缓冲填满时由前端获取，用于唤醒后端
     Lux::MutexLock mutex_;
     Lux::Condition cond_ GUARDED_BY(mutex_);
+    bool notified_ GUARDED_BY(mutex_);
+    /// 后端写完一批后通知等待缓冲的前端
+    Lux::Condition spaceCond_ GUARDED_BY(mutex_);
+    uint64_t generation_ GUARDED_BY(mutex_);
+
+    /// 由独立的写线程写文件，后端线程只复制缓冲
+    bool useWriter_;
+    LogWriter::Options writerOptions_;
+    LogFile::Rotation rotation_;
 
-    /// 当前缓冲
-    BufferPtr currentBuffer_ GUARDED_BY(mutex_);
-    /// 预备缓冲，相当于 currentBuffer_ 的“备胎”
-    BufferPtr nextBuffer_ GUARDED_BY(mutex_);
-    /// 待写入文件的已填满的缓冲
-    BufferVector buffers_ GUARDED_BY(mutex_);
+    OverflowPolicy overflowPolicy_;
+    /// 后端线程按配置修改，前端线程读取
+    std::atomic<int> maxBuffers_;
+    std::atomic<int> numBuffers_;
+    std::atomic<int64_t> droppedMessages_;
+    std::atomic<int64_t> droppedBytes_;
+
+    /// 在 buckets_ 之前构造，之后析构
+    int numMappedBuffers_;
+    std::unique_ptr<MappedBuffers> mappedBuffers_;
+    /// 记录模式下已写入映射文件的 LogSite，按 id 下标，崩溃后 logRecover
+    /// 不依赖日志文件就能解码恢复的记录
+    std::unique_ptr<std::atomic<bool>[]> mappedSites_;
+
+    /// 后端线程每轮检查一次的配置
+    std::unique_ptr<Config<Tunables>::Reader> config_;
+
+    Bucket buckets_[kBuckets];
 
 public:
     AsyncLogger(const string& basename, off_t rollSize, int flushInterval = 3);
@@ -52,21 +184,92 @@ public:
         }
     }
 
-    void append(const char* logline, int len);
+    /// Not thread safe, be called before calling start().
+    void setRecordFormat(RecordFormat format) { recordFormat_ = format; }
+
+    /// @brief Not thread safe, be called before calling start().
+    /// @param maxBuffers 限制策略下，所有缓冲的最大数目，每块 500KB，
+    /// 至少为每个桶两块
+    void setOverflowPolicy(OverflowPolicy policy, int maxBuffers = 200) {
+        overflowPolicy_ = policy;
+        maxBuffers_.store(std::max(maxBuffers, 2 * kBuckets),
+                          std::memory_order_relaxed);
+    }
+
+    /// @brief Not thread safe, be called before calling start().
+    /// 后端线程每轮写入前无锁地检查 @c config，之后 publish() 的
+    /// flushInterval 与 maxBuffers 不用重启即生效；config 的生命期要长于
+    /// AsyncLogger
+    void setConfig(const Config<Tunables>& config) {
+        config_.reset(new Config<Tunables>::Reader(config));
+        applyConfig();
+    }
+
+    /// @brief Not thread safe, be called before calling start().
+    /// 后端线程把缓冲交给 LogWriter 的写线程，磁盘卡顿时后端仍能交换缓冲，
+    /// 直到写线程的 maxBlocks 块都在排队
+    void setWriter(const LogWriter::Options& options) {
+        useWriter_ = true;
+        writerOptions_ = options;
+    }
+
+    /// @brief Not thread safe, be called before calling start().
+    /// 按小时滚动、保留的文件数目、在低优先级线程中压缩滚动的文件
+    void setRotation(const LogFile::Rotation& rotation) {
+        rotation_ = rotation;
+    }
+
+    /// @brief Not thread safe, be called before calling start().
+    /// 前端缓冲放在 MAP_SHARED 的映射文件中，进程崩溃后尚未写入日志文件的
+    /// 缓冲仍在文件里，由 logRecover 恢复；正常退出时删除该文件。
+    /// setWriter() 时已交给写线程、尚未写入的数据不能恢复
+    /// @param numBuffers 映射文件中的缓冲数目，不够时使用普通的缓冲
+    void setCrashRecovery(int numBuffers = 64) {
+        numMappedBuffers_ = numBuffers;
+    }
+    /// 映射文件名，未启用时为空
+    string crashRecoveryFile() const {
+        return mappedBuffers_ ? mappedBuffers_->filename() : string();
+    }
+
+    /// 因溢出丢弃的日志条数
+    int64_t droppedMessages() const {
+        return droppedMessages_.load(std::memory_order_relaxed);
+    }
+    /// 因溢出丢弃的日志字节数
+    int64_t droppedBytes() const {
+        return droppedBytes_.load(std::memory_order_relaxed);
+    }
+
+    /// 文本日志，Logger::setOutput()
+    void append(const char* logline, int len, Logger::LogLevel level);
+    /// 级别未知的文本日志，kDropBelowWarn 溢出时按 WARN 等待，不丢弃
+    void append(const char* logline, int len) {
+        append(logline, len, Logger::LogLevel::WARN);
+    }
+
+    /// 二进制日志记录，Logger::setRecordOutput()
+    void appendRecord(const char* record, int len);
 
     /// @brief start -
     ///  1. start thread
     ///  2. latch wait
     void start() {
+        if (numMappedBuffers_ > 0 && !mappedBuffers_) openMappedBuffers();
         running_ = true;
         thread_.start();
         latch_.wait();
     }
 
-    void stop() NO_THREAD_SAFETY_ANALYSIS {
+    void stop() {
         running_ = false;
-        cond_.notify();
+        {
+            MutexLockGuard lock(mutex_);
+            notified_ = true;
+            cond_.notify();
+            spaceCond_.notifyAll();
+        }
         thread_.join();
     }
 };
-}  // namespace Lux
\ No newline at end of file
+}  // namespace Lux
@@ -0,0 +1,61 @@
+/**
+ * @file LogArchiver.h
+ * @brief Compresses rolled log files and removes the old ones on a low
+ * priority thread
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Condition.h>
+#include <LuxUtils/Mutex.h>
+#include <LuxUtils/Thread.h>
+#include <LuxUtils/Types.h>
+
+#include <deque>
+
+namespace Lux {
+
+/// @brief Files of LogFile are named basename.YYYYmmdd-HHMMSS.HOSTNAME.PID.log
+/// in the current directory, so the names of a basename sort by time.
+class LogArchiver {
+    LogArchiver(const LogArchiver&) = delete;
+    LogArchiver& operator=(LogArchiver&) = delete;
+
+    void threadFunc();
+    /// gzip @c filename to filename.gz
+    void compress(const string& filename);
+    /// removes the oldest files of basename_ beyond maxFiles_
+    void prune();
+    /// removes the .log.gz.tmp files of a compression cut short by a crash
+    void removeTemporaries();
+
+    const string basename_;
+    const int maxFiles_;
+    /// gzip level, 0 for not compressing
+    const int level_;
+    bool running_ GUARDED_BY(mutex_);
+    Lux::Thread thread_;
+
+    Lux::MutexLock mutex_;
+    Lux::Condition cond_ GUARDED_BY(mutex_);
+    std::deque<string> rolled_ GUARDED_BY(mutex_);
+    /// the file being written, never removed
+    string current_ GUARDED_BY(mutex_);
+
+public:
+    /// @param maxFiles files kept, including the current one, 0 for all
+    /// @param level gzip level 1-9, 0 for not compressing
+    LogArchiver(const string& basename, int maxFiles, int level);
+    /// Archives the rolled files and joins the thread.
+    ~LogArchiver();
+
+    /// The file being written.
+    void setCurrent(const string& filename);
+
+    /// A rolled file, closed and written completely.
+    void add(const string& filename);
+};
+
+}  // namespace Lux
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <LuxLog/LogArchiver.h>
+#include <LuxLog/LogWriter.h>
 #include <LuxUtils/Mutex.h>
 #include <LuxUtils/Types.h>
 
@@ -21,8 +23,25 @@ class LogFile {
     LogFile(const LogFile&) = delete;
     LogFile& operator=(LogFile&) = delete;
 
+public:
+    /// @brief Besides rollSize, a new file is started every period
+    enum class RollPeriod {
+        kHourly,
+        kDaily,
+    };
+
+    struct Rotation {
+        RollPeriod period = RollPeriod::kDaily;
+        /// files of the basename kept, including the current one and the
+        /// ones of previous runs, 0 for all
+        int maxFiles = 0;
+        /// gzip level 1-9 of the rolled files, 0 for not compressing
+        int compressLevel = 0;
+    };
+
 private:
     void append_unlocked(const char* logline, int len);
+    void flush_unlocked();
 
     static string getLogFileName(const string& basename, time_t* now);
 
@@ -37,15 +56,28 @@ private:
     time_t startOfPeriod_;
     time_t lastRoll_;
     time_t lastFlush_;
+    int rollPerSeconds_;
+    string filename_;
+    /// compresses and removes rolled files, shared with close callbacks of
+    /// writer_
+    std::shared_ptr<LogArchiver> archiver_;
     std::unique_ptr<FileUtil::AppendFile> file_;
+    /// not owned, files are written by it if not null
+    LogWriter* writer_;
+    std::unique_ptr<LogWriter::File> writerFile_;
 
-    const static int kRollPerSeconds_ = 60 * 60 * 24;
+    const static int kSecondsPerHour = 60 * 60;
+    const static int kSecondsPerDay = 60 * 60 * 24;
 
 public:
     LogFile(const string& basename, off_t rollSize, bool threadSafe = true,
-            int flushInterval = 3, int checkEveryN = 1024);
+            int flushInterval = 3, int checkEveryN = 1024,
+            LogWriter* writer = nullptr);
     ~LogFile();
 
+    /// @brief Not thread safe, be called before append().
+    void setRotation(const Rotation& rotation);
+
     void append(const char* logline, int len);
     void flush();
     bool rollFile();
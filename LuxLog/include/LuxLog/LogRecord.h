@@ -0,0 +1,301 @@
+/**
+ * @file LogRecord.h
+ * @brief Binary log records, formatted later by the AsyncLogger backend or
+ * by logDecoder
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxLog/Logger.h>
+#include <LuxUtils/StringPiece.h>
+
+#include <cstdint>
+
+namespace Lux {
+
+/// @brief A LOG_*_FMT call site. The format string and the source location
+/// are kept here once, a record only carries the id of its site.
+class LogSite {
+    LogSite(const LogSite&) = delete;
+    LogSite& operator=(LogSite&) = delete;
+
+    const char* format_;
+    Logger::SourceFile file_;
+    int line_;
+    Logger::LogLevel level_;
+    const char* func_;
+    uint32_t id_;
+
+public:
+    /// Max registered sites, the others are formatted by the caller.
+    static const uint32_t kMaxSites = 65536;
+
+    /// @brief Registers the site, ids start from 1, 0 if too many.
+    /// @c format must outlive the site, e.g. a string literal.
+    LogSite(const char* format, Logger::SourceFile file, int line,
+            Logger::LogLevel level, const char* func);
+
+    /// A site read from a binary log file, not registered.
+    LogSite(uint32_t id, const char* format, Logger::SourceFile file,
+            int line, Logger::LogLevel level, const char* func)
+        : format_(format),
+          file_(file),
+          line_(line),
+          level_(level),
+          func_(func),
+          id_(id) {}
+
+    const char* format() const { return format_; }
+    const Logger::SourceFile& file() const { return file_; }
+    int line() const { return line_; }
+    Logger::LogLevel level() const { return level_; }
+    const char* func() const { return func_; }
+    uint32_t id() const { return id_; }
+
+    /// @return the registered site, null if not found. Thread safe, lock free.
+    static const LogSite* find(uint32_t id);
+};
+
+namespace detail {
+/// @brief Kinds of records. Records are framed only if the AsyncLogger keeps
+/// records, i.e. AsyncLogger::RecordFormat::kDeferred or kBinary.
+/// All fields are in native byte order.
+enum class RecordKind : uint16_t {
+    kText = 1,   ///< a formatted line follows the header
+    kEvent = 2,  ///< EventHeader and the arguments follow
+    kSite = 3,   ///< SiteHeader, file, func and format follow
+};
+
+struct RecordHeader {
+    /// of the whole record, including this header
+    uint32_t length;
+    RecordKind kind;
+    uint16_t reserved;
+};
+
+struct EventHeader {
+    uint32_t site;
+    int32_t tid;
+    int64_t microSecondsSinceEpoch;
+};
+
+struct SiteHeader {
+    uint32_t site;
+    int32_t line;
+    int32_t level;
+};
+
+/// Each argument is a type byte and the raw value, strings and keys are
+/// prefixed by a uint32_t length.
+enum class ArgType : uint8_t {
+    kInt,
+    kUInt,
+    kDouble,
+    kChar,
+    kString,
+    kPointer,
+    kBool,
+    /// the name of the field whose value is the next argument, LOG_*_KV
+    kKey,
+};
+
+/// @brief Writes a kEvent record to a caller provided buffer.
+/// Arguments which do not fit are dropped.
+class RecordWriter {
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(RecordWriter&) = delete;
+
+    char* const begin_;
+    char* cur_;
+    char* const end_;
+    // an argument was dropped, so are the following ones
+    bool full_;
+
+    void putRaw(ArgType type, const void* value, size_t len);
+    /// @param truncate cut the string to fit, or drop it
+    void putString(ArgType type, const char* str, size_t len, bool truncate);
+
+public:
+    /// Writes the headers, the time is now.
+    RecordWriter(char* buf, size_t size, const LogSite& site);
+
+    void put(bool v) { putRaw(ArgType::kBool, &v, 1); }
+    void put(char v) { putRaw(ArgType::kChar, &v, 1); }
+    void put(short v) { put(static_cast<long long>(v)); }
+    void put(unsigned short v) { put(static_cast<unsigned long long>(v)); }
+    void put(int v) { put(static_cast<long long>(v)); }
+    void put(unsigned int v) { put(static_cast<unsigned long long>(v)); }
+    void put(long v) { put(static_cast<long long>(v)); }
+    void put(unsigned long v) { put(static_cast<unsigned long long>(v)); }
+    void put(long long v) {
+        int64_t value = v;
+        putRaw(ArgType::kInt, &value, sizeof value);
+    }
+    void put(unsigned long long v) {
+        uint64_t value = v;
+        putRaw(ArgType::kUInt, &value, sizeof value);
+    }
+    void put(float v) { put(static_cast<double>(v)); }
+    void put(double v) { putRaw(ArgType::kDouble, &v, sizeof v); }
+    void put(const void* v) {
+        uintptr_t value = reinterpret_cast<uintptr_t>(v);
+        putRaw(ArgType::kPointer, &value, sizeof value);
+    }
+    void put(const char* v) {
+        if (v) {
+            putString(ArgType::kString, v, strlen(v), true);
+        } else {
+            putString(ArgType::kString, "(null)", 6, true);
+        }
+    }
+    void put(const string& v) {
+        putString(ArgType::kString, v.data(), v.size(), true);
+    }
+    void put(StringPiece v) {
+        putString(ArgType::kString, v.data(), static_cast<size_t>(v.size()),
+                  true);
+    }
+
+    /// The key of a field, never truncated.
+    void putKey(const char* key) {
+        putString(ArgType::kKey, key, strlen(key), false);
+    }
+
+    /// @return the length of the record so far
+    int length() const;
+};
+
+/// @brief Sends a kEvent record to Logger's record output. Without one, the
+/// record is formatted here and sent to the text output.
+void outputRecord(const LogSite& site, const char* record, int len);
+
+/// @brief Formats a kEvent record of @c site to a line in the style of
+/// Logger::recordStyle(), appended to @c stream.
+void formatEvent(const LogSite& site, const char* record, size_t len,
+                 LogStream* stream);
+
+/// @return the site id of a kEvent record
+uint32_t eventSite(const char* record);
+
+/// @brief Appends a kSite record of @c site to @c out.
+void encodeSite(const LogSite& site, string* out);
+
+/// A kSite record, owns the strings which a LogSite refers to.
+struct SiteRecord {
+    uint32_t id;
+    int line;
+    Logger::LogLevel level;
+    string file;
+    string func;
+    string format;
+};
+
+/// @return false if the record is malformed
+bool decodeSite(const char* record, size_t len, SiteRecord* site);
+
+inline void putFields(RecordWriter&) {}
+
+template <typename Value, typename... Rest>
+void putFields(RecordWriter& writer, const char* key, const Value& value,
+               const Rest&... rest) {
+    writer.putKey(key);
+    writer.put(value);
+    putFields(writer, rest...);
+}
+}  // namespace detail
+
+/// @brief Records the site id and the raw @c args, "{}" in the format is
+/// replaced by the next argument when the record is formatted.
+template <typename... Args>
+void logRecord(const LogSite& site, const Args&... args) {
+    char buf[detail::kSmallBuffer];
+    detail::RecordWriter writer(buf, sizeof buf, site);
+    (writer.put(args), ...);
+    detail::outputRecord(site, buf, writer.length());
+}
+
+/// @brief Records the raw @c fields, which are key-value pairs with string
+/// literal keys, e.g. "peer", addr, "latency_us", us. Nothing is allocated.
+template <typename... Fields>
+void logFields(const LogSite& site, const Fields&... fields) {
+    static_assert(sizeof...(Fields) % 2 == 0,
+                  "LOG_*_KV takes pairs of keys and values");
+    char buf[detail::kSmallBuffer];
+    detail::RecordWriter writer(buf, sizeof buf, site);
+    detail::putFields(writer, fields...);
+    detail::outputRecord(site, buf, writer.length());
+}
+
+}  // namespace Lux
+
+// Like LOG_*, but the arguments are formatted by the AsyncLogger backend or
+// by logDecoder, e.g.
+//
+//   LOG_INFO_FMT("{} bytes from {}", n, conn->name());
+//
+// The format must be a string literal.
+#define LUX_LOG_FMT(level, fmt, ...)                                       \
+    do {                                                                   \
+        static const Lux::LogSite luxLogSite(fmt, __FILE__, __LINE__,      \
+                                             level, __func__);             \
+        Lux::logRecord(luxLogSite, ##__VA_ARGS__);                         \
+    } while (0)
+
+#define LOG_TRACE_FMT(fmt, ...)                                            \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(TRACE))                                        \
+            LUX_LOG_FMT(Lux::Logger::LogLevel::TRACE, fmt, ##__VA_ARGS__); \
+    } while (0)
+#define LOG_DEBUG_FMT(fmt, ...)                                            \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(DEBUG))                                        \
+            LUX_LOG_FMT(Lux::Logger::LogLevel::DEBUG, fmt, ##__VA_ARGS__); \
+    } while (0)
+#define LOG_INFO_FMT(fmt, ...)                                             \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(INFO))                                         \
+            LUX_LOG_FMT(Lux::Logger::LogLevel::INFO, fmt, ##__VA_ARGS__);  \
+    } while (0)
+#define LOG_WARN_FMT(fmt, ...) \
+    LUX_LOG_FMT(Lux::Logger::LogLevel::WARN, fmt, ##__VA_ARGS__)
+#define LOG_ERROR_FMT(fmt, ...) \
+    LUX_LOG_FMT(Lux::Logger::LogLevel::ERROR, fmt, ##__VA_ARGS__)
+#define LOG_FATAL_FMT(fmt, ...) \
+    LUX_LOG_FMT(Lux::Logger::LogLevel::FATAL, fmt, ##__VA_ARGS__)
+
+// Structured logging, the message and key-value fields are formatted as
+// Logger::RecordStyle, e.g.
+//
+//   LOG_INFO_KV("request done", "conn", conn->name(), "latency_us", us);
+//
+// The message and the keys must be string literals.
+#define LUX_LOG_KV(level, msg, ...)                                        \
+    do {                                                                   \
+        static const Lux::LogSite luxLogSite(msg, __FILE__, __LINE__,      \
+                                             level, __func__);             \
+        Lux::logFields(luxLogSite, ##__VA_ARGS__);                         \
+    } while (0)
+
+#define LOG_TRACE_KV(msg, ...)                                             \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(TRACE))                                        \
+            LUX_LOG_KV(Lux::Logger::LogLevel::TRACE, msg, ##__VA_ARGS__);  \
+    } while (0)
+#define LOG_DEBUG_KV(msg, ...)                                             \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(DEBUG))                                        \
+            LUX_LOG_KV(Lux::Logger::LogLevel::DEBUG, msg, ##__VA_ARGS__);  \
+    } while (0)
+#define LOG_INFO_KV(msg, ...)                                              \
+    do {                                                                   \
+        if (LUX_LOG_ENABLED(INFO))                                         \
+            LUX_LOG_KV(Lux::Logger::LogLevel::INFO, msg, ##__VA_ARGS__);   \
+    } while (0)
+#define LOG_WARN_KV(msg, ...) \
+    LUX_LOG_KV(Lux::Logger::LogLevel::WARN, msg, ##__VA_ARGS__)
+#define LOG_ERROR_KV(msg, ...) \
+    LUX_LOG_KV(Lux::Logger::LogLevel::ERROR, msg, ##__VA_ARGS__)
+#define LOG_FATAL_KV(msg, ...) \
+    LUX_LOG_KV(Lux::Logger::LogLevel::FATAL, msg, ##__VA_ARGS__)
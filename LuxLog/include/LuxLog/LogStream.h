@@ -16,6 +16,7 @@
 namespace Lux {
 namespace detail {
 const int kSmallBuffer = 4000;
+const int kMediumBuffer = 500 * 1000;
 const int kLargeBuffer = 4000 * 1000;
 
 template <int SIZE>
@@ -105,10 +106,7 @@ public:
 
     self& operator<<(const void*);
 
-    self& operator<<(float v) {
-        *this << static_cast<double>(v);
-        return *this;
-    }
+    self& operator<<(float);
     self& operator<<(double);
     // self& operator<<(long double);
 
@@ -0,0 +1,159 @@
+/**
+ * @file LogWriter.h
+ * @brief A dedicated thread writing log files with pwritev, so that the
+ * AsyncLogger backend keeps swapping buffers while the disk is slow
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Condition.h>
+#include <LuxUtils/Mutex.h>
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Thread.h>
+#include <LuxUtils/Types.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Lux {
+
+/// @brief Owns a writer thread. Data appended to a LogWriter::File is copied
+/// to aligned blocks, full blocks are queued and written by the thread, the
+/// queued blocks of a file are written by one pwritev.
+class LogWriter {
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(LogWriter&) = delete;
+
+public:
+    struct Options {
+        /// bytes of a block, rounded up to kAlignment
+        size_t blockSize = 1024 * 1024;
+        /// blocks queued or being filled, appending waits for a free block
+        /// beyond it, at least 4
+        int maxBlocks = 16;
+        /// open files with O_DIRECT, only whole aligned blocks are written
+        /// directly, the tail of a flush goes through the page cache
+        bool directIO = false;
+        /// fdatasync after this many bytes of a file are written, once per
+        /// batch of blocks, and when the file is closed. 0 for never
+        off_t syncBytes = 0;
+    };
+
+    /// alignment of blocks, file offsets and lengths of direct writes
+    static const size_t kAlignment = 4096;
+
+    class File;
+
+private:
+    struct FreeDeleter {
+        void operator()(char* p) const;
+    };
+    using BlockPtr = std::unique_ptr<char, FreeDeleter>;
+
+    /// fds of an open file, closed when the last queued write is done
+    struct FileState;
+
+    /// a write at @c offset of @c len bytes of @c block, or of @c tail if
+    /// @c block is null
+    struct Task {
+        std::shared_ptr<FileState> file;
+        BlockPtr block;
+        string tail;
+        off_t offset;
+        size_t len;
+    };
+
+    void threadFunc();
+    /// writes tasks[first, last), which are contiguous in the same file
+    void writeTasks(std::vector<Task>& tasks, size_t first, size_t last);
+
+    /// @return a free block, waits if maxBlocks are in use
+    BlockPtr acquireBlock();
+    void releaseBlock(BlockPtr block);
+    void submit(Task task);
+
+    const Options options_;
+    std::atomic<bool> running_;
+    Lux::Thread thread_;
+
+    Lux::MutexLock mutex_;
+    /// tasks are queued
+    Lux::Condition notEmpty_ GUARDED_BY(mutex_);
+    /// a block is released
+    Lux::Condition notFull_ GUARDED_BY(mutex_);
+    std::deque<Task> queue_ GUARDED_BY(mutex_);
+    std::vector<BlockPtr> freeBlocks_ GUARDED_BY(mutex_);
+    /// blocks allocated, free or not
+    int numBlocks_ GUARDED_BY(mutex_);
+
+    std::atomic<int64_t> writtenBytes_;
+    std::atomic<int64_t> stalls_;
+
+public:
+    /// Starts the writer thread.
+    explicit LogWriter(const Options& options);
+    /// Writes the queued blocks and joins the thread, files must be closed
+    /// before.
+    ~LogWriter();
+
+    /// @brief Opens @c filename for appending, all writes of the file go
+    /// through this writer.
+    /// @return nullptr if the file cannot be opened
+    std::unique_ptr<File> open(StringArg filename);
+
+    /// bytes written to the disk
+    int64_t writtenBytes() const {
+        return writtenBytes_.load(std::memory_order_relaxed);
+    }
+    /// times that appending waited for a free block
+    int64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+};
+
+/// @brief A file opened by LogWriter::open(), the same interface as
+/// FileUtil::AppendFile. Not thread safe, data is written in the order of
+/// append() calls.
+class LogWriter::File {
+    File(const File&) = delete;
+    File& operator=(File&) = delete;
+
+    friend class LogWriter;
+
+    /// queues [0, len_) of the block and moves to the next one
+    void submitBlock();
+
+    LogWriter* writer_;
+    std::shared_ptr<FileState> state_;
+    const bool direct_;
+    BlockPtr block_;
+    size_t len_;
+    /// bytes of the block already queued as a tail
+    size_t flushed_;
+    /// file offset of the block
+    off_t offset_;
+    off_t writtenBytes_;
+
+    File(LogWriter* writer, std::shared_ptr<FileState> state, bool direct,
+         off_t offset);
+
+public:
+    /// Queues the rest.
+    ~File();
+
+    void append(const char* logline, size_t len);
+
+    /// @brief Queues the data appended so far, returns before it is written.
+    void flush();
+
+    /// @brief Called in the writer thread, or in the destructor, once all
+    /// data of the file is written and the file is closed.
+    void setCloseCallback(std::function<void()> cb);
+
+    off_t writtenBytes() const { return writtenBytes_; }
+};
+
+}  // namespace Lux
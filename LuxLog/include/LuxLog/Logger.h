@@ -10,6 +10,14 @@
 #include <LuxLog/LogStream.h>
 #include <LuxUtils/Timestamp.h>
 
+#include <atomic>
+
+// 编译期最低日志级别，0 TRACE 1 DEBUG 2 INFO，低于它的 LOG_* 被编译器消除，
+// 运行时无法再打开。Release 构建默认为 1，见顶层 CMakeLists.txt
+#ifndef LUX_LOG_ACTIVE_LEVEL
+#define LUX_LOG_ACTIVE_LEVEL 0
+#endif
+
 namespace Lux {
 class Logger {
 public:
@@ -84,16 +92,111 @@ public:
     static LogLevel logLevel();
     static void setLogLevel(LogLevel level);
 
+    /// @brief 日志时间的来源
+    enum class Clock {
+        kPrecise,  ///< gettimeofday (默认)
+        kCoarse,   ///< CLOCK_REALTIME_COARSE，精度为一个 tick (1-4ms)，开销小
+    };
+    /// @brief 日志时间的时区，本地时区的偏移按线程缓存，每 15 分钟更新一次，
+    /// 在输出日志之前设置
+    enum class TimeZone {
+        kUTC,    ///< 默认
+        kLocal,  ///< localtime_r，TZ 环境变量
+    };
+
+    /// @return 日志的当前时间，见 setClock()
+    static Timestamp now();
+    static void setClock(Clock clock);
+    static void setTimeZone(TimeZone zone);
+    /// @brief 时间后加上 ".uuuuuu"，Not thread safe, 在输出日志之前调用
+    static void setMicroseconds(bool on);
+
     typedef void (*OutputFunc)(const char* msg, int len);
     typedef void (*FlushFunc)();
     static void setOutput(OutputFunc);
     static void setFlush(FlushFunc);
+
+    /// @brief 带日志级别的输出，例如 AsyncLogger::append()，代替
+    /// setOutput() 设置的输出，后端可以按级别处理溢出而不必解析文本
+    typedef void (*LevelOutputFunc)(const char* msg, int len, LogLevel level);
+    static void setOutput(LevelOutputFunc);
+
+    /// @brief Output of the binary records of LOG_*_FMT, e.g.
+    /// AsyncLogger::appendRecord(). By default records are formatted by the
+    /// caller and sent to the text output.
+    typedef void (*RecordOutputFunc)(const char* record, int len);
+    static void setRecordOutput(RecordOutputFunc);
+
+    /// @brief How the records of LOG_*_FMT and LOG_*_KV are formatted to
+    /// lines, wherever that happens. Lines of LOG_* stay text.
+    enum class RecordStyle {
+        kText,    ///< like LOG_*, fields are appended as key=value
+        kLogfmt,  ///< time=... level=INFO ... msg="..." key=value
+        kJson,    ///< {"time":"...","level":"INFO",...,"key":value}
+    };
+    static RecordStyle recordStyle();
+    static void setRecordStyle(RecordStyle style);
 };
 
 /* NOTE Global logger level */
 extern Logger::LogLevel g_logLevel;
 inline Logger::LogLevel Logger::logLevel() { return g_logLevel; }
 
+/// @brief 命名的日志模块，例如 polaris，运行时级别独立于全局级别，
+/// 未设置时跟随全局级别。
+/// 编译单元通过 LUX_LOG_MODULE_NAME 选择模块，一般由构建系统按库定义。
+/// 也可以用环境变量设置，例如 Lux_LOG_MODULES=polaris:DEBUG,http:WARN
+class LogModule {
+    LogModule(const LogModule&) = delete;
+    LogModule& operator=(LogModule&) = delete;
+
+    const string name_;
+    /// -1 跟随全局级别
+    std::atomic<int> level_;
+
+public:
+    explicit LogModule(const string& name) : name_(name), level_(-1) {}
+
+    const string& name() const { return name_; }
+
+    Logger::LogLevel level() const {
+        int level = level_.load(std::memory_order_relaxed);
+        return level < 0 ? Logger::logLevel()
+                         : static_cast<Logger::LogLevel>(level);
+    }
+
+    void setLevel(Logger::LogLevel level) {
+        level_.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    /// @brief 模块不会被销毁，不存在时创建。Thread safe.
+    static LogModule& get(const string& name);
+
+    /// @brief Thread safe, 立即对所有线程生效，模块不必已被使用
+    static void setLevel(const string& name, Logger::LogLevel level);
+    /// @brief Thread safe, 恢复为跟随全局级别
+    static void resetLevel(const string& name);
+};
+
+// 本编译单元的日志模块
+#ifdef LUX_LOG_MODULE_NAME
+namespace {
+inline LogModule& luxLogModule() {
+    static LogModule& module = LogModule::get(LUX_LOG_MODULE_NAME);
+    return module;
+}
+}  // namespace
+#define LUX_LOG_LEVEL() Lux::luxLogModule().level()
+#else
+#define LUX_LOG_LEVEL() Lux::Logger::logLevel()
+#endif
+
+// 先比较编译期常量，被消除的级别不会生成任何代码
+#define LUX_LOG_ENABLED(level)                                            \
+    (static_cast<int>(Lux::Logger::LogLevel::level) >=                    \
+         LUX_LOG_ACTIVE_LEVEL &&                                          \
+     LUX_LOG_LEVEL() <= Lux::Logger::LogLevel::level)
+
 //
 // CAUTION: do not write:
 //
@@ -110,26 +213,106 @@ inline Logger::LogLevel Logger::logLevel() { return g_logLevel; }
 //   else
 //     logWarnStream << "Bad news";
 //
-#define LOG_TRACE                                                           \
-    if (Lux::Logger::logLevel() <= Lux::Logger::LogLevel::TRACE)            \
+#define LUX_LOG_STREAM_TRACE                                                \
     Lux::Logger(__FILE__, __LINE__, Lux::Logger::LogLevel::TRACE, __func__) \
         .stream()
-#define LOG_DEBUG                                                           \
-    if (Lux::Logger::logLevel() <= Lux::Logger::LogLevel::DEBUG)            \
+#define LUX_LOG_STREAM_DEBUG                                                \
     Lux::Logger(__FILE__, __LINE__, Lux::Logger::LogLevel::DEBUG, __func__) \
         .stream()
-#define LOG_INFO                                                \
-    if (Lux::Logger::logLevel() <= Lux::Logger::LogLevel::INFO) \
-    Lux::Logger(__FILE__, __LINE__).stream()
-#define LOG_WARN \
+#define LUX_LOG_STREAM_INFO Lux::Logger(__FILE__, __LINE__).stream()
+#define LUX_LOG_STREAM_WARN \
     Lux::Logger(__FILE__, __LINE__, Lux::Logger::LogLevel::WARN).stream()
-#define LOG_ERROR \
+#define LUX_LOG_STREAM_ERROR \
     Lux::Logger(__FILE__, __LINE__, Lux::Logger::LogLevel::ERROR).stream()
+#define LUX_LOG_STREAM_SYSERR Lux::Logger(__FILE__, __LINE__, false).stream()
+
+#define LOG_TRACE if (LUX_LOG_ENABLED(TRACE)) LUX_LOG_STREAM_TRACE
+#define LOG_DEBUG if (LUX_LOG_ENABLED(DEBUG)) LUX_LOG_STREAM_DEBUG
+#define LOG_INFO if (LUX_LOG_ENABLED(INFO)) LUX_LOG_STREAM_INFO
+#define LOG_WARN LUX_LOG_STREAM_WARN
+#define LOG_ERROR LUX_LOG_STREAM_ERROR
 #define LOG_FATAL \
     Lux::Logger(__FILE__, __LINE__, Lux::Logger::LogLevel::FATAL).stream()
-#define LOG_SYSERR Lux::Logger(__FILE__, __LINE__, false).stream()
+#define LOG_SYSERR LUX_LOG_STREAM_SYSERR
 #define LOG_SYSFATAL Lux::Logger(__FILE__, __LINE__, true).stream()
 
+namespace detail {
+/// @brief 调用点的采样状态，sample() 返回 -1 表示不输出，
+/// 否则为上次输出以来跳过的次数。静态初始化，没有构造的开销
+class LogEveryN {
+    std::atomic<int64_t> count_{0};
+
+public:
+    int64_t sample(int64_t n) {
+        if (n <= 1) return 0;
+        int64_t count = count_.fetch_add(1, std::memory_order_relaxed);
+        if (count % n != 0) return -1;
+        return count == 0 ? 0 : n - 1;
+    }
+};
+
+class LogFirstN {
+    std::atomic<int64_t> count_{0};
+
+public:
+    int64_t sample(int64_t n) {
+        /// 达到 n 后只读，不再争用
+        if (count_.load(std::memory_order_relaxed) >= n) return -1;
+        return count_.fetch_add(1, std::memory_order_relaxed) < n ? 0 : -1;
+    }
+};
+
+class LogEveryMs {
+    /// 下次允许输出的时间，单调时钟，毫秒
+    std::atomic<int64_t> next_{0};
+    std::atomic<int64_t> skipped_{0};
+
+public:
+    int64_t sample(int64_t ms);
+};
+
+/// 输出为 "[N suppressed] "
+struct LogSkipped {
+    int64_t count;
+};
+
+inline LogStream& operator<<(LogStream& s, LogSkipped v) {
+    if (v.count > 0) s << '[' << v.count << " suppressed] ";
+    return s;
+}
+}  // namespace detail
+
+// 采样的日志，每个调用点一份静态状态，例如
+//
+//   LOG_EVERY_MS(SYSERR, 1000) << "TCPConnection::handleWrite";
+//
+// severity 为 TRACE DEBUG INFO WARN ERROR SYSERR，跳过的次数写在消息前面。
+// 与 LOG_* 一样，不要直接放在 if else 之间
+#define LUX_LOG_ON_TRACE LUX_LOG_ENABLED(TRACE)
+#define LUX_LOG_ON_DEBUG LUX_LOG_ENABLED(DEBUG)
+#define LUX_LOG_ON_INFO LUX_LOG_ENABLED(INFO)
+#define LUX_LOG_ON_WARN true
+#define LUX_LOG_ON_ERROR true
+#define LUX_LOG_ON_SYSERR true
+
+#define LUX_LOG_SAMPLED(severity, Sampler, arg)                          \
+    if (int64_t luxLogSkipped = -1;                                      \
+        LUX_LOG_ON_##severity && (luxLogSkipped = [](int64_t luxLogArg) { \
+                                     static Sampler sampler;              \
+                                     return sampler.sample(luxLogArg);    \
+                                 }(arg)) >= 0)                            \
+    LUX_LOG_STREAM_##severity << Lux::detail::LogSkipped{luxLogSkipped}
+
+/// 第 1, n+1, 2n+1 ... 次
+#define LOG_EVERY_N(severity, n) \
+    LUX_LOG_SAMPLED(severity, Lux::detail::LogEveryN, n)
+/// 前 n 次
+#define LOG_FIRST_N(severity, n) \
+    LUX_LOG_SAMPLED(severity, Lux::detail::LogFirstN, n)
+/// 每 ms 毫秒至多一次
+#define LOG_EVERY_MS(severity, ms) \
+    LUX_LOG_SAMPLED(severity, Lux::detail::LogEveryMs, ms)
+
 const char* strerror_tl(int savedErrno);
 
 // Taken from glog/logging.h
@@ -0,0 +1,112 @@
+/**
+ * @file MappedBuffers.h
+ * @brief Buffers in a shared memory mapped file, so the log data not yet
+ * written survives a crash of the process
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Mutex.h>
+#include <LuxUtils/Types.h>
+
+#include <atomic>
+#include <vector>
+
+namespace Lux {
+
+/// @brief A file of fixed size slots mapped with MAP_SHARED. The pages stay
+/// in the page cache when the process is killed, the slots of the data not
+/// yet written to the log file are read back by logRecover.
+///
+/// File layout: FileHeader at 0, slot i at kHeaderSize + i * slotSize, each
+/// slot is a Slot followed by the memory of a buffer at kSlotHeaderSize.
+/// A framed file ends with the site area at siteAreaOffset: a SiteArea
+/// followed by the kSite records of the LogSites used in the buffers, which
+/// logRecover writes before the buffers.
+class MappedBuffers {
+    MappedBuffers(const MappedBuffers&) = delete;
+    MappedBuffers& operator=(MappedBuffers&) = delete;
+
+public:
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        /// data of the slots are RecordHeader framed, see
+        /// AsyncLogger::RecordFormat
+        uint32_t framed;
+        uint64_t numSlots;
+        uint64_t slotSize;
+        /// 0 if not framed
+        uint64_t siteAreaOffset;
+        uint64_t siteAreaSize;
+    };
+
+    struct SiteArea {
+        /// bytes of the records after kSlotHeaderSize, stored after them
+        std::atomic<uint64_t> length;
+    };
+
+    struct Slot {
+        /// bytes of the buffer not yet written to the log file, 0 for free
+        /// or written. Stored after the data with release order.
+        std::atomic<int64_t> length;
+        /// microseconds since epoch of the first message
+        int64_t firstTime;
+        /// the data of the buffer, from the start of the slot
+        uint32_t dataOffset;
+    };
+
+    static const char kMagic[8];
+    static const uint32_t kVersion = 2;
+    static const size_t kHeaderSize = 4096;
+    static const size_t kSlotHeaderSize = 64;
+    /// room for a few thousand sites, only the pages written are allocated
+    static const size_t kSiteAreaSize = 4 * 1024 * 1024;
+
+private:
+    Slot* slot(size_t i) const {
+        return reinterpret_cast<Slot*>(base_ + kHeaderSize + i * slotSize_);
+    }
+
+    const string filename_;
+    const size_t slotSize_;
+    size_t numSlots_;
+    char* base_;
+    size_t mappedSize_;
+
+    Lux::MutexLock mutex_;
+    std::vector<Slot*> freeSlots_ GUARDED_BY(mutex_);
+    /// nullptr if not framed
+    SiteArea* siteArea_;
+    size_t siteAreaSize_;
+
+public:
+    /// @brief Creates @c filename with @c numSlots slots for buffers of
+    /// @c bufferSize bytes. No slot is available if it fails.
+    MappedBuffers(const string& filename, int numSlots, size_t bufferSize,
+                  bool framed);
+    /// Unmaps and removes the file, the buffers must be written before.
+    ~MappedBuffers();
+
+    const string& filename() const { return filename_; }
+    /// false if creating or mapping the file failed
+    bool valid() const { return base_ != nullptr; }
+
+    /// @return a free slot, or nullptr if all are in use. Thread safe.
+    Slot* acquire();
+    /// Marks the slot as written and frees it. Thread safe.
+    void release(Slot* slot);
+
+    /// @brief Appends a kSite record to the site area. Thread safe.
+    /// @return false if the area is full or the file is not framed
+    bool appendSite(const char* record, size_t len);
+
+    /// The bufferSize bytes following the slot header.
+    static void* memory(Slot* slot) {
+        return reinterpret_cast<char*>(slot) + kSlotHeaderSize;
+    }
+};
+
+}  // namespace Lux
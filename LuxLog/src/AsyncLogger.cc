@@ -73,24 +73,34 @@
  *  -
  * 实现输出操作的是一个线程，那么在写入期间，这个线程就需要一直持有缓冲区中的日志数据。
  *
- *  - 可以继续优化的地方：
- *    异步日志系统中，使用了一个全局锁，尽管临界区很小，但是如果线程数目较多，锁争用也可能影响性能。
- *    一种解决方法是像 Java 的 ConCurrentHashMap
- * 那样使用多个桶子(bucket)，前端线程写日志的时候 根据线程id哈希到不同的 bucket
- * 中，以减少竞争。
- *    这种解决方案本质上就是提供更多的缓冲区，并且把不同的缓冲区分配给不同的线程(根据线程
- * id 的哈希值)。
- * 那些哈希到相同缓冲区的线程，同样是存在争用的情况的，只不过争用的概率被降低了很多。
+ *  - 多个桶(bucket)：
+ *    全局锁的临界区虽小，线程数目较多时锁争用仍会影响性能。因此像 Java 的
+ * ConcurrentHashMap 那样使用多个桶，前端线程写日志时根据线程 id
+ * 哈希到不同的桶，每个桶有自己的锁和双缓冲，哈希到同一个桶的线程才会争用。
+ *    全局锁 mutex_ 只在缓冲填满、需要唤醒后端时获取。
+ *    后端依次取走各桶的缓冲，按缓冲中第一条日志的时间排序后写入，
+ * 保持近似的全局时间顺序。
  *
  * @author Tianen Lu
  */
 
 #include <LuxLog/AsyncLogger.h>
 #include <LuxLog/LogFile.h>
+#include <LuxLog/LogRecord.h>
+#include <LuxUtils/CurrentThread.h>
+#include <LuxUtils/ProcessInfo.h>
 #include <LuxUtils/Timestamp.h>
 
+#include <algorithm>
+#include <cinttypes>  // PRId64
+#include <cstring>
+#include <ctime>
+#include <new>
+
 using namespace Lux;
 
+const int AsyncLogger::kBuckets;
+
 /// @brief Constructor
 /// @param basename
 /// @param rollSize
@@ -101,47 +111,375 @@ AsyncLogger::AsyncLogger(const string& basename, off_t rollSize,
       running_(false),
       basename_(basename),
       rollSize_(rollSize),
+      recordFormat_(RecordFormat::kText),
       thread_(std::bind(&AsyncLogger::threadFunc, this), "AsyncLogger"),
       latch_(1),
       mutex_(),
       cond_(mutex_),
-      currentBuffer_(new Buffer),
-      nextBuffer_(new Buffer),
-      buffers_() {
-    currentBuffer_->bzero();
-    nextBuffer_->bzero();
-
-    // vector 的reserve增加了vector的capacity，但是它的size没有改变
-    // 而resize改变了vector的capacity同时也增加了它的size
-    buffers_.reserve(16);
+      notified_(false),
+      spaceCond_(mutex_),
+      generation_(0),
+      useWriter_(false),
+      overflowPolicy_(OverflowPolicy::kDiscardBacklog),
+      maxBuffers_(200),
+      numBuffers_(0),
+      droppedMessages_(0),
+      droppedBytes_(0),
+      numMappedBuffers_(0) {
+    /// 缓冲在桶第一次使用时才申请，见 append()
 }
 
-/// @brief 前端线程调用，把日志信息放入缓冲
+/// @brief 前端线程调用，把日志信息放入所在桶的缓冲
 /// @param logline
 /// @param len
-void AsyncLogger::append(const char* logline, int len) {
-    MutexLockGuard lock(mutex_);
-
-    /// 当前写缓冲有足够的空间放置日志信息
-    /// 直接放入
-    if (currentBuffer_->avail() > len) {
-        currentBuffer_->append(logline, static_cast<size_t>(len));
-    } else {  /// 当前缓冲空间不足
-        /// 将当前缓冲移动到 buffers_ 集合中，等待写入文件系统
-        buffers_.push_back(std::move(currentBuffer_));  /// 利用 移动 而非 复制
-
-        /// 如果 预备缓冲 未被移动，则将预备缓冲移动做到当前缓冲
-        /// 也就是说，前端线程的写入速度小于后端线程的文件写入速度
-        if (nextBuffer_) {
-            currentBuffer_ = std::move(nextBuffer_);
-        } else {  /// 前端线程写入太快，需要重新申请一块新的缓冲作为当前缓冲
-            // Rarely happens
-            currentBuffer_.reset(new Buffer);
-        }
-
-        /// 日志文件写入
-        currentBuffer_->append(logline, static_cast<size_t>(len));
+/// @param level
+void AsyncLogger::append(const char* logline, int len,
+                         Logger::LogLevel level) {
+    if (recordFormat_ == RecordFormat::kText) {
+        appendToBucket(nullptr, 0, logline, len, level);
+    } else {
+        /// 与二进制记录混在一起，需要分帧
+        detail::RecordHeader header;
+        header.length = static_cast<uint32_t>(sizeof header + len);
+        header.kind = detail::RecordKind::kText;
+        header.reserved = 0;
+        appendToBucket(reinterpret_cast<const char*>(&header), sizeof header,
+                       logline, len, level);
+    }
+}
+
+/// @brief 前端线程调用，把二进制日志记录放入所在桶的缓冲
+/// @param record 由 LOG_*_FMT 生成的 kEvent 记录
+/// @param len
+void AsyncLogger::appendRecord(const char* record, int len) {
+    const LogSite* site = LogSite::find(detail::eventSite(record));
+    if (!site) return;
+    if (recordFormat_ != RecordFormat::kText) {
+        if (mappedSites_ &&
+            !mappedSites_[site->id()].load(std::memory_order_acquire)) {
+            addMappedSite(*site);
+        }
+        appendToBucket(nullptr, 0, record, len, site->level());
+        return;
+    }
+
+    /// 文本模式，在前端格式化
+    LogStream stream;
+    detail::formatEvent(*site, record, static_cast<size_t>(len), &stream);
+    appendToBucket(nullptr, 0, stream.buffer().data(),
+                   stream.buffer().length(), site->level());
+}
+
+namespace {
+/// @brief 缓冲中的日志条数，用于丢弃计数
+/// @param framed 是否分帧，见 RecordFormat
+int64_t countMessages(const char* data, int len, bool framed) {
+    int64_t n = 0;
+    const char* end = data + len;
+    if (!framed) {
+        while ((data = static_cast<const char*>(
+                    ::memchr(data, '\n', static_cast<size_t>(end - data))))) {
+            ++data;
+            ++n;
+        }
+        return n;
+    }
+    while (end - data >= static_cast<ptrdiff_t>(sizeof(detail::RecordHeader))) {
+        detail::RecordHeader header;
+        ::memcpy(&header, data, sizeof header);
+        if (header.length < sizeof header) break;
+        data += header.length;
+        ++n;
+    }
+    return n;
+}
+}  // namespace
+
+void AsyncLogger::appendToBucket(const char* header, int headerLen,
+                                 const char* data, int len,
+                                 Logger::LogLevel level) {
+    Bucket& bucket = buckets_[CurrentThread::tid() % kBuckets];
+    const int total = headerLen + len;
+    /// 放不进一块缓冲
+    if (total >= detail::kMediumBuffer) {
+        droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(total, std::memory_order_relaxed);
+        return;
+    }
+
+    while (true) {
+        bool full = false;
+        bool stalled = false;
+        {
+            AdaptiveMutexGuard lock(bucket.mutex);
+            BufferPtr& current = bucket.currentBuffer;
+            bucket.used = true;
+
+            /// 当前写缓冲有足够的空间放置日志信息
+            /// 直接放入
+            if (current && current->avail() > total) {
+                if (current->length() == 0) {
+                    current->firstTime = Timestamp::now();
+                }
+                current->append(header, static_cast<size_t>(headerLen));
+                current->append(data, static_cast<size_t>(len));
+                current->publish();
+                return;
+            }
+
+            /// 当前缓冲空间不足
+            /// 将当前缓冲移动到 buffers 集合中，等待写入文件系统
+            if (current) {
+                bucket.buffers.push_back(std::move(current));
+                full = true;
+            }
+
+            /// 如果 预备缓冲 未被移动，则将预备缓冲移动做到当前缓冲
+            /// 否则前端线程写入太快，需要重新申请一块新的缓冲作为当前缓冲
+            current = bucket.nextBuffer ? std::move(bucket.nextBuffer)
+                                        : newBuffer();
+
+            if (current) {
+                current->firstTime = Timestamp::now();
+                current->append(header, static_cast<size_t>(headerLen));
+                current->append(data, static_cast<size_t>(len));
+                current->publish();
+            } else if (running_ &&
+                       (overflowPolicy_ == OverflowPolicy::kBlock ||
+                        (overflowPolicy_ == OverflowPolicy::kDropBelowWarn &&
+                         level >= Logger::LogLevel::WARN))) {
+                stalled = true;
+            } else {
+                droppedMessages_.fetch_add(1, std::memory_order_relaxed);
+                droppedBytes_.fetch_add(total, std::memory_order_relaxed);
+            }
+        }
+        if (!full && !stalled) return;
+
+        MutexLockGuard lock(mutex_);
+        notified_ = true;
         cond_.notify();
+        if (!stalled) return;
+
+        /// 后端先补充缓冲，再在 mutex_ 下递增 generation_；持有 mutex_
+        /// 后再检查一次，否则在上面失败之后、加锁之前的补充会被错过
+        const uint64_t generation = generation_;
+        if (hasSpace(bucket)) continue;
+
+        /// 等待后端写完一批、归还缓冲后重试
+        while (generation_ == generation && running_) {
+            spaceCond_.wait();
+        }
+    }
+}
+
+bool AsyncLogger::hasSpace(Bucket& bucket) {
+    {
+        AdaptiveMutexGuard lock(bucket.mutex);
+        if (bucket.currentBuffer || bucket.nextBuffer) return true;
+    }
+    return numBuffers_.load(std::memory_order_relaxed) <
+           maxBuffers_.load(std::memory_order_relaxed);
+}
+
+AsyncLogger::BufferPtr AsyncLogger::newBuffer() {
+    if (overflowPolicy_ == OverflowPolicy::kDiscardBacklog) {
+        numBuffers_.fetch_add(1, std::memory_order_relaxed);
+        return allocBuffer();
+    }
+    int n = numBuffers_.load(std::memory_order_relaxed);
+    do {
+        if (n >= maxBuffers_.load(std::memory_order_relaxed)) {
+            return BufferPtr();
+        }
+    } while (!numBuffers_.compare_exchange_weak(n, n + 1,
+                                                std::memory_order_relaxed));
+    return allocBuffer();
+}
+
+AsyncLogger::BufferPtr AsyncLogger::allocBuffer() {
+    if (mappedBuffers_) {
+        if (MappedBuffers::Slot* slot = mappedBuffers_->acquire()) {
+            Buffer* buffer = new (MappedBuffers::memory(slot)) Buffer;
+            buffer->mapped = mappedBuffers_.get();
+            buffer->slot = slot;
+            slot->dataOffset = static_cast<uint32_t>(
+                buffer->data() - reinterpret_cast<char*>(slot));
+            return BufferPtr(buffer);
+        }
+    }
+    return BufferPtr(new Buffer);
+}
+
+void AsyncLogger::BufferDeleter::operator()(Buffer* buffer) const {
+    if (MappedBuffers::Slot* slot = buffer->slot) {
+        MappedBuffers* mapped = buffer->mapped;
+        buffer->~Buffer();
+        mapped->release(slot);
+    } else {
+        delete buffer;
+    }
+}
+
+void AsyncLogger::openMappedBuffers() {
+    char timebuf[32];
+    struct tm tm;
+    time_t now = ::time(nullptr);
+    ::localtime_r(&now, &tm);
+    ::strftime(timebuf, sizeof timebuf, ".%Y%m%d-%H%M%S.", &tm);
+    char pidbuf[32];
+    snprintf(pidbuf, sizeof pidbuf, ".%d.buffers", ProcessInfo::pid());
+    mappedBuffers_.reset(new MappedBuffers(
+        basename_ + timebuf + ProcessInfo::hostname() + pidbuf,
+        numMappedBuffers_, sizeof(Buffer),
+        recordFormat_ != RecordFormat::kText));
+    if (recordFormat_ != RecordFormat::kText && mappedBuffers_->valid()) {
+        mappedSites_.reset(new std::atomic<bool>[LogSite::kMaxSites + 1]());
+    }
+}
+
+void AsyncLogger::addMappedSite(const LogSite& site) {
+    string record;
+    detail::encodeSite(site, &record);
+    /// 并发时可能写入两次，logDecoder 以后一次为准
+    if (!mappedBuffers_->appendSite(record.data(), record.size())) {
+        fprintf(stderr, "AsyncLogger: no room for site %u in %s\n",
+                site.id(), mappedBuffers_->filename().c_str());
+    }
+    mappedSites_[site.id()].store(true, std::memory_order_release);
+}
+
+void AsyncLogger::deleteBuffers(BufferVector::iterator first,
+                                BufferVector::iterator last) {
+    numBuffers_.fetch_sub(static_cast<int>(last - first),
+                          std::memory_order_relaxed);
+    for (; first != last; ++first) first->reset();
+}
+
+/// @brief 后端线程调用，取走各桶已填满的缓冲和非空的当前缓冲
+/// @param buffersToWrite 待写入缓冲集
+/// @param spareBuffers 空闲缓冲，用于替换当前缓冲和补充预备缓冲
+void AsyncLogger::collect(BufferVector* buffersToWrite,
+                          BufferVector* spareBuffers) {
+    auto spare = [this, spareBuffers] {
+        if (spareBuffers->empty()) return newBuffer();
+        BufferPtr buffer = std::move(spareBuffers->back());
+        spareBuffers->pop_back();
+        return buffer;
+    };
+
+    for (Bucket& bucket : buckets_) {
+        AdaptiveMutexGuard lock(bucket.mutex);
+        for (auto& buffer : bucket.buffers) {
+            buffersToWrite->push_back(std::move(buffer));
+        }
+        bucket.buffers.clear();
+
+        /// 从未使用过的桶
+        if (!bucket.used) continue;
+
+        /// 最核心操作，前后端缓冲交换，内部指针交换 而非复制
+        /// 申请不到缓冲时留空，前端线程会等待或丢弃
+        if (bucket.currentBuffer && bucket.currentBuffer->length() > 0) {
+            buffersToWrite->push_back(std::move(bucket.currentBuffer));
+        }
+        if (!bucket.currentBuffer) bucket.currentBuffer = spare();
+        if (!bucket.nextBuffer) bucket.nextBuffer = spare();
+    }
+}
+
+/// @brief 后端线程调用，把空闲缓冲补充给缺少缓冲的桶，不申请新缓冲
+/// @param spareBuffers
+void AsyncLogger::refill(BufferVector* spareBuffers) {
+    for (Bucket& bucket : buckets_) {
+        if (spareBuffers->empty()) return;
+        AdaptiveMutexGuard lock(bucket.mutex);
+        if (!bucket.used) continue;
+        for (BufferPtr* buffer : {&bucket.currentBuffer, &bucket.nextBuffer}) {
+            if (!*buffer && !spareBuffers->empty()) {
+                *buffer = std::move(spareBuffers->back());
+                spareBuffers->pop_back();
+            }
+        }
+    }
+}
+
+void AsyncLogger::applyConfig() {
+    const Tunables& tunables = config_->get();
+    flushInterval_ = std::max(tunables.flushInterval, 1);
+    maxBuffers_.store(std::max(tunables.maxBuffers, 2 * kBuckets),
+                      std::memory_order_relaxed);
+}
+
+/// @brief 后端线程调用，把一行提示写入文件
+/// @param msg
+/// @param output
+void AsyncLogger::writeNotice(const char* msg, LogFile* output) {
+    fputs(msg, stderr);
+    int len = static_cast<int>(strlen(msg));
+    if (recordFormat_ == RecordFormat::kBinary) {
+        detail::RecordHeader header;
+        header.length = static_cast<uint32_t>(sizeof header + len);
+        header.kind = detail::RecordKind::kText;
+        header.reserved = 0;
+        output->append(reinterpret_cast<const char*>(&header), sizeof header);
+    }
+    output->append(msg, len);
+}
+
+/// @brief 后端线程调用，按 recordFormat_ 把一块缓冲写入文件
+/// @param buffer
+/// @param output
+/// @param writtenSites kBinary 时已写入文件的 LogSite，每个只写一次
+void AsyncLogger::writeBuffer(const Buffer& buffer, LogFile* output,
+                              std::vector<bool>* writtenSites) {
+    if (recordFormat_ == RecordFormat::kText) {
+        output->append(buffer.data(), buffer.length());
+        return;
+    }
+
+    const char* p = buffer.data();
+    const char* end = p + buffer.length();
+    /// kBinary 时连续的记录一次写入
+    const char* pending = p;
+    LogStream stream;
+    string siteRecord;
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(detail::RecordHeader))) {
+        detail::RecordHeader header;
+        ::memcpy(&header, p, sizeof header);
+        assert(header.length >= sizeof header && p + header.length <= end);
+
+        if (header.kind == detail::RecordKind::kText) {
+            if (recordFormat_ == RecordFormat::kDeferred) {
+                output->append(p + sizeof header,
+                               static_cast<int>(header.length - sizeof header));
+            }
+        } else if (header.kind == detail::RecordKind::kEvent) {
+            uint32_t id = detail::eventSite(p);
+            const LogSite* site = LogSite::find(id);
+            if (recordFormat_ == RecordFormat::kDeferred) {
+                if (site) {
+                    stream.resetBuffer();
+                    detail::formatEvent(*site, p, header.length, &stream);
+                    output->append(stream.buffer().data(),
+                                   stream.buffer().length());
+                }
+            } else if (site && !(*writtenSites)[id]) {
+                /// 第一次写入该 LogSite 的记录之前，先写入 kSite 记录
+                output->append(pending, static_cast<int>(p - pending));
+                pending = p;
+                siteRecord.clear();
+                detail::encodeSite(*site, &siteRecord);
+                output->append(siteRecord.data(),
+                               static_cast<int>(siteRecord.size()));
+                (*writtenSites)[id] = true;
+            }
+        }
+        p += header.length;
+    }
+
+    if (recordFormat_ == RecordFormat::kBinary) {
+        output->append(pending, static_cast<int>(end - pending));
     }
 }
 
@@ -150,82 +488,107 @@ void AsyncLogger::threadFunc() {
     assert(running_ == true);
     latch_.countDown();
 
+    /// 写线程在 output 之后析构，写完 output 关闭时剩余的数据
+    std::unique_ptr<LogWriter> writer;
+    if (useWriter_) writer.reset(new LogWriter(writerOptions_));
     // LogFile output(basename_, rollSize_, false);
-    LogFile output(basename_, rollSize_, false, flushInterval_);
-
-    BufferPtr newBuffer1(new Buffer);
-    BufferPtr newBuffer2(new Buffer);
-    newBuffer1->bzero();
-    newBuffer2->bzero();
+    LogFile output(basename_, rollSize_, false, flushInterval_, 1024,
+                   writer.get());
+    output.setRotation(rotation_);
 
-    /// 申请一块大小为16的缓冲集，一般只会用到2块，除非前端写入速度太快
+    /// 每个桶一般只会用到2块，除非前端写入速度太快
+    const size_t kMaxSpareBuffers = 2 * kBuckets;
+    /// 超过 100MB 的日志视为堆积，只保留最早的部分
+    const size_t kMaxBuffersToWrite = 200;
+    BufferVector spareBuffers;
+    spareBuffers.reserve(kMaxSpareBuffers);
     BufferVector buffersToWrite;
-    buffersToWrite.reserve(16);
-
-    while (running_) {
-        assert(newBuffer1 && newBuffer1->length() == 0);
-        assert(newBuffer2 && newBuffer2->length() == 0);
-        assert(buffersToWrite.empty());
-
-        /// Swap out what need to be written, keep CS short
-        {
-            Lux::MutexLockGuard lock(mutex_);
-            if (buffers_.empty())  // unusual usage!
-                cond_.waitForSeconds(flushInterval_);
+    buffersToWrite.reserve(kMaxSpareBuffers);
+    std::vector<bool> writtenSites(LogSite::kMaxSites + 1);
+    int64_t reportedDrops = 0;
 
-            /// 采用move 提高效率
-            buffers_.push_back(std::move(currentBuffer_));
-            currentBuffer_ = std::move(newBuffer1);
-            /// 内部指针交换 而非复制
-            /// 最核心操作，前后端缓冲交换
-            buffersToWrite.swap(buffers_);
-            if (!nextBuffer_) nextBuffer_ = std::move(newBuffer2);
+    auto write = [&] {
+        collect(&buffersToWrite, &spareBuffers);
+        if (buffersToWrite.empty() && droppedMessages() == reportedDrops) {
+            return;
         }
 
-        assert(!buffersToWrite.empty());
+        /// 各桶的缓冲按第一条日志的时间排序，保持近似的全局顺序
+        std::stable_sort(buffersToWrite.begin(), buffersToWrite.end(),
+                         [](const BufferPtr& lhs, const BufferPtr& rhs) {
+                             return lhs->firstTime < rhs->firstTime;
+                         });
 
-        /// 待写入缓冲集长度不对 输出错误
+        /// 待写入缓冲集过长 输出错误
         /// 将错误数据写入文件，并裁剪待写入缓冲集
-        if (buffersToWrite.size() > 25) {
+        if (overflowPolicy_ == OverflowPolicy::kDiscardBacklog &&
+            buffersToWrite.size() > kMaxBuffersToWrite) {
+            int64_t bytes = 0;
+            int64_t messages = 0;
+            for (auto it = buffersToWrite.begin() + kBuckets;
+                 it != buffersToWrite.end(); ++it) {
+                bytes += (*it)->length();
+                messages += countMessages((*it)->data(), (*it)->length(),
+                                          recordFormat_ != RecordFormat::kText);
+            }
+            droppedMessages_.fetch_add(messages, std::memory_order_relaxed);
+            droppedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+            deleteBuffers(buffersToWrite.begin() + kBuckets,
+                          buffersToWrite.end());
+            buffersToWrite.erase(buffersToWrite.begin() + kBuckets,
+                                 buffersToWrite.end());
+        }
+
+        /// 报告上一批以来丢弃的日志
+        int64_t dropped = droppedMessages();
+        if (dropped != reportedDrops) {
             char buf[256];
             snprintf(buf, sizeof buf,
-                     "Dropped log messages at %s, %zd larger buffers\n",
-                     Timestamp::now().toFormattedString().c_str(),
-                     buffersToWrite.size() - 2);
-            fputs(buf, stderr);
-            output.append(buf, static_cast<int>(strlen(buf)));
-            buffersToWrite.erase(buffersToWrite.begin() + 2,
-                                 buffersToWrite.end());
+                     "Dropped %" PRId64 " log messages at %s, %" PRId64
+                     " in total\n",
+                     dropped - reportedDrops,
+                     Timestamp::now().toFormattedString().c_str(), dropped);
+            writeNotice(buf, &output);
+            reportedDrops = dropped;
         }
 
         /// 迭代待写入缓冲集，将缓冲日志写入文件系统
-        for (const auto& buffer : buffersToWrite) {
+        for (auto& buffer : buffersToWrite) {
             // FIXME: use unbuffered stdio FILE ? or use ::writev ?
-            output.append(buffer->data(), buffer->length());
-        }
-
-        if (buffersToWrite.size() > 2) {
-            // drop non-bzero-ed buffers, avoid trashing
-            buffersToWrite.resize(2);
+            writeBuffer(*buffer, &output, &writtenSites);
+            buffer->reset();
         }
+        /// 写入文件 (page cache) 之后，映射文件中的缓冲才不需要恢复
+        output.flush();
+        for (auto& buffer : buffersToWrite) buffer->markWritten();
 
-        if (!newBuffer1) {
-            assert(!buffersToWrite.empty());
-            newBuffer1 = std::move(buffersToWrite.back());
+        // drop the rest, avoid trashing
+        while (spareBuffers.size() < kMaxSpareBuffers &&
+               !buffersToWrite.empty()) {
+            spareBuffers.push_back(std::move(buffersToWrite.back()));
             buffersToWrite.pop_back();
-            newBuffer1->reset();
         }
+        deleteBuffers(buffersToWrite.begin(), buffersToWrite.end());
+        buffersToWrite.clear();
+        refill(&spareBuffers);
+    };
 
-        if (!newBuffer2) {
-            assert(!buffersToWrite.empty());
-            newBuffer2 = std::move(buffersToWrite.back());
-            buffersToWrite.pop_back();
-            newBuffer2->reset();
+    while (running_) {
+        if (config_ && config_->changed()) applyConfig();
+        {
+            Lux::MutexLockGuard lock(mutex_);
+            if (!notified_)  // unusual usage!
+                cond_.waitForSeconds(flushInterval_);
+            notified_ = false;
         }
+        write();
 
-        buffersToWrite.clear();
-        output.flush();
+        /// 唤醒等待缓冲的前端线程
+        Lux::MutexLockGuard lock(mutex_);
+        ++generation_;
+        spaceCond_.notifyAll();
     }
 
-    output.flush();
+    /// 写入 stop() 之前的最后一批日志
+    write();
 }
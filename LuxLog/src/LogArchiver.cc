@@ -0,0 +1,192 @@
+/**
+ * @file LogArchiver.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/LogArchiver.h>
+#include <LuxUtils/CurrentThread.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>  // setpriority
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Lux;
+
+namespace {
+// linux/ioprio.h
+const int kIoprioWhoProcess = 1;
+const int kIoprioClassIdle = 3;
+const int kIoprioClassShift = 13;
+
+bool endsWith(const string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+/// @brief The names in the current directory of files of @c basename,
+/// i.e. starting with "basename." and a digit.
+std::vector<string> listFiles(const string& basename) {
+    std::vector<string> names;
+    DIR* dir = ::opendir(".");
+    if (!dir) return names;
+
+    const string prefix = basename + ".";
+    while (struct dirent* entry = ::readdir(dir)) {
+        string name = entry->d_name;
+        if (name.size() > prefix.size() &&
+            name.compare(0, prefix.size(), prefix) == 0 &&
+            ::isdigit(static_cast<unsigned char>(name[prefix.size()]))) {
+            names.push_back(std::move(name));
+        }
+    }
+    ::closedir(dir);
+    return names;
+}
+}  // namespace
+
+LogArchiver::LogArchiver(const string& basename, int maxFiles, int level)
+    : basename_(basename),
+      maxFiles_(maxFiles),
+      level_(level),
+      running_(true),
+      thread_(std::bind(&LogArchiver::threadFunc, this), "LogArchiver"),
+      mutex_(),
+      cond_(mutex_) {
+    thread_.start();
+}
+
+LogArchiver::~LogArchiver() {
+    {
+        MutexLockGuard lock(mutex_);
+        running_ = false;
+        cond_.notify();
+    }
+    thread_.join();
+}
+
+void LogArchiver::setCurrent(const string& filename) {
+    MutexLockGuard lock(mutex_);
+    current_ = filename;
+}
+
+void LogArchiver::add(const string& filename) {
+    MutexLockGuard lock(mutex_);
+    rolled_.push_back(filename);
+    cond_.notify();
+}
+
+void LogArchiver::threadFunc() {
+    // do not compete with the service for CPU and disk
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(CurrentThread::tid()), 19);
+    ::syscall(SYS_ioprio_set, kIoprioWhoProcess, CurrentThread::tid(),
+              kIoprioClassIdle << kIoprioClassShift);
+
+    // files left by the previous runs
+    removeTemporaries();
+    if (maxFiles_ > 0) prune();
+
+    while (true) {
+        string filename;
+        {
+            MutexLockGuard lock(mutex_);
+            while (rolled_.empty() && running_) {
+                cond_.wait();
+            }
+            if (rolled_.empty()) break;
+            filename = std::move(rolled_.front());
+            rolled_.pop_front();
+        }
+
+        if (level_ > 0) compress(filename);
+        if (maxFiles_ > 0) prune();
+    }
+}
+
+void LogArchiver::compress(const string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // removed by prune()
+        if (errno != ENOENT) {
+            fprintf(stderr, "LogArchiver::compress() %s failed %s\n",
+                    filename.c_str(), strerror(errno));
+        }
+        return;
+    }
+
+    string gzname = filename + ".gz";
+    string tmpname = gzname + ".tmp";
+    char mode[8];
+    snprintf(mode, sizeof mode, "wb%d", std::min(level_, 9));
+    gzFile out = ::gzopen(tmpname.c_str(), mode);
+    bool ok = out != nullptr;
+
+    char buf[64 * 1024];
+    ssize_t n = 0;
+    while (ok && (n = ::read(fd, buf, sizeof buf)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+        } else {
+            ok = ::gzwrite(out, buf, static_cast<unsigned>(n)) == n;
+        }
+    }
+    // the file is read once, keep it out of the page cache
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    if (out && ::gzclose(out) != Z_OK) ok = false;
+
+    if (ok && ::rename(tmpname.c_str(), gzname.c_str()) == 0) {
+        ::unlink(filename.c_str());
+    } else {
+        fprintf(stderr, "LogArchiver::compress() %s failed\n",
+                filename.c_str());
+        ::unlink(tmpname.c_str());
+    }
+}
+
+void LogArchiver::removeTemporaries() {
+    // the .log is removed only after the .gz is complete, so it is still there
+    for (const string& name : listFiles(basename_)) {
+        if (endsWith(name, ".log.gz.tmp")) ::unlink(name.c_str());
+    }
+}
+
+void LogArchiver::prune() {
+    // basename.YYYYmmdd-..., a file and its .gz count once
+    std::vector<string> names;
+    for (string& name : listFiles(basename_)) {
+        if (endsWith(name, ".log")) {
+            names.push_back(std::move(name));
+        } else if (endsWith(name, ".log.gz")) {
+            names.push_back(name.substr(0, name.size() - 3));
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    string current;
+    {
+        MutexLockGuard lock(mutex_);
+        current = current_;
+    }
+    size_t maxFiles = static_cast<size_t>(maxFiles_);
+    for (size_t i = 0; i < names.size() && names.size() - i > maxFiles; ++i) {
+        if (names[i] == current) continue;
+        ::unlink(names[i].c_str());
+        ::unlink((names[i] + ".gz").c_str());
+        ::unlink((names[i] + ".gz.tmp").c_str());
+    }
+}
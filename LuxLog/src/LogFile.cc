@@ -16,7 +16,7 @@
 using namespace Lux;
 
 LogFile::LogFile(const string& basename, off_t rollSize, bool threadSafe,
-                 int flushInterval, int checkEveryN)
+                 int flushInterval, int checkEveryN, LogWriter* writer)
     : basename_(basename),
       rollSize_(rollSize),
       flushInterval_(flushInterval),
@@ -25,13 +25,28 @@ LogFile::LogFile(const string& basename, off_t rollSize, bool threadSafe,
       mutex_(threadSafe ? new MutexLock : NULL),
       startOfPeriod_(0),
       lastRoll_(0),
-      lastFlush_(0) {
+      lastFlush_(0),
+      rollPerSeconds_(kSecondsPerDay),
+      writer_(writer) {
     assert(basename.find('/') == string::npos);
     rollFile();
 }
 
 LogFile::~LogFile() = default;
 
+void LogFile::setRotation(const Rotation& rotation) {
+    rollPerSeconds_ = rotation.period == RollPeriod::kHourly ? kSecondsPerHour
+                                                             : kSecondsPerDay;
+    startOfPeriod_ = lastRoll_ / rollPerSeconds_ * rollPerSeconds_;
+    if (rotation.maxFiles > 0 || rotation.compressLevel > 0) {
+        archiver_ = std::make_shared<LogArchiver>(
+            basename_, rotation.maxFiles, rotation.compressLevel);
+        archiver_->setCurrent(filename_);
+    } else {
+        archiver_.reset();
+    }
+}
+
 void LogFile::append(const char* logline, int len) {
     if (mutex_) {
         MutexLockGuard lock(*mutex_);
@@ -44,28 +59,43 @@ void LogFile::append(const char* logline, int len) {
 void LogFile::flush() {
     if (mutex_) {
         MutexLockGuard lock(*mutex_);
-        file_->flush();
+        flush_unlocked();
+    } else {
+        flush_unlocked();
+    }
+}
+
+void LogFile::flush_unlocked() {
+    if (writerFile_) {
+        writerFile_->flush();
     } else {
         file_->flush();
     }
 }
 
 void LogFile::append_unlocked(const char* logline, int len) {
-    file_->append(logline, len);
+    off_t writtenBytes;
+    if (writerFile_) {
+        writerFile_->append(logline, static_cast<size_t>(len));
+        writtenBytes = writerFile_->writtenBytes();
+    } else {
+        file_->append(logline, static_cast<size_t>(len));
+        writtenBytes = file_->writtenBytes();
+    }
 
-    if (file_->writtenBytes() > rollSize_) {
+    if (writtenBytes > rollSize_) {
         rollFile();
     } else {
         ++count_;
         if (count_ >= checkEveryN_) {
             count_ = 0;
             time_t now = ::time(NULL);
-            time_t thisPeriod_ = now / kRollPerSeconds_ * kRollPerSeconds_;
+            time_t thisPeriod_ = now / rollPerSeconds_ * rollPerSeconds_;
             if (thisPeriod_ != startOfPeriod_) {
                 rollFile();
             } else if (now - lastFlush_ > flushInterval_) {
                 lastFlush_ = now;
-                file_->flush();
+                flush_unlocked();
             }
         }
     }
@@ -74,13 +104,40 @@ void LogFile::append_unlocked(const char* logline, int len) {
 bool LogFile::rollFile() {
     time_t now = 0;
     string filename = getLogFileName(basename_, &now);
-    time_t start = now / kRollPerSeconds_ * kRollPerSeconds_;
+    time_t start = now / rollPerSeconds_ * rollPerSeconds_;
 
     if (now > lastRoll_) {
         lastRoll_ = now;
         lastFlush_ = now;
         startOfPeriod_ = start;
-        file_.reset(new FileUtil::AppendFile(filename));
+        string rolled = std::move(filename_);
+        filename_ = filename;
+        if (archiver_) archiver_->setCurrent(filename_);
+
+        // archived after the queued writes are done
+        bool rolledByWriter = writerFile_ != nullptr;
+        if (rolledByWriter && archiver_) {
+            std::shared_ptr<LogArchiver> archiver = archiver_;
+            writerFile_->setCloseCallback(
+                [archiver, rolled] { archiver->add(rolled); });
+        }
+        writerFile_.reset();
+        file_.reset();
+
+        if (writer_) {
+            writerFile_ = writer_->open(filename);
+            if (!writerFile_) {
+                fprintf(stderr,
+                        "LogFile::rollFile() %s is written without "
+                        "LogWriter\n",
+                        filename.c_str());
+            }
+        }
+        // no writer_, or it failed to open the file
+        if (!writerFile_) file_.reset(new FileUtil::AppendFile(filename));
+        if (archiver_ && !rolled.empty() && !rolledByWriter) {
+            archiver_->add(rolled);
+        }
         return true;
     }
     return false;
@@ -0,0 +1,516 @@
+/**
+ * @file LogRecord.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/LogRecord.h>
+#include <LuxUtils/CurrentThread.h>
+#include <LuxUtils/Timestamp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>    // isfinite
+#include <cstddef>  // ptrdiff_t
+#include <cstring>
+#include <ctime>  // gmtime_r tm
+
+namespace Lux {
+// Logger.cc
+extern Logger::OutputFunc g_output;
+extern Logger::LevelOutputFunc g_levelOutput;
+extern Logger::FlushFunc g_flush;
+extern Logger::RecordOutputFunc g_recordOutput;
+extern const char* LogLevelName[];
+void formatLogTime(int64_t microSecondsSinceEpoch, LogStream& stream);
+
+namespace {
+std::atomic<uint32_t> g_numSites(0);
+std::atomic<const LogSite*> g_sites[LogSite::kMaxSites];
+
+__thread char t_isoTime[64];
+__thread time_t t_lastIsoSecond;
+
+template <typename T>
+T readAs(const char* p) {
+    T value;
+    ::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+/// Put "YYYY-MM-DDThh:mm:ss.uuuuuuZ" into stream, RFC 3339 in UTC
+void formatIsoTime(int64_t microSecondsSinceEpoch, LogStream* stream) {
+    time_t seconds = static_cast<time_t>(microSecondsSinceEpoch /
+                                         Timestamp::kMicroSecondsPerSecond);
+    if (seconds != t_lastIsoSecond) {
+        t_lastIsoSecond = seconds;
+        struct tm tm_time {};
+        ::gmtime_r(&seconds, &tm_time);
+        snprintf(t_isoTime, sizeof(t_isoTime), "%4d-%02d-%02dT%02d:%02d:%02d.",
+                 tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
+                 tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
+    }
+    char buf[8];
+    int micros = static_cast<int>(microSecondsSinceEpoch %
+                                  Timestamp::kMicroSecondsPerSecond);
+    for (int i = 5; i >= 0; --i) {
+        buf[i] = static_cast<char>('0' + micros % 10);
+        micros /= 10;
+    }
+    buf[6] = 'Z';
+    stream->append(t_isoTime, 20);
+    stream->append(buf, 7);
+}
+
+/// A decoded argument, strings point into the record
+struct Arg {
+    detail::ArgType type;
+    int64_t i;
+    uint64_t u;
+    double d;
+    char c;
+    bool b;
+    uintptr_t pointer;
+    const char* str;
+    uint32_t len;
+};
+
+/// @return the end of the argument, null if malformed
+const char* readArg(const char* p, const char* end, Arg* arg) {
+    if (p >= end) return nullptr;
+    arg->type = static_cast<detail::ArgType>(*p++);
+    switch (arg->type) {
+        case detail::ArgType::kInt:
+            if (end - p < 8) return nullptr;
+            arg->i = readAs<int64_t>(p);
+            return p + 8;
+        case detail::ArgType::kUInt:
+            if (end - p < 8) return nullptr;
+            arg->u = readAs<uint64_t>(p);
+            return p + 8;
+        case detail::ArgType::kDouble:
+            if (end - p < 8) return nullptr;
+            arg->d = readAs<double>(p);
+            return p + 8;
+        case detail::ArgType::kChar:
+            if (end - p < 1) return nullptr;
+            arg->c = *p;
+            return p + 1;
+        case detail::ArgType::kBool:
+            if (end - p < 1) return nullptr;
+            arg->b = *p != 0;
+            return p + 1;
+        case detail::ArgType::kString:
+        case detail::ArgType::kKey:
+            if (end - p < 4) return nullptr;
+            arg->len = readAs<uint32_t>(p);
+            p += 4;
+            if (static_cast<size_t>(end - p) < arg->len) return nullptr;
+            arg->str = p;
+            return p + arg->len;
+        case detail::ArgType::kPointer:
+            if (end - p < static_cast<ptrdiff_t>(sizeof(uintptr_t))) {
+                return nullptr;
+            }
+            arg->pointer = readAs<uintptr_t>(p);
+            return p + sizeof(uintptr_t);
+    }
+    return nullptr;
+}
+
+/// Put the value like LOG_* does
+void appendValue(const Arg& arg, LogStream* stream) {
+    switch (arg.type) {
+        case detail::ArgType::kInt:
+            *stream << static_cast<long long>(arg.i);
+            break;
+        case detail::ArgType::kUInt:
+            *stream << static_cast<unsigned long long>(arg.u);
+            break;
+        case detail::ArgType::kDouble:
+            *stream << arg.d;
+            break;
+        case detail::ArgType::kChar:
+            *stream << arg.c;
+            break;
+        case detail::ArgType::kBool:
+            *stream << arg.b;
+            break;
+        case detail::ArgType::kString:
+        case detail::ArgType::kKey:
+            stream->append(arg.str, static_cast<int>(arg.len));
+            break;
+        case detail::ArgType::kPointer:
+            *stream << reinterpret_cast<const void*>(arg.pointer);
+            break;
+    }
+}
+
+/// Put the quoted string, escaped for JSON, which logfmt also accepts
+void appendQuoted(const char* str, size_t len, LogStream* stream) {
+    static const char kHex[] = "0123456789abcdef";
+    *stream << '"';
+    const char* run = str;
+    const char* end = str + len;
+    for (const char* p = str; p != end; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        stream->append(run, static_cast<int>(p - run));
+        run = p + 1;
+        switch (c) {
+            case '"':
+                stream->append("\\\"", 2);
+                break;
+            case '\\':
+                stream->append("\\\\", 2);
+                break;
+            case '\n':
+                stream->append("\\n", 2);
+                break;
+            case '\r':
+                stream->append("\\r", 2);
+                break;
+            case '\t':
+                stream->append("\\t", 2);
+                break;
+            default: {
+                char buf[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+                stream->append(buf, 6);
+            }
+        }
+    }
+    stream->append(run, static_cast<int>(end - run));
+    *stream << '"';
+}
+
+/// Put the string as a JSON string, or as a logfmt value, quoted if needed
+void appendString(const char* str, size_t len, bool json, LogStream* stream) {
+    bool quote = json || len == 0;
+    for (size_t i = 0; !quote && i < len; ++i) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        quote = c <= ' ' || c == '=' || c == '"' || c == '\\';
+    }
+    if (quote) {
+        appendQuoted(str, len, stream);
+    } else {
+        stream->append(str, static_cast<int>(len));
+    }
+}
+
+/// Put the value of a field, typed in JSON
+void appendField(const Arg& arg, bool json, LogStream* stream) {
+    switch (arg.type) {
+        case detail::ArgType::kDouble:
+            // JSON has no NaN or Infinity
+            if (json && !std::isfinite(arg.d)) {
+                stream->append("null", 4);
+            } else {
+                *stream << arg.d;
+            }
+            break;
+        case detail::ArgType::kBool:
+            if (arg.b) {
+                stream->append("true", 4);
+            } else {
+                stream->append("false", 5);
+            }
+            break;
+        case detail::ArgType::kChar:
+            appendString(&arg.c, 1, json, stream);
+            break;
+        case detail::ArgType::kString:
+        case detail::ArgType::kKey:
+            appendString(arg.str, arg.len, json, stream);
+            break;
+        case detail::ArgType::kPointer:
+            if (json) *stream << '"';
+            *stream << reinterpret_cast<const void*>(arg.pointer);
+            if (json) *stream << '"';
+            break;
+        default:
+            appendValue(arg, stream);
+    }
+}
+
+/// @brief Put the format, "{}" is replaced by the next argument, "{{" and
+/// "}}" are escapes.
+/// @return the first argument not used, null if none or malformed
+const char* formatMessage(const char* format, const char* p, const char* end,
+                          LogStream* stream) {
+    for (const char* f = format; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}') {
+            // fields are not used for the format
+            bool isKey = p && p < end &&
+                         static_cast<detail::ArgType>(*p) ==
+                             detail::ArgType::kKey;
+            Arg arg;
+            const char* next = p && !isKey ? readArg(p, end, &arg) : nullptr;
+            if (next) {
+                appendValue(arg, stream);
+                p = next;
+            } else {
+                stream->append("{}", 2);
+                if (!isKey) p = nullptr;
+            }
+            ++f;
+        } else if ((f[0] == '{' && f[1] == '{') ||
+                   (f[0] == '}' && f[1] == '}')) {
+            *stream << *f;
+            ++f;
+        } else {
+            *stream << *f;
+        }
+    }
+    return p;
+}
+
+/// Put the key-value fields from p on, other arguments are skipped
+void formatFields(const char* p, const char* end, bool json,
+                  LogStream* stream) {
+    while (p && p < end) {
+        Arg key;
+        const char* next = readArg(p, end, &key);
+        if (!next) return;
+        p = next;
+        if (key.type != detail::ArgType::kKey) continue;
+
+        // a key without its value is dropped with the rest
+        Arg value;
+        next = readArg(p, end, &value);
+        if (!next || value.type == detail::ArgType::kKey) return;
+        p = next;
+
+        if (json) {
+            *stream << ',';
+            appendQuoted(key.str, key.len, stream);
+            *stream << ':';
+        } else {
+            *stream << ' ';
+            stream->append(key.str, static_cast<int>(key.len));
+            *stream << '=';
+        }
+        appendField(value, json, stream);
+    }
+}
+
+void appendSiteString(const char* str, size_t len, string* out) {
+    uint32_t n = static_cast<uint32_t>(len);
+    out->append(reinterpret_cast<const char*>(&n), sizeof n);
+    out->append(str, len);
+}
+
+/// @return the end of the string, null if malformed
+const char* readString(const char* p, const char* end, string* str) {
+    if (end - p < 4) return nullptr;
+    uint32_t len = readAs<uint32_t>(p);
+    p += 4;
+    if (static_cast<size_t>(end - p) < len) return nullptr;
+    str->assign(p, len);
+    return p + len;
+}
+}  // namespace
+}  // namespace Lux
+
+using namespace Lux;
+using namespace Lux::detail;
+
+const uint32_t LogSite::kMaxSites;
+
+LogSite::LogSite(const char* format, Logger::SourceFile file, int line,
+                 Logger::LogLevel level, const char* func)
+    : format_(format),
+      file_(file),
+      line_(line),
+      level_(level),
+      func_(func),
+      id_(0) {
+    uint32_t index = g_numSites.fetch_add(1, std::memory_order_relaxed);
+    if (index < kMaxSites) {
+        g_sites[index].store(this, std::memory_order_release);
+        id_ = index + 1;
+    }
+}
+
+const LogSite* LogSite::find(uint32_t id) {
+    if (id == 0 || id > kMaxSites) return nullptr;
+    return g_sites[id - 1].load(std::memory_order_acquire);
+}
+
+RecordWriter::RecordWriter(char* buf, size_t size, const LogSite& site)
+    : begin_(buf), cur_(buf), end_(buf + size), full_(false) {
+    assert(size >= sizeof(RecordHeader) + sizeof(EventHeader));
+    cur_ += sizeof(RecordHeader);
+    EventHeader event;
+    event.site = site.id();
+    event.tid = CurrentThread::tid();
+    event.microSecondsSinceEpoch = Logger::now().microSecondsSinceEpoch();
+    ::memcpy(cur_, &event, sizeof event);
+    cur_ += sizeof event;
+}
+
+void RecordWriter::putRaw(ArgType type, const void* value, size_t len) {
+    if (full_ || static_cast<size_t>(end_ - cur_) < 1 + len) {
+        full_ = true;
+        return;
+    }
+    *cur_++ = static_cast<char>(type);
+    ::memcpy(cur_, value, len);
+    cur_ += len;
+}
+
+void RecordWriter::putString(ArgType type, const char* str, size_t len,
+                             bool truncate) {
+    size_t avail = static_cast<size_t>(end_ - cur_);
+    if (full_ || avail < 1 + sizeof(uint32_t) ||
+        (!truncate && avail - 1 - sizeof(uint32_t) < len)) {
+        full_ = true;
+        return;
+    }
+    // truncated to fit
+    uint32_t n = static_cast<uint32_t>(
+        std::min(len, avail - 1 - sizeof(uint32_t)));
+    *cur_++ = static_cast<char>(type);
+    ::memcpy(cur_, &n, sizeof n);
+    cur_ += sizeof n;
+    ::memcpy(cur_, str, n);
+    cur_ += n;
+}
+
+int RecordWriter::length() const {
+    RecordHeader header;
+    header.length = static_cast<uint32_t>(cur_ - begin_);
+    header.kind = RecordKind::kEvent;
+    header.reserved = 0;
+    ::memcpy(begin_, &header, sizeof header);
+    return static_cast<int>(header.length);
+}
+
+void detail::outputRecord(const LogSite& site, const char* record, int len) {
+    if (g_recordOutput && site.id() != 0) {
+        g_recordOutput(record, len);
+    } else {
+        LogStream stream;
+        formatEvent(site, record, static_cast<size_t>(len), &stream);
+        const LogStream::Buffer& buf(stream.buffer());
+        if (g_levelOutput) {
+            g_levelOutput(buf.data(), buf.length(), site.level());
+        } else {
+            g_output(buf.data(), buf.length());
+        }
+    }
+    if (site.level() == Logger::LogLevel::FATAL) {
+        g_flush();
+        abort();
+    }
+}
+
+void detail::formatEvent(const LogSite& site, const char* record, size_t len,
+                         LogStream* stream) {
+    const char* p = record + sizeof(RecordHeader);
+    const char* end = record + len;
+    EventHeader event = readAs<EventHeader>(p);
+    p += sizeof event;
+    Logger::RecordStyle style = Logger::recordStyle();
+
+    if (style == Logger::RecordStyle::kText) {
+        // the same layout as Logger
+        formatLogTime(event.microSecondsSinceEpoch, *stream);
+        char tid[32];
+        int n = snprintf(tid, sizeof tid, "%5d ", event.tid);
+        stream->append(tid, n);
+        stream->append(LogLevelName[static_cast<int>(site.level())], 6);
+        stream->append(site.file().data_, site.file().size_);
+        *stream << ':' << site.line() << ' ';
+        if (site.level() <= Logger::LogLevel::DEBUG) {
+            *stream << site.func() << "(..) ";
+        }
+        stream->append(">_< ", 4);
+        p = formatMessage(site.format(), p, end, stream);
+        formatFields(p, end, false, stream);
+        *stream << '\n';
+        return;
+    }
+
+    const bool json = style == Logger::RecordStyle::kJson;
+    const char* level = LogLevelName[static_cast<int>(site.level())];
+    int levelLen = static_cast<int>(strcspn(level, " "));
+    LogStream message;
+    p = formatMessage(site.format(), p, end, &message);
+
+    if (json) {
+        stream->append("{\"time\":\"", 9);
+        formatIsoTime(event.microSecondsSinceEpoch, stream);
+        stream->append("\",\"level\":\"", 11);
+        stream->append(level, levelLen);
+        *stream << "\",\"tid\":" << event.tid << ",\"src\":\"";
+        stream->append(site.file().data_, site.file().size_);
+        *stream << ':' << site.line() << '"';
+        if (site.level() <= Logger::LogLevel::DEBUG) {
+            stream->append(",\"func\":", 8);
+            appendQuoted(site.func(), strlen(site.func()), stream);
+        }
+        stream->append(",\"msg\":", 7);
+    } else {
+        stream->append("time=", 5);
+        formatIsoTime(event.microSecondsSinceEpoch, stream);
+        stream->append(" level=", 7);
+        stream->append(level, levelLen);
+        *stream << " tid=" << event.tid << " src=";
+        stream->append(site.file().data_, site.file().size_);
+        *stream << ':' << site.line();
+        if (site.level() <= Logger::LogLevel::DEBUG) {
+            stream->append(" func=", 6);
+            appendString(site.func(), strlen(site.func()), false, stream);
+        }
+        stream->append(" msg=", 5);
+    }
+    appendString(message.buffer().data(),
+                 static_cast<size_t>(message.buffer().length()), json, stream);
+    formatFields(p, end, json, stream);
+    if (json) *stream << '}';
+    *stream << '\n';
+}
+
+uint32_t detail::eventSite(const char* record) {
+    return readAs<EventHeader>(record + sizeof(RecordHeader)).site;
+}
+
+void detail::encodeSite(const LogSite& site, string* out) {
+    size_t begin = out->size();
+    RecordHeader header = {0, RecordKind::kSite, 0};
+    out->append(reinterpret_cast<const char*>(&header), sizeof header);
+    SiteHeader siteHeader;
+    siteHeader.site = site.id();
+    siteHeader.line = site.line();
+    siteHeader.level = static_cast<int32_t>(site.level());
+    out->append(reinterpret_cast<const char*>(&siteHeader), sizeof siteHeader);
+    appendSiteString(site.file().data_,
+                     static_cast<size_t>(site.file().size_), out);
+    appendSiteString(site.func(), strlen(site.func()), out);
+    appendSiteString(site.format(), strlen(site.format()), out);
+
+    header.length = static_cast<uint32_t>(out->size() - begin);
+    ::memcpy(&(*out)[begin], &header, sizeof header);
+}
+
+bool detail::decodeSite(const char* record, size_t len, SiteRecord* site) {
+    const char* p = record + sizeof(RecordHeader);
+    const char* end = record + len;
+    if (static_cast<size_t>(end - p) < sizeof(SiteHeader)) return false;
+    SiteHeader siteHeader = readAs<SiteHeader>(p);
+    p += sizeof siteHeader;
+    if (siteHeader.level < 0 ||
+        siteHeader.level >=
+            static_cast<int32_t>(Logger::LogLevel::NUM_LOG_LEVELS)) {
+        return false;
+    }
+    site->id = siteHeader.site;
+    site->line = siteHeader.line;
+    site->level = static_cast<Logger::LogLevel>(siteHeader.level);
+    p = readString(p, end, &site->file);
+    if (p) p = readString(p, end, &site->func);
+    if (p) p = readString(p, end, &site->format);
+    return p != nullptr;
+}
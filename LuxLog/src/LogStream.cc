@@ -6,10 +6,10 @@
  */
 
 #include <LuxLog/LogStream.h>
+#include <LuxUtils/Format.h>
 #include <inttypes.h>  // PRId64
 
-#include <algorithm>  // reverse
-#include <limits>     // numeric_limits
+#include <limits>  // numeric_limits
 
 #ifndef __STDC_FORMAT_MACROS
 #define __STDC_FORMAT_MACROS
@@ -18,60 +18,10 @@
 using namespace Lux;
 using namespace Lux::detail;
 
-// NOTE: better itoa.
-#if defined(__clang__)
-#pragma clang diagnostic ignored "-Wtautological-compare"
-#else
-#pragma GCC diagnostic ignored "-Wtype-limits"
-#endif
-
 namespace Lux {
 namespace detail {
-const char digits[] = "9876543210123456789";
-const char* zero = digits + 9;
-static_assert(sizeof(digits) == 20, "wrong number of digits");
-
-const char digitsHex[] = "0123456789ABCDEF";
-static_assert(sizeof digitsHex == 17, "wrong number of digitsHex");
-
-/// @brief Efficient Integer to String Conversions, by Matthew Wilson.
-template <typename T>
-size_t convert(char buf[], T value) {
-    T i = value;
-    char* p = buf;
-
-    do {
-        int lsd = static_cast<int>(i % 10);
-        i /= 10;
-        *p++ = zero[lsd];
-    } while (i != 0);
-
-    if (value < 0) {
-        *p++ = '-';
-    }
-    *p = '\0';
-    std::reverse(buf, p);
-
-    return static_cast<size_t>(p - buf);
-}
-
-size_t convertHex(char buf[], uintptr_t value) {
-    uintptr_t i = value;
-    char* p = buf;
-
-    do {
-        int lsd = static_cast<int>(i % 16);
-        i /= 16;
-        *p++ = digitsHex[lsd];
-    } while (i != 0);
-
-    *p = '\0';
-    std::reverse(buf, p);
-
-    return static_cast<size_t>(p - buf);
-}
-
 template class FixedBuffer<kSmallBuffer>;
+template class FixedBuffer<kMediumBuffer>;
 template class FixedBuffer<kLargeBuffer>;
 }  // namespace detail
 
@@ -210,12 +160,15 @@ void LogStream::staticCheck() {
     static_assert(
         kMaxNumericSize - 10 > std::numeric_limits<long long>::digits10,
         "kMaxNumericSize is large enough");
+    static_assert(kMaxNumericSize >= format::kMaxDoubleSize &&
+                      kMaxNumericSize >= format::kMaxIntegerSize,
+                  "kMaxNumericSize is large enough");
 }
 
 template <typename T>
 void LogStream::formatInteger(T v) {
     if (buffer_.avail() >= kMaxNumericSize) {
-        size_t len = convert(buffer_.current(), v);
+        size_t len = format::formatDecimal(buffer_.current(), v);
         buffer_.add(len);
     }
 }
@@ -266,17 +219,23 @@ LogStream& LogStream::operator<<(const void* p) {
         char* buf = buffer_.current();
         buf[0] = '0';
         buf[1] = 'x';
-        size_t len = convertHex(buf + 2, v);
+        size_t len = format::formatHex(buf + 2, v);
         buffer_.add(len + 2);
     }
     return *this;
 }
 
-// FIXME: replace this with Grisu3 by Florian Loitsch.
+/// 最短的可以原样读回的形式，不经过 snprintf
+LogStream& LogStream::operator<<(float v) {
+    if (buffer_.avail() >= kMaxNumericSize) {
+        buffer_.add(format::formatDouble(buffer_.current(), v));
+    }
+    return *this;
+}
+
 LogStream& LogStream::operator<<(double v) {
     if (buffer_.avail() >= kMaxNumericSize) {
-        int len = ::snprintf(buffer_.current(), kMaxNumericSize, "%.12g", v);
-        buffer_.add(static_cast<size_t>(len));
+        buffer_.add(format::formatDouble(buffer_.current(), v));
     }
     return *this;
 }
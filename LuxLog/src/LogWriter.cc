@@ -0,0 +1,350 @@
+/**
+ * @file LogWriter.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/LogWriter.h>
+
+#include <fcntl.h>
+#include <limits.h>  // IOV_MAX
+#include <sys/stat.h>
+#include <sys/uio.h>  // pwritev
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Lux;
+
+const size_t LogWriter::kAlignment;
+
+struct LogWriter::FileState {
+    FileState(const FileState&) = delete;
+    FileState& operator=(FileState&) = delete;
+
+    FileState(string name, int fd, int bufferedFd, off_t syncBytes)
+        : name(std::move(name)),
+          fd(fd),
+          bufferedFd(bufferedFd),
+          syncBytes(syncBytes),
+          unsynced(0) {}
+
+    ~FileState() {
+        if (syncBytes > 0 && unsynced > 0) ::fdatasync(bufferedFd);
+        if (fd != bufferedFd) ::close(fd);
+        ::close(bufferedFd);
+        if (closeCallback) closeCallback();
+    }
+
+    const string name;
+    /// O_DIRECT if directIO, else the same as bufferedFd
+    const int fd;
+    const int bufferedFd;
+    const off_t syncBytes;
+    /// only accessed by the writer thread, or after it is done
+    off_t unsynced;
+    /// set before the File is destroyed
+    std::function<void()> closeCallback;
+};
+
+namespace {
+LogWriter::Options normalize(LogWriter::Options options) {
+    options.blockSize = std::max(options.blockSize, LogWriter::kAlignment);
+    options.blockSize = (options.blockSize + LogWriter::kAlignment - 1) /
+                        LogWriter::kAlignment * LogWriter::kAlignment;
+    options.maxBlocks = std::max(options.maxBlocks, 4);
+    return options;
+}
+
+/// @brief pwritev until all is written.
+/// @return 0, or errno
+int writeFully(int fd, struct iovec* iov, int iovcnt, off_t offset) {
+    while (iovcnt > 0) {
+        ssize_t n = ::pwritev(fd, iov, iovcnt, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        offset += n;
+        size_t written = static_cast<size_t>(n);
+        while (iovcnt > 0 && written >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+    return 0;
+}
+}  // namespace
+
+void LogWriter::FreeDeleter::operator()(char* p) const { ::free(p); }
+
+LogWriter::LogWriter(const Options& options)
+    : options_(normalize(options)),
+      running_(true),
+      thread_(std::bind(&LogWriter::threadFunc, this), "LogWriter"),
+      mutex_(),
+      notEmpty_(mutex_),
+      notFull_(mutex_),
+      numBlocks_(0),
+      writtenBytes_(0),
+      stalls_(0) {
+    thread_.start();
+}
+
+LogWriter::~LogWriter() {
+    running_ = false;
+    {
+        MutexLockGuard lock(mutex_);
+        notEmpty_.notify();
+    }
+    thread_.join();
+}
+
+std::unique_ptr<LogWriter::File> LogWriter::open(StringArg filename) {
+    // not O_APPEND, which ignores the offset of pwritev
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        fprintf(stderr, "LogWriter::open() %s failed %s\n", filename.c_str(),
+                strerror(errno));
+        return std::unique_ptr<File>();
+    }
+
+    struct stat st;
+    off_t offset = ::fstat(fd, &st) == 0 ? st.st_size : 0;
+
+    int directFd = -1;
+    // direct writes must start at an aligned offset
+    if (options_.directIO && offset % kAlignment == 0) {
+        directFd = ::open(filename.c_str(), O_WRONLY | O_CLOEXEC | O_DIRECT);
+        if (directFd < 0) {
+            fprintf(stderr, "LogWriter::open() O_DIRECT %s failed %s\n",
+                    filename.c_str(), strerror(errno));
+        }
+    }
+
+    bool direct = directFd >= 0;
+    std::shared_ptr<FileState> state(new FileState(
+        filename.c_str(), direct ? directFd : fd, fd, options_.syncBytes));
+    return std::unique_ptr<File>(
+        new File(this, std::move(state), direct, offset));
+}
+
+LogWriter::BlockPtr LogWriter::acquireBlock() {
+    MutexLockGuard lock(mutex_);
+    if (freeBlocks_.empty() && numBlocks_ >= options_.maxBlocks) {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        do {
+            notFull_.wait();
+        } while (freeBlocks_.empty());
+    }
+    if (!freeBlocks_.empty()) {
+        BlockPtr block = std::move(freeBlocks_.back());
+        freeBlocks_.pop_back();
+        return block;
+    }
+
+    void* p = nullptr;
+    if (::posix_memalign(&p, kAlignment, options_.blockSize) != 0) {
+        fprintf(stderr, "LogWriter::acquireBlock() out of memory\n");
+        abort();
+    }
+    ++numBlocks_;
+    return BlockPtr(static_cast<char*>(p));
+}
+
+void LogWriter::releaseBlock(BlockPtr block) {
+    MutexLockGuard lock(mutex_);
+    freeBlocks_.push_back(std::move(block));
+    notFull_.notify();
+}
+
+void LogWriter::submit(Task task) {
+    MutexLockGuard lock(mutex_);
+    queue_.push_back(std::move(task));
+    notEmpty_.notify();
+}
+
+void LogWriter::writeTasks(std::vector<Task>& tasks, size_t first,
+                           size_t last) {
+    FileState& file = *tasks[first].file;
+    off_t offset = tasks[first].offset;
+    size_t len = 0;
+    int fd = file.bufferedFd;
+    int err = 0;
+
+    if (tasks[first].block) {
+        struct iovec iov[IOV_MAX];
+        int iovcnt = 0;
+        for (size_t i = first; i < last; ++i) {
+            iov[iovcnt].iov_base = tasks[i].block.get();
+            iov[iovcnt].iov_len = tasks[i].len;
+            ++iovcnt;
+            len += tasks[i].len;
+        }
+        fd = file.fd;
+        err = writeFully(fd, iov, iovcnt, offset);
+        // e.g. a file system accepting O_DIRECT only on open()
+        if (err == EINVAL && fd != file.bufferedFd) {
+            fd = file.bufferedFd;
+            iovcnt = 0;
+            for (size_t i = first; i < last; ++i) {
+                iov[iovcnt].iov_base = tasks[i].block.get();
+                iov[iovcnt].iov_len = tasks[i].len;
+                ++iovcnt;
+            }
+            err = writeFully(fd, iov, iovcnt, offset);
+        }
+    } else {
+        assert(last == first + 1);
+        struct iovec iov;
+        iov.iov_base = &tasks[first].tail[0];
+        iov.iov_len = tasks[first].len;
+        len = tasks[first].len;
+        err = writeFully(fd, &iov, 1, offset);
+    }
+
+    if (err != 0) {
+        fprintf(stderr, "LogWriter::writeTasks() %s failed %s\n",
+                file.name.c_str(), strerror(err));
+        return;
+    }
+    writtenBytes_.fetch_add(static_cast<int64_t>(len),
+                            std::memory_order_relaxed);
+    file.unsynced += static_cast<off_t>(len);
+}
+
+void LogWriter::threadFunc() {
+    std::vector<Task> tasks;
+    while (true) {
+        {
+            MutexLockGuard lock(mutex_);
+            while (queue_.empty() && running_) {
+                notEmpty_.wait();
+            }
+            if (queue_.empty()) break;
+            for (Task& task : queue_) tasks.push_back(std::move(task));
+            queue_.clear();
+        }
+
+        // the blocks following each other in a file are written at once
+        size_t first = 0;
+        while (first < tasks.size()) {
+            size_t last = first + 1;
+            if (tasks[first].block) {
+                while (last < tasks.size() && last - first < IOV_MAX &&
+                       tasks[last].file == tasks[first].file &&
+                       tasks[last].block &&
+                       tasks[last].offset == tasks[last - 1].offset +
+                                                 static_cast<off_t>(
+                                                     tasks[last - 1].len)) {
+                    ++last;
+                }
+            }
+            writeTasks(tasks, first, last);
+
+            // fdatasync once per batch
+            FileState& file = *tasks[first].file;
+            if (file.syncBytes > 0 && file.unsynced >= file.syncBytes) {
+                ::fdatasync(file.bufferedFd);
+                file.unsynced = 0;
+            }
+            first = last;
+        }
+
+        for (Task& task : tasks) {
+            if (task.block) releaseBlock(std::move(task.block));
+        }
+        // the last reference of a closed file closes it
+        tasks.clear();
+    }
+}
+
+LogWriter::File::File(LogWriter* writer, std::shared_ptr<FileState> state,
+                      bool direct, off_t offset)
+    : writer_(writer),
+      state_(std::move(state)),
+      direct_(direct),
+      len_(0),
+      flushed_(0),
+      offset_(offset),
+      writtenBytes_(0) {}
+
+LogWriter::File::~File() {
+    flush();
+    if (block_) writer_->releaseBlock(std::move(block_));
+}
+
+void LogWriter::File::setCloseCallback(std::function<void()> cb) {
+    state_->closeCallback = std::move(cb);
+}
+
+void LogWriter::File::append(const char* logline, size_t len) {
+    const size_t blockSize = writer_->options_.blockSize;
+    writtenBytes_ += static_cast<off_t>(len);
+    while (len > 0) {
+        if (!block_) block_ = writer_->acquireBlock();
+        size_t n = std::min(len, blockSize - len_);
+        ::memcpy(block_.get() + len_, logline, n);
+        len_ += n;
+        logline += n;
+        len -= n;
+        if (len_ == blockSize) submitBlock();
+    }
+}
+
+void LogWriter::File::submitBlock() {
+    Task task;
+    task.file = state_;
+    task.block = std::move(block_);
+    task.offset = offset_;
+    task.len = len_;
+    writer_->submit(std::move(task));
+    offset_ += static_cast<off_t>(len_);
+    len_ = 0;
+    flushed_ = 0;
+}
+
+void LogWriter::File::flush() {
+    if (!block_ || len_ == flushed_) return;
+    if (!direct_) {
+        submitBlock();
+        return;
+    }
+
+    // the aligned part is written directly, the tail is copied to the next
+    // block and written again with it
+    size_t aligned = len_ / kAlignment * kAlignment;
+    if (aligned > 0) {
+        BlockPtr next = writer_->acquireBlock();
+        size_t tail = len_ - aligned;
+        size_t flushedTail = flushed_ > aligned ? flushed_ - aligned : 0;
+        ::memcpy(next.get(), block_.get() + aligned, tail);
+        len_ = aligned;
+        submitBlock();
+        block_ = std::move(next);
+        len_ = tail;
+        flushed_ = flushedTail;
+    }
+
+    // through the page cache, the length is not aligned
+    if (len_ > flushed_) {
+        Task task;
+        task.file = state_;
+        task.tail.assign(block_.get() + flushed_, len_ - flushed_);
+        task.offset = offset_ + static_cast<off_t>(flushed_);
+        task.len = len_ - flushed_;
+        writer_->submit(std::move(task));
+        flushed_ = len_;
+    }
+}
@@ -7,10 +7,14 @@
 
 #include <LuxLog/Logger.h>
 #include <LuxUtils/CurrentThread.h>  // tid
+#include <LuxUtils/Format.h>
+#include <LuxUtils/Mutex.h>
 #include <LuxUtils/Timestamp.h>
 
 #include <cstring>
 #include <ctime>  // gmtime_r tm
+#include <map>
+#include <memory>
 
 namespace Lux {
 /*
@@ -31,7 +35,10 @@ public:
 
 __thread char t_errnobuf[512];
 __thread char t_time[64];
-__thread time_t t_lastSecond;
+__thread time_t t_lastSecond = -1;
+/// 本地时区相对 UTC 的偏移，在 t_utcOffsetUntil 之前有效
+__thread int t_utcOffset;
+__thread time_t t_utcOffsetUntil;
 
 const char* strerror_tl(int savedErrno) {
     return ::strerror_r(savedErrno, t_errnobuf, sizeof(t_errnobuf));
@@ -49,6 +56,10 @@ Logger::LogLevel initLogLevel() {
 /* NOTE Global logger level is set */
 Logger::LogLevel g_logLevel = initLogLevel();
 
+Logger::Clock g_clock = Logger::Clock::kPrecise;
+Logger::TimeZone g_timeZone = Logger::TimeZone::kUTC;
+bool g_microseconds = false;
+
 const char* LogLevelName[static_cast<unsigned int>(
     Logger::LogLevel::NUM_LOG_LEVELS)] = {
     "TRACE ", "DEBUG ", "INFO  ", "WARN  ", "ERROR ", "FATAL ",
@@ -79,6 +90,88 @@ inline LogStream& operator<<(LogStream& s, const Logger::SourceFile& v) {
     return s;
 }
 
+namespace {
+/// 时区的偏移只在整 15 分钟变化
+const int kUtcOffsetPeriod = 15 * 60;
+
+inline void put2Digits(char* p, int v) {
+    Lux::format::write2Digits(p, static_cast<unsigned>(v));
+}
+
+/// @brief 1970-01-01 以来的天数转换为年月日，不需要 gmtime_r
+/// http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+void civilFromDays(int64_t days, int* year, int* month, int* day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    *day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    *month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    *year = static_cast<int>(yoe + era * 400 + (*month <= 2));
+}
+
+int utcOffset(time_t seconds) {
+    if (seconds >= t_utcOffsetUntil ||
+        seconds < t_utcOffsetUntil - kUtcOffsetPeriod) {
+        struct tm tm_time {};
+        ::localtime_r(&seconds, &tm_time);
+        t_utcOffset = static_cast<int>(tm_time.tm_gmtoff);
+        t_utcOffsetUntil =
+            seconds / kUtcOffsetPeriod * kUtcOffsetPeriod + kUtcOffsetPeriod;
+    }
+    return t_utcOffset;
+}
+}  // namespace
+
+/**
+ * @brief Put "YYYY/MM/DD hh:mm:ss[.uuuuuu] " into stream, 按线程缓存到秒，
+ * 由 LogRecord.cc 共用
+ */
+void formatLogTime(int64_t microSecondsSinceEpoch, LogStream& stream) {
+    time_t seconds = static_cast<time_t>(microSecondsSinceEpoch /
+                                         Timestamp::kMicroSecondsPerSecond);
+    int micros = static_cast<int>(microSecondsSinceEpoch %
+                                  Timestamp::kMicroSecondsPerSecond);
+    if (g_timeZone == Logger::TimeZone::kLocal) seconds += utcOffset(seconds);
+
+    if (seconds != t_lastSecond) {
+        t_lastSecond = seconds;
+        int year, month, day;
+        civilFromDays(seconds / 86400, &year, &month, &day);
+        int secondOfDay = static_cast<int>(seconds % 86400);
+        put2Digits(t_time, year / 100);
+        put2Digits(t_time + 2, year % 100);
+        t_time[4] = '/';
+        put2Digits(t_time + 5, month);
+        t_time[7] = '/';
+        put2Digits(t_time + 8, day);
+        t_time[10] = ' ';
+        put2Digits(t_time + 11, secondOfDay / 3600);
+        t_time[13] = ':';
+        put2Digits(t_time + 14, secondOfDay / 60 % 60);
+        t_time[16] = ':';
+        put2Digits(t_time + 17, secondOfDay % 60);
+    }
+
+    if (g_microseconds) {
+        char buf[28];
+        ::memcpy(buf, t_time, 19);
+        buf[19] = '.';
+        put2Digits(buf + 20, micros / 10000);
+        put2Digits(buf + 22, micros / 100 % 100);
+        put2Digits(buf + 24, micros % 100);
+        buf[26] = ' ';
+        stream.append(buf, 27);
+    } else {
+        char buf[20];
+        ::memcpy(buf, t_time, 19);
+        buf[19] = ' ';
+        stream.append(buf, 20);
+    }
+}
+
 /**
  * @brief Default output Func.
  *  It push `msg` to `stdout`.
@@ -98,9 +191,83 @@ void defaultOutput(const char* msg, int len) {
 
 void defaultFlush() { fflush(stdout); }
 
+namespace {
+/// @brief 所有日志模块，从不销毁，日志可能在静态对象析构时调用
+class LogModules {
+    LogModules(const LogModules&) = delete;
+    LogModules& operator=(LogModules&) = delete;
+
+    MutexLock mutex_;
+    std::map<string, std::unique_ptr<LogModule>> modules_ GUARDED_BY(mutex_);
+
+    /// Lux_LOG_MODULES=polaris:DEBUG,http:WARN
+    void initFromEnv() {
+        const char* env = ::getenv("Lux_LOG_MODULES");
+        if (!env) return;
+        string spec(env);
+        size_t begin = 0;
+        while (begin < spec.size()) {
+            size_t end = spec.find(',', begin);
+            if (end == string::npos) end = spec.size();
+            string item = spec.substr(begin, end - begin);
+            begin = end + 1;
+            if (item.empty()) continue;  // "a:INFO,"
+            size_t colon = item.find(':');
+            int level = colon == string::npos || colon == 0
+                            ? -1
+                            : parseLevel(item.substr(colon + 1));
+            if (level < 0) {
+                fprintf(stderr, "Lux_LOG_MODULES: bad module level '%s'\n",
+                        item.c_str());
+            } else {
+                find(item.substr(0, colon))
+                    .setLevel(static_cast<Logger::LogLevel>(level));
+            }
+        }
+    }
+
+    static int parseLevel(const string& name) {
+        for (int i = 0; i < static_cast<int>(Logger::LogLevel::NUM_LOG_LEVELS);
+             ++i) {
+            // "INFO  " -> "INFO"
+            string levelName(LogLevelName[i]);
+            levelName.erase(levelName.find(' '));
+            if (name == levelName) return i;
+        }
+        return -1;
+    }
+
+    LogModule& find(const string& name) REQUIRES(mutex_) {
+        std::unique_ptr<LogModule>& module = modules_[name];
+        if (!module) module.reset(new LogModule(name));
+        return *module;
+    }
+
+public:
+    LogModules() {
+        MutexLockGuard lock(mutex_);
+        initFromEnv();
+    }
+
+    LogModule& get(const string& name) {
+        MutexLockGuard lock(mutex_);
+        return find(name);
+    }
+
+    static LogModules& instance() {
+        static LogModules* modules = new LogModules;
+        return *modules;
+    }
+};
+}  // namespace
+
 /* NOTE Global Outuput/Flush Function */
 Logger::OutputFunc g_output = defaultOutput;
+/// 设置后代替 g_output
+Logger::LevelOutputFunc g_levelOutput = nullptr;
 Logger::FlushFunc g_flush = defaultFlush;
+Logger::RecordOutputFunc g_recordOutput = nullptr;
+Logger::RecordStyle g_recordStyle = Logger::RecordStyle::kText;
 
 }  // namespace Lux
 
@@ -108,7 +275,7 @@ using namespace Lux;
 
 Logger::Impl::Impl(LogLevel level, int savedErrno, const SourceFile& file,
                    int line)
-    : time_(Timestamp::now()),
+    : time_(Logger::now()),
       stream_(),
       level_(level),
       line_(line),
@@ -132,21 +299,7 @@ Logger::Impl::Impl(LogLevel level, int savedErrno, const SourceFile& file,
 
 /// @brief Put "YYYY/MM/DD hh:mm:ss " into stream
 void Logger::Impl::formatTime() {
-    int64_t secondsSinceEpoch = time_.secondsSinceEpoch();
-    if (secondsSinceEpoch != t_lastSecond) {
-        t_lastSecond = secondsSinceEpoch;
-        struct tm tm_time {};
-        ::gmtime_r(&secondsSinceEpoch, &tm_time);
-
-        int len = snprintf(
-            t_time, sizeof(t_time), "%4d/%02d/%02d %02d:%02d:%02d",
-            tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
-            tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
-        assert(len == 19);
-        (void)len;
-    }
-    stream_ << T(t_time, 19);
-    stream_ << T(" ", 1);
+    formatLogTime(time_.microSecondsSinceEpoch(), stream_);
 }
 
 /**
@@ -182,7 +335,11 @@ Logger::Logger(SourceFile file, int line, bool toAbort)
 Logger::~Logger() {
     impl_.finish();
     const LogStream::Buffer& buf(stream().buffer());
-    g_output(buf.data(), buf.length());
+    if (g_levelOutput) {
+        g_levelOutput(buf.data(), buf.length(), impl_.level_);
+    } else {
+        g_output(buf.data(), buf.length());
+    }
     if (impl_.level_ == LogLevel::FATAL) {
         g_flush();
         abort();
@@ -191,6 +348,62 @@ Logger::~Logger() {
 
 void Logger::setLogLevel(Logger::LogLevel level) { g_logLevel = level; }
 
-void Logger::setOutput(OutputFunc out) { g_output = out; }
+Timestamp Logger::now() {
+    if (g_clock == Clock::kCoarse) {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return Timestamp(static_cast<int64_t>(ts.tv_sec) *
+                             Timestamp::kMicroSecondsPerSecond +
+                         ts.tv_nsec / 1000);
+    }
+    return Timestamp::now();
+}
+
+void Logger::setClock(Clock clock) { g_clock = clock; }
+
+void Logger::setTimeZone(TimeZone zone) { g_timeZone = zone; }
+
+void Logger::setMicroseconds(bool on) { g_microseconds = on; }
+
+int64_t detail::LogEveryMs::sample(int64_t ms) {
+    /// 粗粒度时钟足够，读取开销更小
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    int64_t now = static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+
+    int64_t next = next_.load(std::memory_order_relaxed);
+    if (now < next ||
+        !next_.compare_exchange_strong(next, now + ms,
+                                       std::memory_order_relaxed)) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    return skipped_.exchange(0, std::memory_order_relaxed);
+}
+
+LogModule& LogModule::get(const string& name) {
+    return LogModules::instance().get(name);
+}
+
+void LogModule::setLevel(const string& name, Logger::LogLevel level) {
+    get(name).setLevel(level);
+}
+
+void LogModule::resetLevel(const string& name) {
+    get(name).level_.store(-1, std::memory_order_relaxed);
+}
+
+void Logger::setOutput(OutputFunc out) {
+    g_output = out;
+    g_levelOutput = nullptr;
+}
+
+void Logger::setOutput(LevelOutputFunc out) { g_levelOutput = out; }
 
 void Logger::setFlush(FlushFunc flush) { g_flush = flush; }
+
+void Logger::setRecordOutput(RecordOutputFunc out) { g_recordOutput = out; }
+
+Logger::RecordStyle Logger::recordStyle() { return g_recordStyle; }
+
+void Logger::setRecordStyle(RecordStyle style) { g_recordStyle = style; }
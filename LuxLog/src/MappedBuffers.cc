@@ -0,0 +1,126 @@
+/**
+ * @file MappedBuffers.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/MappedBuffers.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+using namespace Lux;
+
+const char MappedBuffers::kMagic[8] = {'L', 'U', 'X', 'B', 'U', 'F', 'S', '\0'};
+const uint32_t MappedBuffers::kVersion;
+const size_t MappedBuffers::kHeaderSize;
+const size_t MappedBuffers::kSlotHeaderSize;
+const size_t MappedBuffers::kSiteAreaSize;
+
+static_assert(sizeof(MappedBuffers::FileHeader) <= MappedBuffers::kHeaderSize,
+              "FileHeader is too large");
+static_assert(sizeof(MappedBuffers::Slot) <= MappedBuffers::kSlotHeaderSize,
+              "Slot is too large");
+static_assert(sizeof(MappedBuffers::SiteArea) <=
+                  MappedBuffers::kSlotHeaderSize,
+              "SiteArea is too large");
+
+MappedBuffers::MappedBuffers(const string& filename, int numSlots,
+                             size_t bufferSize, bool framed)
+    : filename_(filename),
+      slotSize_((kSlotHeaderSize + bufferSize + kHeaderSize - 1) /
+                kHeaderSize * kHeaderSize),
+      numSlots_(numSlots > 0 ? static_cast<size_t>(numSlots) : 0),
+      base_(nullptr),
+      mappedSize_(kHeaderSize + numSlots_ * slotSize_ +
+                  (framed ? kSiteAreaSize : 0)),
+      siteArea_(nullptr),
+      siteAreaSize_(0) {
+    int fd = ::open(filename_.c_str(),
+                    O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    // a sparse file, only the pages touched by the buffers are allocated
+    if (fd < 0 ||
+        ::ftruncate(fd, static_cast<off_t>(mappedSize_)) != 0) {
+        fprintf(stderr, "MappedBuffers %s failed %s\n", filename_.c_str(),
+                strerror(errno));
+        if (fd >= 0) ::close(fd);
+        numSlots_ = 0;
+        return;
+    }
+    void* p = ::mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "MappedBuffers mmap %s failed %s\n",
+                filename_.c_str(), strerror(errno));
+        ::unlink(filename_.c_str());
+        numSlots_ = 0;
+        return;
+    }
+    base_ = static_cast<char*>(p);
+
+    FileHeader* header = reinterpret_cast<FileHeader*>(base_);
+    ::memcpy(header->magic, kMagic, sizeof kMagic);
+    header->version = kVersion;
+    header->framed = framed ? 1 : 0;
+    header->numSlots = numSlots_;
+    header->slotSize = slotSize_;
+    header->siteAreaOffset = 0;
+    header->siteAreaSize = 0;
+    if (framed) {
+        size_t offset = kHeaderSize + numSlots_ * slotSize_;
+        header->siteAreaOffset = offset;
+        header->siteAreaSize = kSiteAreaSize;
+        siteArea_ = new (base_ + offset) SiteArea;
+        siteArea_->length.store(0, std::memory_order_relaxed);
+        siteAreaSize_ = kSiteAreaSize - kSlotHeaderSize;
+    }
+
+    MutexLockGuard lock(mutex_);
+    freeSlots_.reserve(numSlots_);
+    for (size_t i = numSlots_; i > 0; --i) {
+        Slot* s = new (slot(i - 1)) Slot;
+        s->length.store(0, std::memory_order_relaxed);
+        s->firstTime = 0;
+        s->dataOffset = 0;
+        freeSlots_.push_back(s);
+    }
+}
+
+MappedBuffers::~MappedBuffers() {
+    if (!base_) return;
+    ::munmap(base_, mappedSize_);
+    ::unlink(filename_.c_str());
+}
+
+MappedBuffers::Slot* MappedBuffers::acquire() {
+    MutexLockGuard lock(mutex_);
+    if (freeSlots_.empty()) return nullptr;
+    Slot* s = freeSlots_.back();
+    freeSlots_.pop_back();
+    return s;
+}
+
+void MappedBuffers::release(Slot* slot) {
+    slot->length.store(0, std::memory_order_release);
+    MutexLockGuard lock(mutex_);
+    freeSlots_.push_back(slot);
+}
+
+bool MappedBuffers::appendSite(const char* record, size_t len) {
+    if (!siteArea_) return false;
+    MutexLockGuard lock(mutex_);
+    uint64_t length = siteArea_->length.load(std::memory_order_relaxed);
+    if (length + len > siteAreaSize_) return false;
+    char* data = reinterpret_cast<char*>(siteArea_) + kSlotHeaderSize;
+    ::memcpy(data + length, record, len);
+    siteArea_->length.store(length + len, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,151 @@
+#include <LuxLog/LogArchiver.h>
+#include <assert.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace Lux;
+
+const char kBasename[] = "archived";
+
+std::string logName(int i) {
+    char buf[64];
+    snprintf(buf, sizeof buf, "%s.20260101-%06d.host.1.log", kBasename, i);
+    return buf;
+}
+
+void writeFile(const std::string& name, const std::string& content) {
+    FILE* fp = ::fopen(name.c_str(), "w");
+    assert(fp != nullptr);
+    ::fwrite(content.data(), 1, content.size(), fp);
+    ::fclose(fp);
+}
+
+bool exists(const std::string& name) {
+    return ::access(name.c_str(), F_OK) == 0;
+}
+
+std::string gunzip(const std::string& name) {
+    gzFile in = ::gzopen(name.c_str(), "rb");
+    assert(in != nullptr);
+    std::string content;
+    char buf[4096];
+    int n;
+    while ((n = ::gzread(in, buf, sizeof buf)) > 0) content.append(buf, n);
+    ::gzclose(in);
+    return content;
+}
+
+/// names in the current directory, sorted
+std::vector<std::string> listDir() {
+    std::vector<std::string> names;
+    DIR* dir = ::opendir(".");
+    assert(dir != nullptr);
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..") names.push_back(name);
+    }
+    ::closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void removeAll() {
+    for (const std::string& name : listDir()) ::unlink(name.c_str());
+}
+
+std::string content(int i) {
+    std::string s;
+    for (int j = 0; j < 1000; ++j) {
+        s += logName(i) + " line " + std::to_string(j) + "\n";
+    }
+    return s;
+}
+
+void testRetention() {
+    for (int i = 0; i < 5; ++i) writeFile(logName(i), content(i));
+    writeFile(logName(1) + ".gz", "old");
+    writeFile("other.20260101-000000.host.1.log", "not ours");
+    writeFile(std::string(kBasename) + ".conf", "not a log");
+    {
+        LogArchiver archiver(kBasename, 3, 0);
+        archiver.setCurrent(logName(4));
+    }
+    // the two oldest and the .gz of one are removed at startup
+    assert(!exists(logName(0)));
+    assert(!exists(logName(1)));
+    assert(!exists(logName(1) + ".gz"));
+    assert(exists(logName(2)));
+    assert(exists(logName(3)));
+    assert(exists(logName(4)));
+    assert(exists("other.20260101-000000.host.1.log"));
+    assert(exists(std::string(kBasename) + ".conf"));
+    removeAll();
+
+    // the current file is never removed, even if it sorts first
+    for (int i = 0; i < 3; ++i) writeFile(logName(i), content(i));
+    {
+        LogArchiver archiver(kBasename, 1, 0);
+        archiver.setCurrent(logName(0));
+    }
+    assert(exists(logName(0)));
+    assert(!exists(logName(1)));
+    assert(exists(logName(2)));
+    removeAll();
+}
+
+void testCompression() {
+    writeFile(logName(0), content(0));
+    writeFile(logName(1), content(1));
+    writeFile(logName(2), content(2));
+    // a compression cut short by a crash, not compressed again here
+    writeFile(logName(2) + ".gz.tmp", "partial");
+    {
+        LogArchiver archiver(kBasename, 0, 6);
+        archiver.setCurrent(logName(2));
+        archiver.add(logName(0));
+        archiver.add(logName(1));
+        // the queued files are compressed before the destructor returns
+    }
+    assert(!exists(logName(2) + ".gz.tmp"));
+    for (int i = 0; i < 2; ++i) {
+        assert(!exists(logName(i)));
+        assert(gunzip(logName(i) + ".gz") == content(i));
+    }
+    assert(exists(logName(2)));
+    assert(!exists(logName(2) + ".gz"));
+
+    // compressed files count for retention
+    writeFile(logName(3), content(3));
+    {
+        LogArchiver archiver(kBasename, 2, 6);
+        archiver.setCurrent(logName(3));
+        archiver.add(logName(2));
+    }
+    assert(listDir() ==
+           std::vector<std::string>({logName(2) + ".gz", logName(3)}));
+    assert(gunzip(logName(2) + ".gz") == content(2));
+    removeAll();
+}
+
+int main() {
+    // LogArchiver works in the current directory, like LogFile; the tests
+    // remove every file there, so never run them anywhere else
+    char dir[] = "/tmp/LogArchiver_unit_XXXXXX";
+    if (::mkdtemp(dir) == nullptr || ::chdir(dir) != 0) {
+        perror(dir);
+        return 1;
+    }
+
+    testRetention();
+    testCompression();
+
+    if (::chdir("/") == 0) ::rmdir(dir);
+    printf("LogArchiver tests passed\n");
+}
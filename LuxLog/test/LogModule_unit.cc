@@ -0,0 +1,106 @@
+// the module of this file, see LogModule
+#define LUX_LOG_MODULE_NAME "unit"
+
+#include <LuxLog/Logger.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+
+using namespace Lux;
+
+typedef Logger::LogLevel Level;
+
+std::string g_text;
+
+void textOutput(const char* msg, int len) { g_text.append(msg, len); }
+
+/// Lux_LOG_MODULES is read when the first module is created
+void testEnv() {
+    assert(LogModule::get("polaris").level() == Level::DEBUG);
+    assert(LogModule::get("http").level() == Level::WARN);
+    assert(LogModule::get("tcp").level() == Level::TRACE);
+    // the last one of a module wins
+    assert(LogModule::get("redis").level() == Level::ERROR);
+    // bad items are skipped, the modules follow the global level
+    assert(LogModule::get("bad").level() == Logger::logLevel());
+    assert(LogModule::get("noLevel").level() == Logger::logLevel());
+    assert(LogModule::get("").level() == Logger::logLevel());
+    // level names are case sensitive, padding is not part of them
+    assert(LogModule::get("lower").level() == Logger::logLevel());
+    assert(LogModule::get("padded").level() == Logger::logLevel());
+}
+
+void testLevels() {
+    Logger::setLogLevel(Level::INFO);
+    LogModule& mysql = LogModule::get("mysql");
+    assert(&mysql == &LogModule::get("mysql"));
+    assert(mysql.name() == "mysql");
+    assert(mysql.level() == Level::INFO);
+
+    // unset modules follow the global level
+    Logger::setLogLevel(Level::WARN);
+    assert(mysql.level() == Level::WARN);
+
+    LogModule::setLevel("mysql", Level::DEBUG);
+    assert(mysql.level() == Level::DEBUG);
+    Logger::setLogLevel(Level::ERROR);
+    assert(mysql.level() == Level::DEBUG);
+    assert(LogModule::get("http").level() == Level::WARN);
+
+    LogModule::resetLevel("mysql");
+    assert(mysql.level() == Level::ERROR);
+
+    // set before the module is used
+    LogModule::setLevel("later", Level::TRACE);
+    assert(LogModule::get("later").level() == Level::TRACE);
+    Logger::setLogLevel(Level::INFO);
+}
+
+/// LOG_* of this file use the level of "unit"
+void testMacros() {
+    Logger::setOutput(textOutput);
+    Logger::setLogLevel(Level::INFO);
+
+    LOG_DEBUG << "hidden";
+    assert(g_text.empty());
+
+    LogModule::setLevel("unit", Level::DEBUG);
+    LOG_DEBUG << "shown";
+    assert(g_text.find("DEBUG") != std::string::npos);
+    assert(g_text.find("shown") != std::string::npos);
+    g_text.clear();
+
+    // TRACE compiled out still writes nothing
+    LogModule::setLevel("unit", Level::TRACE);
+    LOG_TRACE << "trace";
+    assert(g_text.empty() == (LUX_LOG_ACTIVE_LEVEL > 0));
+    g_text.clear();
+
+    // the global level does not change the module any more
+    LogModule::setLevel("unit", Level::WARN);
+    Logger::setLogLevel(Level::TRACE);
+    LOG_INFO << "hidden";
+    assert(g_text.empty());
+    LOG_WARN << "warn";
+    assert(g_text.find("warn") != std::string::npos);
+    g_text.clear();
+
+    LogModule::resetLevel("unit");
+    LOG_DEBUG << "shown";
+    assert(g_text.find("shown") != std::string::npos);
+    Logger::setLogLevel(Level::INFO);
+}
+
+int main() {
+    ::setenv("Lux_LOG_MODULES",
+             "polaris:DEBUG,http:WARN,tcp:TRACE,redis:INFO,redis:ERROR,"
+             "bad:LOUD,noLevel,:DEBUG,lower:debug,padded:INFO ,",
+             1);
+
+    testEnv();
+    testLevels();
+    testMacros();
+    printf("LogModule tests passed\n");
+}
@@ -0,0 +1,119 @@
+#include <LuxLog/LogRecord.h>
+#include <assert.h>
+
+#include <string>
+#include <vector>
+
+using namespace Lux;
+
+std::string g_text;
+std::vector<std::string> g_records;
+
+void textOutput(const char* msg, int len) { g_text.append(msg, len); }
+void recordOutput(const char* record, int len) {
+    g_records.emplace_back(record, len);
+}
+
+bool endsWith(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string format(const std::string& record) {
+    const LogSite* site = LogSite::find(detail::eventSite(record.data()));
+    assert(site);
+    LogStream stream;
+    detail::formatEvent(*site, record.data(), record.size(), &stream);
+    return stream.buffer().toString();
+}
+
+int main() {
+    Logger::setOutput(textOutput);
+
+    // formatted by the caller without a record output
+    std::string name("conn");
+    LOG_INFO_FMT("{} sent {} bytes, {} {}", name, 42, 2.5, 'x');
+    assert(endsWith(g_text, ">_< conn sent 42 bytes, 2.5 x\n"));
+    assert(g_text.find("INFO  LogRecord_unit.cc:") != std::string::npos);
+
+    // recorded, formatted later
+    Logger::setRecordOutput(recordOutput);
+    for (int i = 0; i < 2; ++i) {
+        LOG_WARN_FMT("{{}} {} {} {} {}", -1L, 18446744073709551615UL,
+                     static_cast<const char*>(nullptr), true);
+    }
+    assert(g_records.size() == 2);
+    assert(detail::eventSite(g_records[0].data()) ==
+           detail::eventSite(g_records[1].data()));
+    std::string line = format(g_records[0]);
+    assert(endsWith(line, ">_< {} -1 18446744073709551615 (null) 1\n"));
+    assert(line.find("WARN  ") != std::string::npos);
+
+    // missing arguments are left as they are
+    g_records.clear();
+    LOG_ERROR_FMT("{} and {}", 1);
+    assert(endsWith(format(g_records[0]), ">_< 1 and {}\n"));
+
+    // a long string is truncated to fit the record
+    g_records.clear();
+    LOG_ERROR_FMT("{}|{}", std::string(3000, 'a'), 1);
+    LOG_ERROR_FMT("{}|{}", std::string(10000, 'a'), 1);
+    assert(endsWith(format(g_records[0]), "a|1\n"));
+    assert(g_records[1].size() == static_cast<size_t>(detail::kSmallBuffer));
+    format(g_records[1]);
+
+    // site definitions for logDecoder
+    const LogSite* site = LogSite::find(detail::eventSite(g_records[0].data()));
+    std::string encoded;
+    detail::encodeSite(*site, &encoded);
+    detail::SiteRecord decoded;
+    assert(detail::decodeSite(encoded.data(), encoded.size(), &decoded));
+    assert(decoded.id == site->id());
+    assert(decoded.line == site->line());
+    assert(decoded.level == Logger::LogLevel::ERROR);
+    assert(decoded.file == "LogRecord_unit.cc");
+    assert(decoded.func == "main");
+    assert(decoded.format == "{}|{}");
+    assert(!detail::decodeSite(encoded.data(), encoded.size() - 1, &decoded));
+
+    // structured fields, typed in JSON
+    g_records.clear();
+    LOG_WARN_KV("request done", "conn", name, "status", 200, "latency",
+                0.25, "ok", true, "path", "/a b\"");
+    line = format(g_records[0]);
+    assert(endsWith(line, ">_< request done conn=conn status=200 "
+                          "latency=0.25 ok=true path=\"/a b\\\"\"\n"));
+
+    Logger::setRecordStyle(Logger::RecordStyle::kJson);
+    line = format(g_records[0]);
+    assert(line.compare(0, 9, "{\"time\":\"") == 0);
+    assert(line.find("Z\",\"level\":\"WARN\",\"tid\":") != std::string::npos);
+    assert(endsWith(line, "\"msg\":\"request done\",\"conn\":\"conn\","
+                          "\"status\":200,\"latency\":0.25,\"ok\":true,"
+                          "\"path\":\"/a b\\\"\"}\n"));
+
+    Logger::setRecordStyle(Logger::RecordStyle::kLogfmt);
+    line = format(g_records[0]);
+    assert(line.compare(0, 5, "time=") == 0);
+    assert(line.find(" level=WARN tid=") != std::string::npos);
+    assert(endsWith(line, " msg=\"request done\" conn=conn status=200 "
+                          "latency=0.25 ok=true path=\"/a b\\\"\"\n"));
+
+    // placeholders of the message do not use the fields
+    g_records.clear();
+    LOG_ERROR_FMT("{} of {}", 1);
+    LOG_WARN_KV("x{}y", "k", '\n');
+    assert(endsWith(format(g_records[0]), " msg=\"1 of {}\"\n"));
+    assert(endsWith(format(g_records[1]), " msg=x{}y k=\"\\n\"\n"));
+    Logger::setRecordStyle(Logger::RecordStyle::kJson);
+    assert(endsWith(format(g_records[1]),
+                    "\"msg\":\"x{}y\",\"k\":\"\\n\"}\n"));
+    Logger::setRecordStyle(Logger::RecordStyle::kText);
+
+    // below the log level, nothing is recorded
+    g_records.clear();
+    Logger::setLogLevel(Logger::LogLevel::INFO);
+    LOG_DEBUG_FMT("{}", 1);
+    LOG_DEBUG_KV("x", "k", 1);
+    assert(g_records.empty());
+}
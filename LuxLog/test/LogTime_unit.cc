@@ -0,0 +1,92 @@
+#include <LuxLog/Logger.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <random>
+#include <string>
+
+namespace Lux {
+// Logger.cc, shared with LogRecord.cc
+void formatLogTime(int64_t microSecondsSinceEpoch, LogStream& stream);
+}  // namespace Lux
+
+using namespace Lux;
+
+std::string logTime(int64_t microSecondsSinceEpoch) {
+    LogStream stream;
+    formatLogTime(microSecondsSinceEpoch, stream);
+    return stream.buffer().toString();
+}
+
+/// "YYYY/MM/DD hh:mm:ss " by strftime()
+std::string expected(time_t seconds, bool local) {
+    struct tm tm;
+    if (local) {
+        ::localtime_r(&seconds, &tm);
+    } else {
+        ::gmtime_r(&seconds, &tm);
+    }
+    char buf[32];
+    ::strftime(buf, sizeof buf, "%Y/%m/%d %H:%M:%S ", &tm);
+    return buf;
+}
+
+void check(time_t seconds, bool local) {
+    int64_t micros = static_cast<int64_t>(seconds) * 1000000;
+    assert(logTime(micros) == expected(seconds, local));
+}
+
+/// the last and the first second of each day, which covers the ends of
+/// months, years and February of leap years, 2000 and 2100 included
+void testUTC() {
+    Logger::setTimeZone(Logger::TimeZone::kUTC);
+    std::mt19937 random(1);
+    const int64_t kDays = 366LL * 131;  // to 2100
+    for (int64_t day = 1; day < kDays; ++day) {
+        time_t midnight = static_cast<time_t>(day * 86400);
+        check(midnight - 1, false);
+        check(midnight, false);
+        check(midnight + static_cast<time_t>(random() % 86400), false);
+    }
+    assert(logTime(951782400LL * 1000000) == "2000/02/29 00:00:00 ");
+    assert(logTime(4107542400LL * 1000000) == "2100/03/01 00:00:00 ");
+
+    // the cached second with another fraction
+    Logger::setMicroseconds(true);
+    assert(logTime(1000000) == "1970/01/01 00:00:01.000000 ");
+    assert(logTime(1000000 + 123456) == "1970/01/01 00:00:01.123456 ");
+    assert(logTime(1000000 + 999999) == "1970/01/01 00:00:01.999999 ");
+    assert(logTime(1709251199LL * 1000000 + 7) ==
+           "2024/02/29 23:59:59.000007 ");
+    Logger::setMicroseconds(false);
+}
+
+/// every hour and the second before it through two years, across the
+/// daylight saving time changes of TZ
+void testLocal(const char* tz) {
+    ::setenv("TZ", tz, 1);
+    ::tzset();
+    Logger::setTimeZone(Logger::TimeZone::kLocal);
+    const time_t kStart = 1704067200;  // 2024/01/01 UTC
+    for (time_t t = kStart; t < kStart + 2 * 366 * 86400; t += 3600) {
+        check(t - 1, true);
+        check(t, true);
+        check(t + 1800, true);
+    }
+    // the 15 minute offset cache, going back in time
+    for (time_t t = kStart + 366 * 86400; t > kStart; t -= 86400 + 900) {
+        check(t, true);
+    }
+    Logger::setTimeZone(Logger::TimeZone::kUTC);
+}
+
+int main() {
+    testUTC();
+    testLocal("EST5EDT,M3.2.0,M11.1.0");
+    // a half hour offset, daylight saving time in the southern summer
+    testLocal("ACST-9:30ACDT,M10.1.0,M4.1.0/3");
+    testLocal("UTC0");
+    printf("LogTime tests passed\n");
+}
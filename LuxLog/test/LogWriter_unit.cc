@@ -0,0 +1,86 @@
+#include <LuxLog/LogWriter.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <random>
+#include <string>
+
+using namespace Lux;
+
+std::string readFile(const std::string& path) {
+    std::string content;
+    FILE* fp = ::fopen(path.c_str(), "r");
+    assert(fp != nullptr);
+    char buf[65536];
+    size_t n;
+    while ((n = ::fread(buf, 1, sizeof buf, fp)) > 0) content.append(buf, n);
+    ::fclose(fp);
+    return content;
+}
+
+/// lines of random length, flushed now and then, the file has the same bytes
+void testWrite(const std::string& path, bool directIO) {
+    LogWriter::Options options;
+    options.blockSize = 64 * 1024;
+    options.maxBlocks = 4;
+    options.directIO = directIO;
+    options.syncBytes = 1024 * 1024;
+
+    std::string expected;
+    bool closed = false;
+    {
+        LogWriter writer(options);
+        std::unique_ptr<LogWriter::File> file = writer.open(path);
+        assert(file);
+        file->setCloseCallback([&closed] { closed = true; });
+
+        std::mt19937 random(directIO ? 1 : 2);
+        for (int i = 0; i < 20000; ++i) {
+            std::string line(random() % 500, static_cast<char>('a' + i % 26));
+            line += std::to_string(i) + "\n";
+            file->append(line.data(), line.size());
+            expected += line;
+            if (random() % 100 == 0) file->flush();
+        }
+        assert(file->writtenBytes() == static_cast<off_t>(expected.size()));
+        file.reset();
+        // ~LogWriter() writes what is queued
+    }
+    assert(closed);
+    assert(readFile(path) == expected);
+
+    // appended after the existing content, an unaligned offset is written
+    // through the page cache
+    {
+        LogWriter writer(options);
+        std::unique_ptr<LogWriter::File> file = writer.open(path);
+        assert(file);
+        std::string more(100000, 'z');
+        file->append(more.data(), more.size());
+        expected += more;
+    }
+    assert(readFile(path) == expected);
+}
+
+void testOpenFailure() {
+    LogWriter::Options options;
+    LogWriter writer(options);
+    assert(!writer.open("/nonexistent/LogWriter_unit.log"));
+}
+
+int main() {
+    char path[] = "/tmp/LogWriter_unit_XXXXXX";
+    int fd = ::mkstemp(path);
+    assert(fd >= 0);
+    ::close(fd);
+
+    testWrite(path, false);
+    ::unlink(path);
+    testWrite(path, true);
+    ::unlink(path);
+    testOpenFailure();
+
+    printf("LogWriter tests passed\n");
+}
@@ -9,7 +9,9 @@
 off_t kRollSize = 500 * 1000 * 1000;
 Lux::AsyncLogger* g_asyncLog = nullptr;
 
-void asyncOutput(const char* msg, int len) { g_asyncLog->append(msg, len); }
+void asyncOutput(const char* msg, int len, Lux::Logger::LogLevel level) {
+    g_asyncLog->append(msg, len, level);
+}
 
 void test() { LOG_TRACE << "Here is test"; }
 
@@ -8,10 +8,12 @@
 #pragma once
 
 #include <LuxUtils/Condition.h>
+#include <LuxUtils/Config.h>
 #include <LuxUtils/Mutex.h>
 #include <LuxUtils/Types.h>
 #include <mysql/mysql.h>
 
+#include <memory>
 #include <queue>
 
 #include "LuxLog/Logger.h"
@@ -22,6 +24,17 @@ class MySQLConnPool {
     MySQLConnPool(const MySQLConnPool&) = delete;
     MySQLConnPool& operator=(MySQLConnPool&) = delete;
 
+public:
+    /// 运行中可以修改的设置，见 setConfig()
+    struct Tunables {
+        /// 连接数上限，增大时按需建立新连接，减小时归还的连接被关闭
+        int capacity = 10;
+        /// 新连接的连接超时，秒，0 为 MySQL 的默认值
+        unsigned connectTimeout = 0;
+        /// 没有空闲连接时 getConnecton() 等待的秒数，0 不等待
+        double waitTimeout = 0.0;
+    };
+
 private:
     int capicity_;  // 数据库连接池的最大容量
     int curSize_;   // 数据库连接池当前连接数
@@ -43,6 +56,16 @@ private:
     // The flag of auto commit;
     // false - disEnable; true - enable
     bool autoCommit_;
+    string charset_;
+
+    int connecting_ GUARDED_BY(mutex_);  // 正在建立的连接数
+    Tunables tunables_ GUARDED_BY(mutex_);
+    std::unique_ptr<Config<Tunables>::Reader> config_ GUARDED_BY(mutex_);
+
+    /// 建立一个连接，失败时返回 nullptr
+    MYSQL* connect(unsigned connectTimeout);
+    /// 读取 config_ 中新的设置
+    void refreshTunables() REQUIRES(mutex_);
 
 public:
     MySQLConnPool(int capicity, const string& ipAddr, uint16_t port,
@@ -55,6 +78,10 @@ public:
               const string& user, const string& passwd, const string& db,
               bool autoCommit = false, const char* charsest = "utf8mb4");
 
+    /// 之后 publish() 的设置在下一次取出或归还连接时生效，无需重启，
+    /// config 的生命期要长于连接池
+    void setConfig(const Config<Tunables>& config);
+
     inline bool state() const { return state_; }
     void setChacter(MYSQL* mysql, const char* charset);
 
@@ -6,6 +6,7 @@
  */
 
 #include <LuxMySQL/MySQLConnPool.h>
+#include <LuxUtils/MonoTime.h>
 #include <mysql/mysql.h>
 
 #include <cstdint>
@@ -36,7 +37,10 @@ MySQLConnPool::MySQLConnPool(int capicity, const string& ipAddr, uint16_t port,
       user_(user),
       passwd_(passwd),
       db_(db),
-      autoCommit_(autoCommit) {}
+      autoCommit_(autoCommit),
+      connecting_(0) {
+    tunables_.capacity = capicity;
+}
 
 MySQLConnPool::MySQLConnPool()
     : capicity_(0),
@@ -44,7 +48,9 @@ MySQLConnPool::MySQLConnPool()
       leftSize_(0),
       mutex_(),
       cond_(mutex_),
-      state_(false) {
+      state_(false),
+      autoCommit_(false),
+      connecting_(0) {
     LOG_DEBUG << __func__;
 }
 
@@ -72,55 +78,15 @@ void MySQLConnPool::init(int capcity, const string& ipAddr, uint16_t port,
     passwd_ = passwd;
     db_ = db;
 
+    autoCommit_ = autoCommit;
+    charset_ = charset;
+
     for (int i = 0; i < capcity; ++i) {
-        MYSQL* mysql = nullptr;
-        mysql = mysql_init(mysql);
+        MYSQL* mysql = connect(0);
         if (nullptr == mysql) {
-            /**
-               1. MySQL 服务器未运行或无法连接：
-                    确保 MySQL 服务器正在运行，
-                    并且您的代码中指定的主机名、端口、用户名和密码正确。
-               2. MySQL C API 库未正确安装：
-                    请检查您的系统中是否正确安装了 MySQL C API库。
-                    如果没有，请安装正确的库文件。
-               3. 缺少必要的库文件：
-                    如果您使用的是动态链接库，则您的系统中必须存在所需的库文件。
-                    请确保您的系统中安装了所有必要的库文件，
-                    包括 MySQL C API 库和其依赖的库文件。
-               4. 内存分配错误：
-                    如果您的系统内存不足，或者您的代码中存在其他内存分配问题，
-                    则可能会导致 mysql_init 初始化失败。
-             */
-            LOG_ERROR << "return code: " << -1
-                      << "\nError message: Initialize MySQL failed.\n";
-
-            exit(1);
-        }
-
-        if (mysql_real_connect(mysql, ipAddr_.c_str(), user_.c_str(),
-                               passwd_.c_str(), db_.c_str(), port_, nullptr,
-                               0) != mysql) {
-            LOG_ERROR << "return code: " << mysql_errno(mysql)
-                      << "\nError message: " << mysql_error(mysql);
-
-            mysql_close(mysql);
-            exit(1);
-        }
-
-        // auto commit
-        autoCommit_ = autoCommit;
-        if (mysql_autocommit(mysql, autoCommit_) != false) {
-            LOG_ERROR << "return code: " << mysql_errno(mysql)
-                      << "\nError message: " << mysql_error(mysql);
-
-            mysql_close(mysql);
-            mysql = nullptr;
             exit(1);
         }
 
-        // set character for every connection
-        setChacter(mysql, charset);
-
         // push conn into que
         {
             MutexLockGuard lck(mutex_);
@@ -130,7 +96,94 @@ void MySQLConnPool::init(int capcity, const string& ipAddr, uint16_t port,
     }
 
     state_ = true;
+    MutexLockGuard lock(mutex_);
     capicity_ = leftSize_;
+    tunables_.capacity = capicity_;
+    // setConfig() 先于 init() 时，以配置为准
+    if (config_) {
+        tunables_ = config_->get();
+        capicity_ = tunables_.capacity;
+    }
+}
+
+/**
+ * @brief 建立一个连接，设置自动提交与字符集
+ *
+ * @param connectTimeout 秒，0 为 MySQL 的默认值
+ * @return MYSQL*，失败时为 nullptr
+ */
+MYSQL* MySQLConnPool::connect(unsigned connectTimeout) {
+    MYSQL* mysql = mysql_init(nullptr);
+    if (nullptr == mysql) {
+        /**
+           1. MySQL 服务器未运行或无法连接：
+                确保 MySQL 服务器正在运行，
+                并且您的代码中指定的主机名、端口、用户名和密码正确。
+           2. MySQL C API 库未正确安装：
+                请检查您的系统中是否正确安装了 MySQL C API库。
+                如果没有，请安装正确的库文件。
+           3. 缺少必要的库文件：
+                如果您使用的是动态链接库，则您的系统中必须存在所需的库文件。
+                请确保您的系统中安装了所有必要的库文件，
+                包括 MySQL C API 库和其依赖的库文件。
+           4. 内存分配错误：
+                如果您的系统内存不足，或者您的代码中存在其他内存分配问题，
+                则可能会导致 mysql_init 初始化失败。
+         */
+        LOG_ERROR << "return code: " << -1
+                  << "\nError message: Initialize MySQL failed.\n";
+        return nullptr;
+    }
+
+    if (connectTimeout > 0) {
+        mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connectTimeout);
+    }
+
+    if (mysql_real_connect(mysql, ipAddr_.c_str(), user_.c_str(),
+                           passwd_.c_str(), db_.c_str(), port_, nullptr,
+                           0) != mysql) {
+        LOG_ERROR << "return code: " << mysql_errno(mysql)
+                  << "\nError message: " << mysql_error(mysql);
+
+        mysql_close(mysql);
+        return nullptr;
+    }
+
+    // auto commit
+    if (mysql_autocommit(mysql, autoCommit_) != false) {
+        LOG_ERROR << "return code: " << mysql_errno(mysql)
+                  << "\nError message: " << mysql_error(mysql);
+
+        mysql_close(mysql);
+        return nullptr;
+    }
+
+    // set character for every connection
+    if (mysql_set_character_set(mysql, charset_.c_str()) != 0) {
+        LOG_ERROR << "Failed to set character: " << charset_
+                  << mysql_error(mysql);
+
+        mysql_close(mysql);
+        return nullptr;
+    }
+    return mysql;
+}
+
+void MySQLConnPool::setConfig(const Config<Tunables>& config) {
+    MutexLockGuard lock(mutex_);
+    config_.reset(new Config<Tunables>::Reader(config));
+    refreshTunables();
+}
+
+void MySQLConnPool::refreshTunables() {
+    // 无锁地比较版本号，只在 publish() 之后复制
+    if (config_ && config_->changed()) {
+        tunables_ = config_->get();
+        capicity_ = tunables_.capacity;
+        LOG_INFO << "MySQLConnPool capacity " << tunables_.capacity
+                 << ", connect timeout " << tunables_.connectTimeout
+                 << "s, wait timeout " << tunables_.waitTimeout << "s";
+    }
 }
 
 /**
@@ -141,20 +194,42 @@ void MySQLConnPool::init(int capcity, const string& ipAddr, uint16_t port,
  */
 MYSQL* MySQLConnPool::getConnecton() {
     MYSQL* conn = nullptr;
-    if (0 == pool_.size()) return nullptr;
+    unsigned connectTimeout = 0;
 
     {
         MutexLockGuard lock(mutex_);
-        while (pool_.empty()) {
-            cond_.wait();
-        }
+        refreshTunables();
+
+        // 容量增大后，没有空闲连接时建立新连接
+        if (pool_.empty() &&
+            curSize_ + leftSize_ + connecting_ < tunables_.capacity) {
+            ++connecting_;
+            connectTimeout = tunables_.connectTimeout;
+        } else {
+            if (pool_.empty() && tunables_.waitTimeout > 0) {
+                MonoTime deadline =
+                    addTime(MonoTime::now(), tunables_.waitTimeout);
+                MonoTime now;
+                while (pool_.empty() && (now = MonoTime::now()) < deadline) {
+                    cond_.waitForSeconds(timeDifference(deadline, now));
+                }
+            }
+            if (pool_.empty()) return nullptr;
 
-        conn = pool_.front();
-        pool_.pop();
-        --leftSize_;
-        ++curSize_;
+            conn = pool_.front();
+            pool_.pop();
+            --leftSize_;
+            ++curSize_;
+            return conn;
+        }
     }
 
+    // 连接需要若干次往返，不持有锁
+    conn = connect(connectTimeout);
+
+    MutexLockGuard lock(mutex_);
+    --connecting_;
+    if (conn != nullptr) ++curSize_;
     return conn;
 }
 
@@ -167,14 +242,24 @@ MYSQL* MySQLConnPool::getConnecton() {
 bool MySQLConnPool::releaseConnection(MYSQL* conn) {
     if (nullptr == conn) return false;
 
+    bool overCapacity = false;
     {
         MutexLockGuard lock(mutex_);
-        pool_.push(conn);
-        ++leftSize_;
+        refreshTunables();
         --curSize_;
+        // 容量减小后，多出的连接在归还时关闭
+        overCapacity = curSize_ + leftSize_ + connecting_ >= tunables_.capacity;
+        if (!overCapacity) {
+            pool_.push(conn);
+            ++leftSize_;
+        }
     }
 
-    cond_.notify();
+    if (overCapacity) {
+        mysql_close(conn);
+    } else {
+        cond_.notify();
+    }
     return true;
 }
 
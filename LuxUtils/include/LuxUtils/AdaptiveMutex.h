@@ -0,0 +1,131 @@
+/**
+ * @file AdaptiveMutex.h
+ * @brief A mutex that spins for a while and then sleeps on a futex
+ *
+ * The futex word is 0 when unlocked, 1 when locked, 2 when locked and a
+ * thread may sleep on it ("Futexes Are Tricky", Drepper). Locking and
+ * unlocking without contention is one atomic instruction each, and unlock()
+ * only makes a syscall if a thread sleeps. A contended lock() spins first,
+ * for as long as the lock was held recently, like glibc's
+ * PTHREAD_MUTEX_ADAPTIVE_NP: short critical sections are handed over
+ * without a syscall on either side.
+ *
+ * It works with the guard, not with Condition, use MutexLock to wait on a
+ * condition.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/CurrentThread.h>
+#include <LuxUtils/Mutex.h>
+
+#include <atomic>
+#include <cassert>
+
+namespace Lux {
+namespace detail {
+/// sleeps while *word == expected, spurious wakeups are possible
+void futexWait(std::atomic<int>* word, int expected);
+/// wakes up to @c count threads sleeping on @c word
+void futexWake(std::atomic<int>* word, int count);
+
+/// tells the CPU we are spinning
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    asm volatile("" ::: "memory");
+#endif
+}
+}  // namespace detail
+
+// Use like MutexLock, for data touched in short critical sections:
+//
+//   mutable AdaptiveMutex mutex_;
+//   std::vector<int> data_ GUARDED_BY(mutex_);
+//
+//   AdaptiveMutexGuard lock(mutex_);
+class CAPABILITY("mutex") AdaptiveMutex {
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(AdaptiveMutex&) = delete;
+
+public:
+    /// upper bound of the spins before sleeping
+    static const int kMaxSpins = 100;
+
+private:
+    enum : int { kUnlocked = 0, kLocked = 1, kContended = 2 };
+
+    std::atomic<int> state_;
+    /// average spins a contended lock() needed recently
+    std::atomic<int> spins_;
+    /// @brief 持有该互斥量的线程 ID(tid)
+    pid_t holder_;
+
+    void lockSlow();
+
+public:
+    AdaptiveMutex() : state_(kUnlocked), spins_(0), holder_(0) {}
+
+    ~AdaptiveMutex() { assert(holder_ == 0); }
+
+    inline bool isLockedByThisThread() const {
+        return holder_ == CurrentThread::tid();
+    }
+
+    inline void assertLocked() const ASSERT_CAPABILITY(this) {
+        assert(isLockedByThisThread());
+    }
+
+    inline void lock() ACQUIRE() {
+        int expected = kUnlocked;
+        if (!state_.compare_exchange_strong(expected, kLocked,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            lockSlow();
+        }
+        holder_ = CurrentThread::tid();
+    }
+
+    inline bool tryLock() TRY_ACQUIRE(true) {
+        int expected = kUnlocked;
+        if (state_.compare_exchange_strong(expected, kLocked,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            holder_ = CurrentThread::tid();
+            return true;
+        }
+        return false;
+    }
+
+    inline void unlock() RELEASE() {
+        holder_ = 0;
+        if (state_.exchange(kUnlocked, std::memory_order_release) ==
+            kContended) {
+            detail::futexWake(&state_, 1);
+        }
+    }
+};
+
+class SCOPED_CAPABILITY AdaptiveMutexGuard {
+    AdaptiveMutexGuard(const AdaptiveMutexGuard&) = delete;
+    AdaptiveMutexGuard& operator=(AdaptiveMutexGuard&) = delete;
+
+private:
+    AdaptiveMutex& mutex_;
+
+public:
+    explicit AdaptiveMutexGuard(AdaptiveMutex& mutex) ACQUIRE(mutex)
+        : mutex_(mutex) {
+        mutex_.lock();
+    }
+
+    ~AdaptiveMutexGuard() RELEASE() { mutex_.unlock(); }
+};
+}  // namespace Lux
+
+#define AdaptiveMutexGuard(x) error "Missing guard object name"
@@ -8,65 +8,38 @@
 
 #pragma once
 
+#include <LuxUtils/CurrentThread.h>
+
+#include <atomic>
+#include <cstddef>
 #include <cstdint>  // int32_t int64_t
+#include <memory>
 
 /**
- * @brief GCC 4.1.2版本之后，对X86或X86_64支持内置原子操作。
- * 就是说，不需要引入第三方库（如pthread）的锁保护，
- * 即可对1、2、4、8字节的数值或指针类型，进行原子加/减/与/或/异或等操作。
- *
- * 根据GCC手册中《Using the GNU Compiler Collection (GCC)》章节内容，
- * 将__sync_系列17个函数声明整理简化如下：
- *      将 value 和 *ptr 进行
- * 加/减/或/与/异或/取反，结果更新到*ptr，并返回操作之前*ptr的值
- *  - type __sync_fetch_and_add (type *ptr, type value, ...)
- *  - type __sync_fetch_and_sub (type *ptr, type value, ...)
- *  - type __sync_fetch_and_or (type *ptr, type value, ...)
- *  - type __sync_fetch_and_and (type *ptr, type value, ...)
- *  - type __sync_fetch_and_xor (type *ptr, type value, ...)
- *  - type __sync_fetch_and_nand (type *ptr, type value, ...)
- *
- *      将 value 和 *ptr 进行
- * 加/减/或/与/异或/取反，结果更新到*ptr，并返回操作之后*ptr的值
- *  - type __sync_add_and_fetch (type *ptr, type value, ...)
- *  - type __sync_sub_and_fetch (type *ptr, type value, ...)
- *  - type __sync_or_and_fetch (type *ptr, type value, ...)
- *  - type __sync_and_and_fetch (type *ptr, type value, ...)
- *  - type __sync_xor_and_fetch (type *ptr, type value, ...)
- *  - type __sync_nand_and_fetch (type *ptr, type value, ...)
- *
- *      比较 *ptr 与 oldval 的值，如果两者相等，则将newval更新到*ptr并返回true
- *  - bool __sync_bool_compare_and_swap (type *ptr, type oldval type newval,
- * ...)
- *
+ * @brief 基于 std::atomic，每个操作都可以指定内存序，默认 seq_cst。
  *
- 比较*ptr与oldval的值，如果两者相等，则将newval更新到*ptr并返回操作之前*ptr的值
- *  - type __sync_val_compare_and_swap (type *ptr, type oldval type newval, ...)
+ * 原来的 __sync_* 内置函数都是完整的内存栅栏，而很多场景并不需要：
+ *  - memory_order_relaxed 只保证操作本身是原子的，适合统计计数、生成序号
+ *  - memory_order_acquire 用于读，之后的读写不会被重排到它之前
+ *  - memory_order_release 用于写，之前的读写不会被重排到它之后，
+ *    与另一线程的 acquire 配对，发布数据
+ *  - memory_order_acq_rel 用于读-改-写，兼有 acquire 和 release
+ *  - memory_order_seq_cst 所有线程看到一致的全局顺序，代价最高
  *
- *      发出完整内存栅栏
- *  - __sync_synchronize (...)
- *
- *      将value写入*ptr，对*ptr加锁，并返回操作之前*ptr的值。即，try
- * spinlock语义
- *  - type __sync_lock_test_and_set (type *ptr, type value, ...)
- *
- *      将0写入到*ptr，并对*ptr解锁。即，unlock spinlock语义
- *  - void __sync_lock_release (type *ptr, ...)
- *
- * 这个type不能乱用(type只能是int, long, long long以及对应的unsigned类型)，
- * 同时在用gcc编译的时候要加上选项 -march=i686
- *
- * 后面的可扩展参数(…)用来指出哪些变量需要memory barrier，
- * 因为目前gcc实现的是full barrier(类似Linuxkernel中的mb()，
- * 表示这个操作之前的所有内存操作不会被重排到这个操作之后)，所以可以忽略掉这个参数。
+ * x86 上 relaxed/acquire/release 的 load 和 store 就是普通的 mov，
+ * 读-改-写无论内存序都是带 lock 前缀的指令，但 relaxed 允许编译器重排；
+ * ARM 等弱内存模型的平台上差别更大。
  */
 
 namespace Lux {
 namespace detail {
+/// 缓存行大小，填充和对齐用
+const size_t kCacheLineSize = 64;
+
 template <typename T>
 class AtomicIntegerT {
 private:
-    volatile T value_;
+    std::atomic<T> value_;
 
     AtomicIntegerT(const AtomicIntegerT&) = delete;
     AtomicIntegerT& operator=(AtomicIntegerT&) = delete;
@@ -74,52 +47,117 @@ private:
 public:
     AtomicIntegerT() : value_(0) {}
 
-    // uncomment if you need copying and assignment
-    //
-    // AtomicIntegerT(const AtomicIntegerT& that)
-    //   : value_(that.get())
-    // {}
-    //
-    // AtomicIntegerT& operator=(const AtomicIntegerT& that)
-    // {
-    //   getAndSet(that.get());
-    //   return *this;
-    // }
-
-    /// @brief CAS compare and swap
-    /// @return
-    T get() {
-        // in gcc >= 4.7: __atomic_load_n(&value_, __ATOMIC_SEQ_CST)
-        return __sync_val_compare_and_swap(&value_, 0, 0);
+    T get(std::memory_order order = std::memory_order_seq_cst) const {
+        return value_.load(order);
     }
 
-    T getAndAdd(T x) {
-        // in gcc >= 4.7: __atomic_fetch_add(&value_, x,
-        // __ATOMIC_SEQ_CST)
-        return __sync_fetch_and_add(&value_, x);
+    void set(T newValue, std::memory_order order = std::memory_order_seq_cst) {
+        value_.store(newValue, order);
     }
 
-    T addAndGet(T x) { return getAndAdd(x) + x; }
+    T getAndAdd(T x, std::memory_order order = std::memory_order_seq_cst) {
+        return value_.fetch_add(x, order);
+    }
 
-    T incrementAndGet() { return addAndGet(1); }
+    T addAndGet(T x, std::memory_order order = std::memory_order_seq_cst) {
+        return getAndAdd(x, order) + x;
+    }
 
-    T decrementAndGet() { return addAndGet(-1); }
+    T incrementAndGet(std::memory_order order = std::memory_order_seq_cst) {
+        return addAndGet(1, order);
+    }
 
-    void add(T x) { getAndAdd(x); }
+    T decrementAndGet(std::memory_order order = std::memory_order_seq_cst) {
+        return addAndGet(-1, order);
+    }
 
-    void increment() { incrementAndGet(); }
+    void add(T x, std::memory_order order = std::memory_order_seq_cst) {
+        getAndAdd(x, order);
+    }
+
+    void increment(std::memory_order order = std::memory_order_seq_cst) {
+        incrementAndGet(order);
+    }
+
+    void decrement(std::memory_order order = std::memory_order_seq_cst) {
+        decrementAndGet(order);
+    }
 
-    void decrement() { decrementAndGet(); }
+    T getAndSet(T newValue,
+                std::memory_order order = std::memory_order_seq_cst) {
+        return value_.exchange(newValue, order);
+    }
+
+    /// @brief CAS compare and swap，失败时 *expected 更新为当前值
+    /// @return 是否替换成功
+    bool compareAndSet(T* expected, T newValue,
+                       std::memory_order order = std::memory_order_seq_cst) {
+        return value_.compare_exchange_strong(*expected, newValue, order);
+    }
+};
+
+/// @brief 独占一个缓存行的 AtomicIntegerT，
+/// 用于数组中每个线程各自修改的计数，避免伪共享(false sharing)
+template <typename T>
+class alignas(kCacheLineSize) PaddedAtomicIntegerT : public AtomicIntegerT<T> {
+    char padding_[kCacheLineSize - sizeof(AtomicIntegerT<T>)];
+};
+
+/// @brief 分片计数器，用于高频更新、低频读取的统计量。
+/// 每个线程按 tid 落到一个分片上，只用 relaxed 操作更新自己的分片，
+/// 线程之间不争用同一个缓存行；读取时把所有分片加起来，
+/// 与并发的更新之间没有一致的快照。
+template <typename T>
+class ShardedCounterT {
+    ShardedCounterT(const ShardedCounterT&) = delete;
+    ShardedCounterT& operator=(ShardedCounterT&) = delete;
+
+private:
+    const size_t mask_;
+    std::unique_ptr<PaddedAtomicIntegerT<T>[]> shards_;
+
+    static size_t roundUp(size_t n) {
+        size_t shards = 1;
+        while (shards < n) shards *= 2;
+        return shards;
+    }
+
+    PaddedAtomicIntegerT<T>& shard() {
+        return shards_[static_cast<size_t>(CurrentThread::tid()) & mask_];
+    }
+
+public:
+    /// @param shards 向上取整为 2 的幂
+    explicit ShardedCounterT(size_t shards = 16)
+        : mask_(roundUp(shards) - 1),
+          shards_(new PaddedAtomicIntegerT<T>[mask_ + 1]) {}
+
+    void add(T x) { shard().add(x, std::memory_order_relaxed); }
+    void increment() { add(1); }
+    void decrement() { add(-1); }
+
+    /// 各分片之和
+    T get() const {
+        T sum = 0;
+        for (size_t i = 0; i <= mask_; ++i) {
+            sum += shards_[i].get(std::memory_order_relaxed);
+        }
+        return sum;
+    }
 
-    T getAndSet(T newValue) {
-        // in gcc >= 4.7: __atomic_exchange_n(&value_, newValue,
-        // __ATOMIC_SEQ_CST)
-        return __sync_lock_test_and_set(&value_, newValue);
+    /// 清零，与并发的 add() 之间不是原子的
+    void reset() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            shards_[i].set(0, std::memory_order_relaxed);
+        }
     }
 };
 }  // namespace detail
 
 typedef detail::AtomicIntegerT<int32_t> AtomicInt32;
 typedef detail::AtomicIntegerT<int64_t> AtomicInt64;
+typedef detail::PaddedAtomicIntegerT<int32_t> PaddedAtomicInt32;
+typedef detail::PaddedAtomicIntegerT<int64_t> PaddedAtomicInt64;
+typedef detail::ShardedCounterT<int64_t> ShardedCounter;
 
-}  // namespace Lux
\ No newline at end of file
+}  // namespace Lux
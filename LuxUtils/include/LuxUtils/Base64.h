@@ -0,0 +1,27 @@
+/**
+ * @file Base64.h
+ * @brief Base64 编解码 (RFC 4648)，包括标准字母表与 URL 安全字母表
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Types.h>
+
+namespace Lux {
+namespace Base64 {
+
+/// @brief Encode @c data with the standard alphabet, padded with '='.
+string encode(StringPiece data);
+
+/// @brief Encode @c data with the URL and filename safe alphabet, no padding.
+string encodeUrl(StringPiece data);
+
+/// @brief Decode either alphabet, padding is optional.
+/// @return false if @c data is not valid base64, @c out is unspecified then.
+bool decode(StringPiece data, string* out);
+
+}  // namespace Base64
+}  // namespace Lux
@@ -0,0 +1,115 @@
+/**
+ * @file Config.h
+ * @brief Immutable configuration snapshots, replaced as a whole
+ *
+ * A Config<T> holds the current T, e.g. the tunables of one component, as
+ * a shared_ptr<const T>. publish() builds a new snapshot and swaps it in;
+ * a snapshot is never modified, so a reader sees either all of the old
+ * values or all of the new ones.
+ *
+ * Reading does not lock: each reading thread keeps a Config<T>::Reader,
+ * which caches a reference to the snapshot it last saw and compares one
+ * atomic version number per access. Only when a new version was published
+ * does it take the lock once to fetch it. An old snapshot is freed when the
+ * last Reader holding it moves on, like a grace period of RCU.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/AdaptiveMutex.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Lux {
+
+template <typename T>
+class Config {
+    Config(const Config&) = delete;
+    Config& operator=(Config&) = delete;
+
+private:
+    mutable AdaptiveMutex mutex_;
+    std::shared_ptr<const T> current_ GUARDED_BY(mutex_);
+    /// bumped after current_ is replaced
+    std::atomic<uint64_t> version_;
+
+public:
+    class Reader;
+
+    explicit Config(T initial = T())
+        : current_(std::make_shared<const T>(std::move(initial))),
+          version_(1) {}
+
+    /// @brief Replaces the snapshot, thread safe.
+    void publish(T value) {
+        std::shared_ptr<const T> next =
+            std::make_shared<const T>(std::move(value));
+        AdaptiveMutexGuard lock(mutex_);
+        current_.swap(next);
+        version_.store(version_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_release);
+        // the old snapshot is released out of the lock, by next
+    }
+
+    /// @brief The current snapshot, to keep or to pass to another thread.
+    /// Takes the lock, use a Reader on hot paths.
+    std::shared_ptr<const T> snapshot() const {
+        AdaptiveMutexGuard lock(mutex_);
+        return current_;
+    }
+
+    /// @brief Changes with every publish(), starting from 1.
+    uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+private:
+    /// @brief The snapshot and its version, consistent with each other.
+    std::pair<std::shared_ptr<const T>, uint64_t> load() const {
+        AdaptiveMutexGuard lock(mutex_);
+        return std::make_pair(current_,
+                              version_.load(std::memory_order_relaxed));
+    }
+};
+
+/**
+ * @brief Lock free view of a Config, for one thread.
+ *
+ * Not thread safe: give each reading thread, or each object used by one
+ * thread (an EventLoop, the logger's backend), its own Reader. The
+ * reference returned by get() stays valid until the next get() on the
+ * same Reader.
+ */
+template <typename T>
+class Config<T>::Reader {
+private:
+    const Config* config_;
+    uint64_t version_;
+    std::shared_ptr<const T> snapshot_;
+
+public:
+    explicit Reader(const Config& config)
+        : config_(&config), version_(0) {}
+
+    /// @brief Whether a newer snapshot than the last get() was published.
+    bool changed() const { return config_->version() != version_; }
+
+    const T& get() {
+        if (changed()) {
+            auto loaded = config_->load();
+            snapshot_.swap(loaded.first);
+            version_ = loaded.second;
+        }
+        return *snapshot_;
+    }
+
+    const T& operator*() { return get(); }
+    const T* operator->() { return &get(); }
+};
+
+}  // namespace Lux
@@ -0,0 +1,107 @@
+/**
+ * @file Format.h
+ * @brief Number to text without printf, shared by LogStream and the HTTP
+ * response headers
+ *
+ * Integers are written two digits at a time from a table of "00".."99",
+ * after counting the digits, so the text is produced in place, in order,
+ * with half the divisions of a digit by digit loop. Floating point numbers
+ * use std::to_chars, the shortest text that reads back to the same value
+ * (Ryu in libstdc++), instead of snprintf("%.12g") which parses a format
+ * and may lose precision.
+ *
+ * None of them writes a terminating '\0'.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Lux {
+namespace format {
+
+/// room for any 64 bits integer with its sign
+const size_t kMaxIntegerSize = 21;
+/// room for the shortest text of any double, e.g. -2.2250738585072014e-308
+const size_t kMaxDoubleSize = 32;
+
+namespace detail {
+/// "00010203...9899"
+extern const char kDigitPairs[201];
+}  // namespace detail
+
+/// @brief Writes @c v, 0 <= v < 100, as two digits.
+inline void write2Digits(char* p, unsigned v) {
+    ::memcpy(p, &detail::kDigitPairs[v * 2], 2);
+}
+
+/// number of decimal digits of @c v, 1 for 0
+inline size_t countDigits(uint64_t v) {
+    size_t n = 1;
+    while (true) {
+        if (v < 10) return n;
+        if (v < 100) return n + 1;
+        if (v < 1000) return n + 2;
+        if (v < 10000) return n + 3;
+        v /= 10000;
+        n += 4;
+    }
+}
+
+/// @brief Writes @c v in decimal to buf.
+/// @return the length, at most 20
+inline size_t formatUnsigned(char* buf, uint64_t v) {
+    size_t len = countDigits(v);
+    char* p = buf + len;
+    while (v >= 100) {
+        unsigned pair = static_cast<unsigned>(v % 100);
+        v /= 100;
+        p -= 2;
+        write2Digits(p, pair);
+    }
+    if (v >= 10) {
+        write2Digits(p - 2, static_cast<unsigned>(v));
+    } else {
+        p[-1] = static_cast<char>('0' + v);
+    }
+    return len;
+}
+
+/// @brief Writes an integer in decimal to buf, which has kMaxIntegerSize
+/// bytes.
+/// @return the length
+template <typename T>
+inline size_t formatDecimal(char* buf, T value) {
+    static_assert(std::is_integral<T>::value, "Must be integral type");
+    if constexpr (std::is_signed<T>::value) {
+        if (value < 0) {
+            *buf = '-';
+            // negating in 64 bits is right for the minimum too, and no
+            // narrow type gets promoted back to int
+            return 1 + formatUnsigned(buf + 1,
+                                      0 - static_cast<uint64_t>(value));
+        }
+    }
+    return formatUnsigned(buf, static_cast<uint64_t>(value));
+}
+
+/// @brief Writes @c value in upper case hex, without "0x".
+/// @return the length
+size_t formatHex(char* buf, uintptr_t value);
+
+/// @brief Writes the shortest text that reads back as @c value, to buf of
+/// kMaxDoubleSize bytes, "nan" and "inf" for those. Decimal exponents in
+/// [-5, 15) are written in fixed notation, e.g. "100000" and "0.0001", the
+/// others in scientific, e.g. "1e+15" and "1e-06".
+/// @return the length
+size_t formatDouble(char* buf, double value);
+/// shortest as a float, 0.1f is "0.1" and not "0.10000000149011612"
+size_t formatDouble(char* buf, float value);
+
+}  // namespace format
+}  // namespace Lux
@@ -0,0 +1,218 @@
+/**
+ * @file InlineAny.h
+ * @brief A copyable value of any type, stored inline up to @c Capacity
+ * bytes, no RTTI
+ *
+ * Like std::any with a larger small buffer chosen by the user: a type that
+ * fits in Capacity bytes and is nothrow movable is constructed in place, a
+ * larger one on the heap. The type is checked by comparing the address of
+ * a per-type operation table instead of typeid, get<T>() only asserts it.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Lux {
+
+template <size_t Capacity, size_t Align = alignof(std::max_align_t)>
+class InlineAny {
+    static_assert(Capacity >= sizeof(void*), "room for the heap pointer");
+
+    /// the operations of one stored type, its address identifies the type
+    struct Ops {
+        void (*destroy)(void* storage) noexcept;
+        void (*copy)(const void* src, void* dest);
+        /// constructs dest from src and destroys src
+        void (*move)(void* src, void* dest) noexcept;
+        void* (*get)(void* storage) noexcept;
+    };
+
+    template <typename T>
+    static constexpr bool isInline() {
+        return sizeof(T) <= Capacity && Align % alignof(T) == 0 &&
+               std::is_nothrow_move_constructible<T>::value;
+    }
+
+    template <typename T, bool = isInline<T>()>
+    struct OpsOf {
+        static T* ptr(void* storage) noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+        static void destroy(void* storage) noexcept { ptr(storage)->~T(); }
+        static void copy(const void* src, void* dest) {
+            new (dest) T(*ptr(const_cast<void*>(src)));
+        }
+        static void move(void* src, void* dest) noexcept {
+            new (dest) T(std::move(*ptr(src)));
+            destroy(src);
+        }
+        static void* get(void* storage) noexcept { return ptr(storage); }
+
+        template <typename... Args>
+        static T* create(void* storage, Args&&... args) {
+            return new (storage) T(std::forward<Args>(args)...);
+        }
+
+        static const Ops ops;
+    };
+
+    /// too large, the storage holds a T*
+    template <typename T>
+    struct OpsOf<T, false> {
+        static T*& ptr(void* storage) noexcept {
+            return *reinterpret_cast<T**>(storage);
+        }
+        static void destroy(void* storage) noexcept { delete ptr(storage); }
+        static void copy(const void* src, void* dest) {
+            *reinterpret_cast<T**>(dest) =
+                new T(*ptr(const_cast<void*>(src)));
+        }
+        static void move(void* src, void* dest) noexcept {
+            *reinterpret_cast<T**>(dest) = ptr(src);
+        }
+        static void* get(void* storage) noexcept { return ptr(storage); }
+
+        template <typename... Args>
+        static T* create(void* storage, Args&&... args) {
+            T* p = new T(std::forward<Args>(args)...);
+            *reinterpret_cast<T**>(storage) = p;
+            return p;
+        }
+
+        static const Ops ops;
+    };
+
+    template <typename T>
+    using Decay = typename std::decay<T>::type;
+
+    const Ops* ops_;
+    alignas(Align) unsigned char storage_[Capacity];
+
+public:
+    InlineAny() noexcept : ops_(nullptr) {}
+
+    InlineAny(const InlineAny& rhs) : ops_(nullptr) {
+        if (rhs.ops_) {
+            rhs.ops_->copy(rhs.storage_, storage_);
+            ops_ = rhs.ops_;
+        }
+    }
+
+    InlineAny(InlineAny&& rhs) noexcept : ops_(rhs.ops_) {
+        if (ops_) {
+            ops_->move(rhs.storage_, storage_);
+            rhs.ops_ = nullptr;
+        }
+    }
+
+    template <typename T, typename = typename std::enable_if<
+                              !std::is_same<Decay<T>, InlineAny>::value>::type>
+    InlineAny(T&& value) : ops_(nullptr) {
+        emplace<Decay<T>>(std::forward<T>(value));
+    }
+
+    ~InlineAny() { reset(); }
+
+    InlineAny& operator=(const InlineAny& rhs) {
+        InlineAny(rhs).swap(*this);
+        return *this;
+    }
+
+    InlineAny& operator=(InlineAny&& rhs) noexcept {
+        InlineAny(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    template <typename T, typename = typename std::enable_if<
+                              !std::is_same<Decay<T>, InlineAny>::value>::type>
+    InlineAny& operator=(T&& value) {
+        emplace<Decay<T>>(std::forward<T>(value));
+        return *this;
+    }
+
+    /// @brief Destroys the value held and constructs a T from @c args.
+    /// @return the new value
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        static_assert(std::is_copy_constructible<T>::value,
+                      "InlineAny is copyable");
+        reset();
+        T* p = OpsOf<T>::create(storage_, std::forward<Args>(args)...);
+        ops_ = &OpsOf<T>::ops;
+        return *p;
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    void swap(InlineAny& rhs) noexcept {
+        if (this == &rhs) return;
+        InlineAny tmp;
+        if (rhs.ops_) rhs.ops_->move(rhs.storage_, tmp.storage_);
+        tmp.ops_ = rhs.ops_;
+        if (ops_) ops_->move(storage_, rhs.storage_);
+        rhs.ops_ = ops_;
+        if (tmp.ops_) tmp.ops_->move(tmp.storage_, storage_);
+        ops_ = tmp.ops_;
+        tmp.ops_ = nullptr;
+    }
+
+    bool hasValue() const noexcept { return ops_ != nullptr; }
+
+    template <typename T>
+    bool is() const noexcept {
+        return ops_ == &OpsOf<T>::ops;
+    }
+
+    /// true if a T is held in place, without heap allocation
+    template <typename T>
+    static constexpr bool storesInline() {
+        return isInline<T>();
+    }
+
+    /// @return the T held, nullptr if empty or of another type
+    template <typename T>
+    T* tryGet() noexcept {
+        return is<T>() ? static_cast<T*>(ops_->get(storage_)) : nullptr;
+    }
+    template <typename T>
+    const T* tryGet() const noexcept {
+        return const_cast<InlineAny*>(this)->tryGet<T>();
+    }
+
+    /// The T held, which must be a T, only asserted.
+    template <typename T>
+    T& get() noexcept {
+        assert(is<T>());
+        return *static_cast<T*>(OpsOf<T>::get(storage_));
+    }
+    template <typename T>
+    const T& get() const noexcept {
+        return const_cast<InlineAny*>(this)->get<T>();
+    }
+};
+
+template <size_t Capacity, size_t Align>
+template <typename T, bool Inline>
+const typename InlineAny<Capacity, Align>::Ops
+    InlineAny<Capacity, Align>::OpsOf<T, Inline>::ops = {
+        &OpsOf::destroy, &OpsOf::copy, &OpsOf::move, &OpsOf::get};
+
+template <size_t Capacity, size_t Align>
+template <typename T>
+const typename InlineAny<Capacity, Align>::Ops
+    InlineAny<Capacity, Align>::OpsOf<T, false>::ops = {
+        &OpsOf::destroy, &OpsOf::copy, &OpsOf::move, &OpsOf::get};
+
+}  // namespace Lux
@@ -0,0 +1,304 @@
+/**
+ * @file MPMCQueue.h
+ * @brief Bounded lock free multi-producer multi-consumer FIFO queue
+ *
+ * Dmitry Vyukov's bounded MPMC queue: every cell has a sequence number,
+ * a producer claims the cell at the enqueue position when its sequence
+ * equals the position, a consumer when it equals the position + 1. One CAS
+ * per operation, no lock, producers and consumers touch different cache
+ * lines unless the queue is almost empty or full.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Condition.h>
+#include <LuxUtils/Mutex.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>  // yield
+#include <utility>
+
+namespace Lux {
+
+/// @brief Bounded FIFO queue for producers and consumers of any threads.
+/// try* return at once, spin* spin and yield until done, push() and pop()
+/// spin a little and then sleep.
+template <typename T>
+class MPMCQueue {
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(MPMCQueue&) = delete;
+
+    static const size_t kCacheLine = 64;
+    /// tries before push() and pop() sleep
+    static const int kSpins = 128;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return reinterpret_cast<T*>(storage); }
+    };
+
+    /// @return the cell of @c pos if it is free to write in this lap
+    Cell* enqueueCell(size_t pos) {
+        Cell* cell = &cells_[pos & mask_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        return seq == pos ? cell : nullptr;
+    }
+    /// @return the cell of @c pos if it is written in this lap
+    Cell* dequeueCell(size_t pos) {
+        Cell* cell = &cells_[pos & mask_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        return seq == pos + 1 ? cell : nullptr;
+    }
+
+    /// @brief Claims a cell to write.
+    /// @return nullptr if full
+    Cell* claimEnqueue(size_t* pos) {
+        size_t p = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell* cell = &cells_[p & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(p);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(
+                        p, p + 1, std::memory_order_relaxed)) {
+                    *pos = p;
+                    return cell;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                p = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Claims a cell to read.
+    /// @return nullptr if empty
+    Cell* claimDequeue(size_t* pos) {
+        size_t p = dequeuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell* cell = &cells_[p & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(p + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(
+                        p, p + 1, std::memory_order_relaxed)) {
+                    *pos = p;
+                    return cell;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                p = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publishEnqueue(Cell* cell, size_t pos) {
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+    void publishDequeue(Cell* cell, size_t pos) {
+        cell->value()->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    }
+
+    /// wakes the sleeping consumers after a push, or producers after a pop
+    void wake(std::atomic<int>& waiters, Condition& cond) {
+        // pairs with the fence in sleep(), one of them sees the other
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            MutexLockGuard lock(mutex_);
+            cond.notifyAll();
+        }
+    }
+
+    /// @brief Retries @c op, spinning and then sleeping on @c cond while
+    /// @c ready is false. op() is not called with mutex_ held, it may wake.
+    template <typename Op, typename Ready>
+    void sleep(Op op, Ready ready, std::atomic<int>& waiters,
+               Condition& cond) {
+        while (true) {
+            for (int i = 0; i < kSpins; ++i) {
+                if (op()) return;
+            }
+            MutexLockGuard lock(mutex_);
+            waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) cond.wait();
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<size_t> enqueuePos_;
+    alignas(kCacheLine) std::atomic<size_t> dequeuePos_;
+
+    /// only for push() and pop() that sleep
+    alignas(kCacheLine) std::atomic<int> pushWaiters_;
+    std::atomic<int> popWaiters_;
+    Lux::MutexLock mutex_;
+    Lux::Condition notFull_ GUARDED_BY(mutex_);
+    Lux::Condition notEmpty_ GUARDED_BY(mutex_);
+
+public:
+    /// @param capacity rounded up to a power of two, at least 2
+    explicit MPMCQueue(size_t capacity)
+        : mask_(roundUp(capacity) - 1),
+          cells_(new Cell[mask_ + 1]),
+          enqueuePos_(0),
+          dequeuePos_(0),
+          pushWaiters_(0),
+          popWaiters_(0),
+          mutex_(),
+          notFull_(mutex_),
+          notEmpty_(mutex_) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// Destroys the values left, no other thread may use the queue.
+    ~MPMCQueue() {
+        size_t end = enqueuePos_.load(std::memory_order_relaxed);
+        for (size_t p = dequeuePos_.load(std::memory_order_relaxed); p != end;
+             ++p) {
+            cells_[p & mask_].value()->~T();
+        }
+    }
+
+    static size_t roundUp(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) capacity *= 2;
+        return capacity;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /// An estimate, exact only without concurrent operations.
+    size_t size() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    /// @return false if full
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        size_t pos;
+        Cell* cell = claimEnqueue(&pos);
+        if (!cell) return false;
+        new (cell->storage) T(std::forward<Args>(args)...);
+        publishEnqueue(cell, pos);
+        wake(popWaiters_, notEmpty_);
+        return true;
+    }
+    bool tryPush(const T& value) { return tryEmplace(value); }
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    /// @return false if empty
+    bool tryPop(T* value) {
+        size_t pos;
+        Cell* cell = claimDequeue(&pos);
+        if (!cell) return false;
+        *value = std::move(*cell->value());
+        publishDequeue(cell, pos);
+        wake(pushWaiters_, notFull_);
+        return true;
+    }
+
+    /// @brief Pushes values[0, n) in order, as many as there is room for.
+    /// @return the number pushed, moved from values
+    size_t tryPushBatch(T* values, size_t n) {
+        size_t p = enqueuePos_.load(std::memory_order_relaxed);
+        size_t k;
+        do {
+            // the cells free in this lap, they stay free until claimed
+            k = 0;
+            while (k < n && enqueueCell(p + k)) ++k;
+            if (k == 0) {
+                size_t now = enqueuePos_.load(std::memory_order_relaxed);
+                if (now == p) return 0;
+                p = now;
+                continue;
+            }
+        } while (k == 0 || !enqueuePos_.compare_exchange_weak(
+                               p, p + k, std::memory_order_relaxed));
+        for (size_t i = 0; i < k; ++i) {
+            Cell* cell = &cells_[(p + i) & mask_];
+            new (cell->storage) T(std::move(values[i]));
+            publishEnqueue(cell, p + i);
+        }
+        wake(popWaiters_, notEmpty_);
+        return k;
+    }
+
+    /// @brief Pops up to @c n values in order into values[0, n).
+    /// @return the number popped
+    size_t tryPopBatch(T* values, size_t n) {
+        size_t p = dequeuePos_.load(std::memory_order_relaxed);
+        size_t k;
+        do {
+            k = 0;
+            while (k < n && dequeueCell(p + k)) ++k;
+            if (k == 0) {
+                size_t now = dequeuePos_.load(std::memory_order_relaxed);
+                if (now == p) return 0;
+                p = now;
+                continue;
+            }
+        } while (k == 0 || !dequeuePos_.compare_exchange_weak(
+                               p, p + k, std::memory_order_relaxed));
+        for (size_t i = 0; i < k; ++i) {
+            Cell* cell = &cells_[(p + i) & mask_];
+            values[i] = std::move(*cell->value());
+            publishDequeue(cell, p + i);
+        }
+        wake(pushWaiters_, notFull_);
+        return k;
+    }
+
+    /// Spins and yields until there is room, for short waits.
+    void spinPush(T value) {
+        while (!tryPush(std::move(value))) std::this_thread::yield();
+    }
+    /// Spins and yields until there is a value, for short waits.
+    T spinPop() {
+        T value;
+        while (!tryPop(&value)) std::this_thread::yield();
+        return value;
+    }
+
+    /// Waits until there is room.
+    void push(T value) {
+        sleep([&] { return tryPush(std::move(value)); },
+              [this] {
+                  return enqueueCell(enqueuePos_.load(
+                             std::memory_order_relaxed)) != nullptr;
+              },
+              pushWaiters_, notFull_);
+    }
+    /// Waits until there is a value.
+    T pop() {
+        T value;
+        sleep([&] { return tryPop(&value); },
+              [this] {
+                  return dequeueCell(dequeuePos_.load(
+                             std::memory_order_relaxed)) != nullptr;
+              },
+              popWaiters_, notEmpty_);
+        return value;
+    }
+};
+
+}  // namespace Lux
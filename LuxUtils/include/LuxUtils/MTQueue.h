@@ -13,6 +13,7 @@
 
 /**
  * @brief 线程安全的生产者-消费者队列
+ * 无界，pop() 取出最后放入的元素 (LIFO)；需要有界的 FIFO 队列时见 MPMCQueue
  *
  * @tparam T
  */
@@ -0,0 +1,166 @@
+/**
+ * @file MappedINI.h
+ * @brief Read-only INI reader over a mmap of the file, indexed on demand
+ *
+ * Same syntax as LuxINI.hpp: sections and keys are case insensitive,
+ * leading and trailing white spaces are ignored, ';' starts a comment line,
+ * "\=" escapes '=' in a key, and a repeated key overrides the earlier one.
+ *
+ * Nothing is copied or upper-cased. open() only maps the file; the first
+ * lookup scans for the "[section]" lines, and the keys of a section are
+ * indexed when that section is first looked up, so the startup cost of a
+ * large generated file (routing tables, ACLs) is paid for the sections that
+ * are actually read. Names and values are string_views into the mapping.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Types.h>
+
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Lux {
+namespace INIParser {
+
+namespace detail {
+/// ASCII case insensitive, the same as comparing after iniTransform()
+struct CaseInsensitiveHash {
+    size_t operator()(std::string_view s) const;
+};
+
+struct CaseInsensitiveEqual {
+    bool operator()(std::string_view lhs, std::string_view rhs) const;
+};
+}  // namespace detail
+
+/**
+ * @brief Read-only, memory mapped INI file.
+ *
+ * The views returned are valid until the next open()/reload() or the
+ * destruction of the MappedINI. Lookups fill the index lazily, so this
+ * class is not thread safe, even through a const reference; copy the values
+ * out, or build a snapshot, for other threads.
+ *
+ * The file should be replaced with rename(2) rather than rewritten in place:
+ * the mapping keeps the old inode, while truncating a mapped file makes
+ * reading the truncated pages raise SIGBUS.
+ */
+class MappedINI {
+    MappedINI(const MappedINI&) = delete;
+    MappedINI& operator=(MappedINI&) = delete;
+
+private:
+    using Range = std::pair<const char*, const char*>;
+    using KeyMap =
+        std::unordered_map<std::string_view, std::string_view,
+                           detail::CaseInsensitiveHash,
+                           detail::CaseInsensitiveEqual>;
+
+    struct Section {
+        /// bodies of the "[section]" headers with this name, in file order
+        std::vector<Range> bodies;
+        bool indexed = false;
+        KeyMap keys;
+    };
+
+    using SectionMap =
+        std::unordered_map<std::string_view, Section,
+                           detail::CaseInsensitiveHash,
+                           detail::CaseInsensitiveEqual>;
+
+    string fileName_;
+    const char* data_;
+    size_t mapSize_;
+    /// the text, after the UTF-8 BOM if any
+    Range text_;
+
+    mutable bool indexed_;
+    mutable SectionMap sections_;
+    /// keys with "\=" unescaped, the views point here
+    mutable std::deque<string> unescapedKeys_;
+
+private:
+    void unmap();
+    void indexSections() const;
+    const Section* findSection(std::string_view section) const;
+
+    /// @brief Cuts the first line off @c rest, without the line break.
+    static std::string_view nextLine(Range* rest);
+    static std::string_view trim(std::string_view s);
+    /// @brief Splits one line into key and value, both trimmed.
+    /// @return false if @c line is not "key=value"
+    static bool parseKeyValue(std::string_view line, std::string_view* key,
+                              std::string_view* value);
+
+public:
+    MappedINI();
+    ~MappedINI();
+
+    /// @brief Maps @c fileName in place of the previous mapping.
+    /// @return 0 on success, errno otherwise, and the old content is kept
+    int open(StringArg fileName);
+    /// @brief Maps the file again, for a new version replaced by rename(2).
+    /// @return the same as open()
+    int reload();
+
+    bool valid() const { return data_ != nullptr; }
+    const string& fileName() const { return fileName_; }
+    /// bytes of the text
+    size_t size() const {
+        return static_cast<size_t>(text_.second - text_.first);
+    }
+
+    bool has(std::string_view section) const;
+    bool has(std::string_view section, std::string_view key) const;
+
+    /// @brief The value of @c key in @c section, @c defaultValue if absent.
+    std::string_view get(std::string_view section, std::string_view key,
+                         std::string_view defaultValue = {}) const;
+
+    /// @name Typed values, @c defaultValue if absent or malformed
+    /// @{
+    int64_t getInt(std::string_view section, std::string_view key,
+                   int64_t defaultValue) const;
+    /// bytes, with an optional K/M/G suffix of 1024, e.g. "64K", "500M"
+    int64_t getSize(std::string_view section, std::string_view key,
+                    int64_t defaultValue) const;
+    double getDouble(std::string_view section, std::string_view key,
+                     double defaultValue) const;
+    /// true/false, yes/no, on/off or 1/0, in any case
+    bool getBool(std::string_view section, std::string_view key,
+                 bool defaultValue) const;
+    /// @}
+
+    /// @brief Calls @c func(key, value) for each key of @c section in file
+    /// order. A repeated key is visited each time it appears, and "\="
+    /// stays escaped in the key.
+    template <typename Func>
+    void forEach(std::string_view section, Func&& func) const;
+
+    /// number of distinct sections
+    size_t sectionCount() const;
+};
+
+template <typename Func>
+void MappedINI::forEach(std::string_view section, Func&& func) const {
+    const Section* s = findSection(section);
+    if (s == nullptr) return;
+    for (Range body : s->bodies) {
+        while (body.first < body.second) {
+            std::string_view key, value;
+            if (parseKeyValue(nextLine(&body), &key, &value)) {
+                func(key, value);
+            }
+        }
+    }
+}
+
+}  // namespace INIParser
+}  // namespace Lux
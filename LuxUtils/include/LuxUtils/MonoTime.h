@@ -0,0 +1,84 @@
+/**
+ * @file MonoTime.h
+ * @brief
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Timestamp.h>
+#include <LuxUtils/Types.h>
+
+namespace Lux {
+
+/**
+ * @brief Time point of CLOCK_MONOTONIC, in micro seconds resolution.
+ *
+ * Unlike Timestamp, it never jumps when the wall clock is set or stepped by
+ * NTP, so it is the clock for timeouts and intervals. It means nothing
+ * across reboots or processes. clock_gettime() reads it through the vDSO,
+ * from the TSC on x86, without a syscall.
+ *
+ * This class is immutable, pass it by value.
+ */
+class MonoTime {
+private:
+    /// @brief micro seconds since an unspecified point, usually the boot
+    int64_t microSeconds_;
+
+public:
+    /// @brief Constucts an invalid MonoTime.
+    MonoTime() : microSeconds_(0) {}
+
+    explicit MonoTime(int64_t microSecondsArg)
+        : microSeconds_(microSecondsArg) {}
+
+    // default copy/assignment/dtor are Okay
+
+    /// @brief seconds.microseconds, for logging
+    string toString() const;
+
+    inline bool valid() const { return microSeconds_ > 0; }
+
+    inline int64_t microSeconds() const { return microSeconds_; }
+
+    ///
+    /// Get time of now, clock_gettime(CLOCK_MONOTONIC).
+    ///
+    static MonoTime now();
+    static MonoTime invalid() { return MonoTime(); }
+
+    /// @brief The monotonic time when the wall clock reads @c wall, as
+    /// estimated now. Later steps of the wall clock do not move it.
+    static MonoTime fromTimestamp(Timestamp wall);
+};
+
+inline bool operator<(MonoTime lhs, MonoTime rhs) {
+    return lhs.microSeconds() < rhs.microSeconds();
+}
+
+inline bool operator==(MonoTime lhs, MonoTime rhs) {
+    return lhs.microSeconds() == rhs.microSeconds();
+}
+
+///
+/// Gets time difference of two monotonic times, result in seconds.
+///
+/// @return (high-low) in seconds
+inline double timeDifference(MonoTime high, MonoTime low) {
+    return static_cast<double>(high.microSeconds() - low.microSeconds()) /
+           Timestamp::kMicroSecondsPerSecond;
+}
+
+///
+/// Add @c seconds to given monotonic time.
+///
+/// @return time+seconds as MonoTime
+///
+inline MonoTime addTime(MonoTime time, double seconds) {
+    auto delta =
+        static_cast<int64_t>(seconds * Timestamp::kMicroSecondsPerSecond);
+    return MonoTime(time.microSeconds() + delta);
+}
+}  // namespace Lux
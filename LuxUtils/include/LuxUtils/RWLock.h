@@ -0,0 +1,120 @@
+/**
+ * @file RWLock.h
+ * @brief Reader-writer lock with a reader counter per CPU
+ *
+ * A reader increments the counter of the CPU it runs on, so readers on
+ * different CPUs do not bounce a shared cache line, and checks that no
+ * writer is in. A writer takes an AdaptiveMutex against the other writers,
+ * announces itself so that new readers step back, and waits until all the
+ * counters drop to zero. Reads are cheap and scale, writes are expensive:
+ * for data read far more often than written.
+ *
+ * Writers are preferred, a thread holding a read lock must not take it
+ * again, a waiting writer would deadlock it.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/AdaptiveMutex.h>
+#include <LuxUtils/Mutex.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace Lux {
+
+class CAPABILITY("mutex") RWLock {
+    RWLock(const RWLock&) = delete;
+    RWLock& operator=(RWLock&) = delete;
+
+    static const size_t kCacheLine = 64;
+    /// checks of the state before sleeping
+    static const int kSpins = 100;
+
+    enum : int { kNoWriter = 0, kWriter = 1, kWriterReadersSleep = 2 };
+
+    struct alignas(kCacheLine) Slot {
+        std::atomic<int> readers{0};
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    AdaptiveMutex writerMutex_;
+    /// kNoWriter, or a writer holds or waits for the lock
+    alignas(kCacheLine) std::atomic<int> writer_;
+    /// bumped by readers leaving while a writer waits, it sleeps on it
+    std::atomic<int> drained_;
+
+    /// the slot of the CPU we run on
+    size_t currentSlot() const;
+    bool noReaders() const;
+    void waitForWriter();
+    void wakeWriter();
+
+public:
+    RWLock();
+
+    /// @return the slot to pass to unlockShared()
+    inline size_t lockShared() ACQUIRE_SHARED() {
+        size_t slot = currentSlot();
+        while (true) {
+            // seq_cst, pairs with the store and the loads in lock()
+            slots_[slot].readers.fetch_add(1);
+            if (writer_.load() == kNoWriter) return slot;
+            slots_[slot].readers.fetch_sub(1);
+            wakeWriter();
+            waitForWriter();
+        }
+    }
+
+    inline void unlockShared(size_t slot) RELEASE_SHARED() {
+        slots_[slot].readers.fetch_sub(1);
+        if (writer_.load() != kNoWriter) wakeWriter();
+    }
+
+    void lock() ACQUIRE();
+    void unlock() RELEASE();
+
+    /// must be called when locked, i.e. for assertion
+    inline bool isWriteLockedByThisThread() const {
+        return writerMutex_.isLockedByThisThread();
+    }
+};
+
+class SCOPED_CAPABILITY ReadLockGuard {
+    ReadLockGuard(const ReadLockGuard&) = delete;
+    ReadLockGuard& operator=(ReadLockGuard&) = delete;
+
+private:
+    RWLock& lock_;
+    const size_t slot_;
+
+public:
+    explicit ReadLockGuard(RWLock& lock) ACQUIRE_SHARED(lock)
+        : lock_(lock), slot_(lock.lockShared()) {}
+
+    ~ReadLockGuard() RELEASE() { lock_.unlockShared(slot_); }
+};
+
+class SCOPED_CAPABILITY WriteLockGuard {
+    WriteLockGuard(const WriteLockGuard&) = delete;
+    WriteLockGuard& operator=(WriteLockGuard&) = delete;
+
+private:
+    RWLock& lock_;
+
+public:
+    explicit WriteLockGuard(RWLock& lock) ACQUIRE(lock) : lock_(lock) {
+        lock_.lock();
+    }
+
+    ~WriteLockGuard() RELEASE() { lock_.unlock(); }
+};
+}  // namespace Lux
+
+#define ReadLockGuard(x) error "Missing guard object name"
+#define WriteLockGuard(x) error "Missing guard object name"
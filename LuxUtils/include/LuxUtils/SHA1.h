@@ -0,0 +1,46 @@
+/**
+ * @file SHA1.h
+ * @brief SHA-1 摘要 (RFC 3174)，仅用于协议握手等场景，不要用于安全用途
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Types.h>
+
+namespace Lux {
+
+/// @brief Incremental SHA-1.
+class SHA1 {
+public:
+    static const size_t kDigestLength = 20;
+
+private:
+    uint32_t state_[5];
+    uint64_t length_;  // total bytes
+    unsigned char block_[64];
+    size_t blockSize_;
+
+    void transform(const unsigned char* block);
+
+public:
+    SHA1();
+
+    void update(const void* data, size_t len);
+    void update(StringPiece data) { update(data.data(), data.size()); }
+
+    /// @brief Finish and return the 20-byte raw digest.
+    /// The object must not be updated afterwards.
+    string digest();
+
+    /// @brief One-shot raw digest of @c data.
+    static string digest(StringPiece data) {
+        SHA1 sha1;
+        sha1.update(data);
+        return sha1.digest();
+    }
+};
+
+}  // namespace Lux
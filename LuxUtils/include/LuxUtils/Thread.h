@@ -62,6 +62,8 @@ public:
 
     const std::string& name() const { return name_; }
 
-    static int numCreated() { return numCreated_.get(); }
+    static int numCreated() {
+        return numCreated_.get(std::memory_order_relaxed);
+    }
 };
 }  // namespace Lux
@@ -0,0 +1,256 @@
+/**
+ * @file ThreadPool.h
+ * @brief Work stealing thread pool with futures and continuations
+ *
+ * Each worker owns a WorkStealingDeque, tasks run by a worker are pushed to
+ * its own deque and popped LIFO, idle workers steal the oldest tasks of the
+ * others. Tasks from other threads go through a shared FIFO queue.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Condition.h>
+#include <LuxUtils/Mutex.h>
+#include <LuxUtils/Thread.h>
+#include <LuxUtils/Types.h>
+#include <LuxUtils/WorkStealingDeque.h>
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Lux {
+
+template <typename T>
+class Future;
+
+namespace detail {
+template <typename T>
+struct FutureState;
+}  // namespace detail
+
+class ThreadPool {
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&) = delete;
+
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+        std::unique_ptr<Lux::Thread> thread;
+    };
+
+    void workerFunc(int index);
+    /// @return a task of the worker, of the shared queue, or stolen
+    Task* take(int index);
+    /// wakes a sleeping worker, after a task is queued
+    void wakeOne();
+
+    const string name_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_;
+
+    Lux::MutexLock mutex_;
+    Lux::Condition cond_ GUARDED_BY(mutex_);
+    /// tasks from threads not of the pool
+    std::deque<Task*> queue_ GUARDED_BY(mutex_);
+    /// tasks queued and not yet taken, of all the queues
+    std::atomic<int64_t> queued_;
+    /// workers waiting for cond_
+    std::atomic<int> idle_;
+
+public:
+    explicit ThreadPool(const string& name = string("ThreadPool"));
+    /// Calls stop().
+    ~ThreadPool();
+
+    /// @brief Starts @c numThreads workers, the number of CPUs if 0.
+    void start(int numThreads = 0);
+    /// @brief Runs the queued tasks, including the ones they queue, then
+    /// joins the workers.
+    void stop();
+
+    /// @brief Queues @c task, runs it in the caller thread if the pool is not
+    /// started. Thread safe.
+    void run(Task task);
+
+    /// @brief Queues @c f, its result or exception is set to the future.
+    template <typename F>
+    auto submit(F&& f) -> Future<std::invoke_result_t<std::decay_t<F>>>;
+
+    const string& name() const { return name_; }
+    size_t size() const { return workers_.size(); }
+    /// tasks queued and not yet taken
+    int64_t queued() const { return queued_.load(std::memory_order_relaxed); }
+};
+
+namespace detail {
+/// @brief Shared by a Future and the task setting it.
+template <typename T>
+struct FutureState : std::enable_shared_from_this<FutureState<T>> {
+    using Value = std::conditional_t<std::is_void<T>::value, bool, T>;
+    using Continuation =
+        std::function<void(const std::shared_ptr<FutureState>&)>;
+
+    explicit FutureState(ThreadPool* pool)
+        : pool(pool), mutex(), cond(mutex), ready(false) {}
+
+    void setValue(Value v) {
+        {
+            MutexLockGuard lock(mutex);
+            value.emplace(std::move(v));
+        }
+        complete();
+    }
+    void setException(std::exception_ptr e) {
+        {
+            MutexLockGuard lock(mutex);
+            exception = std::move(e);
+        }
+        complete();
+    }
+
+    /// runs @c next on the pool once ready
+    void setContinuation(Continuation next) {
+        {
+            MutexLockGuard lock(mutex);
+            if (!ready) {
+                continuation = std::move(next);
+                return;
+            }
+        }
+        schedule(std::move(next));
+    }
+
+    void wait() {
+        MutexLockGuard lock(mutex);
+        while (!ready) cond.wait();
+    }
+
+    ThreadPool* const pool;
+    Lux::MutexLock mutex;
+    Lux::Condition cond GUARDED_BY(mutex);
+    bool ready GUARDED_BY(mutex);
+    std::optional<Value> value;
+    std::exception_ptr exception;
+    Continuation continuation GUARDED_BY(mutex);
+
+private:
+    void complete() {
+        Continuation next;
+        {
+            MutexLockGuard lock(mutex);
+            ready = true;
+            next = std::move(continuation);
+            cond.notifyAll();
+        }
+        if (next) schedule(std::move(next));
+    }
+    void schedule(Continuation next) {
+        std::shared_ptr<FutureState> self = this->shared_from_this();
+        pool->run([self, next] { next(self); });
+    }
+};
+
+/// @brief Calls @c f and sets its result or exception to @c state.
+template <typename T, typename F>
+void fulfil(FutureState<T>& state, F& f) {
+    try {
+        if constexpr (std::is_void<T>::value) {
+            f();
+            state.setValue(true);
+        } else {
+            state.setValue(f());
+        }
+    } catch (...) {
+        state.setException(std::current_exception());
+    }
+}
+
+template <typename F, typename T>
+struct ThenResult {
+    using type = std::invoke_result_t<F, T>;
+};
+template <typename F>
+struct ThenResult<F, void> {
+    using type = std::invoke_result_t<F>;
+};
+}  // namespace detail
+
+/// @brief The result of a task submitted to a ThreadPool. Not thread safe,
+/// get() and then() consume the value and can be called once.
+template <typename T>
+class Future {
+    std::shared_ptr<detail::FutureState<T>> state_;
+
+public:
+    Future() = default;
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state)
+        : state_(std::move(state)) {}
+
+    bool valid() const { return static_cast<bool>(state_); }
+
+    bool ready() const {
+        MutexLockGuard lock(state_->mutex);
+        return state_->ready;
+    }
+
+    void wait() const { state_->wait(); }
+
+    /// @brief Waits for the result, rethrows the exception of the task.
+    T get() {
+        std::shared_ptr<detail::FutureState<T>> state = std::move(state_);
+        state->wait();
+        if (state->exception) std::rethrow_exception(state->exception);
+        if constexpr (!std::is_void<T>::value) {
+            return std::move(*state->value);
+        }
+    }
+
+    /// @brief Runs @c f with the value on the pool once it is ready. If the
+    /// task threw, @c f is skipped and the exception is passed on.
+    template <typename F>
+    auto then(F&& f) -> Future<typename detail::ThenResult<F, T>::type> {
+        using R = typename detail::ThenResult<F, T>::type;
+        auto next = std::make_shared<detail::FutureState<R>>(state_->pool);
+        std::shared_ptr<detail::FutureState<T>> state = std::move(state_);
+        state->setContinuation(
+            [next, f = std::forward<F>(f)](
+                const std::shared_ptr<detail::FutureState<T>>& self) mutable {
+                if (self->exception) {
+                    next->setException(self->exception);
+                    return;
+                }
+                if constexpr (std::is_void<T>::value) {
+                    detail::fulfil(*next, f);
+                } else {
+                    auto call = [&] { return f(std::move(*self->value)); };
+                    detail::fulfil(*next, call);
+                }
+            });
+        return Future<R>(std::move(next));
+    }
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& f)
+    -> Future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto state = std::make_shared<detail::FutureState<R>>(this);
+    run([state, f = std::forward<F>(f)]() mutable {
+        detail::fulfil(*state, f);
+    });
+    return Future<R>(std::move(state));
+}
+
+}  // namespace Lux
@@ -0,0 +1,141 @@
+/**
+ * @file WorkStealingDeque.h
+ * @brief Chase-Lev work stealing deque, the owner pushes and pops at the
+ * bottom, other threads steal from the top
+ *
+ * "Dynamic Circular Work-Stealing Deque", Chase and Lev, SPAA 2005.
+ * The memory orders follow "Correct and Efficient Work-Stealing for Weak
+ * Memory Models", Lê et al., PPoPP 2013.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Lux {
+
+/// @brief Lock free for the owner and the thieves, grows when full. push()
+/// and pop() are called by the owner thread only, steal() by any thread.
+/// @tparam T trivially copyable, usually a pointer
+template <typename T>
+class WorkStealingDeque {
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&) = delete;
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "T must be trivially copyable");
+
+    /// a circular array of a power of two capacity
+    struct Array {
+        explicit Array(int64_t capacity)
+            : capacity(capacity),
+              mask(capacity - 1),
+              slots(new std::atomic<T>[static_cast<size_t>(capacity)]) {}
+
+        T get(int64_t i) const {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, T x) {
+            slots[i & mask].store(x, std::memory_order_relaxed);
+        }
+        Array* grow(int64_t bottom, int64_t top) const {
+            Array* array = new Array(capacity * 2);
+            for (int64_t i = top; i != bottom; ++i) array->put(i, get(i));
+            return array;
+        }
+
+        const int64_t capacity;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    alignas(64) std::atomic<int64_t> top_;
+    alignas(64) std::atomic<int64_t> bottom_;
+    std::atomic<Array*> array_;
+    /// replaced arrays, a thief may still read them, freed with the deque
+    std::vector<std::unique_ptr<Array>> retired_;
+
+public:
+    /// @param capacity rounded up to a power of two
+    explicit WorkStealingDeque(int64_t capacity = 256)
+        : top_(0), bottom_(0) {
+        int64_t n = 1;
+        while (n < capacity) n *= 2;
+        array_.store(new Array(n), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque() { delete array_.load(std::memory_order_relaxed); }
+
+    /// Owner only.
+    void push(T x) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            retired_.emplace_back(a);
+            a = a->grow(b, t);
+            array_.store(a, std::memory_order_release);
+        }
+        a->put(b, x);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /// @brief Owner only, the last pushed first.
+    /// @return false if empty, or the last one is stolen
+    bool pop(T* x) {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        *x = a->get(b);
+        if (t == b) {
+            // the last one, race with the thieves
+            bool won = top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /// @brief Any thread, the first pushed first.
+    /// @return false if empty, or another thread took it
+    bool steal(T* x) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return false;
+
+        Array* a = array_.load(std::memory_order_acquire);
+        T value = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;
+        }
+        *x = value;
+        return true;
+    }
+
+    /// An estimate, exact only in the owner thread without thieves.
+    int64_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+    bool empty() const { return size() == 0; }
+};
+
+}  // namespace Lux
@@ -0,0 +1,53 @@
+/**
+ * @file AdaptiveMutex.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/AdaptiveMutex.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+using namespace Lux;
+
+const int AdaptiveMutex::kMaxSpins;
+
+void Lux::detail::futexWait(std::atomic<int>* word, int expected) {
+    ::syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAIT_PRIVATE,
+              expected, nullptr, nullptr, 0);
+}
+
+void Lux::detail::futexWake(std::atomic<int>* word, int count) {
+    ::syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAKE_PRIVATE,
+              count, nullptr, nullptr, 0);
+}
+
+void AdaptiveMutex::lockSlow() {
+    int spins = spins_.load(std::memory_order_relaxed);
+    int maxSpins = std::min(kMaxSpins, spins * 2 + 10);
+    int n = 0;
+    for (; n < maxSpins; ++n) {
+        detail::cpuRelax();
+        int expected = kUnlocked;
+        // read before the CAS, so that spinners do not steal the cache line
+        if (state_.load(std::memory_order_relaxed) == kUnlocked &&
+            state_.compare_exchange_weak(expected, kLocked,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    // a moving average, as glibc does for adaptive mutexes
+    spins_.store(spins + (n - spins) / 8, std::memory_order_relaxed);
+    if (n < maxSpins) return;
+
+    // from now on the state says a thread may sleep, unlock() wakes one
+    while (state_.exchange(kContended, std::memory_order_acquire) !=
+           kUnlocked) {
+        detail::futexWait(&state_, kContended);
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file Base64.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/Base64.h>
+
+using namespace Lux;
+
+namespace {
+const char kStdAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char kUrlAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+string encodeWith(StringPiece data, const char* alphabet, bool pad) {
+    string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+
+    const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        uint32_t n = (static_cast<uint32_t>(p[i]) << 16) |
+                     (static_cast<uint32_t>(p[i + 1]) << 8) | p[i + 2];
+        out.push_back(alphabet[(n >> 18) & 0x3F]);
+        out.push_back(alphabet[(n >> 12) & 0x3F]);
+        out.push_back(alphabet[(n >> 6) & 0x3F]);
+        out.push_back(alphabet[n & 0x3F]);
+    }
+
+    size_t rest = data.size() - i;
+    if (rest > 0) {
+        uint32_t n = static_cast<uint32_t>(p[i]) << 16;
+        if (rest == 2) n |= static_cast<uint32_t>(p[i + 1]) << 8;
+        out.push_back(alphabet[(n >> 18) & 0x3F]);
+        out.push_back(alphabet[(n >> 12) & 0x3F]);
+        if (rest == 2) out.push_back(alphabet[(n >> 6) & 0x3F]);
+        if (pad) out.append(rest == 1 ? "==" : "=");
+    }
+    return out;
+}
+
+/// @return 6-bit value of @c c, or -1 if @c c is not in either alphabet
+int decodeChar(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return -1;
+}
+}  // namespace
+
+string Base64::encode(StringPiece data) {
+    return encodeWith(data, kStdAlphabet, true);
+}
+
+string Base64::encodeUrl(StringPiece data) {
+    return encodeWith(data, kUrlAlphabet, false);
+}
+
+bool Base64::decode(StringPiece data, string* out) {
+    while (!data.empty() && data.back() == '=') data.remove_suffix(1);
+    if (data.size() % 4 == 1) return false;
+
+    out->clear();
+    out->reserve(data.size() * 3 / 4);
+
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : data) {
+        int v = decodeChar(c);
+        if (v < 0) return false;
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out->push_back(static_cast<char>((acc >> bits) & 0xFF));
+        }
+    }
+    return true;
+}
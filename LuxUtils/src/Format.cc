@@ -0,0 +1,146 @@
+/**
+ * @file Format.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/Format.h>
+
+#include <algorithm>  // reverse, copy, fill_n
+#include <cstdio>
+#include <cstring>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+using namespace Lux;
+
+const char format::detail::kDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+size_t format::formatHex(char* buf, uintptr_t value) {
+    static const char digitsHex[] = "0123456789ABCDEF";
+    char* p = buf;
+    do {
+        *p++ = digitsHex[value % 16];
+        value /= 16;
+    } while (value != 0);
+    std::reverse(buf, p);
+    return static_cast<size_t>(p - buf);
+}
+
+namespace {
+
+/// exponents in [kMinFixedExponent, kMaxFixedExponent) are written in fixed
+/// notation, e.g. 100000 and 0.0001, the others in scientific, e.g. 1e+100
+const int kMinFixedExponent = -5;
+const int kMaxFixedExponent = 15;
+
+/**
+ * @brief Rewrites the scientific text in buf, e.g. "-1.25e+05", in fixed
+ * notation if its exponent is in range, with the same digits.
+ * @return the new length
+ */
+size_t toFixedNotation(char* buf, size_t len) {
+    const char* e = static_cast<const char*>(::memchr(buf, 'e', len));
+    if (e == nullptr) return len;  // nan, inf
+    // not atoi(), the text is not terminated
+    const char* end = buf + len;
+    const char* q = e + 1;
+    bool negativeExponent = *q == '-';
+    if (*q == '-' || *q == '+') ++q;
+    int exponent = 0;
+    for (; q < end; ++q) exponent = exponent * 10 + (*q - '0');
+    if (negativeExponent) exponent = -exponent;
+    if (exponent < kMinFixedExponent || exponent >= kMaxFixedExponent) {
+        return len;
+    }
+
+    const char* p = buf;
+    bool negative = *p == '-';
+    if (negative) ++p;
+    // the significant digits, without the point
+    char digits[format::kMaxDoubleSize];
+    size_t numDigits = 0;
+    for (; p < e; ++p) {
+        if (*p != '.') digits[numDigits++] = *p;
+    }
+
+    char* out = buf;
+    if (negative) *out++ = '-';
+    if (exponent < 0) {
+        *out++ = '0';
+        *out++ = '.';
+        out = std::fill_n(out, -exponent - 1, '0');
+        out = std::copy(digits, digits + numDigits, out);
+    } else {
+        size_t intDigits = static_cast<size_t>(exponent) + 1;
+        if (numDigits <= intDigits) {
+            out = std::copy(digits, digits + numDigits, out);
+            out = std::fill_n(out, intDigits - numDigits, '0');
+        } else {
+            out = std::copy(digits, digits + intDigits, out);
+            *out++ = '.';
+            out = std::copy(digits + intDigits, digits + numDigits, out);
+        }
+    }
+    return static_cast<size_t>(out - buf);
+}
+
+#if !defined(__cpp_lib_to_chars) || __cpp_lib_to_chars < 201611L
+/// "1.2500000000000000e+05" to "1.25e+05"
+size_t trimMantissa(char* buf, size_t len) {
+    char* e = static_cast<char*>(::memchr(buf, 'e', len));
+    if (e == nullptr) return len;
+    char* end = e;
+    while (end[-1] == '0') --end;
+    if (end[-1] == '.') --end;
+    size_t expLen = static_cast<size_t>(buf + len - e);
+    ::memmove(end, e, expLen);
+    return static_cast<size_t>(end - buf) + expLen;
+}
+#endif
+
+}  // namespace
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+
+// shortest digits, then placed by the exponent
+size_t format::formatDouble(char* buf, double value) {
+    std::to_chars_result result = std::to_chars(
+        buf, buf + kMaxDoubleSize, value, std::chars_format::scientific);
+    return toFixedNotation(buf, static_cast<size_t>(result.ptr - buf));
+}
+
+size_t format::formatDouble(char* buf, float value) {
+    std::to_chars_result result = std::to_chars(
+        buf, buf + kMaxDoubleSize, value, std::chars_format::scientific);
+    return toFixedNotation(buf, static_cast<size_t>(result.ptr - buf));
+}
+
+#else  // no floating point std::to_chars
+
+// enough digits to read back the same value, not always the shortest
+size_t format::formatDouble(char* buf, double value) {
+    int len = ::snprintf(buf, kMaxDoubleSize, "%.16e", value);
+    return toFixedNotation(buf, trimMantissa(buf, static_cast<size_t>(len)));
+}
+
+size_t format::formatDouble(char* buf, float value) {
+    int len = ::snprintf(buf, kMaxDoubleSize, "%.8e",
+                         static_cast<double>(value));
+    return toFixedNotation(buf, trimMantissa(buf, static_cast<size_t>(len)));
+}
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * @file MappedINI.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/MappedINI.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Lux;
+using namespace Lux::INIParser;
+
+namespace {
+
+const char kWhitespace[] = " \t\n\r\f\v";
+/// mapping of an empty file, which mmap() refuses
+const char kEmpty[] = "";
+
+inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/// the whole of @c text is an integer
+bool parseInt(std::string_view text, int64_t* value) {
+    const char* end = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), end, *value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+}  // namespace
+
+size_t detail::CaseInsensitiveHash::operator()(std::string_view s) const {
+    // FNV-1a
+    size_t h = 14695981039346656037ULL;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(lower(c));
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool detail::CaseInsensitiveEqual::operator()(std::string_view lhs,
+                                              std::string_view rhs) const {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (lower(lhs[i]) != lower(rhs[i])) return false;
+    }
+    return true;
+}
+
+MappedINI::MappedINI()
+    : data_(nullptr),
+      mapSize_(0),
+      text_(nullptr, nullptr),
+      indexed_(false) {}
+
+MappedINI::~MappedINI() { unmap(); }
+
+void MappedINI::unmap() {
+    if (mapSize_ > 0) {
+        ::munmap(const_cast<char*>(data_), mapSize_);
+    }
+    data_ = nullptr;
+    mapSize_ = 0;
+    text_ = Range(nullptr, nullptr);
+    indexed_ = false;
+    sections_.clear();
+    unescapedKeys_.clear();
+}
+
+int MappedINI::open(StringArg fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno;
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        int err = errno;
+        ::close(fd);
+        return err;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    const char* data = kEmpty;
+    if (size > 0) {
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            return err;
+        }
+        data = static_cast<const char*>(p);
+    }
+    // the mapping holds the inode
+    ::close(fd);
+
+    string name(fileName.c_str());
+    unmap();
+    fileName_.swap(name);
+    data_ = data;
+    mapSize_ = size;
+    text_ = Range(data, data + size);
+    if (size >= 3 && ::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        text_.first += 3;
+    }
+    return 0;
+}
+
+int MappedINI::reload() {
+    // open() replaces fileName_, so take a copy
+    string fileName(fileName_);
+    return open(fileName);
+}
+
+std::string_view MappedINI::nextLine(Range* rest) {
+    const char* begin = rest->first;
+    size_t len = static_cast<size_t>(rest->second - begin);
+    const char* eol = static_cast<const char*>(::memchr(begin, '\n', len));
+    if (eol == nullptr) {
+        rest->first = rest->second;
+        return std::string_view(begin, len);
+    }
+    rest->first = eol + 1;
+    return std::string_view(begin, static_cast<size_t>(eol - begin));
+}
+
+std::string_view MappedINI::trim(std::string_view s) {
+    size_t first = s.find_first_not_of(kWhitespace);
+    if (first == std::string_view::npos) return std::string_view();
+    size_t last = s.find_last_not_of(kWhitespace);
+    return s.substr(first, last - first + 1);
+}
+
+bool MappedINI::parseKeyValue(std::string_view line, std::string_view* key,
+                              std::string_view* value) {
+    line = trim(line);
+    if (line.empty() || line[0] == ';') return false;
+
+    // the first '=' not escaped as "\="
+    size_t equalsAt = 0;
+    while ((equalsAt = line.find('=', equalsAt)) != std::string_view::npos) {
+        if (equalsAt == 0 || line[equalsAt - 1] != '\\') break;
+        ++equalsAt;
+    }
+    if (equalsAt == std::string_view::npos) return false;
+
+    *key = trim(line.substr(0, equalsAt));
+    *value = trim(line.substr(equalsAt + 1));
+    return true;
+}
+
+void MappedINI::indexSections() const {
+    indexed_ = true;
+    Range rest = text_;
+    Section* current = nullptr;
+    const char* bodyBegin = nullptr;
+
+    while (rest.first < rest.second) {
+        const char* lineBegin = rest.first;
+        std::string_view line = trim(nextLine(&rest));
+        if (line.empty() || line[0] != '[') continue;
+
+        // trailing comment is allowed on a section line
+        std::string_view header = line.substr(0, line.find(';'));
+        size_t closingAt = header.rfind(']');
+        if (closingAt == std::string_view::npos) continue;
+
+        if (current != nullptr) {
+            current->bodies.emplace_back(bodyBegin, lineBegin);
+        }
+        current = &sections_[trim(header.substr(1, closingAt - 1))];
+        bodyBegin = rest.first;
+    }
+    if (current != nullptr) {
+        current->bodies.emplace_back(bodyBegin, text_.second);
+    }
+}
+
+const MappedINI::Section* MappedINI::findSection(
+    std::string_view section) const {
+    if (!indexed_) indexSections();
+
+    auto it = sections_.find(trim(section));
+    if (it == sections_.end()) return nullptr;
+
+    Section& s = it->second;
+    if (!s.indexed) {
+        s.indexed = true;
+        for (Range body : s.bodies) {
+            while (body.first < body.second) {
+                std::string_view key, value;
+                if (!parseKeyValue(nextLine(&body), &key, &value)) continue;
+                if (key.find("\\=") != std::string_view::npos) {
+                    string unescaped(key);
+                    size_t pos = 0;
+                    while ((pos = unescaped.find("\\=", pos)) !=
+                           string::npos) {
+                        unescaped.erase(pos, 1);
+                        ++pos;
+                    }
+                    unescapedKeys_.push_back(std::move(unescaped));
+                    key = unescapedKeys_.back();
+                }
+                // later keys override the earlier ones
+                s.keys[key] = value;
+            }
+        }
+    }
+    return &s;
+}
+
+bool MappedINI::has(std::string_view section) const {
+    if (!indexed_) indexSections();
+    return sections_.count(trim(section)) == 1;
+}
+
+bool MappedINI::has(std::string_view section, std::string_view key) const {
+    const Section* s = findSection(section);
+    return s != nullptr && s->keys.count(trim(key)) == 1;
+}
+
+std::string_view MappedINI::get(std::string_view section,
+                                std::string_view key,
+                                std::string_view defaultValue) const {
+    const Section* s = findSection(section);
+    if (s == nullptr) return defaultValue;
+    auto it = s->keys.find(trim(key));
+    return it == s->keys.end() ? defaultValue : it->second;
+}
+
+size_t MappedINI::sectionCount() const {
+    if (!indexed_) indexSections();
+    return sections_.size();
+}
+
+int64_t MappedINI::getInt(std::string_view section, std::string_view key,
+                          int64_t defaultValue) const {
+    int64_t value;
+    return parseInt(get(section, key), &value) ? value : defaultValue;
+}
+
+int64_t MappedINI::getSize(std::string_view section, std::string_view key,
+                           int64_t defaultValue) const {
+    std::string_view text = get(section, key);
+    if (text.empty()) return defaultValue;
+
+    int shift = 0;
+    switch (lower(text.back())) {
+        case 'k':
+            shift = 10;
+            break;
+        case 'm':
+            shift = 20;
+            break;
+        case 'g':
+            shift = 30;
+            break;
+        default:
+            break;
+    }
+    if (shift != 0) text = trim(text.substr(0, text.size() - 1));
+
+    int64_t value;
+    if (!parseInt(text, &value) || value < 0 ||
+        value > (INT64_MAX >> shift)) {
+        return defaultValue;
+    }
+    return value << shift;
+}
+
+double MappedINI::getDouble(std::string_view section, std::string_view key,
+                            double defaultValue) const {
+    std::string_view text = get(section, key);
+    if (text.empty()) return defaultValue;
+
+    // strtod() needs the '\0'
+    string copy(text);
+    char* end = nullptr;
+    double value = ::strtod(copy.c_str(), &end);
+    return end == copy.c_str() + copy.size() ? value : defaultValue;
+}
+
+bool MappedINI::getBool(std::string_view section, std::string_view key,
+                        bool defaultValue) const {
+    std::string_view text = get(section, key);
+    detail::CaseInsensitiveEqual equal;
+    for (const char* yes : {"true", "yes", "on", "1"}) {
+        if (equal(text, yes)) return true;
+    }
+    for (const char* no : {"false", "no", "off", "0"}) {
+        if (equal(text, no)) return false;
+    }
+    return defaultValue;
+}
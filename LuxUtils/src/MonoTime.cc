@@ -0,0 +1,40 @@
+/**
+ * @file MonoTime.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/MonoTime.h>
+#include <inttypes.h>  // PRId64
+
+#include <cstdio>
+#include <ctime>  // clock_gettime
+
+using namespace Lux;
+
+static_assert(sizeof(MonoTime) == sizeof(int64_t),
+              "MonoTime should be same size as int64_t");
+
+MonoTime MonoTime::now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return MonoTime(static_cast<int64_t>(ts.tv_sec) *
+                        Timestamp::kMicroSecondsPerSecond +
+                    ts.tv_nsec / 1000);
+}
+
+MonoTime MonoTime::fromTimestamp(Timestamp wall) {
+    int64_t delta = wall.microSecondsSinceEpoch() -
+                    Timestamp::now().microSecondsSinceEpoch();
+    return MonoTime(now().microSeconds() + delta);
+}
+
+string MonoTime::toString() const {
+    char buf[32] = {0};
+    int64_t seconds = microSeconds_ / Timestamp::kMicroSecondsPerSecond;
+    int64_t microseconds = microSeconds_ % Timestamp::kMicroSecondsPerSecond;
+    snprintf(buf, sizeof(buf), "%" PRId64 ".%06" PRId64 "", seconds,
+             microseconds);
+    return buf;
+}
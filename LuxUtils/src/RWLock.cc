@@ -0,0 +1,92 @@
+/**
+ * @file RWLock.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/RWLock.h>
+#include <sched.h>   // sched_getcpu
+#include <unistd.h>  // sysconf
+
+#include <climits>
+
+using namespace Lux;
+
+namespace {
+size_t numSlots() {
+    long cpus = ::sysconf(_SC_NPROCESSORS_CONF);
+    size_t n = 1;
+    while (n < static_cast<size_t>(cpus > 0 ? cpus : 1)) n *= 2;
+    return n;
+}
+}  // namespace
+
+RWLock::RWLock()
+    : mask_(numSlots() - 1),
+      slots_(new Slot[mask_ + 1]),
+      writerMutex_(),
+      writer_(kNoWriter),
+      drained_(0) {}
+
+size_t RWLock::currentSlot() const {
+    // a vDSO call, or a read of the rseq area
+    int cpu = ::sched_getcpu();
+    if (cpu < 0) cpu = CurrentThread::tid();
+    return static_cast<size_t>(cpu) & mask_;
+}
+
+bool RWLock::noReaders() const {
+    for (size_t i = 0; i <= mask_; ++i) {
+        if (slots_[i].readers.load() != 0) return false;
+    }
+    return true;
+}
+
+void RWLock::waitForWriter() {
+    for (int i = 0; i < kSpins; ++i) {
+        if (writer_.load(std::memory_order_acquire) == kNoWriter) return;
+        detail::cpuRelax();
+    }
+    int writer = writer_.load(std::memory_order_relaxed);
+    while (writer != kNoWriter) {
+        // tells unlock() to wake us
+        if (writer == kWriter &&
+            !writer_.compare_exchange_weak(writer, kWriterReadersSleep,
+                                           std::memory_order_relaxed)) {
+            continue;
+        }
+        detail::futexWait(&writer_, kWriterReadersSleep);
+        writer = writer_.load(std::memory_order_relaxed);
+    }
+}
+
+void RWLock::wakeWriter() {
+    drained_.fetch_add(1);
+    detail::futexWake(&drained_, 1);
+}
+
+void RWLock::lock() {
+    writerMutex_.lock();
+    // seq_cst, pairs with the readers incrementing and then loading writer_
+    writer_.store(kWriter);
+    int spins = 0;
+    while (true) {
+        // read before the counters, a reader leaving later changes it
+        int drained = drained_.load();
+        if (noReaders()) break;
+        if (spins < kSpins) {
+            ++spins;
+            detail::cpuRelax();
+        } else {
+            detail::futexWait(&drained_, drained);
+        }
+    }
+}
+
+void RWLock::unlock() {
+    if (writer_.exchange(kNoWriter) == kWriterReadersSleep) {
+        detail::futexWake(&writer_, INT_MAX);
+    }
+    writerMutex_.unlock();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file SHA1.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/SHA1.h>
+
+#include <algorithm>
+
+using namespace Lux;
+
+const size_t SHA1::kDigestLength;
+
+namespace {
+inline uint32_t rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+}  // namespace
+
+SHA1::SHA1() : length_(0), blockSize_(0) {
+    state_[0] = 0x67452301;
+    state_[1] = 0xEFCDAB89;
+    state_[2] = 0x98BADCFE;
+    state_[3] = 0x10325476;
+    state_[4] = 0xC3D2E1F0;
+}
+
+void SHA1::transform(const unsigned char* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(block[4 * i]) << 24) |
+               (static_cast<uint32_t>(block[4 * i + 1]) << 16) |
+               (static_cast<uint32_t>(block[4 * i + 2]) << 8) |
+               block[4 * i + 3];
+    }
+    for (int i = 16; i < 80; ++i) {
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3],
+             e = state_[4];
+    for (int i = 0; i < 80; ++i) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+}
+
+void SHA1::update(const void* data, size_t len) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    length_ += len;
+
+    if (blockSize_ > 0) {
+        size_t n = std::min(len, sizeof block_ - blockSize_);
+        memcpy(block_ + blockSize_, p, n);
+        blockSize_ += n;
+        p += n;
+        len -= n;
+        if (blockSize_ < sizeof block_) return;
+        transform(block_);
+        blockSize_ = 0;
+    }
+
+    for (; len >= sizeof block_; p += sizeof block_, len -= sizeof block_) {
+        transform(p);
+    }
+    memcpy(block_, p, len);
+    blockSize_ = len;
+}
+
+string SHA1::digest() {
+    uint64_t bits = length_ * 8;
+
+    // 0x80, zeros, then the 64-bit big-endian length
+    unsigned char padding[72] = {0x80};
+    size_t padLength = blockSize_ < 56 ? 56 - blockSize_ : 120 - blockSize_;
+    update(padding, padLength);
+    for (int i = 0; i < 8; ++i) {
+        padding[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    }
+    update(padding, 8);
+
+    string result(kDigestLength, '\0');
+    for (size_t i = 0; i < kDigestLength; ++i) {
+        result[i] = static_cast<char>(state_[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    return result;
+}
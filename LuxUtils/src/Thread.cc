@@ -175,7 +175,7 @@ Thread::~Thread() {
 
 /// @brief Set the name of thread to "Thread..."
 void Thread::setDefaultName() {
-    int num = numCreated_.incrementAndGet();
+    int num = numCreated_.incrementAndGet(std::memory_order_relaxed);
     if (name_.empty()) {
         char buf[32];
         snprintf(buf, sizeof(buf), "Thread%d", num);
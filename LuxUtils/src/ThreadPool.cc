@@ -0,0 +1,154 @@
+/**
+ * @file ThreadPool.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxUtils/ThreadPool.h>
+#include <unistd.h>  // sysconf
+
+#include <cassert>
+#include <cstdio>
+
+using namespace Lux;
+
+namespace {
+/// the pool and the index of the current worker thread
+__thread ThreadPool* t_pool = nullptr;
+__thread int t_index = -1;
+__thread uint32_t t_random = 0;
+
+/// xorshift, picks the first victim to steal from
+uint32_t nextRandom() {
+    uint32_t x = t_random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    t_random = x;
+    return x;
+}
+}  // namespace
+
+ThreadPool::ThreadPool(const string& name)
+    : name_(name),
+      running_(false),
+      mutex_(),
+      cond_(mutex_),
+      queued_(0),
+      idle_(0) {}
+
+ThreadPool::~ThreadPool() {
+    if (running_) stop();
+}
+
+void ThreadPool::start(int numThreads) {
+    assert(workers_.empty());
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(::sysconf(_SC_NPROCESSORS_ONLN));
+        if (numThreads <= 0) numThreads = 1;
+    }
+    running_ = true;
+    workers_.reserve(static_cast<size_t>(numThreads));
+    for (int i = 0; i < numThreads; ++i) {
+        workers_.emplace_back(new Worker);
+    }
+    // all deques exist before a worker steals
+    for (int i = 0; i < numThreads; ++i) {
+        char id[32];
+        snprintf(id, sizeof id, "%d", i + 1);
+        workers_[static_cast<size_t>(i)]->thread.reset(new Lux::Thread(
+            std::bind(&ThreadPool::workerFunc, this, i), name_ + id));
+        workers_[static_cast<size_t>(i)]->thread->start();
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        MutexLockGuard lock(mutex_);
+        running_ = false;
+        cond_.notifyAll();
+    }
+    for (auto& worker : workers_) {
+        worker->thread->join();
+    }
+    workers_.clear();
+}
+
+void ThreadPool::run(Task task) {
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+
+    Task* t = new Task(std::move(task));
+    if (t_pool == this) {
+        workers_[static_cast<size_t>(t_index)]->deque.push(t);
+        queued_.fetch_add(1);
+        // pairs with idle_ in workerFunc(), one of them sees the other
+        if (idle_.load() > 0) wakeOne();
+    } else {
+        MutexLockGuard lock(mutex_);
+        queue_.push_back(t);
+        queued_.fetch_add(1);
+        cond_.notify();
+    }
+}
+
+void ThreadPool::wakeOne() {
+    MutexLockGuard lock(mutex_);
+    cond_.notify();
+}
+
+ThreadPool::Task* ThreadPool::take(int index) {
+    Task* task = nullptr;
+    if (workers_[static_cast<size_t>(index)]->deque.pop(&task)) {
+        return task;
+    }
+
+    if (queued_.load(std::memory_order_relaxed) == 0) return nullptr;
+    {
+        MutexLockGuard lock(mutex_);
+        if (!queue_.empty()) {
+            task = queue_.front();
+            queue_.pop_front();
+            return task;
+        }
+    }
+
+    size_t n = workers_.size();
+    size_t first = nextRandom() % n;
+    for (size_t i = 0; i < n; ++i) {
+        size_t victim = (first + i) % n;
+        if (victim == static_cast<size_t>(index)) continue;
+        if (workers_[victim]->deque.steal(&task)) return task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::workerFunc(int index) {
+    t_pool = this;
+    t_index = index;
+    t_random = static_cast<uint32_t>(index) * 2654435761u + 1;
+
+    while (true) {
+        if (Task* task = take(index)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            std::unique_ptr<Task> owner(task);
+            (*owner)();
+            continue;
+        }
+
+        MutexLockGuard lock(mutex_);
+        idle_.fetch_add(1);
+        while (queued_.load() == 0 && running_) {
+            cond_.wait();
+        }
+        idle_.fetch_sub(1);
+        // stopped, and all the queued tasks are done
+        if (queued_.load() == 0 && !running_) break;
+    }
+
+    t_pool = nullptr;
+    t_index = -1;
+}
@@ -1,6 +1,10 @@
 #include <LuxUtils/Atomic.h>
 #include <assert.h>
 
+#include <cstdint>
+#include <thread>
+#include <vector>
+
 int main() {
     {
         Lux::AtomicInt64 a0;
@@ -33,4 +37,44 @@ int main() {
         assert(a1.getAndSet(100) == 2);
         assert(a1.get() == 100);
     }
+
+    {
+        Lux::AtomicInt32 a2;
+        a2.set(7, std::memory_order_release);
+        assert(a2.get(std::memory_order_acquire) == 7);
+        assert(a2.incrementAndGet(std::memory_order_relaxed) == 8);
+        int32_t expected = 0;
+        assert(!a2.compareAndSet(&expected, 1));
+        assert(expected == 8);
+        assert(a2.compareAndSet(&expected, 1, std::memory_order_acq_rel));
+        assert(a2.get() == 1);
+    }
+
+    {
+        // one cache line each
+        static_assert(sizeof(Lux::PaddedAtomicInt64) == 64, "padded");
+        static_assert(alignof(Lux::PaddedAtomicInt32) == 64, "aligned");
+        Lux::PaddedAtomicInt64 counters[4];
+        counters[1].increment(std::memory_order_relaxed);
+        assert(counters[0].get() == 0 && counters[1].get() == 1);
+        assert(reinterpret_cast<uintptr_t>(&counters[1]) % 64 == 0);
+    }
+
+    {
+        const int kThreads = 4;
+        const int kCount = 100000;
+        Lux::ShardedCounter counter(5);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&counter] {
+                for (int i = 0; i < kCount; ++i) counter.increment();
+                counter.add(10);
+                counter.decrement();
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        assert(counter.get() == kThreads * (kCount + 9));
+        counter.reset();
+        assert(counter.get() == 0);
+    }
 }
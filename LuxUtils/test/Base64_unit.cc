@@ -0,0 +1,30 @@
+#include <LuxUtils/Base64.h>
+#include <assert.h>
+
+using namespace Lux;
+
+int main() {
+    // RFC 4648 test vectors
+    assert(Base64::encode("") == "");
+    assert(Base64::encode("f") == "Zg==");
+    assert(Base64::encode("fo") == "Zm8=");
+    assert(Base64::encode("foo") == "Zm9v");
+    assert(Base64::encode("foob") == "Zm9vYg==");
+    assert(Base64::encode("fooba") == "Zm9vYmE=");
+    assert(Base64::encode("foobar") == "Zm9vYmFy");
+
+    assert(Base64::encodeUrl("\xfb\xff") == "-_8");
+
+    string out;
+    assert(Base64::decode("Zm9vYmFy", &out) && out == "foobar");
+    assert(Base64::decode("Zm9vYg==", &out) && out == "foob");
+    assert(Base64::decode("Zm9vYg", &out) && out == "foob");
+    assert(Base64::decode("-_8", &out) && out == "\xfb\xff");
+    assert(!Base64::decode("Zm9v!", &out));
+    assert(!Base64::decode("Z", &out));
+
+    string binary;
+    for (int i = 0; i < 256; ++i) binary.push_back(static_cast<char>(i));
+    assert(Base64::decode(Base64::encode(binary), &out) && out == binary);
+    assert(Base64::decode(Base64::encodeUrl(binary), &out) && out == binary);
+}
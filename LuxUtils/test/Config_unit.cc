@@ -0,0 +1,111 @@
+#include <LuxUtils/Config.h>
+#include <LuxUtils/Thread.h>
+#include <LuxUtils/Timestamp.h>
+#include <assert.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Lux;
+
+struct Tunables {
+    int numThreads = 4;
+    /// always numThreads * 1024, to check a snapshot is never torn
+    long bufferSize = 4 * 1024;
+    std::string name = "default";
+};
+
+void testPublish() {
+    Config<Tunables> config;
+    assert(config.version() == 1);
+    assert(config.snapshot()->numThreads == 4);
+
+    Config<Tunables>::Reader reader(config);
+    assert(reader.changed());
+    assert(reader->numThreads == 4);
+    assert(!reader.changed());
+
+    std::shared_ptr<const Tunables> kept = config.snapshot();
+
+    Tunables next;
+    next.numThreads = 8;
+    next.bufferSize = 8 * 1024;
+    next.name = "next";
+    config.publish(next);
+    assert(config.version() == 2);
+    assert(reader.changed());
+    assert((*reader).name == "next");
+    assert(reader->numThreads == 8);
+
+    // a snapshot taken before is not modified
+    assert(kept->numThreads == 4);
+    assert(kept->name == "default");
+    // the reader moved on, kept is the last owner
+    assert(kept.use_count() == 1);
+}
+
+void testConcurrent() {
+    Config<Tunables> config;
+    std::atomic<bool> done(false);
+    std::atomic<long> reads(0);
+
+    std::vector<std::unique_ptr<Thread>> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back(new Thread([&config, &done, &reads] {
+            Config<Tunables>::Reader reader(config);
+            long n = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                const Tunables& t = reader.get();
+                assert(t.bufferSize == t.numThreads * 1024L);
+                ++n;
+                if (n % 1024 == 0) std::this_thread::yield();
+            }
+            reads.fetch_add(n);
+        }));
+        readers.back()->start();
+    }
+
+    for (int i = 1; i <= 10000; ++i) {
+        Tunables next;
+        next.numThreads = i;
+        next.bufferSize = i * 1024L;
+        config.publish(next);
+    }
+    done = true;
+    for (auto& thr : readers) thr->join();
+    assert(config.snapshot()->numThreads == 10000);
+    printf("%ld reads\n", reads.load());
+}
+
+void benchmark() {
+    const int kCount = 10 * 1000 * 1000;
+    Config<Tunables> config;
+    Config<Tunables>::Reader reader(config);
+    long sum = 0;
+
+    Timestamp start(Timestamp::now());
+    for (int i = 0; i < kCount; ++i) {
+        sum += reader->numThreads;
+    }
+    double readerTime = timeDifference(Timestamp::now(), start);
+
+    start = Timestamp::now();
+    for (int i = 0; i < kCount / 10; ++i) {
+        sum += config.snapshot()->numThreads;
+    }
+    double snapshotTime = timeDifference(Timestamp::now(), start) * 10;
+
+    printf("%d reads: Reader %f snapshot() %f (%ld)\n", kCount, readerTime,
+           snapshotTime, sum);
+}
+
+int main() {
+    testPublish();
+    testConcurrent();
+    benchmark();
+    printf("Config tests passed\n");
+}
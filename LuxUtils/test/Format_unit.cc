@@ -0,0 +1,153 @@
+#include <LuxUtils/Format.h>
+#include <LuxUtils/Timestamp.h>
+#include <assert.h>
+#include <inttypes.h>  // PRId64 PRIu64
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace Lux;
+
+template <typename T>
+std::string decimal(T value) {
+    char buf[format::kMaxIntegerSize];
+    return std::string(buf, format::formatDecimal(buf, value));
+}
+
+std::string shortest(double value) {
+    char buf[format::kMaxDoubleSize];
+    return std::string(buf, format::formatDouble(buf, value));
+}
+
+void testIntegers() {
+    char expected[32];
+    // around every power of ten
+    uint64_t power = 1;
+    for (int i = 0; i < 20; ++i) {
+        for (uint64_t v : {power - 1, power, power + 1}) {
+            snprintf(expected, sizeof expected, "%" PRIu64, v);
+            assert(decimal(v) == expected);
+            int64_t s = -static_cast<int64_t>(v);
+            snprintf(expected, sizeof expected, "%" PRId64, s);
+            assert(decimal(s) == expected);
+        }
+        power *= 10;
+    }
+    assert(decimal(0) == "0");
+    assert(decimal(std::numeric_limits<int64_t>::min()) ==
+           "-9223372036854775808");
+    assert(decimal(std::numeric_limits<uint64_t>::max()) ==
+           "18446744073709551615");
+    assert(decimal(std::numeric_limits<int32_t>::min()) == "-2147483648");
+    assert(decimal(static_cast<short>(-7)) == "-7");
+    assert(decimal(static_cast<unsigned char>(200)) == "200");
+
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 100000; ++i) {
+        int64_t v = static_cast<int64_t>(random()) >> (random() % 64);
+        snprintf(expected, sizeof expected, "%" PRId64, v);
+        assert(decimal(v) == expected);
+    }
+
+    char buf[32];
+    assert(std::string(buf, format::formatHex(buf, 0)) == "0");
+    assert(std::string(buf, format::formatHex(buf, 0xBEEF01)) == "BEEF01");
+}
+
+void testDoubles() {
+    assert(shortest(0.0) == "0");
+    assert(shortest(0.25) == "0.25");
+    assert(shortest(-1.5) == "-1.5");
+    assert(shortest(0.1 + 0.2) == "0.30000000000000004");
+    assert(shortest(1e100) == "1e+100");
+    assert(shortest(123456.0) == "123456");
+    // fixed notation for exponents in [-5, 15), shortest digits either way
+    assert(shortest(100000.0) == "100000");
+    assert(shortest(-200000.0) == "-200000");
+    assert(shortest(1.5e10) == "15000000000");
+    assert(shortest(123456789012345.0) == "123456789012345");
+    assert(shortest(999999999999999.0) == "999999999999999");
+    assert(shortest(1e15) == "1e+15");
+    assert(shortest(1.25e16) == "1.25e+16");
+    assert(shortest(0.001) == "0.001");
+    assert(shortest(1e-5) == "0.00001");
+    assert(shortest(-1.2345e-5) == "-0.000012345");
+    assert(shortest(1e-6) == "1e-06");
+    assert(shortest(std::numeric_limits<double>::infinity()) == "inf");
+    assert(shortest(std::nan("")) == "nan");
+
+    char buf[format::kMaxDoubleSize];
+    assert(std::string(buf, format::formatDouble(buf, 0.1f)) == "0.1");
+    assert(std::string(buf, format::formatDouble(buf, 1e5f)) == "100000");
+    assert(std::string(buf, format::formatDouble(buf, 1e-7f)) == "1e-07");
+
+    // reads back the same bits
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t bits = random();
+        double v;
+        ::memcpy(&v, &bits, sizeof v);
+        if (!std::isfinite(v)) continue;
+        std::string text = shortest(v);
+        assert(text.size() < format::kMaxDoubleSize);
+        assert(::strtod(text.c_str(), nullptr) == v);
+    }
+    // and across the fixed notation range, with all 17 digits
+    for (int exponent = -7; exponent <= 17; ++exponent) {
+        for (int i = 0; i < 1000; ++i) {
+            double v = std::ldexp(static_cast<double>(random() >> 11), -53) *
+                       std::pow(10.0, exponent);
+            std::string text = shortest(v);
+            assert(text.size() < format::kMaxDoubleSize);
+            assert(::strtod(text.c_str(), nullptr) == v);
+        }
+    }
+}
+
+void benchmark() {
+    const int kCount = 1000 * 1000;
+    char buf[64];
+    size_t total = 0;
+
+    Timestamp start(Timestamp::now());
+    for (int i = 0; i < kCount; ++i) {
+        total += static_cast<size_t>(
+            snprintf(buf, sizeof buf, "%d", i * 997));
+    }
+    double snprintfInt = timeDifference(Timestamp::now(), start);
+
+    start = Timestamp::now();
+    for (int i = 0; i < kCount; ++i) {
+        total += format::formatDecimal(buf, i * 997);
+    }
+    double formatInt = timeDifference(Timestamp::now(), start);
+
+    start = Timestamp::now();
+    for (int i = 0; i < kCount; ++i) {
+        total += static_cast<size_t>(
+            snprintf(buf, sizeof buf, "%.12g", i * 0.37));
+    }
+    double snprintfDouble = timeDifference(Timestamp::now(), start);
+
+    start = Timestamp::now();
+    for (int i = 0; i < kCount; ++i) {
+        total += format::formatDouble(buf, i * 0.37);
+    }
+    double formatDouble = timeDifference(Timestamp::now(), start);
+
+    printf("int: snprintf %f format %f\n", snprintfInt, formatInt);
+    printf("double: snprintf %f format %f\n", snprintfDouble, formatDouble);
+    printf("%zu\n", total);
+}
+
+int main() {
+    testIntegers();
+    testDoubles();
+    benchmark();
+    printf("Format tests passed\n");
+}
@@ -0,0 +1,100 @@
+#include <LuxUtils/InlineAny.h>
+#include <assert.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace Lux;
+
+typedef InlineAny<64> Any;
+
+struct Big {
+    char data[128];
+    int value;
+};
+
+/// counts the live objects
+struct Counted {
+    static int live;
+    int value;
+
+    explicit Counted(int v) : value(v) { ++live; }
+    Counted(const Counted& rhs) : value(rhs.value) { ++live; }
+    Counted(Counted&& rhs) noexcept : value(rhs.value) { ++live; }
+    ~Counted() { --live; }
+};
+int Counted::live = 0;
+
+bool isInside(const Any& any, const void* p) {
+    const char* begin = reinterpret_cast<const char*>(&any);
+    const char* q = static_cast<const char*>(p);
+    return q >= begin && q < begin + sizeof any;
+}
+
+void testBasic() {
+    Any a;
+    assert(!a.hasValue());
+    assert(a.tryGet<int>() == nullptr);
+
+    a = 42;
+    assert(a.is<int>() && !a.is<long>());
+    assert(a.get<int>() == 42);
+    assert(a.tryGet<long>() == nullptr);
+    assert(isInside(a, a.tryGet<int>()));
+
+    a = std::string("hello");
+    assert(a.get<std::string>() == "hello");
+    a.get<std::string>() += " world";
+    const Any& ref = a;
+    assert(*ref.tryGet<std::string>() == "hello world");
+
+    // too large, on the heap
+    static_assert(!Any::storesInline<Big>(), "Big is on the heap");
+    static_assert(Any::storesInline<std::map<int, int>>(), "map is inline");
+    Big& big = a.emplace<Big>();
+    big.value = 7;
+    assert(!isInside(a, &big));
+    Any copy(a);
+    assert(copy.get<Big>().value == 7 && &copy.get<Big>() != &big);
+    Any moved(std::move(copy));
+    assert(!copy.hasValue());
+    assert(moved.get<Big>().value == 7);
+
+    a.reset();
+    assert(!a.hasValue());
+}
+
+void testLifetime() {
+    {
+        Any a(Counted(1));
+        assert(Counted::live == 1);
+        Any b(a);
+        assert(Counted::live == 2);
+        b.get<Counted>().value = 2;
+        a.swap(b);
+        assert(a.get<Counted>().value == 2 && b.get<Counted>().value == 1);
+        assert(Counted::live == 2);
+
+        b = std::make_shared<int>(3);
+        assert(Counted::live == 1);
+        a.swap(b);
+        assert(*a.get<std::shared_ptr<int>>() == 3);
+        assert(b.get<Counted>().value == 2);
+
+        a = b;
+        assert(Counted::live == 2);
+        a = Any();
+        assert(Counted::live == 1 && !a.hasValue());
+        b.swap(b);
+        assert(b.get<Counted>().value == 2);
+    }
+    assert(Counted::live == 0);
+}
+
+int main() {
+    testBasic();
+    testLifetime();
+    printf("InlineAny tests passed\n");
+}
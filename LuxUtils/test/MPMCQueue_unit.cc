@@ -0,0 +1,120 @@
+#include <LuxUtils/MPMCQueue.h>
+#include <assert.h>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Lux;
+
+void testSingleThread() {
+    MPMCQueue<int> queue(5);
+    assert(queue.capacity() == 8);
+    assert(queue.empty());
+
+    // FIFO across laps
+    int value = 0;
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 8; ++i) assert(queue.tryPush(lap * 8 + i));
+        assert(!queue.tryPush(-1));
+        assert(queue.size() == 8);
+        for (int i = 0; i < 8; ++i) {
+            assert(queue.tryPop(&value) && value == lap * 8 + i);
+        }
+        assert(!queue.tryPop(&value));
+    }
+
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10] = {};
+    assert(queue.tryPush(100));
+    assert(queue.tryPushBatch(in, 10) == 7);
+    assert(queue.tryPopBatch(out, 3) == 3);
+    assert(out[0] == 100 && out[1] == 0 && out[2] == 1);
+    assert(queue.tryPopBatch(out, 10) == 5);
+    assert(out[0] == 2 && out[4] == 6);
+    assert(queue.tryPopBatch(out, 10) == 0);
+
+    // move only values, and the ones left are destroyed
+    auto counter = std::make_shared<int>(0);
+    {
+        MPMCQueue<std::unique_ptr<std::shared_ptr<int>>> owners(4);
+        for (int i = 0; i < 3; ++i) {
+            owners.spinPush(
+                std::unique_ptr<std::shared_ptr<int>>(
+                    new std::shared_ptr<int>(counter)));
+        }
+        auto first = owners.spinPop();
+        assert(*first == counter);
+        assert(counter.use_count() == 4);
+    }
+    assert(counter.use_count() == 1);
+}
+
+/// every value is popped once, and in order for each producer
+void testThreads(bool blocking, bool batch) {
+    const int kProducers = 4;
+    const int kConsumers = 4;
+    const int kPerProducer = 20000;
+    MPMCQueue<int> queue(64);
+    std::vector<std::atomic<int>> popped(kProducers * kPerProducer);
+    std::atomic<int> remaining(kProducers * kPerProducer);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                int value = p * kPerProducer + i;
+                if (blocking) {
+                    queue.push(value);
+                } else if (batch) {
+                    while (queue.tryPushBatch(&value, 1) == 0) {
+                        std::this_thread::yield();
+                    }
+                } else {
+                    queue.spinPush(value);
+                }
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int> last(kProducers, -1);
+            int values[16];
+            while (remaining.load() > 0) {
+                size_t n = 0;
+                if (blocking) {
+                    values[n++] = queue.pop();
+                } else if (batch) {
+                    n = queue.tryPopBatch(values, 16);
+                } else {
+                    n = queue.tryPop(values) ? 1 : 0;
+                }
+                if (n == 0) std::this_thread::yield();
+                for (size_t i = 0; i < n; ++i) {
+                    int value = values[i];
+                    // -1 wakes the blocked consumers at the end
+                    if (value < 0) continue;
+                    int producer = value / kPerProducer;
+                    assert(value > last[static_cast<size_t>(producer)]);
+                    last[static_cast<size_t>(producer)] = value;
+                    popped[static_cast<size_t>(value)].fetch_add(1);
+                    if (remaining.fetch_sub(1) == 1 && blocking) {
+                        for (int k = 1; k < kConsumers; ++k) queue.push(-1);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (auto& n : popped) assert(n.load() == 1);
+}
+
+int main() {
+    testSingleThread();
+    testThreads(false, false);
+    testThreads(false, true);
+    testThreads(true, false);
+    printf("MPMCQueue tests passed\n");
+}
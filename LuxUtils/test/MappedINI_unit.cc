@@ -0,0 +1,157 @@
+#include <LuxUtils/LuxINI.hpp>
+#include <LuxUtils/MappedINI.h>
+#include <LuxUtils/Timestamp.h>
+#include <assert.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace Lux;
+using namespace Lux::INIParser;
+
+void writeFile(const string& path, const string& content) {
+    // replace by rename(2), as MappedINI expects
+    string tmp = path + ".tmp";
+    FILE* fp = ::fopen(tmp.c_str(), "w");
+    assert(fp != nullptr);
+    ::fwrite(content.data(), 1, content.size(), fp);
+    ::fclose(fp);
+    ::rename(tmp.c_str(), path.c_str());
+}
+
+void testParse(const string& path) {
+    writeFile(path,
+              "\xEF\xBB\xBF"
+              "global=ignored\n"
+              "; comment\n"
+              "[Server] ; trailing comment\n"
+              "  Threads = 4  \r\n"
+              "host=0.0.0.0\n"
+              "a\\=b = escaped\n"
+              "empty =\n"
+              "garbage line\n"
+              "\n"
+              "[Logger]\n"
+              "level=INFO\n"
+              "[server]\n"
+              "threads=8\n"
+              "port=8080\n"
+              "[sizes]\n"
+              "k=64K\n"
+              "m = 500 m\n"
+              "g=2G\n"
+              "bad=12X\n"
+              "timeout=1.5\n"
+              "on=ON\n"
+              "no=No\n");
+
+    MappedINI ini;
+    assert(!ini.valid());
+    assert(ini.open(path) == 0);
+    assert(ini.valid());
+
+    assert(ini.sectionCount() == 3);
+    assert(ini.has("SERVER"));
+    assert(ini.has(" logger "));
+    assert(!ini.has("global"));
+    assert(!ini.has("missing"));
+
+    // the repeated section is merged and the later key wins
+    assert(ini.get("server", "THREADS") == "8");
+    assert(ini.get("server", "port") == "8080");
+    assert(ini.get("server", "host") == "0.0.0.0");
+    assert(ini.get("server", "a=b") == "escaped");
+    assert(ini.has("server", "empty"));
+    assert(ini.get("server", "empty", "default").empty());
+    assert(ini.get("server", "missing", "default") == "default");
+    assert(ini.get("missing", "key", "default") == "default");
+    assert(ini.get("logger", "level") == "INFO");
+
+    assert(ini.getInt("server", "threads", 1) == 8);
+    assert(ini.getInt("server", "host", 1) == 1);
+    assert(ini.getInt("server", "missing", -1) == -1);
+    assert(ini.getSize("server", "threads", 0) == 8);
+    assert(ini.getSize("sizes", "k", 0) == 64 * 1024);
+    assert(ini.getSize("sizes", "m", 0) == 500 * 1024 * 1024);
+    assert(ini.getSize("sizes", "g", 0) == 2LL * 1024 * 1024 * 1024);
+    assert(ini.getSize("sizes", "bad", 7) == 7);
+    assert(ini.getDouble("sizes", "timeout", 0.0) == 1.5);
+    assert(ini.getDouble("sizes", "bad", 2.5) == 2.5);
+    assert(ini.getBool("sizes", "on", false));
+    assert(!ini.getBool("sizes", "no", true));
+    assert(ini.getBool("sizes", "bad", true));
+
+    int n = 0;
+    ini.forEach("server", [&n](std::string_view, std::string_view) { ++n; });
+    assert(n == 6);
+
+    // same answers as LuxINI
+    INI reader(path);
+    INIStructure data;
+    reader.read(data);
+    assert(data["server"]["threads"] == string(ini.get("server", "threads")));
+    assert(data["server"]["a=b"] == string(ini.get("server", "a=b")));
+    assert(data["logger"]["level"] == string(ini.get("logger", "level")));
+
+    // a new version replaced by rename
+    writeFile(path, "[server]\nthreads=16\n");
+    assert(ini.get("server", "threads") == "8");
+    assert(ini.reload() == 0);
+    assert(ini.get("server", "threads") == "16");
+    assert(!ini.has("logger"));
+
+    // a failed open keeps the old content
+    assert(ini.open(path + ".missing") != 0);
+    assert(ini.get("server", "threads") == "16");
+    assert(ini.fileName() == path);
+
+    writeFile(path, "");
+    assert(ini.reload() == 0);
+    assert(ini.size() == 0);
+    assert(ini.sectionCount() == 0);
+}
+
+void benchmark(const string& path) {
+    const int kSections = 1000;
+    const int kKeys = 100;
+    string content;
+    for (int i = 0; i < kSections; ++i) {
+        content += "[route" + std::to_string(i) + "]\n";
+        for (int j = 0; j < kKeys; ++j) {
+            content += "key" + std::to_string(j) + " = 10.0." +
+                       std::to_string(i % 256) + "." + std::to_string(j) +
+                       "\n";
+        }
+    }
+    writeFile(path, content);
+
+    Timestamp start(Timestamp::now());
+    INI reader(path);
+    INIStructure data;
+    reader.read(data);
+    string value = data["route500"]["key50"];
+    double iniTime = timeDifference(Timestamp::now(), start);
+
+    start = Timestamp::now();
+    MappedINI ini;
+    ini.open(path);
+    assert(ini.get("route500", "key50") == value);
+    double mappedTime = timeDifference(Timestamp::now(), start);
+
+    printf("%zu bytes: LuxINI %f MappedINI %f\n", content.size(), iniTime,
+           mappedTime);
+}
+
+int main() {
+    char path[] = "/tmp/MappedINI_unit_XXXXXX";
+    int fd = ::mkstemp(path);
+    assert(fd >= 0);
+    ::close(fd);
+
+    testParse(path);
+    benchmark(path);
+
+    ::unlink(path);
+    printf("MappedINI tests passed\n");
+}
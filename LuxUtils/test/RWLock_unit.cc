@@ -0,0 +1,113 @@
+#include <LuxUtils/AdaptiveMutex.h>
+#include <LuxUtils/RWLock.h>
+#include <LuxUtils/Timestamp.h>
+#include <assert.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace Lux;
+
+const int kThreads = 4;
+
+void testAdaptiveMutex() {
+    AdaptiveMutex mutex;
+    assert(mutex.tryLock());
+    assert(mutex.isLockedByThisThread());
+    std::thread other([&] { assert(!mutex.tryLock()); });
+    other.join();
+    mutex.unlock();
+
+    const int kCount = 200000;
+    long counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kCount; ++i) {
+                AdaptiveMutexGuard lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(counter == static_cast<long>(kThreads) * kCount);
+}
+
+/// readers never see a half done write
+void testRWLock() {
+    RWLock lock;
+    long a = 0;
+    long b = 0;
+    std::atomic<bool> done(false);
+    std::atomic<long> reads(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                {
+                    ReadLockGuard guard(lock);
+                    assert(a == b);
+                    reads.fetch_add(1, std::memory_order_relaxed);
+                }
+                // lets the writers run when there are few CPUs
+                std::this_thread::yield();
+            }
+        });
+    }
+    const int kWrites = 2000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < kWrites; ++i) {
+                WriteLockGuard guard(lock);
+                assert(lock.isWriteLockedByThisThread());
+                ++a;
+                ++b;
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    for (auto& thread : threads) thread.join();
+    assert(a == 2 * kWrites && b == a);
+    assert(reads.load() > 0);
+}
+
+template <typename Mutex, typename Guard>
+double timeShortSections(Mutex& mutex, int nthreads) {
+    const int kCount = 1000 * 1000;
+    long counter = 0;
+    Timestamp start(Timestamp::now());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < kCount; ++i) {
+                Guard lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(counter == static_cast<long>(nthreads) * kCount);
+    return timeDifference(Timestamp::now(), start);
+}
+
+int main() {
+    testAdaptiveMutex();
+    testRWLock();
+
+    for (int nthreads = 1; nthreads <= kThreads; nthreads *= 2) {
+        MutexLock mutex;
+        AdaptiveMutex adaptive;
+        double pthread = timeShortSections<MutexLock, MutexLockGuard>(
+            mutex, nthreads);
+        double spin = timeShortSections<AdaptiveMutex, AdaptiveMutexGuard>(
+            adaptive, nthreads);
+        printf("%d thread(s): MutexLock %f AdaptiveMutex %f\n", nthreads,
+               pthread, spin);
+    }
+    printf("RWLock tests passed\n");
+}
@@ -0,0 +1,42 @@
+#include <LuxUtils/SHA1.h>
+#include <assert.h>
+
+#include <algorithm>
+
+using namespace Lux;
+
+string hex(const string& digest) {
+    static const char kHex[] = "0123456789abcdef";
+    string result;
+    for (unsigned char c : digest) {
+        result.push_back(kHex[c >> 4]);
+        result.push_back(kHex[c & 0xF]);
+    }
+    return result;
+}
+
+int main() {
+    // RFC 3174 test vectors
+    assert(hex(SHA1::digest("")) == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    assert(hex(SHA1::digest("abc")) ==
+           "a9993e364706816aba3e25717850c26c9cd0d89d");
+    assert(hex(SHA1::digest(
+               "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+           "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+
+    SHA1 million;
+    string a(1000, 'a');
+    for (int i = 0; i < 1000; ++i) million.update(a);
+    assert(hex(million.digest()) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+    // incremental update must not depend on the chunk size
+    string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i);
+    for (size_t chunk = 1; chunk < 130; ++chunk) {
+        SHA1 sha1;
+        for (size_t i = 0; i < data.size(); i += chunk) {
+            sha1.update(data.data() + i, std::min(chunk, data.size() - i));
+        }
+        assert(sha1.digest() == SHA1::digest(data));
+    }
+}
@@ -0,0 +1,146 @@
+#include <LuxUtils/CountDownLatch.h>
+#include <LuxUtils/CurrentThread.h>
+#include <LuxUtils/ThreadPool.h>
+#include <LuxUtils/WorkStealingDeque.h>
+#include <assert.h>
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Lux;
+
+void testDeque() {
+    WorkStealingDeque<int> deque(2);
+    for (int i = 0; i < 10; ++i) deque.push(i);
+    assert(deque.size() == 10);
+    int x = -1;
+    assert(deque.pop(&x) && x == 9);
+    assert(deque.steal(&x) && x == 0);
+    while (deque.pop(&x)) {
+    }
+    assert(deque.empty());
+    assert(!deque.steal(&x));
+
+    // every item is taken once, by the owner or a thief
+    const int kItems = 200000;
+    WorkStealingDeque<int> shared;
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            int item;
+            while (!done.load()) {
+                if (shared.steal(&item)) taken[item].fetch_add(1);
+            }
+            while (shared.steal(&item)) taken[item].fetch_add(1);
+        });
+    }
+    for (int i = 0; i < kItems; ++i) {
+        shared.push(i);
+        int item;
+        if (i % 3 == 0 && shared.pop(&item)) taken[item].fetch_add(1);
+    }
+    int item;
+    while (shared.pop(&item)) taken[item].fetch_add(1);
+    done = true;
+    for (auto& thief : thieves) thief.join();
+    for (auto& n : taken) assert(n.load() == 1);
+}
+
+void testRun() {
+    // not started, runs in the caller
+    ThreadPool notStarted;
+    int tid = 0;
+    notStarted.run([&] { tid = CurrentThread::tid(); });
+    assert(tid == CurrentThread::tid());
+
+    std::atomic<int> count(0);
+    std::function<void(int)> spawn;
+    {
+        ThreadPool pool("TestPool");
+        pool.start(4);
+        assert(pool.size() == 4);
+        for (int i = 0; i < 1000; ++i) {
+            pool.run([&] { count.fetch_add(1); });
+        }
+        // tasks queued by tasks, done before stop() returns
+        spawn = [&](int depth) {
+            count.fetch_add(1);
+            if (depth == 0) return;
+            pool.run([&, depth] { spawn(depth - 1); });
+            pool.run([&, depth] { spawn(depth - 1); });
+        };
+        pool.run([&] { spawn(10); });
+    }
+    assert(count.load() == 1000 + (1 << 11) - 1);
+}
+
+void testFuture() {
+    ThreadPool pool;
+    pool.start(3);
+
+    Future<int> answer = pool.submit([] { return 6 * 7; });
+    assert(answer.valid());
+    assert(answer.get() == 42);
+    assert(!answer.valid());
+
+    auto text = pool.submit([] { return 21; })
+                    .then([](int x) { return x * 2; })
+                    .then([](int x) { return std::to_string(x); });
+    assert(text.get() == "42");
+
+    // exceptions skip the continuations
+    std::atomic<bool> called(false);
+    auto failed = pool.submit([]() -> int { throw std::runtime_error("x"); })
+                      .then([&](int x) {
+                          called = true;
+                          return x;
+                      });
+    bool caught = false;
+    try {
+        failed.get();
+    } catch (const std::runtime_error& e) {
+        caught = std::string(e.what()) == "x";
+    }
+    assert(caught && !called);
+
+    // void results
+    CountDownLatch latch(1);
+    std::atomic<int> order(0);
+    auto done = pool.submit([&] { order = 1; }).then([&] {
+        assert(order == 1);
+        order = 2;
+        latch.countDown();
+    });
+    latch.wait();
+    done.get();
+    assert(order == 2);
+
+    // continuations of a ready future
+    Future<int> ready = pool.submit([] { return 1; });
+    ready.wait();
+    assert(ready.ready());
+    assert(ready.then([](int x) { return x + 1; }).get() == 2);
+
+    // many tasks in flight
+    std::vector<Future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([i] { return i; }));
+    }
+    int sum = 0;
+    for (auto& r : results) sum += r.get();
+    assert(sum == 4950);
+    pool.stop();
+}
+
+int main() {
+    testDeque();
+    testRun();
+    testFuture();
+    printf("ThreadPool tests passed\n");
+}
@@ -1,7 +1,10 @@
+#include <LuxUtils/MonoTime.h>
 #include <LuxUtils/Timestamp.h>
+#include <assert.h>
 
 #include <vector>
 
+using Lux::MonoTime;
 using Lux::Timestamp;
 
 void passByConstReference(const Timestamp& x) {
@@ -42,7 +45,31 @@ void benchmark() {
     }
 }
 
+void testMonoTime() {
+    MonoTime start(MonoTime::now());
+    assert(start.valid());
+    MonoTime last = start;
+    for (int i = 0; i < 1000 * 1000; ++i) {
+        MonoTime now(MonoTime::now());
+        assert(!(now < last));
+        last = now;
+    }
+    printf("MonoTime %s, 1M reads in %f s\n", start.toString().c_str(),
+           timeDifference(last, start));
+
+    MonoTime later = addTime(start, 1.5);
+    assert(later.microSeconds() - start.microSeconds() == 1500000);
+    assert(timeDifference(later, start) == 1.5);
+
+    // ten seconds of the wall clock from now
+    MonoTime fromWall = MonoTime::fromTimestamp(
+        Lux::addTime(Timestamp::now(), 10.0));
+    double ahead = timeDifference(fromWall, MonoTime::now());
+    assert(ahead > 9.9 && ahead <= 10.0);
+}
+
 int main() {
+    testMonoTime();
     Timestamp now(Timestamp::now());
     printf("%s\n", now.toString().c_str());
     passByValue(now);
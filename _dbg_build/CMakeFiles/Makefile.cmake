@@ -0,0 +1,121 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "/root/repo/LuxLog/CMakeLists.txt"
+  "/root/repo/LuxLog/test/CMakeLists.txt"
+  "/root/repo/LuxMySQL/CMakeLists.txt"
+  "/root/repo/LuxMySQL/test/CMakeLists.txt"
+  "/root/repo/LuxRedis/CMakeLists.txt"
+  "/root/repo/LuxRedis/test/CMakeLists.txt"
+  "/root/repo/LuxUtils/CMakeLists.txt"
+  "/root/repo/LuxUtils/test/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "CMakeFiles/VerifyGlobs.cmake"
+  "CMakeFiles/cmake.verify_globs"
+  "/root/repo/app/CMakeLists.txt"
+  "/root/repo/app/http/CMakeLists.txt"
+  "/root/repo/app/http/test/CMakeLists.txt"
+  "/root/repo/app/logdecoder/CMakeLists.txt"
+  "/root/repo/app/logrecover/CMakeLists.txt"
+  "/root/repo/polaris/CMakeLists.txt"
+  "/root/repo/polaris/test/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxUtils/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxUtils/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxLog/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxLog/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "polaris/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "polaris/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxMySQL/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxMySQL/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxRedis/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "LuxRedis/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "app/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "app/http/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "app/http/test/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "app/logdecoder/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "app/logrecover/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/AtomicTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/ExceptionTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/FileUtilTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/MutexTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/ProcessInfoTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/ThreadTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/TimestampTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/LuxINITest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/AnyTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/Base64Test.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/SHA1Test.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/ThreadPoolTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/MPMCQueueTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/InlineAnyTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/RWLockTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/FormatTest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/MappedINITest.dir/DependInfo.cmake"
+  "LuxUtils/test/CMakeFiles/ConfigTest.dir/DependInfo.cmake"
+  "LuxLog/CMakeFiles/LuxLog.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LoggerTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LogRecordTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LogWriterTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LogArchiverTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LogTimeTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/LogModuleTest.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/example_1.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/example_2.dir/DependInfo.cmake"
+  "LuxLog/test/CMakeFiles/example_3.dir/DependInfo.cmake"
+  "polaris/CMakeFiles/polaris.dir/DependInfo.cmake"
+  "polaris/test/CMakeFiles/EchoServer.dir/DependInfo.cmake"
+  "polaris/test/CMakeFiles/EchoClient.dir/DependInfo.cmake"
+  "polaris/test/CMakeFiles/FileWatcher.dir/DependInfo.cmake"
+  "polaris/test/CMakeFiles/CoroutineEcho.dir/DependInfo.cmake"
+  "LuxMySQL/CMakeFiles/LuxMySQL.dir/DependInfo.cmake"
+  "LuxMySQL/test/CMakeFiles/MySQLConnPoolTest.dir/DependInfo.cmake"
+  "LuxRedis/CMakeFiles/LuxRedis.dir/DependInfo.cmake"
+  "LuxRedis/test/CMakeFiles/LuxRedisTest.dir/DependInfo.cmake"
+  "app/http/CMakeFiles/httpServer.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/HPackTest.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/Http2SessionTest.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/WebSocketTest.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/HttpProxyTest.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/HttpCacheTest.dir/DependInfo.cmake"
+  "app/http/test/CMakeFiles/RateLimiterTest.dir/DependInfo.cmake"
+  "app/logdecoder/CMakeFiles/logDecoder.dir/DependInfo.cmake"
+  "app/logrecover/CMakeFiles/logRecover.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,255 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by CMake Version 3.25
+cmake_policy(SET CMP0009 NEW)
+
+# srcs at LuxLog/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxLog/include/*.h")
+set(OLD_GLOB
+  "/root/repo/LuxLog/include/LuxLog/AsyncLogger.h"
+  "/root/repo/LuxLog/include/LuxLog/LogArchiver.h"
+  "/root/repo/LuxLog/include/LuxLog/LogFile.h"
+  "/root/repo/LuxLog/include/LuxLog/LogRecord.h"
+  "/root/repo/LuxLog/include/LuxLog/LogStream.h"
+  "/root/repo/LuxLog/include/LuxLog/LogWriter.h"
+  "/root/repo/LuxLog/include/LuxLog/Logger.h"
+  "/root/repo/LuxLog/include/LuxLog/MappedBuffers.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxLog/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxLog/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/LuxLog/src/AsyncLogger.cc"
+  "/root/repo/LuxLog/src/LogArchiver.cc"
+  "/root/repo/LuxLog/src/LogFile.cc"
+  "/root/repo/LuxLog/src/LogRecord.cc"
+  "/root/repo/LuxLog/src/LogStream.cc"
+  "/root/repo/LuxLog/src/LogWriter.cc"
+  "/root/repo/LuxLog/src/Logger.cc"
+  "/root/repo/LuxLog/src/MappedBuffers.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxMySQL/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxMySQL/include/*.h")
+set(OLD_GLOB
+  "/root/repo/LuxMySQL/include/LuxMySQL/MySQLConn.h"
+  "/root/repo/LuxMySQL/include/LuxMySQL/MySQLConnPool.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxMySQL/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxMySQL/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/LuxMySQL/src/MySQLConn.cc"
+  "/root/repo/LuxMySQL/src/MySQLConnPool.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxRedis/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxRedis/include/*.h")
+set(OLD_GLOB
+  "/root/repo/LuxRedis/include/LuxRedis/RedisConn.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxRedis/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxRedis/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/LuxRedis/src/RedisConn.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxUtils/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxUtils/include/*.h")
+set(OLD_GLOB
+  "/root/repo/LuxUtils/include/LuxUtils/AdaptiveMutex.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Any.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Atomic.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Base64.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Condition.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Config.h"
+  "/root/repo/LuxUtils/include/LuxUtils/CountDownLatch.h"
+  "/root/repo/LuxUtils/include/LuxUtils/CurrentThread.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Exception.h"
+  "/root/repo/LuxUtils/include/LuxUtils/FileUtil.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Format.h"
+  "/root/repo/LuxUtils/include/LuxUtils/InlineAny.h"
+  "/root/repo/LuxUtils/include/LuxUtils/MPMCQueue.h"
+  "/root/repo/LuxUtils/include/LuxUtils/MTQueue.h"
+  "/root/repo/LuxUtils/include/LuxUtils/MappedINI.h"
+  "/root/repo/LuxUtils/include/LuxUtils/MonoTime.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Mutex.h"
+  "/root/repo/LuxUtils/include/LuxUtils/ProcessInfo.h"
+  "/root/repo/LuxUtils/include/LuxUtils/RWLock.h"
+  "/root/repo/LuxUtils/include/LuxUtils/SHA1.h"
+  "/root/repo/LuxUtils/include/LuxUtils/StringPiece.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Thread.h"
+  "/root/repo/LuxUtils/include/LuxUtils/ThreadPool.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Timestamp.h"
+  "/root/repo/LuxUtils/include/LuxUtils/Types.h"
+  "/root/repo/LuxUtils/include/LuxUtils/WorkStealingDeque.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at LuxUtils/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/LuxUtils/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/LuxUtils/src/AdaptiveMutex.cc"
+  "/root/repo/LuxUtils/src/Base64.cc"
+  "/root/repo/LuxUtils/src/Condition.cc"
+  "/root/repo/LuxUtils/src/CountDownLatch.cc"
+  "/root/repo/LuxUtils/src/CurrentThread.cc"
+  "/root/repo/LuxUtils/src/Exception.cc"
+  "/root/repo/LuxUtils/src/FileUtil.cc"
+  "/root/repo/LuxUtils/src/Format.cc"
+  "/root/repo/LuxUtils/src/MappedINI.cc"
+  "/root/repo/LuxUtils/src/MonoTime.cc"
+  "/root/repo/LuxUtils/src/ProcessInfo.cc"
+  "/root/repo/LuxUtils/src/RWLock.cc"
+  "/root/repo/LuxUtils/src/SHA1.cc"
+  "/root/repo/LuxUtils/src/Thread.cc"
+  "/root/repo/LuxUtils/src/ThreadPool.cc"
+  "/root/repo/LuxUtils/src/Timestamp.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at app/http/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/app/http/include/*.h")
+set(OLD_GLOB
+  "/root/repo/app/http/include/http/HPack.h"
+  "/root/repo/app/http/include/http/Http2Session.h"
+  "/root/repo/app/http/include/http/HttpCache.h"
+  "/root/repo/app/http/include/http/HttpContext.h"
+  "/root/repo/app/http/include/http/HttpProxy.h"
+  "/root/repo/app/http/include/http/HttpRequest.h"
+  "/root/repo/app/http/include/http/HttpResponse.h"
+  "/root/repo/app/http/include/http/HttpServer.h"
+  "/root/repo/app/http/include/http/MysqlConn.h"
+  "/root/repo/app/http/include/http/RateLimiter.h"
+  "/root/repo/app/http/include/http/WebSocket.h"
+  "/root/repo/app/http/include/http/app.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at app/http/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/app/http/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/app/http/src/HPack.cc"
+  "/root/repo/app/http/src/Http2Session.cc"
+  "/root/repo/app/http/src/HttpCache.cc"
+  "/root/repo/app/http/src/HttpContext.cc"
+  "/root/repo/app/http/src/HttpProxy.cc"
+  "/root/repo/app/http/src/HttpResponse.cc"
+  "/root/repo/app/http/src/HttpServer.cc"
+  "/root/repo/app/http/src/RateLimiter.cc"
+  "/root/repo/app/http/src/WebSocket.cc"
+  "/root/repo/app/http/src/app.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at app/logdecoder/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/app/logdecoder/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/app/logdecoder/src/LogDecoder.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at app/logrecover/CMakeLists.txt:1 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/app/logrecover/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/app/logrecover/src/LogRecover.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at polaris/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/polaris/include/*.h")
+set(OLD_GLOB
+  "/root/repo/polaris/include/polaris/Acceptor.h"
+  "/root/repo/polaris/include/polaris/Buffer.h"
+  "/root/repo/polaris/include/polaris/Callbacks.h"
+  "/root/repo/polaris/include/polaris/Channel.h"
+  "/root/repo/polaris/include/polaris/Connector.h"
+  "/root/repo/polaris/include/polaris/Coroutine.h"
+  "/root/repo/polaris/include/polaris/EPollPoller.h"
+  "/root/repo/polaris/include/polaris/EventLoop.h"
+  "/root/repo/polaris/include/polaris/EventLoopThread.h"
+  "/root/repo/polaris/include/polaris/EventLoopThreadPool.h"
+  "/root/repo/polaris/include/polaris/FileWatcher.h"
+  "/root/repo/polaris/include/polaris/InetAddress.h"
+  "/root/repo/polaris/include/polaris/Poller.h"
+  "/root/repo/polaris/include/polaris/Sockets.h"
+  "/root/repo/polaris/include/polaris/TCPClient.h"
+  "/root/repo/polaris/include/polaris/TCPConnection.h"
+  "/root/repo/polaris/include/polaris/TCPServer.h"
+  "/root/repo/polaris/include/polaris/Timer.h"
+  "/root/repo/polaris/include/polaris/TimerId.h"
+  "/root/repo/polaris/include/polaris/TimerQueue.h"
+  "/root/repo/polaris/include/polaris/polaris.h"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
+
+# srcs at polaris/CMakeLists.txt:6 (file)
+file(GLOB_RECURSE NEW_GLOB LIST_DIRECTORIES false "/root/repo/polaris/src/*.cc")
+set(OLD_GLOB
+  "/root/repo/polaris/src/Acceptor.cc"
+  "/root/repo/polaris/src/Buffer.cc"
+  "/root/repo/polaris/src/Channel.cc"
+  "/root/repo/polaris/src/Connector.cc"
+  "/root/repo/polaris/src/EPollPoller.cc"
+  "/root/repo/polaris/src/EventLoop.cc"
+  "/root/repo/polaris/src/EventLoopThread.cc"
+  "/root/repo/polaris/src/EventLoopThreadPool.cc"
+  "/root/repo/polaris/src/FileWatcher.cc"
+  "/root/repo/polaris/src/InetAddress.cc"
+  "/root/repo/polaris/src/Poller.cc"
+  "/root/repo/polaris/src/Sockets.cc"
+  "/root/repo/polaris/src/TCPClient.cc"
+  "/root/repo/polaris/src/TCPConnection.cc"
+  "/root/repo/polaris/src/TCPServer.cc"
+  "/root/repo/polaris/src/Timer.cc"
+  "/root/repo/polaris/src/TimerQueue.cc"
+  )
+if(NOT "${NEW_GLOB}" STREQUAL "${OLD_GLOB}")
+  message("-- GLOB mismatch!")
+  file(TOUCH_NOCREATE "/root/repo/_dbg_build/CMakeFiles/cmake.verify_globs")
+endif()
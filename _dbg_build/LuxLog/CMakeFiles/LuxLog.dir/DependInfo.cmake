@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/LuxLog/src/AsyncLogger.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/AsyncLogger.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/AsyncLogger.cc.o.d"
+  "/root/repo/LuxLog/src/LogArchiver.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogArchiver.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogArchiver.cc.o.d"
+  "/root/repo/LuxLog/src/LogFile.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogFile.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogFile.cc.o.d"
+  "/root/repo/LuxLog/src/LogRecord.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogRecord.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogRecord.cc.o.d"
+  "/root/repo/LuxLog/src/LogStream.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogStream.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogStream.cc.o.d"
+  "/root/repo/LuxLog/src/LogWriter.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogWriter.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/LogWriter.cc.o.d"
+  "/root/repo/LuxLog/src/Logger.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/Logger.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/Logger.cc.o.d"
+  "/root/repo/LuxLog/src/MappedBuffers.cc" "LuxLog/CMakeFiles/LuxLog.dir/src/MappedBuffers.cc.o" "gcc" "LuxLog/CMakeFiles/LuxLog.dir/src/MappedBuffers.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
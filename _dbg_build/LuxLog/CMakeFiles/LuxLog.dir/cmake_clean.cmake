@@ -0,0 +1,25 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxLog.dir/src/AsyncLogger.cc.o"
+  "CMakeFiles/LuxLog.dir/src/AsyncLogger.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/LogArchiver.cc.o"
+  "CMakeFiles/LuxLog.dir/src/LogArchiver.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/LogFile.cc.o"
+  "CMakeFiles/LuxLog.dir/src/LogFile.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/LogRecord.cc.o"
+  "CMakeFiles/LuxLog.dir/src/LogRecord.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/LogStream.cc.o"
+  "CMakeFiles/LuxLog.dir/src/LogStream.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/LogWriter.cc.o"
+  "CMakeFiles/LuxLog.dir/src/LogWriter.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/Logger.cc.o"
+  "CMakeFiles/LuxLog.dir/src/Logger.cc.o.d"
+  "CMakeFiles/LuxLog.dir/src/MappedBuffers.cc.o"
+  "CMakeFiles/LuxLog.dir/src/MappedBuffers.cc.o.d"
+  "libLuxLog.a"
+  "libLuxLog.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxLog.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LogArchiverTest.dir/LogArchiver_unit.cc.o"
+  "CMakeFiles/LogArchiverTest.dir/LogArchiver_unit.cc.o.d"
+  "LogArchiverTest"
+  "LogArchiverTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LogArchiverTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
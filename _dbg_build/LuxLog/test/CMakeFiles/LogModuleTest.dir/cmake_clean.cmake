@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LogModuleTest.dir/LogModule_unit.cc.o"
+  "CMakeFiles/LogModuleTest.dir/LogModule_unit.cc.o.d"
+  "LogModuleTest"
+  "LogModuleTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LogModuleTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LogRecordTest.dir/LogRecord_unit.cc.o"
+  "CMakeFiles/LogRecordTest.dir/LogRecord_unit.cc.o.d"
+  "LogRecordTest"
+  "LogRecordTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LogRecordTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LogTimeTest.dir/LogTime_unit.cc.o"
+  "CMakeFiles/LogTimeTest.dir/LogTime_unit.cc.o.d"
+  "LogTimeTest"
+  "LogTimeTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LogTimeTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
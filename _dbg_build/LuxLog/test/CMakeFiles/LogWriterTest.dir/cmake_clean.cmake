@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LogWriterTest.dir/LogWriter_unit.cc.o"
+  "CMakeFiles/LogWriterTest.dir/LogWriter_unit.cc.o.d"
+  "LogWriterTest"
+  "LogWriterTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LogWriterTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LoggerTest.dir/Logger_unit.cc.o"
+  "CMakeFiles/LoggerTest.dir/Logger_unit.cc.o.d"
+  "LoggerTest"
+  "LoggerTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LoggerTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/example_1.dir/example_1.cc.o"
+  "CMakeFiles/example_1.dir/example_1.cc.o.d"
+  "example_1"
+  "example_1.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/example_1.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
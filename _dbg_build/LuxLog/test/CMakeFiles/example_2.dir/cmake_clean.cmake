@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/example_2.dir/example_2.cc.o"
+  "CMakeFiles/example_2.dir/example_2.cc.o.d"
+  "example_2"
+  "example_2.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/example_2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
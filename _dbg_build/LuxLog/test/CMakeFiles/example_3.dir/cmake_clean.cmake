@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/example_3.dir/example_3.cc.o"
+  "CMakeFiles/example_3.dir/example_3.cc.o.d"
+  "example_3"
+  "example_3.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/example_3.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
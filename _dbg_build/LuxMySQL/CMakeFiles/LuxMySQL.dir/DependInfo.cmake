@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/LuxMySQL/src/MySQLConn.cc" "LuxMySQL/CMakeFiles/LuxMySQL.dir/src/MySQLConn.cc.o" "gcc" "LuxMySQL/CMakeFiles/LuxMySQL.dir/src/MySQLConn.cc.o.d"
+  "/root/repo/LuxMySQL/src/MySQLConnPool.cc" "LuxMySQL/CMakeFiles/LuxMySQL.dir/src/MySQLConnPool.cc.o" "gcc" "LuxMySQL/CMakeFiles/LuxMySQL.dir/src/MySQLConnPool.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/LuxLog/CMakeFiles/LuxLog.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
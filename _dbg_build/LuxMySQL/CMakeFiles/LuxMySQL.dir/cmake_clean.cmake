@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxMySQL.dir/src/MySQLConn.cc.o"
+  "CMakeFiles/LuxMySQL.dir/src/MySQLConn.cc.o.d"
+  "CMakeFiles/LuxMySQL.dir/src/MySQLConnPool.cc.o"
+  "CMakeFiles/LuxMySQL.dir/src/MySQLConnPool.cc.o.d"
+  "libLuxMySQL.a"
+  "libLuxMySQL.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxMySQL.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
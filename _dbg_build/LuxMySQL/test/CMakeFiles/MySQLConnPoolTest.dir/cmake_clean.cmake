@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MySQLConnPoolTest.dir/MySQLConnPool_unit.cc.o"
+  "CMakeFiles/MySQLConnPoolTest.dir/MySQLConnPool_unit.cc.o.d"
+  "MySQLConnPoolTest"
+  "MySQLConnPoolTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MySQLConnPoolTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxRedis.dir/src/RedisConn.cc.o"
+  "CMakeFiles/LuxRedis.dir/src/RedisConn.cc.o.d"
+  "libLuxRedis.a"
+  "libLuxRedis.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxRedis.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
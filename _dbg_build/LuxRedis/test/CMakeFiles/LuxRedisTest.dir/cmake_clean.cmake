@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxRedisTest.dir/LuxRedis_unit.cc.o"
+  "CMakeFiles/LuxRedisTest.dir/LuxRedis_unit.cc.o.d"
+  "LuxRedisTest"
+  "LuxRedisTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxRedisTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/LuxUtils/src/AdaptiveMutex.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/AdaptiveMutex.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/AdaptiveMutex.cc.o.d"
+  "/root/repo/LuxUtils/src/Base64.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Base64.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Base64.cc.o.d"
+  "/root/repo/LuxUtils/src/Condition.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Condition.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Condition.cc.o.d"
+  "/root/repo/LuxUtils/src/CountDownLatch.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/CountDownLatch.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/CountDownLatch.cc.o.d"
+  "/root/repo/LuxUtils/src/CurrentThread.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/CurrentThread.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/CurrentThread.cc.o.d"
+  "/root/repo/LuxUtils/src/Exception.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Exception.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Exception.cc.o.d"
+  "/root/repo/LuxUtils/src/FileUtil.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/FileUtil.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/FileUtil.cc.o.d"
+  "/root/repo/LuxUtils/src/Format.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Format.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Format.cc.o.d"
+  "/root/repo/LuxUtils/src/MappedINI.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/MappedINI.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/MappedINI.cc.o.d"
+  "/root/repo/LuxUtils/src/MonoTime.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/MonoTime.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/MonoTime.cc.o.d"
+  "/root/repo/LuxUtils/src/ProcessInfo.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/ProcessInfo.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/ProcessInfo.cc.o.d"
+  "/root/repo/LuxUtils/src/RWLock.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/RWLock.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/RWLock.cc.o.d"
+  "/root/repo/LuxUtils/src/SHA1.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/SHA1.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/SHA1.cc.o.d"
+  "/root/repo/LuxUtils/src/Thread.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Thread.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Thread.cc.o.d"
+  "/root/repo/LuxUtils/src/ThreadPool.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/ThreadPool.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/ThreadPool.cc.o.d"
+  "/root/repo/LuxUtils/src/Timestamp.cc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Timestamp.cc.o" "gcc" "LuxUtils/CMakeFiles/LuxUtils.dir/src/Timestamp.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxUtils.dir/src/AdaptiveMutex.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/AdaptiveMutex.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Base64.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Base64.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Condition.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Condition.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/CountDownLatch.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/CountDownLatch.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/CurrentThread.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/CurrentThread.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Exception.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Exception.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/FileUtil.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/FileUtil.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Format.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Format.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/MappedINI.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/MappedINI.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/MonoTime.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/MonoTime.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/ProcessInfo.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/ProcessInfo.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/RWLock.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/RWLock.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/SHA1.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/SHA1.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Thread.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Thread.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/ThreadPool.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/ThreadPool.cc.o.d"
+  "CMakeFiles/LuxUtils.dir/src/Timestamp.cc.o"
+  "CMakeFiles/LuxUtils.dir/src/Timestamp.cc.o.d"
+  "libLuxUtils.a"
+  "libLuxUtils.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxUtils.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "AnyTest"
+  "AnyTest.pdb"
+  "CMakeFiles/AnyTest.dir/Any_unit.cc.o"
+  "CMakeFiles/AnyTest.dir/Any_unit.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/AnyTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
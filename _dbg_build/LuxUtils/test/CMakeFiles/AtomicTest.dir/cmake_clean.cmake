@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "AtomicTest"
+  "AtomicTest.pdb"
+  "CMakeFiles/AtomicTest.dir/Atomic_unit.cc.o"
+  "CMakeFiles/AtomicTest.dir/Atomic_unit.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/AtomicTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "Base64Test"
+  "Base64Test.pdb"
+  "CMakeFiles/Base64Test.dir/Base64_unit.cc.o"
+  "CMakeFiles/Base64Test.dir/Base64_unit.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Base64Test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
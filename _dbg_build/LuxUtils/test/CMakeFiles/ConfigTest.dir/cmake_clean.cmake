@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ConfigTest.dir/Config_unit.cc.o"
+  "CMakeFiles/ConfigTest.dir/Config_unit.cc.o.d"
+  "ConfigTest"
+  "ConfigTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ConfigTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
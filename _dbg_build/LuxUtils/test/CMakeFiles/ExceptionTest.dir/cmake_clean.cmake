@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ExceptionTest.dir/Exception_unit.cc.o"
+  "CMakeFiles/ExceptionTest.dir/Exception_unit.cc.o.d"
+  "ExceptionTest"
+  "ExceptionTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ExceptionTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
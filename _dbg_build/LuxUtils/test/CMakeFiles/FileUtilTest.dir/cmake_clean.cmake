@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FileUtilTest.dir/FileUtil_unit.cc.o"
+  "CMakeFiles/FileUtilTest.dir/FileUtil_unit.cc.o.d"
+  "FileUtilTest"
+  "FileUtilTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FileUtilTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
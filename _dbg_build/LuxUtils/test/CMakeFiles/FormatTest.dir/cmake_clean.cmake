@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FormatTest.dir/Format_unit.cc.o"
+  "CMakeFiles/FormatTest.dir/Format_unit.cc.o.d"
+  "FormatTest"
+  "FormatTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FormatTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/InlineAnyTest.dir/InlineAny_unit.cc.o"
+  "CMakeFiles/InlineAnyTest.dir/InlineAny_unit.cc.o.d"
+  "InlineAnyTest"
+  "InlineAnyTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/InlineAnyTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
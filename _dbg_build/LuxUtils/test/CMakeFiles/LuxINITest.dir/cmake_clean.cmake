@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LuxINITest.dir/LuxINI_unit.cc.o"
+  "CMakeFiles/LuxINITest.dir/LuxINI_unit.cc.o.d"
+  "LuxINITest"
+  "LuxINITest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LuxINITest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
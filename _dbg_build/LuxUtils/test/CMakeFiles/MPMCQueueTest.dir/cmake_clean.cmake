@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MPMCQueueTest.dir/MPMCQueue_unit.cc.o"
+  "CMakeFiles/MPMCQueueTest.dir/MPMCQueue_unit.cc.o.d"
+  "MPMCQueueTest"
+  "MPMCQueueTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MPMCQueueTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MappedINITest.dir/MappedINI_unit.cc.o"
+  "CMakeFiles/MappedINITest.dir/MappedINI_unit.cc.o.d"
+  "MappedINITest"
+  "MappedINITest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MappedINITest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
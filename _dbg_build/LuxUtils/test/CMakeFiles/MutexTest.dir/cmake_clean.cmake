@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MutexTest.dir/Mutex_unit.cc.o"
+  "CMakeFiles/MutexTest.dir/Mutex_unit.cc.o.d"
+  "MutexTest"
+  "MutexTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MutexTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
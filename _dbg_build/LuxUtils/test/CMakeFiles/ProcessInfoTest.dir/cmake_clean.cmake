@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ProcessInfoTest.dir/ProcessInfo_unit.cc.o"
+  "CMakeFiles/ProcessInfoTest.dir/ProcessInfo_unit.cc.o.d"
+  "ProcessInfoTest"
+  "ProcessInfoTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ProcessInfoTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/RWLockTest.dir/RWLock_unit.cc.o"
+  "CMakeFiles/RWLockTest.dir/RWLock_unit.cc.o.d"
+  "RWLockTest"
+  "RWLockTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/RWLockTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SHA1Test.dir/SHA1_unit.cc.o"
+  "CMakeFiles/SHA1Test.dir/SHA1_unit.cc.o.d"
+  "SHA1Test"
+  "SHA1Test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SHA1Test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
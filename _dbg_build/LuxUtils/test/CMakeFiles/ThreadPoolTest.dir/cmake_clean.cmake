@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ThreadPoolTest.dir/ThreadPool_unit.cc.o"
+  "CMakeFiles/ThreadPoolTest.dir/ThreadPool_unit.cc.o.d"
+  "ThreadPoolTest"
+  "ThreadPoolTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ThreadPoolTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/app/http/src/HPack.cc" "app/http/CMakeFiles/httpServer.dir/src/HPack.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HPack.cc.o.d"
+  "/root/repo/app/http/src/Http2Session.cc" "app/http/CMakeFiles/httpServer.dir/src/Http2Session.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/Http2Session.cc.o.d"
+  "/root/repo/app/http/src/HttpCache.cc" "app/http/CMakeFiles/httpServer.dir/src/HttpCache.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HttpCache.cc.o.d"
+  "/root/repo/app/http/src/HttpContext.cc" "app/http/CMakeFiles/httpServer.dir/src/HttpContext.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HttpContext.cc.o.d"
+  "/root/repo/app/http/src/HttpProxy.cc" "app/http/CMakeFiles/httpServer.dir/src/HttpProxy.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HttpProxy.cc.o.d"
+  "/root/repo/app/http/src/HttpResponse.cc" "app/http/CMakeFiles/httpServer.dir/src/HttpResponse.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HttpResponse.cc.o.d"
+  "/root/repo/app/http/src/HttpServer.cc" "app/http/CMakeFiles/httpServer.dir/src/HttpServer.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/HttpServer.cc.o.d"
+  "/root/repo/app/http/src/RateLimiter.cc" "app/http/CMakeFiles/httpServer.dir/src/RateLimiter.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/RateLimiter.cc.o.d"
+  "/root/repo/app/http/src/WebSocket.cc" "app/http/CMakeFiles/httpServer.dir/src/WebSocket.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/WebSocket.cc.o.d"
+  "/root/repo/app/http/src/app.cc" "app/http/CMakeFiles/httpServer.dir/src/app.cc.o" "gcc" "app/http/CMakeFiles/httpServer.dir/src/app.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/LuxLog/CMakeFiles/LuxLog.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/polaris/CMakeFiles/polaris.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/LuxMySQL/CMakeFiles/LuxMySQL.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
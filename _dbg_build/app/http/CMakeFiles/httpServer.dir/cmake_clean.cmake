@@ -0,0 +1,29 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/httpServer.dir/src/HPack.cc.o"
+  "CMakeFiles/httpServer.dir/src/HPack.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/Http2Session.cc.o"
+  "CMakeFiles/httpServer.dir/src/Http2Session.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/HttpCache.cc.o"
+  "CMakeFiles/httpServer.dir/src/HttpCache.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/HttpContext.cc.o"
+  "CMakeFiles/httpServer.dir/src/HttpContext.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/HttpProxy.cc.o"
+  "CMakeFiles/httpServer.dir/src/HttpProxy.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/HttpResponse.cc.o"
+  "CMakeFiles/httpServer.dir/src/HttpResponse.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/HttpServer.cc.o"
+  "CMakeFiles/httpServer.dir/src/HttpServer.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/RateLimiter.cc.o"
+  "CMakeFiles/httpServer.dir/src/RateLimiter.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/WebSocket.cc.o"
+  "CMakeFiles/httpServer.dir/src/WebSocket.cc.o.d"
+  "CMakeFiles/httpServer.dir/src/app.cc.o"
+  "CMakeFiles/httpServer.dir/src/app.cc.o.d"
+  "httpServer"
+  "httpServer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/httpServer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HPackTest.dir/HPack_unit.cc.o"
+  "CMakeFiles/HPackTest.dir/HPack_unit.cc.o.d"
+  "CMakeFiles/HPackTest.dir/__/src/HPack.cc.o"
+  "CMakeFiles/HPackTest.dir/__/src/HPack.cc.o.d"
+  "HPackTest"
+  "HPackTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HPackTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Http2SessionTest.dir/Http2Session_unit.cc.o"
+  "CMakeFiles/Http2SessionTest.dir/Http2Session_unit.cc.o.d"
+  "CMakeFiles/Http2SessionTest.dir/__/src/HPack.cc.o"
+  "CMakeFiles/Http2SessionTest.dir/__/src/HPack.cc.o.d"
+  "CMakeFiles/Http2SessionTest.dir/__/src/Http2Session.cc.o"
+  "CMakeFiles/Http2SessionTest.dir/__/src/Http2Session.cc.o.d"
+  "Http2SessionTest"
+  "Http2SessionTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Http2SessionTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
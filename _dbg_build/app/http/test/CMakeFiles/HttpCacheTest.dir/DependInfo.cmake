@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/app/http/test/HttpCache_unit.cc" "app/http/test/CMakeFiles/HttpCacheTest.dir/HttpCache_unit.cc.o" "gcc" "app/http/test/CMakeFiles/HttpCacheTest.dir/HttpCache_unit.cc.o.d"
+  "/root/repo/app/http/src/HttpCache.cc" "app/http/test/CMakeFiles/HttpCacheTest.dir/__/src/HttpCache.cc.o" "gcc" "app/http/test/CMakeFiles/HttpCacheTest.dir/__/src/HttpCache.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/LuxLog/CMakeFiles/LuxLog.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/polaris/CMakeFiles/polaris.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HttpCacheTest.dir/HttpCache_unit.cc.o"
+  "CMakeFiles/HttpCacheTest.dir/HttpCache_unit.cc.o.d"
+  "CMakeFiles/HttpCacheTest.dir/__/src/HttpCache.cc.o"
+  "CMakeFiles/HttpCacheTest.dir/__/src/HttpCache.cc.o.d"
+  "HttpCacheTest"
+  "HttpCacheTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HttpCacheTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HttpProxyTest.dir/HttpProxy_unit.cc.o"
+  "CMakeFiles/HttpProxyTest.dir/HttpProxy_unit.cc.o.d"
+  "CMakeFiles/HttpProxyTest.dir/__/src/HttpProxy.cc.o"
+  "CMakeFiles/HttpProxyTest.dir/__/src/HttpProxy.cc.o.d"
+  "HttpProxyTest"
+  "HttpProxyTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HttpProxyTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
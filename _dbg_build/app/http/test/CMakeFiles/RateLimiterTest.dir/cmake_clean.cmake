@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/RateLimiterTest.dir/RateLimiter_unit.cc.o"
+  "CMakeFiles/RateLimiterTest.dir/RateLimiter_unit.cc.o.d"
+  "CMakeFiles/RateLimiterTest.dir/__/src/RateLimiter.cc.o"
+  "CMakeFiles/RateLimiterTest.dir/__/src/RateLimiter.cc.o.d"
+  "RateLimiterTest"
+  "RateLimiterTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/RateLimiterTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
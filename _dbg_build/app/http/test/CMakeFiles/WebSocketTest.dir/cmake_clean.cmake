@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/WebSocketTest.dir/WebSocket_unit.cc.o"
+  "CMakeFiles/WebSocketTest.dir/WebSocket_unit.cc.o.d"
+  "CMakeFiles/WebSocketTest.dir/__/src/WebSocket.cc.o"
+  "CMakeFiles/WebSocketTest.dir/__/src/WebSocket.cc.o.d"
+  "WebSocketTest"
+  "WebSocketTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/WebSocketTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
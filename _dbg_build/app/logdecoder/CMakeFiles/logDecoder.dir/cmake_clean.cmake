@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/logDecoder.dir/src/LogDecoder.cc.o"
+  "CMakeFiles/logDecoder.dir/src/LogDecoder.cc.o.d"
+  "logDecoder"
+  "logDecoder.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/logDecoder.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
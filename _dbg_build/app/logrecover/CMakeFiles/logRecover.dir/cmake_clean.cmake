@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/logRecover.dir/src/LogRecover.cc.o"
+  "CMakeFiles/logRecover.dir/src/LogRecover.cc.o.d"
+  "logRecover"
+  "logRecover.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/logRecover.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
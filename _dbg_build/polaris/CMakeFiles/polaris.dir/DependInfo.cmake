@@ -0,0 +1,37 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/polaris/src/Acceptor.cc" "polaris/CMakeFiles/polaris.dir/src/Acceptor.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Acceptor.cc.o.d"
+  "/root/repo/polaris/src/Buffer.cc" "polaris/CMakeFiles/polaris.dir/src/Buffer.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Buffer.cc.o.d"
+  "/root/repo/polaris/src/Channel.cc" "polaris/CMakeFiles/polaris.dir/src/Channel.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Channel.cc.o.d"
+  "/root/repo/polaris/src/Connector.cc" "polaris/CMakeFiles/polaris.dir/src/Connector.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Connector.cc.o.d"
+  "/root/repo/polaris/src/EPollPoller.cc" "polaris/CMakeFiles/polaris.dir/src/EPollPoller.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/EPollPoller.cc.o.d"
+  "/root/repo/polaris/src/EventLoop.cc" "polaris/CMakeFiles/polaris.dir/src/EventLoop.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/EventLoop.cc.o.d"
+  "/root/repo/polaris/src/EventLoopThread.cc" "polaris/CMakeFiles/polaris.dir/src/EventLoopThread.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/EventLoopThread.cc.o.d"
+  "/root/repo/polaris/src/EventLoopThreadPool.cc" "polaris/CMakeFiles/polaris.dir/src/EventLoopThreadPool.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/EventLoopThreadPool.cc.o.d"
+  "/root/repo/polaris/src/FileWatcher.cc" "polaris/CMakeFiles/polaris.dir/src/FileWatcher.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/FileWatcher.cc.o.d"
+  "/root/repo/polaris/src/InetAddress.cc" "polaris/CMakeFiles/polaris.dir/src/InetAddress.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/InetAddress.cc.o.d"
+  "/root/repo/polaris/src/Poller.cc" "polaris/CMakeFiles/polaris.dir/src/Poller.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Poller.cc.o.d"
+  "/root/repo/polaris/src/Sockets.cc" "polaris/CMakeFiles/polaris.dir/src/Sockets.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Sockets.cc.o.d"
+  "/root/repo/polaris/src/TCPClient.cc" "polaris/CMakeFiles/polaris.dir/src/TCPClient.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/TCPClient.cc.o.d"
+  "/root/repo/polaris/src/TCPConnection.cc" "polaris/CMakeFiles/polaris.dir/src/TCPConnection.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/TCPConnection.cc.o.d"
+  "/root/repo/polaris/src/TCPServer.cc" "polaris/CMakeFiles/polaris.dir/src/TCPServer.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/TCPServer.cc.o.d"
+  "/root/repo/polaris/src/Timer.cc" "polaris/CMakeFiles/polaris.dir/src/Timer.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/Timer.cc.o.d"
+  "/root/repo/polaris/src/TimerQueue.cc" "polaris/CMakeFiles/polaris.dir/src/TimerQueue.cc.o" "gcc" "polaris/CMakeFiles/polaris.dir/src/TimerQueue.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_dbg_build/LuxUtils/CMakeFiles/LuxUtils.dir/DependInfo.cmake"
+  "/root/repo/_dbg_build/LuxLog/CMakeFiles/LuxLog.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,43 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/polaris.dir/src/Acceptor.cc.o"
+  "CMakeFiles/polaris.dir/src/Acceptor.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Buffer.cc.o"
+  "CMakeFiles/polaris.dir/src/Buffer.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Channel.cc.o"
+  "CMakeFiles/polaris.dir/src/Channel.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Connector.cc.o"
+  "CMakeFiles/polaris.dir/src/Connector.cc.o.d"
+  "CMakeFiles/polaris.dir/src/EPollPoller.cc.o"
+  "CMakeFiles/polaris.dir/src/EPollPoller.cc.o.d"
+  "CMakeFiles/polaris.dir/src/EventLoop.cc.o"
+  "CMakeFiles/polaris.dir/src/EventLoop.cc.o.d"
+  "CMakeFiles/polaris.dir/src/EventLoopThread.cc.o"
+  "CMakeFiles/polaris.dir/src/EventLoopThread.cc.o.d"
+  "CMakeFiles/polaris.dir/src/EventLoopThreadPool.cc.o"
+  "CMakeFiles/polaris.dir/src/EventLoopThreadPool.cc.o.d"
+  "CMakeFiles/polaris.dir/src/FileWatcher.cc.o"
+  "CMakeFiles/polaris.dir/src/FileWatcher.cc.o.d"
+  "CMakeFiles/polaris.dir/src/InetAddress.cc.o"
+  "CMakeFiles/polaris.dir/src/InetAddress.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Poller.cc.o"
+  "CMakeFiles/polaris.dir/src/Poller.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Sockets.cc.o"
+  "CMakeFiles/polaris.dir/src/Sockets.cc.o.d"
+  "CMakeFiles/polaris.dir/src/TCPClient.cc.o"
+  "CMakeFiles/polaris.dir/src/TCPClient.cc.o.d"
+  "CMakeFiles/polaris.dir/src/TCPConnection.cc.o"
+  "CMakeFiles/polaris.dir/src/TCPConnection.cc.o.d"
+  "CMakeFiles/polaris.dir/src/TCPServer.cc.o"
+  "CMakeFiles/polaris.dir/src/TCPServer.cc.o.d"
+  "CMakeFiles/polaris.dir/src/Timer.cc.o"
+  "CMakeFiles/polaris.dir/src/Timer.cc.o.d"
+  "CMakeFiles/polaris.dir/src/TimerQueue.cc.o"
+  "CMakeFiles/polaris.dir/src/TimerQueue.cc.o.d"
+  "libpolaris.a"
+  "libpolaris.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/polaris.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CoroutineEcho.dir/CoroutineEcho_unit.cc.o"
+  "CMakeFiles/CoroutineEcho.dir/CoroutineEcho_unit.cc.o.d"
+  "CoroutineEcho"
+  "CoroutineEcho.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CoroutineEcho.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/EchoClient.dir/EchoClient_unit.cc.o"
+  "CMakeFiles/EchoClient.dir/EchoClient_unit.cc.o.d"
+  "EchoClient"
+  "EchoClient.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/EchoClient.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/EchoServer.dir/EchoServer_unit.cc.o"
+  "CMakeFiles/EchoServer.dir/EchoServer_unit.cc.o.d"
+  "EchoServer"
+  "EchoServer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/EchoServer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
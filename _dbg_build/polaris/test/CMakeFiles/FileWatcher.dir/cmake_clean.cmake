@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FileWatcher.dir/FileWatcher_unit.cc.o"
+  "CMakeFiles/FileWatcher.dir/FileWatcher_unit.cc.o.d"
+  "FileWatcher"
+  "FileWatcher.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FileWatcher.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,93 @@
+/**
+ * @file HPack.h
+ * @brief HPACK: Header Compression for HTTP/2 (RFC 7541)
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Types.h>
+#include <polaris/Buffer.h>
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Lux {
+namespace http {
+namespace hpack {
+
+using HeaderField = std::pair<string, string>;
+using HeaderList = std::vector<HeaderField>;
+
+/// Size of the table entry, RFC 7541 4.1
+inline size_t entrySize(const HeaderField& field) {
+    return field.first.size() + field.second.size() + 32;
+}
+
+/// @brief Decode a Huffman encoded string literal, RFC 7541 5.2
+/// @return false if padding is invalid or EOS is found in the string.
+bool huffmanDecode(const char* data, size_t len, string* out);
+
+/// @brief Length of @c data Huffman encoded, in bytes, RFC 7541 5.2
+size_t huffmanEncodedLength(const char* data, size_t len);
+
+/// @brief Huffman encode @c data, padded with the most significant bits of
+/// EOS to an octet boundary.
+void huffmanEncode(const char* data, size_t len, polaris::Buffer* out);
+
+enum class DecodeResult {
+    kOk,
+    // malformed, COMPRESSION_ERROR
+    kError,
+    // the header list is larger than the limit, decoding stopped there
+    kTooLarge,
+};
+
+/// @brief Header block decoder, one per connection.
+/// Not thread safe, but always used in the loop of the connection.
+class Decoder {
+private:
+    // newest entry at front, so that dynamic index 1 is entries_[0]
+    std::deque<HeaderField> entries_;
+    size_t size_;
+    size_t maxSize_;
+    // upper bound advertised by SETTINGS_HEADER_TABLE_SIZE
+    const size_t capacity_;
+    // of the decoded header list, counted as entrySize() of each field
+    const size_t maxHeaderListSize_;
+
+    bool lookup(uint64_t index, HeaderField* field) const;
+    void insert(HeaderField field);
+    void evict();
+
+public:
+    explicit Decoder(size_t capacity = 4096,
+                     size_t maxHeaderListSize = 64 * 1024)
+        : size_(0),
+          maxSize_(capacity),
+          capacity_(capacity),
+          maxHeaderListSize_(maxHeaderListSize) {}
+
+    /// @brief Decode a complete header block (HEADERS + CONTINUATION).
+    /// A few bytes of indexed fields may expand to a lot more, so decoding
+    /// stops once the header list is larger than @c maxHeaderListSize.
+    /// @return anything but kOk leaves the dynamic table out of sync with
+    /// the peer, the connection must be closed.
+    DecodeResult decode(const char* data, size_t len, HeaderList* headers);
+};
+
+/// @brief Header block encoder.
+/// It never inserts into the dynamic table, so it needs no state and
+/// ignores the peer's SETTINGS_HEADER_TABLE_SIZE.
+/// String literals are Huffman encoded if that is shorter.
+class Encoder {
+public:
+    /// Header names must be lower case.
+    void encode(const HeaderList& headers, polaris::Buffer* out) const;
+};
+
+}  // namespace hpack
+}  // namespace http
+}  // namespace Lux
@@ -0,0 +1,175 @@
+/**
+ * @file Http2Session.h
+ * @brief HTTP/2 over cleartext TCP (h2c), RFC 7540
+ *  - prior knowledge: the client starts with the connection preface
+ *  - HTTP/1.1 Upgrade: h2c, the request becomes stream 1
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Timestamp.h>
+#include <http/HPack.h>
+#include <http/HttpRequest.h>
+#include <polaris/Buffer.h>
+#include <polaris/Callbacks.h>
+
+#include <functional>
+#include <map>
+
+namespace Lux {
+namespace http {
+
+class HttpResponse;
+
+/// @brief One HTTP/2 connection, multiplexes concurrent streams and
+/// does flow control in both directions.
+///
+/// Requests are dispatched to the same HttpCallback as HTTP/1.x,
+/// the HttpResponse is then serialized into HEADERS and DATA frames.
+/// Not thread safe, but always used in the loop of the connection.
+class Http2Session {
+    Http2Session(const Http2Session&) = delete;
+    Http2Session& operator=(Http2Session&) = delete;
+
+public:
+    using HttpCallback = std::function<void(const HttpRequest&, HttpResponse*)>;
+
+    enum class FrameType : uint8_t {
+        kData = 0x0,
+        kHeaders = 0x1,
+        kPriority = 0x2,
+        kRstStream = 0x3,
+        kSettings = 0x4,
+        kPushPromise = 0x5,
+        kPing = 0x6,
+        kGoAway = 0x7,
+        kWindowUpdate = 0x8,
+        kContinuation = 0x9,
+    };
+
+    enum class ErrorCode : uint32_t {
+        kNoError = 0x0,
+        kProtocolError = 0x1,
+        kInternalError = 0x2,
+        kFlowControlError = 0x3,
+        kSettingsTimeout = 0x4,
+        kStreamClosed = 0x5,
+        kFrameSizeError = 0x6,
+        kRefusedStream = 0x7,
+        kCancel = 0x8,
+        kCompressionError = 0x9,
+        kConnectError = 0xa,
+        kEnhanceYourCalm = 0xb,
+    };
+
+    static const char kPreface[];
+    static const size_t kPrefaceLength = 24;
+    static const size_t kFrameHeaderLength = 9;
+    static const int32_t kDefaultWindowSize = 65535;
+    static const uint32_t kMaxConcurrentStreams = 100;
+    /// request body of a stream, reset by ENHANCE_YOUR_CALM beyond this
+    static const size_t kMaxBodySize = 8 * 1024 * 1024;
+    /// decoded request headers, advertised as SETTINGS_MAX_HEADER_LIST_SIZE,
+    /// the connection is closed by ENHANCE_YOUR_CALM beyond this
+    static const uint32_t kMaxHeaderListSize = 64 * 1024;
+
+    /// @brief Check whether @c buf starts with the client connection preface.
+    /// @return 1 if matched, 0 if more data is needed, -1 if not matched.
+    static int checkPreface(const polaris::Buffer& buf);
+
+private:
+    struct Stream {
+        HttpRequest request;
+        string body;
+        // request received completely, END_STREAM from peer
+        bool remoteClosed = false;
+        int32_t sendWindow = kDefaultWindowSize;
+        int32_t recvWindow = kDefaultWindowSize;
+        // response body not sent yet due to flow control
+        string pending;
+        size_t pendingOffset = 0;
+        bool responding = false;
+    };
+
+    polaris::TCPConnection* conn_;
+    HttpCallback httpCallback_;
+    hpack::Decoder decoder_;
+    hpack::Encoder encoder_;
+
+    std::map<uint32_t, Stream> streams_;
+    // the highest stream id initiated by the peer
+    uint32_t lastStreamId_;
+    // stream id waiting for CONTINUATION, 0 if none
+    uint32_t continuationStreamId_;
+    bool continuationEndStream_;
+    string headerBlock_;
+
+    bool expectPreface_;
+    bool expectSettings_;
+    // GOAWAY received, shutdown when all streams are done
+    bool goAway_;
+    // GOAWAY sent on connection error, ignore everything then
+    bool dead_;
+
+    // peer's settings
+    int32_t peerInitialWindowSize_;
+    uint32_t peerMaxFrameSize_;
+
+    int32_t sendWindow_;
+    int32_t recvWindow_;
+
+    // frames are batched here and sent at the end of each read
+    polaris::Buffer output_;
+
+private:
+    bool handleFrame(FrameType type, uint8_t flags, uint32_t streamId,
+                     const char* payload, size_t len, Timestamp receiveTime);
+    bool onHeaders(uint8_t flags, uint32_t streamId, const char* payload,
+                   size_t len, Timestamp receiveTime);
+    bool onContinuation(uint8_t flags, uint32_t streamId, const char* payload,
+                        size_t len, Timestamp receiveTime);
+    bool onData(uint8_t flags, uint32_t streamId, const char* payload,
+                size_t len);
+    bool onSettings(uint8_t flags, uint32_t streamId, const char* payload,
+                    size_t len);
+    ErrorCode applySettings(const char* payload, size_t len);
+    bool onWindowUpdate(uint32_t streamId, const char* payload, size_t len);
+    bool endHeaders(uint32_t streamId, bool endStream, Timestamp receiveTime);
+
+    void dispatch(uint32_t streamId);
+    void flushStream(uint32_t streamId, Stream* stream);
+    void flushAll();
+    void closeStream(uint32_t streamId);
+
+    void sendSettings();
+    void sendWindowUpdate(uint32_t streamId, uint32_t increment);
+    void sendFrame(FrameType type, uint8_t flags, uint32_t streamId,
+                   const char* payload, size_t len);
+    void resetStream(uint32_t streamId, ErrorCode code);
+    /// @brief Send GOAWAY and close the connection.
+    /// @return always false, for convenience of the frame handlers
+    bool connectionError(ErrorCode code);
+    void flush();
+
+public:
+    Http2Session(polaris::TCPConnection* conn, const HttpCallback& cb);
+
+    /// @brief Prior knowledge, the preface is the next thing to read.
+    void start();
+
+    /// @brief Switch from HTTP/1.1, sends "101 Switching Protocols" and
+    /// answers @c request on stream 1.
+    /// @param settings value of the HTTP2-Settings header
+    /// @return false if HTTP2-Settings is malformed, nothing is sent then and
+    /// the request should be served as HTTP/1.1.
+    bool upgrade(const string& settings, const HttpRequest& request);
+
+    /// @brief Consume frames in @c buf.
+    /// @return false on connection error, GOAWAY has been sent then.
+    bool onMessage(polaris::Buffer* buf, Timestamp receiveTime);
+};
+
+}  // namespace http
+}  // namespace Lux
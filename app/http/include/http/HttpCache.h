@@ -0,0 +1,80 @@
+/**
+ * @file HttpCache.h
+ * @brief Response cache of HttpServer, one per IO loop
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Timestamp.h>
+#include <LuxUtils/Types.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Lux {
+namespace http {
+
+class HttpRequest;
+
+/// @brief Fully serialized responses keyed by method, path, query and the
+/// request headers named by Vary.
+///
+/// A hit is answered by a single send of the shared bytes, the HttpCallback
+/// is not called. Handlers opt in by HttpResponse::setCacheTtl().
+///
+/// Not thread safe, each IO loop has its own, so no locking is needed.
+class HttpCache {
+    HttpCache(const HttpCache&) = delete;
+    HttpCache& operator=(HttpCache&) = delete;
+
+public:
+    using Bytes = std::shared_ptr<const string>;
+
+private:
+    struct Entry {
+        Bytes bytes;
+        Timestamp expiration;
+    };
+
+    /// All variants of one method + path + query
+    struct Resource {
+        // request headers which select the variant, from Vary
+        std::vector<string> vary;
+        // variant key (values of the vary headers) -> entry
+        std::unordered_map<string, Entry> variants;
+    };
+
+    std::unordered_map<string, Resource> resources_;
+    const size_t capacity_;
+    size_t size_;
+
+    static string resourceKey(const HttpRequest& req);
+    static string variantKey(const HttpRequest& req,
+                             const std::vector<string>& vary);
+    /// Drop expired entries, also empty resources.
+    void purge(Timestamp now);
+
+public:
+    /// @param capacity max bytes of the cached responses
+    explicit HttpCache(size_t capacity) : capacity_(capacity), size_(0) {}
+
+    /// @brief Whether responses of @c req may be cached, GET and HEAD only.
+    static bool cacheable(const HttpRequest& req);
+
+    /// @return the serialized response, null if missed or expired.
+    Bytes get(const HttpRequest& req, Timestamp now);
+
+    /// @brief Cache @c bytes for @c ttl seconds, nothing is done if the cache
+    /// is full of unexpired entries.
+    void put(const HttpRequest& req, const std::vector<string>& vary,
+             StringPiece bytes, double ttl, Timestamp now);
+
+    size_t size() const { return size_; }
+};
+
+}  // namespace http
+}  // namespace Lux
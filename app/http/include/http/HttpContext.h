@@ -5,11 +5,20 @@
  * @author Lux
  */
 
+#pragma once
+
 #include <http/HttpRequest.h>
 #include <polaris/Buffer.h>
 
+#include <memory>
+
 namespace Lux {
 namespace http {
+
+class Http2Session;
+class HttpCache;
+class WebSocket;
+
 class HttpContext {
 public:
     enum class HttpRequestParseState {
@@ -22,17 +31,32 @@ public:
 private:
     HttpRequestParseState state_;
     HttpRequest request_;
+    // set after switching to HTTP/2, outlives reset()
+    std::shared_ptr<Http2Session> http2Session_;
+    // set after the WebSocket handshake, outlives reset()
+    std::shared_ptr<WebSocket> webSocket_;
+    // waiting for the upstream, the next request is not parsed until done
+    bool proxying_;
+    // response cache of the loop, null if disabled
+    HttpCache* cache_;
 
     bool processRequestLine(const char* begin, const char* end);
 
 public:
-    HttpContext() : state_(HttpRequestParseState::kExpectRequestLine) {}
+    HttpContext()
+        : state_(HttpRequestParseState::kExpectRequestLine),
+          proxying_(false),
+          cache_(nullptr) {}
 
     // default copy-ctor, dtor and assignment are fine
 
     // return false if any error
     bool parseRequest(Lux::polaris::Buffer* buf, Timestamp receiveTime);
 
+    bool expectRequestLine() const {
+        return state_ == HttpRequestParseState::kExpectRequestLine;
+    }
+
     bool gotAll() const { return state_ == HttpRequestParseState::kGotAll; }
 
     void reset() {
@@ -44,6 +68,26 @@ public:
     const HttpRequest& request() const { return request_; }
 
     HttpRequest& request() { return request_; }
+
+    void setHttp2Session(const std::shared_ptr<Http2Session>& session) {
+        http2Session_ = session;
+    }
+
+    const std::shared_ptr<Http2Session>& http2Session() const {
+        return http2Session_;
+    }
+
+    void setWebSocket(const std::shared_ptr<WebSocket>& webSocket) {
+        webSocket_ = webSocket;
+    }
+
+    const std::shared_ptr<WebSocket>& webSocket() const { return webSocket_; }
+
+    void setProxying(bool on) { proxying_ = on; }
+    bool proxying() const { return proxying_; }
+
+    void setCache(HttpCache* cache) { cache_ = cache; }
+    HttpCache* cache() const { return cache_; }
 };
 }  // namespace http
 }  // namespace Lux
@@ -0,0 +1,101 @@
+/**
+ * @file HttpProxy.h
+ * @brief Reverse proxy, forwards HTTP/1.1 requests to an upstream server
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Mutex.h>
+#include <polaris/polaris.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Lux {
+namespace http {
+
+class HttpRequest;
+
+/// @brief Forwards requests to one upstream server over keep-alive
+/// connections.
+///
+/// Each IO loop has its own pool of TCPClient, so a request is relayed
+/// entirely in the loop of the downstream connection without locking.
+/// Response bytes are written to the downstream connection straight from
+/// the upstream input Buffer. Only the header block is parsed, to find the
+/// end of the response, and rewritten for the downstream connection: its
+/// HTTP version and Connection header, no hop-by-hop headers of upstream.
+/// A chunked response to an HTTP/1.0 client is dechunked and delimited by
+/// closing the connection. The request, body included, is serialized from the
+/// parsed HttpRequest and so copied once.
+///
+/// Registered to HttpServer by HttpServer::addProxy().
+class HttpProxy {
+    HttpProxy(const HttpProxy&) = delete;
+    HttpProxy& operator=(HttpProxy&) = delete;
+
+public:
+    /// @brief Called in the downstream loop when the response is complete.
+    /// @param keepAlive false if the downstream connection must be closed,
+    /// e.g. the response is delimited by closing the connection.
+    using DoneCallback =
+        std::function<void(const polaris::TCPConnectionPtr&, bool keepAlive)>;
+
+private:
+    struct Exchange;
+    struct Upstream;
+    struct LoopPool;
+    using ExchangePtr = std::shared_ptr<Exchange>;
+
+    const polaris::InetAddress upstreamAddr_;
+    const string name_;
+    size_t maxConnections_;
+    double timeout_;
+
+    MutexLock mutex_;
+    std::map<polaris::EventLoop*, std::unique_ptr<LoopPool>> pools_
+        GUARDED_BY(mutex_);
+
+    LoopPool* poolOf(polaris::EventLoop* loop);
+    void newUpstream(LoopPool* pool);
+    /// Hand pending requests to idle connections, connect more if needed.
+    void dispatch(LoopPool* pool);
+    void onUpstreamConnection(LoopPool* pool, Upstream* upstream,
+                              const polaris::TCPConnectionPtr& conn);
+    void onUpstreamMessage(LoopPool* pool, Upstream* upstream,
+                           polaris::Buffer* buf);
+    /// @return false if the response is malformed
+    bool relay(Upstream* upstream, polaris::Buffer* buf);
+    void finishExchange(LoopPool* pool, Upstream* upstream);
+    void failExchange(LoopPool* pool, const ExchangePtr& exchange,
+                      const char* response);
+    void onTimeout(LoopPool* pool, const std::weak_ptr<Exchange>& weakExchange);
+
+public:
+    HttpProxy(const polaris::InetAddress& upstreamAddr, const string& name);
+    ~HttpProxy();
+
+    /// Max upstream connections per IO loop, 16 by default.
+    /// Not thread safe, be called before the server starts.
+    void setMaxConnections(size_t n) { maxConnections_ = n; }
+
+    /// Answer 504 if the response does not start in @c seconds, 30 by default.
+    /// Not thread safe, be called before the server starts.
+    void setTimeout(double seconds) { timeout_ = seconds; }
+
+    /// @brief Forward @c req, the response is relayed to @c downstream.
+    /// @c req is serialized before returning. Called in the loop of
+    /// @c downstream.
+    /// @param close the downstream connection will be closed after the
+    /// response, which then says "Connection: close".
+    void forward(const polaris::TCPConnectionPtr& downstream,
+                 const HttpRequest& req, bool close, const DoneCallback& done);
+};
+
+}  // namespace http
+}  // namespace Lux
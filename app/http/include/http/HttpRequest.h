@@ -9,6 +9,7 @@
 
 #include <LuxUtils/Timestamp.h>
 #include <LuxUtils/Types.h>
+#include <strings.h>
 
 #include <map>
 
@@ -17,7 +18,7 @@ namespace http {
 class HttpRequest {
 public:
     enum class Method { kInvalid, kGet, kPost, kHead, kPut, kDelete };
-    enum class Version { kUnknown, kHttp10, kHttp11 };
+    enum class Version { kUnknown, kHttp10, kHttp11, kHttp20 };
 
 private:
     Method method_;
@@ -65,18 +66,18 @@ public:
                 break;
 
             case Method::kPost:
-                result = "GET";
+                result = "POST";
                 break;
 
             case Method::kHead:
-                result = "GET";
+                result = "HEAD";
                 break;
 
             case Method::kPut:
-                result = "GET";
+                result = "PUT";
                 break;
             case Method::kDelete:
-                result = "GET";
+                result = "DELETE";
                 break;
             default:
                 break;
@@ -109,6 +110,9 @@ public:
             value.resize(value.size() - 1);
         headers_[field] = value;
     }
+    void addHeader(const string& field, const string& value) {
+        headers_[field] = value;
+    }
     string getHeader(const string& field) const {
         // string result;
         auto iter = headers_.find(field);
@@ -117,6 +121,15 @@ public:
 
         return iter != headers_.end() ? iter->second : "";
     }
+    // header names are case-insensitive, RFC 7230 3.2
+    string getHeaderIgnoreCase(const char* field) const {
+        for (const auto& header : headers_) {
+            if (strcasecmp(header.first.c_str(), field) == 0) {
+                return header.second;
+            }
+        }
+        return "";
+    }
     const std::map<string, string>& headers() const { return headers_; }
 
     void setBody(const string& body) { body_ = body; }
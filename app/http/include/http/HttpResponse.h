@@ -11,6 +11,7 @@
 #include <polaris/Buffer.h>
 
 #include <map>
+#include <vector>
 
 namespace Lux {
 namespace http {
@@ -22,6 +23,8 @@ public:
         k301MovedPermanently = 301,
         k400BadRequest = 400,
         k404NotFound = 404,
+        k429TooManyRequests = 429,
+        k503ServiceUnavailable = 503,
     };
 
 private:
@@ -31,14 +34,22 @@ private:
     string statusMessage_;
     bool closeConnection_;
     string body_;
+    // seconds that HttpServer may answer the same request with this response
+    double cacheTtl_;
+    // request headers which the response depends on
+    std::vector<string> vary_;
 
 public:
     explicit HttpResponse(bool close)
-        : statusCode_(HttpStatusCode::kUnknown), closeConnection_(close) {}
+        : statusCode_(HttpStatusCode::kUnknown),
+          closeConnection_(close),
+          cacheTtl_(0) {}
 
     void setStatusCode(HttpStatusCode code) { statusCode_ = code; }
+    HttpStatusCode statusCode() const { return statusCode_; }
 
     void setStatusMessage(const string& message) { statusMessage_ = message; }
+    const string& statusMessage() const { return statusMessage_; }
 
     void setCloseConnection(bool on) { closeConnection_ = on; }
 
@@ -52,8 +63,24 @@ public:
     void addHeader(const string& key, const string& value) {
         headers_[key] = value;
     }
+    const std::map<string, string>& headers() const { return headers_; }
 
     void setBody(const string& body) { body_ = body; }
+    const string& body() const { return body_; }
+
+    /// Opt in to the response cache of HttpServer, 0 disables.
+    void setCacheTtl(double seconds) { cacheTtl_ = seconds; }
+    double cacheTtl() const { return cacheTtl_; }
+
+    /// The response varies with request header @c field, cached responses
+    /// are keyed by its value too. Also sets the Vary header.
+    void addVary(const string& field) {
+        vary_.push_back(field);
+        string& header = headers_["Vary"];
+        if (!header.empty()) header.append(", ");
+        header.append(field);
+    }
+    const std::vector<string>& vary() const { return vary_; }
 
     void appendToBuffer(Lux::polaris::Buffer* output) const;
 };
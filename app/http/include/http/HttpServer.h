@@ -7,9 +7,15 @@
 
 #pragma once
 
+#include <LuxUtils/Atomic.h>
+#include <LuxUtils/Mutex.h>
+#include <http/WebSocket.h>
 #include <polaris/polaris.h>
 
 #include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "polaris/Callbacks.h"
 
@@ -18,11 +24,39 @@ namespace http {
 
 class HttpResponse;
 class HttpRequest;
+class HttpContext;
+class Http2Session;
+class HttpProxy;
+class HttpCache;
+class RateLimiter;
+
+namespace detail {
+struct InflightRequest;
+}
 
 /// A simple embeddable HTTP server designed for report status of a program.
 /// It is not a fully HTTP 1.1 compliant server, but provides minimum features
 /// that can communicate with HttpClient and Web browser.
 /// It is synchronous, just like Java Servlet.
+///
+/// HTTP/2 over cleartext TCP (h2c) is served on the same port, either with
+/// prior knowledge or by HTTP/1.1 Upgrade, requests of all the streams go to
+/// the same HttpCallback.
+///
+/// WebSocket is enabled by setWebSocketOpenCallback(), a HTTP/1.1 request with
+/// "Upgrade: websocket" is then switched to a long-lived WebSocket.
+///
+/// HTTP/1.x requests can be forwarded to upstream servers by addProxy(), the
+/// connection waits for the upstream response before parsing the next request.
+///
+/// With enableResponseCache(), responses with HttpResponse::setCacheTtl() are
+/// kept serialized in a per-loop HttpCache and replayed without calling the
+/// HttpCallback.
+///
+/// Admission control sheds load before the HttpCallback is called: requests
+/// over setClientRateLimit() or addRouteRateLimit() are answered 429, those
+/// over setMaxInflightRequests() are answered 503 and the HTTP/1.x connection
+/// is closed. HTTP/2 streams are answered the same way, the connection stays.
 class HttpServer {
     HttpServer(const HttpServer&) = delete;
     HttpServer& operator=(HttpServer&) = delete;
@@ -34,19 +68,95 @@ private:
     polaris::TCPServer server_;
     HttpCallback httpCallback_;
 
+    WebSocket::OpenCallback webSocketOpenCallback_;
+    WebSocket::MessageCallback webSocketMessageCallback_;
+    WebSocket::CloseCallback webSocketCloseCallback_;
+    double webSocketPingInterval_;
+
+    // path prefix -> proxy, the first match wins
+    std::vector<std::pair<string, std::shared_ptr<HttpProxy>>> proxies_;
+
+    // bytes per loop, 0 if disabled
+    size_t cacheCapacity_;
+    MutexLock mutex_;
+    std::map<polaris::EventLoop*, std::unique_ptr<HttpCache>> caches_
+        GUARDED_BY(mutex_);
+
+    // keyed by client IP, null if disabled
+    std::unique_ptr<RateLimiter> clientLimiter_;
+    // path prefix -> limiter of the route, all matches apply
+    std::vector<std::pair<string, std::unique_ptr<RateLimiter>>> routeLimiters_;
+    // requests being handled or proxied, 0 if unlimited
+    int maxInflightRequests_;
+    AtomicInt32 inflightRequests_;
+
 public:
     HttpServer(polaris::EventLoop* loop, const polaris::InetAddress& listenAddr,
                const string& name,
                polaris::TCPServer::Option option =
                    polaris::TCPServer::Option::kNoReusePort);
+    ~HttpServer();
 
     polaris::EventLoop* getLoop() const { return server_.getLoop(); }
 
     // Not thread safe, callback be registered before calling start().
     void setHttpCallback(const HttpCallback& cb) { httpCallback_ = cb; }
 
+    // Not thread safe, callbacks be registered before calling start().
+    void setWebSocketOpenCallback(const WebSocket::OpenCallback& cb) {
+        webSocketOpenCallback_ = cb;
+    }
+    void setWebSocketMessageCallback(const WebSocket::MessageCallback& cb) {
+        webSocketMessageCallback_ = cb;
+    }
+    void setWebSocketCloseCallback(const WebSocket::CloseCallback& cb) {
+        webSocketCloseCallback_ = cb;
+    }
+    /// Ping idle WebSockets every @c seconds, 0 disables keepalive.
+    void setWebSocketPingInterval(double seconds) {
+        webSocketPingInterval_ = seconds;
+    }
+
+    /// Forward HTTP/1.x requests whose path starts with @c pathPrefix.
+    /// Not thread safe, be called before calling start().
+    void addProxy(const string& pathPrefix,
+                  const std::shared_ptr<HttpProxy>& proxy) {
+        proxies_.emplace_back(pathPrefix, proxy);
+    }
+
     void setThreadNum(int numThreads) { server_.setThreadNum(numThreads); }
 
+    /// See TCPServer::setConfig(), be called before calling start().
+    void setConfig(const Config<polaris::TCPServer::Tunables>& config) {
+        server_.setConfig(config);
+    }
+
+    /// Cache HTTP/1.x responses which opt in by HttpResponse::setCacheTtl(),
+    /// up to @c capacityPerLoop bytes in each IO loop.
+    /// Not thread safe, be called before calling start().
+    void enableResponseCache(size_t capacityPerLoop) {
+        cacheCapacity_ = capacityPerLoop;
+    }
+
+    /// Allow @c rate requests per second from each client IP, with bursts of
+    /// up to @c burst requests.
+    /// Not thread safe, be called before calling start().
+    void setClientRateLimit(double rate, double burst);
+
+    /// Allow @c rate requests per second to the paths starting with
+    /// @c pathPrefix, from all clients together.
+    /// Not thread safe, be called before calling start().
+    void addRouteRateLimit(const string& pathPrefix, double rate, double burst);
+
+    /// Handle or proxy at most @c n requests at the same time, 0 means
+    /// unlimited.
+    /// A request counts while the HttpCallback runs, or until the upstream
+    /// response is done if proxied. The HttpCallback is synchronous, so the
+    /// limit is meaningful mostly for proxied requests; without proxies at
+    /// most one request per IO loop is in flight.
+    /// Not thread safe, be called before calling start().
+    void setMaxInflightRequests(int n) { maxInflightRequests_ = n; }
+
     void start();
 
 private:
@@ -54,7 +164,36 @@ private:
     void onMessage(const polaris::TCPConnectionPtr& conn, polaris::Buffer* buf,
                    Timestamp);
     void onWriteCompleteCallback(const polaris::TCPConnectionPtr& conn);
-    void onRequest(const polaris::TCPConnectionPtr& conn, const HttpRequest&);
+    void onRequest(const polaris::TCPConnectionPtr& conn, const HttpRequest&,
+                   HttpCache* cache);
+    /// HttpCallback of HTTP/2 streams, with admission control
+    void onHttp2Request(const string& clientIp, const HttpRequest& req,
+                        HttpResponse* resp);
+    HttpCache* cacheOf(polaris::EventLoop* loop);
+
+    enum class Admission { kAdmitted, kRateLimited, kOverloaded };
+    /// @c inflight counts the admitted request.
+    Admission checkAdmission(const string& clientIp, const HttpRequest& req,
+                             std::unique_ptr<detail::InflightRequest>* inflight);
+    /// @return false if the request is rejected, it has been answered
+    /// (429, or 503 and closed). @c inflight counts the admitted request.
+    bool admit(const polaris::TCPConnectionPtr& conn, const HttpRequest& req,
+               std::unique_ptr<detail::InflightRequest>* inflight);
+    std::shared_ptr<Http2Session> newHttp2Session(
+        const polaris::TCPConnectionPtr& conn);
+    /// @return true if switched to HTTP/2, the request has been answered
+    bool upgradeToHttp2(const polaris::TCPConnectionPtr& conn,
+                        HttpContext* context);
+    /// @return true if the request is a WebSocket handshake, it has been
+    /// answered (101, or 400/403 and closed)
+    bool upgradeToWebSocket(const polaris::TCPConnectionPtr& conn,
+                            HttpContext* context);
+    /// @return true if the request is forwarded to an upstream
+    bool forwardToProxy(const polaris::TCPConnectionPtr& conn,
+                        HttpContext* context,
+                        std::unique_ptr<detail::InflightRequest>* inflight);
+    void onProxyDone(const polaris::TCPConnectionPtr& conn, bool keepAlive,
+                     bool close);
 };
 }  // namespace http
 }  // namespace Lux
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * @file RateLimiter.h
+ * @brief Token bucket rate limiting of HttpServer
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Mutex.h>
+#include <LuxUtils/Timestamp.h>
+#include <LuxUtils/Types.h>
+
+#include <unordered_map>
+
+namespace Lux {
+namespace http {
+
+/// @brief Refilled by @c rate tokens per second, holds @c burst tokens at most.
+///
+/// Not thread safe.
+class TokenBucket {
+    double rate_;
+    double burst_;
+    double tokens_;
+    Timestamp last_;
+
+    void refill(Timestamp now);
+
+public:
+    /// The bucket is full at @c now.
+    TokenBucket(double rate, double burst, Timestamp now)
+        : rate_(rate), burst_(burst), tokens_(burst), last_(now) {}
+
+    /// @return true if a token is taken
+    bool consume(Timestamp now);
+
+    /// @return true if the bucket has been refilled completely, i.e. the
+    /// bucket can be dropped without changing the result of consume().
+    bool full(Timestamp now) const;
+};
+
+/// @brief One TokenBucket per key, e.g. client IP.
+///
+/// Thread safe, the keys are hashed to shards each with its own lock, so
+/// IO loops seldom contend. Buckets which have been refilled completely are
+/// dropped when a shard is full; if there is still no room, new keys are
+/// refused until some bucket is full again.
+class RateLimiter {
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(RateLimiter&) = delete;
+
+    static const size_t kShards = 16;
+
+    struct Shard {
+        MutexLock mutex;
+        std::unordered_map<string, TokenBucket> buckets GUARDED_BY(mutex);
+    };
+
+    const double rate_;
+    const double burst_;
+    const size_t maxKeysPerShard_;
+    Shard shards_[kShards];
+
+public:
+    /// @param maxKeys max buckets kept at the same time
+    RateLimiter(double rate, double burst, size_t maxKeys = 65536);
+
+    /// @return true if a request of @c key is allowed at @c now
+    bool allow(const string& key, Timestamp now);
+};
+
+}  // namespace http
+}  // namespace Lux
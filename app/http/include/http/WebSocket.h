@@ -0,0 +1,172 @@
+/**
+ * @file WebSocket.h
+ * @brief WebSocket (RFC 6455) on top of HttpServer
+ *  - handshake: HTTP/1.1 GET with "Upgrade: websocket", answered with 101
+ *  - framing: parsed directly on polaris::Buffer, unmasked with SSE2
+ *  - keepalive: ping on a loop timer, closed if no frame arrives in time
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/StringPiece.h>
+#include <LuxUtils/Timestamp.h>
+#include <http/HttpRequest.h>
+#include <polaris/Buffer.h>
+#include <polaris/Callbacks.h>
+#include <polaris/TimerId.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Lux {
+namespace polaris {
+class EventLoop;
+}  // namespace polaris
+
+namespace http {
+
+class WebSocket;
+using WebSocketPtr = std::shared_ptr<WebSocket>;
+
+namespace websocket {
+
+enum class Opcode : uint8_t {
+    kContinuation = 0x0,
+    kText = 0x1,
+    kBinary = 0x2,
+    kClose = 0x8,
+    kPing = 0x9,
+    kPong = 0xA,
+};
+
+enum class CloseCode : uint16_t {
+    kNormal = 1000,
+    kGoingAway = 1001,
+    kProtocolError = 1002,
+    kUnsupportedData = 1003,
+    kInvalidPayload = 1007,
+    kPolicyViolation = 1008,
+    kMessageTooBig = 1009,
+};
+
+struct FrameHeader {
+    bool fin;
+    Opcode opcode;
+    bool masked;
+    uint8_t maskingKey[4];
+    uint64_t payloadLength;
+    // length of the header itself, payload starts here
+    size_t headerLength;
+};
+
+enum class ParseResult { kIncomplete, kComplete, kError };
+
+/// @brief Parse the frame header at the beginning of @c buf, nothing is
+/// retrieved.
+/// @return kComplete if the header (not necessarily the payload) is there,
+/// kError if reserved bits are set.
+ParseResult parseFrameHeader(const polaris::Buffer& buf, FrameHeader* header);
+
+/// @brief dst[i] = src[i] ^ key[i % 4], @c dst may be equal to @c src.
+void unmask(char* dst, const char* src, size_t len, const uint8_t key[4]);
+
+/// @brief Append an unmasked frame, as sent by a server.
+void encodeFrame(Opcode opcode, bool fin, const char* payload, size_t len,
+                 polaris::Buffer* out);
+
+/// @brief Sec-WebSocket-Accept for the given Sec-WebSocket-Key.
+string acceptKey(const string& key);
+
+}  // namespace websocket
+
+/// @brief A server side WebSocket connection.
+///
+/// Created by HttpServer after the handshake, kept in the HttpContext of the
+/// TCP connection. send(), sendBinary(), ping() and close() are thread safe,
+/// the rest runs in the loop of the connection.
+class WebSocket : public std::enable_shared_from_this<WebSocket> {
+    WebSocket(const WebSocket&) = delete;
+    WebSocket& operator=(WebSocket&) = delete;
+
+public:
+    using Opcode = websocket::Opcode;
+    using CloseCode = websocket::CloseCode;
+
+    /// @brief Return false to reject the handshake with 403.
+    using OpenCallback = std::function<bool(const WebSocketPtr&)>;
+    /// @brief A complete (reassembled) message, @c opcode is kText or kBinary.
+    using MessageCallback = std::function<void(
+        const WebSocketPtr&, const string& message, Opcode opcode)>;
+    using CloseCallback = std::function<void(const WebSocketPtr&)>;
+
+    static const size_t kMaxMessageSize = 16 * 1024 * 1024;
+
+    /// @brief Whether @c req asks for a WebSocket upgrade.
+    static bool isUpgradeRequest(const HttpRequest& req);
+
+private:
+    std::weak_ptr<polaris::TCPConnection> conn_;
+    polaris::EventLoop* loop_;
+    HttpRequest request_;
+
+    MessageCallback messageCallback_;
+    CloseCallback closeCallback_;
+
+    // fragmented message being reassembled
+    string message_;
+    Opcode messageOpcode_;
+    bool fragmented_;
+
+    std::atomic<bool> closeSent_;
+    // read by connected() in any thread
+    std::atomic<bool> closed_;
+    // any frame received since last ping
+    bool alive_;
+    polaris::TimerId pingTimer_;
+
+    /// @return false if the connection is closing, stop parsing
+    bool handleFrame(const websocket::FrameHeader& header, const char* payload);
+    bool handleControlFrame(const websocket::FrameHeader& header,
+                            const char* payload);
+    void sendFrame(Opcode opcode, const char* payload, size_t len);
+    void closeInLoop(CloseCode code, const string& reason);
+    void onPingTimer();
+
+public:
+    WebSocket(const polaris::TCPConnectionPtr& conn, const HttpRequest& req);
+
+    /// @brief The handshake request, for path, query and headers.
+    const HttpRequest& request() const { return request_; }
+
+    bool connected() const { return !closed_ && !closeSent_; }
+
+    void setMessageCallback(const MessageCallback& cb) {
+        messageCallback_ = cb;
+    }
+    void setCloseCallback(const CloseCallback& cb) { closeCallback_ = cb; }
+
+    /// @brief Send a text message, @c text must be valid UTF-8.
+    void send(StringPiece text);
+    void sendBinary(StringPiece data);
+    void ping(StringPiece payload = StringPiece());
+    /// @brief Start the closing handshake, nothing can be sent afterwards.
+    void close(CloseCode code = CloseCode::kNormal, const string& reason = "");
+
+    // used by HttpServer
+
+    /// @brief Send ping every @c interval seconds, close the connection if
+    /// nothing was received in between. Called in loop.
+    void startKeepalive(double interval);
+
+    /// @brief Consume frames in @c buf.
+    void onMessage(polaris::Buffer* buf, Timestamp receiveTime);
+
+    /// @brief The TCP connection is down. Called in loop.
+    void onDisconnected();
+};
+
+}  // namespace http
+}  // namespace Lux
@@ -58,6 +58,9 @@ public:
     void onRequest(const HttpRequest& req, HttpResponse* resp);
 
     void setNumThreads(int num) { server_.setThreadNum(num); }
+    void setConfig(const Config<polaris::TCPServer::Tunables>& config) {
+        server_.setConfig(config);
+    }
     void start() { server_.start(); }
 
 private:
@@ -0,0 +1,434 @@
+/**
+ * @file HPack.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <http/HPack.h>
+
+#include <unordered_map>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::http::hpack;
+
+namespace {
+struct StaticEntry {
+    const char* name;
+    const char* value;
+};
+
+// RFC 7541 Appendix A, index starts from 1
+const StaticEntry kStaticTable[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+const uint64_t kStaticTableSize = sizeof kStaticTable / sizeof kStaticTable[0];
+static_assert(sizeof kStaticTable / sizeof kStaticTable[0] == 61,
+              "wrong number of static table entries");
+
+struct HuffmanCode {
+    uint32_t code;
+    int bits;
+};
+
+// RFC 7541 Appendix B, symbol 256 is EOS
+const HuffmanCode kHuffmanTable[] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+    {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+    {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+    {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+    {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+    {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12}, {0x1ff9, 13}, {0x15, 6},
+    {0xf8, 8}, {0x7fa, 11}, {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+    {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6}, {0x0, 5}, {0x1, 5}, {0x2, 5},
+    {0x19, 6}, {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6}, {0x1e, 6}, {0x1f, 6},
+    {0x5c, 7}, {0xfb, 8}, {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+    {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7}, {0x5f, 7}, {0x60, 7},
+    {0x61, 7}, {0x62, 7}, {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7}, {0x67, 7},
+    {0x68, 7}, {0x69, 7}, {0x6a, 7}, {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7}, {0xfc, 8}, {0x73, 7}, {0xfd, 8},
+    {0x1ffb, 13}, {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5}, {0x24, 6}, {0x5, 5}, {0x25, 6},
+    {0x26, 6}, {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7}, {0x28, 6}, {0x29, 6},
+    {0x2a, 6}, {0x7, 5}, {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5}, {0x9, 5},
+    {0x2d, 6}, {0x77, 7}, {0x78, 7}, {0x79, 7}, {0x7a, 7}, {0x7b, 7},
+    {0x7ffe, 15}, {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+    {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20}, {0x3fffd3, 22},
+    {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23}, {0x3fffd6, 22},
+    {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23}, {0x7fffdd, 23},
+    {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23}, {0xffffec, 24},
+    {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23}, {0xffffee, 24},
+    {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23}, {0x7fffe4, 23},
+    {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23}, {0x3fffd9, 22},
+    {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24}, {0x3fffda, 22},
+    {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22}, {0x3fffdc, 22},
+    {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21}, {0x7fffea, 23},
+    {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24}, {0x1fffdf, 21},
+    {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23}, {0x1fffe0, 21},
+    {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21}, {0x7fffed, 23},
+    {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23}, {0xfffea, 20},
+    {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22}, {0x7ffff0, 23},
+    {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23}, {0x3ffffe0, 26},
+    {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19}, {0x3fffe7, 22},
+    {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25}, {0x3ffffe2, 26},
+    {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27}, {0x7ffffdf, 27},
+    {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25}, {0x7fff2, 19},
+    {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27}, {0x7ffffe1, 27},
+    {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24}, {0x1fffe4, 21},
+    {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28},
+    {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27}, {0xfffec, 20},
+    {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21}, {0x3fffe9, 22},
+    {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23}, {0x3fffea, 22},
+    {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25}, {0xfffff4, 24},
+    {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23}, {0x3ffffeb, 26},
+    {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26}, {0x7ffffe7, 27},
+    {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27}, {0x7ffffeb, 27},
+    {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27}, {0x7ffffee, 27},
+    {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26}, {0x3fffffff, 30}
+};
+static_assert(sizeof kHuffmanTable / sizeof kHuffmanTable[0] == 257,
+              "wrong number of huffman codes");
+
+/// @brief Binary decoding tree built from kHuffmanTable.
+class HuffmanTree {
+public:
+    struct Node {
+        int child[2];
+        int symbol;  // -1 for internal nodes
+    };
+
+    HuffmanTree() {
+        nodes_.push_back(Node{{-1, -1}, -1});
+        for (int sym = 0; sym < 257; ++sym) {
+            const HuffmanCode& hc = kHuffmanTable[sym];
+            int node = 0;
+            for (int i = hc.bits - 1; i >= 0; --i) {
+                int bit = (hc.code >> i) & 1;
+                if (nodes_[node].child[bit] < 0) {
+                    nodes_[node].child[bit] = static_cast<int>(nodes_.size());
+                    nodes_.push_back(Node{{-1, -1}, -1});
+                }
+                node = nodes_[node].child[bit];
+            }
+            nodes_[node].symbol = sym;
+        }
+    }
+
+    const Node& node(int index) const { return nodes_[index]; }
+
+    static const HuffmanTree& instance() {
+        static HuffmanTree tree;
+        return tree;
+    }
+
+private:
+    std::vector<Node> nodes_;
+};
+
+bool decodeInteger(const uint8_t*& p, const uint8_t* end, int prefix,
+                   uint64_t* value) {
+    if (p == end) return false;
+    const uint64_t max = (1u << prefix) - 1;
+    uint64_t v = *p++ & max;
+    if (v == max) {
+        int shift = 0;
+        uint8_t b = 0;
+        do {
+            // more than 2^35 is definitely an attack
+            if (p == end || shift > 28) return false;
+            b = *p++;
+            v += static_cast<uint64_t>(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+    }
+    *value = v;
+    return true;
+}
+
+bool decodeString(const uint8_t*& p, const uint8_t* end, string* out) {
+    if (p == end) return false;
+    bool huffman = *p & 0x80;
+    uint64_t len = 0;
+    if (!decodeInteger(p, end, 7, &len)) return false;
+    if (len > static_cast<uint64_t>(end - p)) return false;
+
+    const char* data = reinterpret_cast<const char*>(p);
+    p += len;
+    if (huffman) return huffmanDecode(data, len, out);
+    out->assign(data, len);
+    return true;
+}
+
+void encodeInteger(polaris::Buffer* out, uint8_t flags, int prefix,
+                   uint64_t value) {
+    const uint64_t max = (1u << prefix) - 1;
+    if (value < max) {
+        out->appendInt8(static_cast<int8_t>(flags | value));
+        return;
+    }
+    out->appendInt8(static_cast<int8_t>(flags | max));
+    value -= max;
+    while (value >= 0x80) {
+        out->appendInt8(static_cast<int8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out->appendInt8(static_cast<int8_t>(value));
+}
+
+void encodeString(polaris::Buffer* out, const string& str) {
+    size_t len = huffmanEncodedLength(str.data(), str.size());
+    if (len < str.size()) {
+        encodeInteger(out, 0x80, 7, len);
+        huffmanEncode(str.data(), str.size(), out);
+    } else {
+        encodeInteger(out, 0x00, 7, str.size());
+        out->append(str);
+    }
+}
+
+/// @return static index of @c name, or 0 if not found
+uint64_t staticNameIndex(const string& name) {
+    static const std::unordered_map<string, uint64_t> index = [] {
+        std::unordered_map<string, uint64_t> m;
+        for (uint64_t i = kStaticTableSize; i >= 1; --i) {
+            // keep the first (smallest) index for duplicated names
+            m[kStaticTable[i - 1].name] = i;
+        }
+        return m;
+    }();
+    auto it = index.find(name);
+    return it == index.end() ? 0 : it->second;
+}
+}  // namespace
+
+bool hpack::huffmanDecode(const char* data, size_t len, string* out) {
+    const HuffmanTree& tree = HuffmanTree::instance();
+    out->clear();
+    out->reserve(len * 8 / 5);
+
+    int node = 0;
+    // bits consumed since the last emitted symbol, and whether all of them
+    // are 1, for checking the padding (a prefix of EOS, at most 7 bits).
+    int pending = 0;
+    bool allOnes = true;
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t byte = static_cast<uint8_t>(data[i]);
+        for (int shift = 7; shift >= 0; --shift) {
+            int bit = (byte >> shift) & 1;
+            node = tree.node(node).child[bit];
+            if (node < 0) return false;
+            ++pending;
+            allOnes = allOnes && bit;
+
+            int symbol = tree.node(node).symbol;
+            if (symbol >= 0) {
+                if (symbol == 256) return false;
+                out->push_back(static_cast<char>(symbol));
+                node = 0;
+                pending = 0;
+                allOnes = true;
+            }
+        }
+    }
+    return pending <= 7 && allOnes;
+}
+
+size_t hpack::huffmanEncodedLength(const char* data, size_t len) {
+    size_t bits = 0;
+    for (size_t i = 0; i < len; ++i) {
+        bits += kHuffmanTable[static_cast<uint8_t>(data[i])].bits;
+    }
+    return (bits + 7) / 8;
+}
+
+void hpack::huffmanEncode(const char* data, size_t len, polaris::Buffer* out) {
+    // codes are at most 30 bits, so at most 37 bits are pending
+    uint64_t pending = 0;
+    int bits = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const HuffmanCode& hc = kHuffmanTable[static_cast<uint8_t>(data[i])];
+        pending = (pending << hc.bits) | hc.code;
+        bits += hc.bits;
+        while (bits >= 8) {
+            bits -= 8;
+            out->appendInt8(static_cast<int8_t>(pending >> bits));
+        }
+    }
+    if (bits > 0) {
+        // the padding is the most significant bits of EOS, all ones
+        pending = (pending << (8 - bits)) | (0xFFu >> bits);
+        out->appendInt8(static_cast<int8_t>(pending));
+    }
+}
+
+bool Decoder::lookup(uint64_t index, HeaderField* field) const {
+    if (index == 0) return false;
+    if (index <= kStaticTableSize) {
+        field->first = kStaticTable[index - 1].name;
+        field->second = kStaticTable[index - 1].value;
+        return true;
+    }
+    index -= kStaticTableSize + 1;
+    if (index >= entries_.size()) return false;
+    *field = entries_[index];
+    return true;
+}
+
+void Decoder::insert(HeaderField field) {
+    size_t size = entrySize(field);
+    if (size > maxSize_) {
+        // an entry larger than the table empties the table, RFC 7541 4.4
+        entries_.clear();
+        size_ = 0;
+        return;
+    }
+    size_ += size;
+    entries_.push_front(std::move(field));
+    evict();
+}
+
+void Decoder::evict() {
+    while (size_ > maxSize_ && !entries_.empty()) {
+        size_ -= entrySize(entries_.back());
+        entries_.pop_back();
+    }
+}
+
+DecodeResult Decoder::decode(const char* data, size_t len,
+                             HeaderList* headers) {
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = p + len;
+    bool sawField = false;
+    size_t listSize = 0;
+
+    while (p < end) {
+        uint8_t b = *p;
+        uint64_t index = 0;
+        if (b & 0x80) {
+            // Indexed Header Field, RFC 7541 6.1
+            HeaderField field;
+            if (!decodeInteger(p, end, 7, &index) || !lookup(index, &field))
+                return DecodeResult::kError;
+            listSize += entrySize(field);
+            if (listSize > maxHeaderListSize_) return DecodeResult::kTooLarge;
+            headers->push_back(std::move(field));
+            sawField = true;
+        } else if ((b & 0xE0) == 0x20) {
+            // Dynamic Table Size Update, RFC 7541 6.3
+            if (sawField || !decodeInteger(p, end, 5, &index) ||
+                index > capacity_)
+                return DecodeResult::kError;
+            maxSize_ = index;
+            evict();
+        } else {
+            // Literal Header Field, RFC 7541 6.2
+            bool incremental = (b & 0xC0) == 0x40;
+            HeaderField field;
+            if (!decodeInteger(p, end, incremental ? 6 : 4, &index))
+                return DecodeResult::kError;
+            if (index != 0) {
+                if (!lookup(index, &field)) return DecodeResult::kError;
+            } else if (!decodeString(p, end, &field.first)) {
+                return DecodeResult::kError;
+            }
+            if (!decodeString(p, end, &field.second)) {
+                return DecodeResult::kError;
+            }
+
+            if (incremental) insert(field);
+            listSize += entrySize(field);
+            if (listSize > maxHeaderListSize_) return DecodeResult::kTooLarge;
+            headers->push_back(std::move(field));
+            sawField = true;
+        }
+    }
+    return DecodeResult::kOk;
+}
+
+void Encoder::encode(const HeaderList& headers, polaris::Buffer* out) const {
+    for (const HeaderField& field : headers) {
+        uint64_t nameIndex = staticNameIndex(field.first);
+
+        // :status 200/204/206/304/400/404/500 are fully indexed
+        if (nameIndex == 8) {
+            bool indexed = false;
+            for (uint64_t i = 8; i <= 14; ++i) {
+                if (field.second == kStaticTable[i - 1].value) {
+                    encodeInteger(out, 0x80, 7, i);
+                    indexed = true;
+                    break;
+                }
+            }
+            if (indexed) continue;
+        }
+
+        // Literal Header Field without Indexing, RFC 7541 6.2.2
+        encodeInteger(out, 0x00, 4, nameIndex);
+        if (nameIndex == 0) encodeString(out, field.first);
+        encodeString(out, field.second);
+    }
+}
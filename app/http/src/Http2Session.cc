@@ -0,0 +1,716 @@
+/**
+ * @file Http2Session.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/Logger.h>
+#include <LuxUtils/Base64.h>
+#include <http/Http2Session.h>
+#include <http/HttpResponse.h>
+#include <polaris/TCPConnection.h>
+
+#include <algorithm>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::polaris;
+
+const char Http2Session::kPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const size_t Http2Session::kPrefaceLength;
+const size_t Http2Session::kFrameHeaderLength;
+const int32_t Http2Session::kDefaultWindowSize;
+const uint32_t Http2Session::kMaxConcurrentStreams;
+const size_t Http2Session::kMaxBodySize;
+const uint32_t Http2Session::kMaxHeaderListSize;
+
+namespace {
+const uint8_t kFlagEndStream = 0x1;
+const uint8_t kFlagAck = 0x1;
+const uint8_t kFlagEndHeaders = 0x4;
+const uint8_t kFlagPadded = 0x8;
+const uint8_t kFlagPriority = 0x20;
+
+const uint16_t kSettingsEnablePush = 0x2;
+const uint16_t kSettingsMaxConcurrentStreams = 0x3;
+const uint16_t kSettingsInitialWindowSize = 0x4;
+const uint16_t kSettingsMaxFrameSize = 0x5;
+const uint16_t kSettingsMaxHeaderListSize = 0x6;
+
+// SETTINGS_MAX_FRAME_SIZE of ours, never changed from the default
+const uint32_t kMaxFrameSize = 16384;
+const uint32_t kMaxFrameSizeLimit = 16777215;
+const int64_t kMaxWindowSize = 2147483647;
+// HEADERS + CONTINUATION, ENHANCE_YOUR_CALM beyond this
+const size_t kMaxHeaderBlockSize = 256 * 1024;
+
+uint32_t getUint32(const char* p) {
+    const auto* u = reinterpret_cast<const uint8_t*>(p);
+    return (static_cast<uint32_t>(u[0]) << 24) |
+           (static_cast<uint32_t>(u[1]) << 16) |
+           (static_cast<uint32_t>(u[2]) << 8) | u[3];
+}
+
+void putUint32(char* p, uint32_t v) {
+    p[0] = static_cast<char>(v >> 24);
+    p[1] = static_cast<char>(v >> 16);
+    p[2] = static_cast<char>(v >> 8);
+    p[3] = static_cast<char>(v);
+}
+
+/// Remove the Pad Length field and the padding, RFC 7540 6.1
+bool stripPadding(uint8_t flags, const char** payload, size_t* len) {
+    if (!(flags & kFlagPadded)) return true;
+    if (*len < 1) return false;
+    size_t padding = static_cast<uint8_t>(**payload);
+    if (padding >= *len) return false;
+    ++*payload;
+    *len -= 1 + padding;
+    return true;
+}
+
+/// "user-agent" -> "User-Agent", so that handlers can look up headers the
+/// same way as HTTP/1.x.
+string canonicalName(const string& name) {
+    string result(name);
+    bool upper = true;
+    for (char& c : result) {
+        if (upper && c >= 'a' && c <= 'z') c = static_cast<char>(c - 32);
+        upper = c == '-';
+    }
+    return result;
+}
+
+/// Build the request from a decoded header list, RFC 7540 8.1.2
+/// @return false if the request is malformed
+bool buildRequest(const hpack::HeaderList& headers, Timestamp receiveTime,
+                  HttpRequest* request) {
+    bool hasMethod = false;
+    bool hasPath = false;
+    bool pseudo = true;
+    string cookie;
+    for (const auto& header : headers) {
+        const string& name = header.first;
+        const string& value = header.second;
+        if (!name.empty() && name[0] == ':') {
+            // pseudo-header fields must precede regular fields
+            if (!pseudo) return false;
+            if (name == ":method") {
+                if (hasMethod) return false;
+                hasMethod = true;
+                // unknown method is answered with 400 as HTTP/1.x does
+                request->setMethod(value.data(), value.data() + value.size());
+            } else if (name == ":path") {
+                if (hasPath || value.empty()) return false;
+                hasPath = true;
+                const char* begin = value.data();
+                const char* end = begin + value.size();
+                const char* question = std::find(begin, end, '?');
+                request->setPath(begin, question);
+                if (question != end) request->setQuery(question, end);
+            } else if (name == ":authority") {
+                request->addHeader("Host", value);
+            } else if (name != ":scheme") {
+                return false;
+            }
+        } else {
+            pseudo = false;
+            if (std::any_of(name.begin(), name.end(),
+                            [](char c) { return c >= 'A' && c <= 'Z'; }) ||
+                name == "connection") {
+                return false;
+            }
+            // RFC 7540 8.1.2.5, cookie may be split into several fields
+            if (name == "cookie") {
+                if (!cookie.empty()) cookie.append("; ");
+                cookie.append(value);
+            } else {
+                request->addHeader(canonicalName(name), value);
+            }
+        }
+    }
+    if (!cookie.empty()) request->addHeader("Cookie", cookie);
+
+    request->setVersion(HttpRequest::Version::kHttp20);
+    request->setReceiveTime(receiveTime);
+    return hasMethod && hasPath;
+}
+
+/// Hop-by-hop headers are not allowed in HTTP/2, RFC 7540 8.1.2.2
+bool isConnectionSpecific(const string& name) {
+    return name == "connection" || name == "keep-alive" ||
+           name == "proxy-connection" || name == "transfer-encoding" ||
+           name == "upgrade" || name == "content-length";
+}
+}  // namespace
+
+int Http2Session::checkPreface(const Buffer& buf) {
+    size_t n = std::min(buf.readableBytes(), kPrefaceLength);
+    if (memcmp(buf.peek(), kPreface, n) != 0) return -1;
+    return n == kPrefaceLength ? 1 : 0;
+}
+
+Http2Session::Http2Session(TCPConnection* conn, const HttpCallback& cb)
+    : conn_(conn),
+      httpCallback_(cb),
+      decoder_(4096, kMaxHeaderListSize),
+      lastStreamId_(0),
+      continuationStreamId_(0),
+      continuationEndStream_(false),
+      expectPreface_(true),
+      expectSettings_(true),
+      goAway_(false),
+      dead_(false),
+      peerInitialWindowSize_(kDefaultWindowSize),
+      peerMaxFrameSize_(kMaxFrameSize),
+      sendWindow_(kDefaultWindowSize),
+      recvWindow_(kDefaultWindowSize) {}
+
+void Http2Session::start() {
+    sendSettings();
+    flush();
+}
+
+bool Http2Session::upgrade(const string& settings, const HttpRequest& request) {
+    string payload;
+    if (!Base64::decode(settings, &payload) || payload.size() % 6 != 0 ||
+        applySettings(payload.data(), payload.size()) != ErrorCode::kNoError) {
+        return false;
+    }
+
+    output_.append(
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Connection: Upgrade\r\n"
+        "Upgrade: h2c\r\n\r\n");
+    sendSettings();
+
+    // RFC 7540 3.2, the request is sent on stream 1, half-closed (remote)
+    lastStreamId_ = 1;
+    Stream& stream = streams_[1];
+    stream.request = request;
+    stream.request.setVersion(HttpRequest::Version::kHttp20);
+    stream.sendWindow = peerInitialWindowSize_;
+    stream.remoteClosed = true;
+    dispatch(1);
+    flush();
+    return true;
+}
+
+bool Http2Session::onMessage(Buffer* buf, Timestamp receiveTime) {
+    if (dead_) {
+        buf->retrieveAll();
+        return false;
+    }
+
+    if (expectPreface_) {
+        int matched = checkPreface(*buf);
+        if (matched < 0) {
+            LOG_ERROR << "Http2Session::onMessage - bad connection preface";
+            buf->retrieveAll();
+            return connectionError(ErrorCode::kProtocolError);
+        }
+        if (matched == 0) return true;
+        buf->retrieve(kPrefaceLength);
+        expectPreface_ = false;
+    }
+
+    bool ok = true;
+    while (ok && buf->readableBytes() >= kFrameHeaderLength) {
+        const auto* header = reinterpret_cast<const uint8_t*>(buf->peek());
+        size_t len = (static_cast<size_t>(header[0]) << 16) |
+                     (static_cast<size_t>(header[1]) << 8) | header[2];
+        if (len > kMaxFrameSize) {
+            ok = connectionError(ErrorCode::kFrameSizeError);
+            break;
+        }
+        if (buf->readableBytes() < kFrameHeaderLength + len) break;
+
+        auto type = static_cast<FrameType>(header[3]);
+        uint8_t flags = header[4];
+        uint32_t streamId = getUint32(buf->peek() + 5) & 0x7FFFFFFF;
+        ok = handleFrame(type, flags, streamId, buf->peek() + kFrameHeaderLength,
+                         len, receiveTime);
+        buf->retrieve(kFrameHeaderLength + len);
+    }
+    if (!ok) buf->retrieveAll();
+    flush();
+    // GOAWAY received and every stream done, nothing more will be sent
+    if (ok && goAway_ && streams_.empty()) conn_->shutdown();
+    return ok;
+}
+
+bool Http2Session::handleFrame(FrameType type, uint8_t flags,
+                               uint32_t streamId, const char* payload,
+                               size_t len, Timestamp receiveTime) {
+    // RFC 7540 3.5, the preface must be followed by SETTINGS
+    if (expectSettings_) {
+        if (type != FrameType::kSettings || (flags & kFlagAck)) {
+            return connectionError(ErrorCode::kProtocolError);
+        }
+        expectSettings_ = false;
+    }
+    // RFC 7540 6.10, header block must be contiguous
+    if (continuationStreamId_ != 0 && type != FrameType::kContinuation) {
+        return connectionError(ErrorCode::kProtocolError);
+    }
+
+    switch (type) {
+        case FrameType::kData:
+            return onData(flags, streamId, payload, len);
+
+        case FrameType::kHeaders:
+            return onHeaders(flags, streamId, payload, len, receiveTime);
+
+        case FrameType::kContinuation:
+            return onContinuation(flags, streamId, payload, len, receiveTime);
+
+        case FrameType::kPriority:
+            // priority is advisory, just ignore it
+            if (streamId == 0) {
+                return connectionError(ErrorCode::kProtocolError);
+            }
+            if (len != 5) resetStream(streamId, ErrorCode::kFrameSizeError);
+            return true;
+
+        case FrameType::kRstStream:
+            if (streamId == 0 || streamId > lastStreamId_) {
+                return connectionError(ErrorCode::kProtocolError);
+            }
+            if (len != 4) return connectionError(ErrorCode::kFrameSizeError);
+            closeStream(streamId);
+            return true;
+
+        case FrameType::kSettings:
+            return onSettings(flags, streamId, payload, len);
+
+        case FrameType::kPushPromise:
+            // a client can not push
+            return connectionError(ErrorCode::kProtocolError);
+
+        case FrameType::kPing:
+            if (streamId != 0) {
+                return connectionError(ErrorCode::kProtocolError);
+            }
+            if (len != 8) return connectionError(ErrorCode::kFrameSizeError);
+            if (!(flags & kFlagAck)) {
+                sendFrame(FrameType::kPing, kFlagAck, 0, payload, len);
+            }
+            return true;
+
+        case FrameType::kGoAway:
+            if (streamId != 0) {
+                return connectionError(ErrorCode::kProtocolError);
+            }
+            // shutdown in onMessage(), after the output of this read
+            goAway_ = true;
+            return true;
+
+        case FrameType::kWindowUpdate:
+            return onWindowUpdate(streamId, payload, len);
+
+        default:
+            // RFC 7540 4.1, unknown frame types must be ignored
+            return true;
+    }
+}
+
+bool Http2Session::onHeaders(uint8_t flags, uint32_t streamId,
+                             const char* payload, size_t len,
+                             Timestamp receiveTime) {
+    if (streamId == 0 || !stripPadding(flags, &payload, &len)) {
+        return connectionError(ErrorCode::kProtocolError);
+    }
+    if (flags & kFlagPriority) {
+        // Exclusive + Stream Dependency + Weight
+        if (len < 5) return connectionError(ErrorCode::kFrameSizeError);
+        payload += 5;
+        len -= 5;
+    }
+
+    headerBlock_.assign(payload, len);
+    continuationEndStream_ = flags & kFlagEndStream;
+    if (flags & kFlagEndHeaders) {
+        return endHeaders(streamId, continuationEndStream_, receiveTime);
+    }
+    continuationStreamId_ = streamId;
+    return true;
+}
+
+bool Http2Session::onContinuation(uint8_t flags, uint32_t streamId,
+                                  const char* payload, size_t len,
+                                  Timestamp receiveTime) {
+    if (continuationStreamId_ == 0 || streamId != continuationStreamId_) {
+        return connectionError(ErrorCode::kProtocolError);
+    }
+    if (headerBlock_.size() + len > kMaxHeaderBlockSize) {
+        LOG_ERROR << "Http2Session::onContinuation - header block too large";
+        return connectionError(ErrorCode::kEnhanceYourCalm);
+    }
+
+    headerBlock_.append(payload, len);
+    if (flags & kFlagEndHeaders) {
+        continuationStreamId_ = 0;
+        return endHeaders(streamId, continuationEndStream_, receiveTime);
+    }
+    return true;
+}
+
+bool Http2Session::endHeaders(uint32_t streamId, bool endStream,
+                              Timestamp receiveTime) {
+    // always decode, even if the stream is to be refused, to keep the
+    // dynamic table in sync with the peer
+    hpack::HeaderList headers;
+    hpack::DecodeResult result =
+        decoder_.decode(headerBlock_.data(), headerBlock_.size(), &headers);
+    headerBlock_.clear();
+    // the rest of the block is not decoded, so the dynamic table is lost and
+    // the stream can not be answered with 431 instead
+    if (result == hpack::DecodeResult::kTooLarge) {
+        LOG_ERROR << "Http2Session::endHeaders - header list too large";
+        return connectionError(ErrorCode::kEnhanceYourCalm);
+    }
+    if (result != hpack::DecodeResult::kOk) {
+        return connectionError(ErrorCode::kCompressionError);
+    }
+
+    auto it = streams_.find(streamId);
+    if (it != streams_.end()) {
+        // trailers, which must end the stream
+        Stream& stream = it->second;
+        if (stream.remoteClosed) {
+            resetStream(streamId, ErrorCode::kStreamClosed);
+        } else if (!endStream) {
+            resetStream(streamId, ErrorCode::kProtocolError);
+        } else {
+            stream.remoteClosed = true;
+            stream.request.setBody(stream.body);
+            dispatch(streamId);
+        }
+        return true;
+    }
+
+    // a new stream, RFC 7540 5.1.1
+    if ((streamId & 1) == 0 || streamId <= lastStreamId_) {
+        return connectionError(ErrorCode::kProtocolError);
+    }
+    lastStreamId_ = streamId;
+    if (streams_.size() >= kMaxConcurrentStreams) {
+        resetStream(streamId, ErrorCode::kRefusedStream);
+        return true;
+    }
+
+    Stream& stream = streams_[streamId];
+    stream.sendWindow = peerInitialWindowSize_;
+    if (!buildRequest(headers, receiveTime, &stream.request)) {
+        resetStream(streamId, ErrorCode::kProtocolError);
+        return true;
+    }
+    if (endStream) {
+        stream.remoteClosed = true;
+        dispatch(streamId);
+    }
+    return true;
+}
+
+bool Http2Session::onData(uint8_t flags, uint32_t streamId,
+                          const char* payload, size_t len) {
+    if (streamId == 0) return connectionError(ErrorCode::kProtocolError);
+
+    // flow control counts the entire payload, including padding
+    auto flowControlled = static_cast<int32_t>(len);
+    if (flowControlled > recvWindow_) {
+        return connectionError(ErrorCode::kFlowControlError);
+    }
+    recvWindow_ -= flowControlled;
+    if (recvWindow_ < kDefaultWindowSize / 2) {
+        sendWindowUpdate(0, static_cast<uint32_t>(kDefaultWindowSize -
+                                                  recvWindow_));
+        recvWindow_ = kDefaultWindowSize;
+    }
+
+    if (!stripPadding(flags, &payload, &len)) {
+        return connectionError(ErrorCode::kProtocolError);
+    }
+
+    auto it = streams_.find(streamId);
+    if (it == streams_.end() || it->second.remoteClosed) {
+        if (streamId > lastStreamId_) {
+            return connectionError(ErrorCode::kProtocolError);
+        }
+        resetStream(streamId, ErrorCode::kStreamClosed);
+        return true;
+    }
+
+    Stream& stream = it->second;
+    if (flowControlled > stream.recvWindow) {
+        resetStream(streamId, ErrorCode::kFlowControlError);
+        return true;
+    }
+    stream.recvWindow -= flowControlled;
+    if (stream.body.size() + len > kMaxBodySize) {
+        LOG_ERROR << "Http2Session::onData [" << conn_->name()
+                  << "] - body of stream " << streamId << " too large";
+        resetStream(streamId, ErrorCode::kEnhanceYourCalm);
+        return true;
+    }
+    stream.body.append(payload, len);
+
+    if (flags & kFlagEndStream) {
+        stream.remoteClosed = true;
+        stream.request.setBody(stream.body);
+        dispatch(streamId);
+    } else if (stream.recvWindow < kDefaultWindowSize / 2) {
+        sendWindowUpdate(streamId, static_cast<uint32_t>(kDefaultWindowSize -
+                                                         stream.recvWindow));
+        stream.recvWindow = kDefaultWindowSize;
+    }
+    return true;
+}
+
+bool Http2Session::onSettings(uint8_t flags, uint32_t streamId,
+                              const char* payload, size_t len) {
+    if (streamId != 0) return connectionError(ErrorCode::kProtocolError);
+    if (flags & kFlagAck) {
+        if (len != 0) return connectionError(ErrorCode::kFrameSizeError);
+        return true;
+    }
+    if (len % 6 != 0) return connectionError(ErrorCode::kFrameSizeError);
+
+    ErrorCode code = applySettings(payload, len);
+    if (code != ErrorCode::kNoError) return connectionError(code);
+
+    sendFrame(FrameType::kSettings, kFlagAck, 0, nullptr, 0);
+    // INITIAL_WINDOW_SIZE might have grown
+    flushAll();
+    return true;
+}
+
+Http2Session::ErrorCode Http2Session::applySettings(const char* payload,
+                                                   size_t len) {
+    for (size_t i = 0; i + 6 <= len; i += 6) {
+        auto id = static_cast<uint16_t>(
+            (static_cast<uint8_t>(payload[i]) << 8) |
+            static_cast<uint8_t>(payload[i + 1]));
+        uint32_t value = getUint32(payload + i + 2);
+
+        switch (id) {
+            case kSettingsEnablePush:
+                if (value > 1) return ErrorCode::kProtocolError;
+                break;
+
+            case kSettingsInitialWindowSize: {
+                if (value > kMaxWindowSize) {
+                    return ErrorCode::kFlowControlError;
+                }
+                // RFC 7540 6.9.2, adjust all the open streams by the delta
+                int64_t delta = static_cast<int64_t>(value) -
+                                peerInitialWindowSize_;
+                for (auto& entry : streams_) {
+                    int64_t window = entry.second.sendWindow + delta;
+                    if (window > kMaxWindowSize) {
+                        return ErrorCode::kFlowControlError;
+                    }
+                    entry.second.sendWindow = static_cast<int32_t>(window);
+                }
+                peerInitialWindowSize_ = static_cast<int32_t>(value);
+                break;
+            }
+
+            case kSettingsMaxFrameSize:
+                if (value < kMaxFrameSize || value > kMaxFrameSizeLimit) {
+                    return ErrorCode::kProtocolError;
+                }
+                peerMaxFrameSize_ = value;
+                break;
+
+            default:
+                // HEADER_TABLE_SIZE is irrelevant, the encoder never indexes.
+                // MAX_CONCURRENT_STREAMS is irrelevant, we never push.
+                // Unknown settings must be ignored.
+                break;
+        }
+    }
+    return ErrorCode::kNoError;
+}
+
+bool Http2Session::onWindowUpdate(uint32_t streamId, const char* payload,
+                                  size_t len) {
+    if (len != 4) return connectionError(ErrorCode::kFrameSizeError);
+    uint32_t increment = getUint32(payload) & 0x7FFFFFFF;
+
+    if (streamId == 0) {
+        if (increment == 0 || sendWindow_ + static_cast<int64_t>(increment) >
+                                  kMaxWindowSize) {
+            return connectionError(increment == 0
+                                       ? ErrorCode::kProtocolError
+                                       : ErrorCode::kFlowControlError);
+        }
+        sendWindow_ += static_cast<int32_t>(increment);
+        flushAll();
+        return true;
+    }
+
+    auto it = streams_.find(streamId);
+    if (it == streams_.end()) {
+        // WINDOW_UPDATE can be received on a closed stream
+        if (streamId > lastStreamId_) {
+            return connectionError(ErrorCode::kProtocolError);
+        }
+        return true;
+    }
+
+    Stream& stream = it->second;
+    if (increment == 0) {
+        resetStream(streamId, ErrorCode::kProtocolError);
+    } else if (stream.sendWindow + static_cast<int64_t>(increment) >
+               kMaxWindowSize) {
+        resetStream(streamId, ErrorCode::kFlowControlError);
+    } else {
+        stream.sendWindow += static_cast<int32_t>(increment);
+        if (stream.responding) flushStream(streamId, &stream);
+    }
+    return true;
+}
+
+void Http2Session::dispatch(uint32_t streamId) {
+    Stream& stream = streams_[streamId];
+
+    // connection management is done by HTTP/2 itself, so
+    // HttpResponse::closeConnection() is ignored
+    HttpResponse response(false);
+    if (stream.request.method() == HttpRequest::Method::kInvalid) {
+        response.setStatusCode(HttpResponse::HttpStatusCode::k400BadRequest);
+        response.setStatusMessage("Bad Request");
+    } else {
+        httpCallback_(stream.request, &response);
+    }
+
+    int status = static_cast<int>(response.statusCode());
+    if (status == 0) status = 500;
+
+    hpack::HeaderList headers;
+    headers.emplace_back(":status", std::to_string(status));
+    for (const auto& header : response.headers()) {
+        string name(header.first);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (!isConnectionSpecific(name)) {
+            headers.emplace_back(std::move(name), header.second);
+        }
+    }
+    const string& body = response.body();
+    headers.emplace_back("content-length", std::to_string(body.size()));
+
+    Buffer block;
+    encoder_.encode(headers, &block);
+
+    bool withBody =
+        !body.empty() && stream.request.method() != HttpRequest::Method::kHead;
+    FrameType type = FrameType::kHeaders;
+    uint8_t flags = withBody ? 0 : kFlagEndStream;
+    do {
+        size_t n = std::min<size_t>(block.readableBytes(), peerMaxFrameSize_);
+        if (n == block.readableBytes()) flags |= kFlagEndHeaders;
+        sendFrame(type, flags, streamId, block.peek(), n);
+        block.retrieve(n);
+        type = FrameType::kContinuation;
+        flags = 0;
+    } while (block.readableBytes() > 0);
+
+    if (!withBody) {
+        closeStream(streamId);
+        return;
+    }
+
+    stream.pending = body;
+    stream.responding = true;
+    flushStream(streamId, &stream);
+}
+
+void Http2Session::flushStream(uint32_t streamId, Stream* stream) {
+    const string& pending = stream->pending;
+    while (stream->pendingOffset < pending.size()) {
+        int32_t window = std::min(sendWindow_, stream->sendWindow);
+        if (window <= 0) return;
+
+        size_t n = std::min({pending.size() - stream->pendingOffset,
+                             static_cast<size_t>(window),
+                             static_cast<size_t>(peerMaxFrameSize_)});
+        bool last = stream->pendingOffset + n == pending.size();
+        sendFrame(FrameType::kData, last ? kFlagEndStream : 0, streamId,
+                  pending.data() + stream->pendingOffset, n);
+        stream->pendingOffset += n;
+        sendWindow_ -= static_cast<int32_t>(n);
+        stream->sendWindow -= static_cast<int32_t>(n);
+    }
+    closeStream(streamId);
+}
+
+void Http2Session::flushAll() {
+    for (auto it = streams_.begin();
+         it != streams_.end() && sendWindow_ > 0;) {
+        // flushStream() may erase the current stream
+        auto current = it++;
+        if (current->second.responding) {
+            flushStream(current->first, &current->second);
+        }
+    }
+}
+
+void Http2Session::closeStream(uint32_t streamId) {
+    streams_.erase(streamId);
+}
+
+void Http2Session::sendSettings() {
+    char payload[12];
+    payload[0] = 0;
+    payload[1] = static_cast<char>(kSettingsMaxConcurrentStreams);
+    putUint32(payload + 2, kMaxConcurrentStreams);
+    payload[6] = 0;
+    payload[7] = static_cast<char>(kSettingsMaxHeaderListSize);
+    putUint32(payload + 8, kMaxHeaderListSize);
+    sendFrame(FrameType::kSettings, 0, 0, payload, sizeof payload);
+}
+
+void Http2Session::sendWindowUpdate(uint32_t streamId, uint32_t increment) {
+    char payload[4];
+    putUint32(payload, increment);
+    sendFrame(FrameType::kWindowUpdate, 0, streamId, payload, sizeof payload);
+}
+
+void Http2Session::sendFrame(FrameType type, uint8_t flags, uint32_t streamId,
+                             const char* payload, size_t len) {
+    char header[kFrameHeaderLength];
+    header[0] = static_cast<char>(len >> 16);
+    header[1] = static_cast<char>(len >> 8);
+    header[2] = static_cast<char>(len);
+    header[3] = static_cast<char>(type);
+    header[4] = static_cast<char>(flags);
+    putUint32(header + 5, streamId);
+    output_.append(header, sizeof header);
+    if (len > 0) output_.append(payload, len);
+}
+
+void Http2Session::resetStream(uint32_t streamId, ErrorCode code) {
+    char payload[4];
+    putUint32(payload, static_cast<uint32_t>(code));
+    sendFrame(FrameType::kRstStream, 0, streamId, payload, sizeof payload);
+    streams_.erase(streamId);
+}
+
+bool Http2Session::connectionError(ErrorCode code) {
+    LOG_WARN << "Http2Session::connectionError [" << conn_->name()
+             << "] - error code " << static_cast<uint32_t>(code);
+    char payload[8];
+    putUint32(payload, lastStreamId_);
+    putUint32(payload + 4, static_cast<uint32_t>(code));
+    sendFrame(FrameType::kGoAway, 0, 0, payload, sizeof payload);
+    flush();
+    conn_->shutdown();
+    dead_ = true;
+    return false;
+}
+
+void Http2Session::flush() {
+    if (output_.readableBytes() > 0) conn_->send(&output_);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file HttpCache.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <http/HttpCache.h>
+#include <http/HttpRequest.h>
+
+using namespace Lux;
+using namespace Lux::http;
+
+bool HttpCache::cacheable(const HttpRequest& req) {
+    return req.method() == HttpRequest::Method::kGet ||
+           req.method() == HttpRequest::Method::kHead;
+}
+
+string HttpCache::resourceKey(const HttpRequest& req) {
+    string key(req.methodString());
+    key.push_back(' ');
+    key.append(req.path());
+    key.append(req.query());
+    return key;
+}
+
+string HttpCache::variantKey(const HttpRequest& req,
+                             const std::vector<string>& vary) {
+    string key;
+    for (const string& field : vary) {
+        key.append(req.getHeaderIgnoreCase(field.c_str()));
+        // '\n' can not appear in a header value
+        key.push_back('\n');
+    }
+    return key;
+}
+
+HttpCache::Bytes HttpCache::get(const HttpRequest& req, Timestamp now) {
+    auto resource = resources_.find(resourceKey(req));
+    if (resource == resources_.end()) return Bytes();
+
+    auto& variants = resource->second.variants;
+    auto entry = variants.find(variantKey(req, resource->second.vary));
+    if (entry == variants.end()) return Bytes();
+
+    if (entry->second.expiration < now) {
+        size_ -= entry->second.bytes->size();
+        variants.erase(entry);
+        if (variants.empty()) resources_.erase(resource);
+        return Bytes();
+    }
+    return entry->second.bytes;
+}
+
+void HttpCache::put(const HttpRequest& req, const std::vector<string>& vary,
+                    StringPiece bytes, double ttl, Timestamp now) {
+    if (size_ + bytes.size() > capacity_) {
+        purge(now);
+        if (size_ + bytes.size() > capacity_) return;
+    }
+
+    Resource& resource = resources_[resourceKey(req)];
+    if (resource.vary != vary) {
+        // the handler changed Vary, old variants are keyed differently
+        for (const auto& variant : resource.variants) {
+            size_ -= variant.second.bytes->size();
+        }
+        resource.variants.clear();
+        resource.vary = vary;
+    }
+
+    Entry& entry = resource.variants[variantKey(req, vary)];
+    if (entry.bytes) size_ -= entry.bytes->size();
+    entry.bytes = std::make_shared<const string>(bytes.data(), bytes.size());
+    entry.expiration = addTime(now, ttl);
+    size_ += bytes.size();
+}
+
+void HttpCache::purge(Timestamp now) {
+    for (auto resource = resources_.begin(); resource != resources_.end();) {
+        auto& variants = resource->second.variants;
+        for (auto entry = variants.begin(); entry != variants.end();) {
+            if (entry->second.expiration < now) {
+                size_ -= entry->second.bytes->size();
+                entry = variants.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+        if (variants.empty()) {
+            resource = resources_.erase(resource);
+        } else {
+            ++resource;
+        }
+    }
+}
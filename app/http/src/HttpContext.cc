@@ -86,10 +86,18 @@ bool http::HttpContext::parseRequest(polaris::Buffer* buf,
                 hasMore = false;
             }
         } else if (state_ == HttpRequestParseState::kExpectBody) {
-            string body = buf->retrieveAllAsString();
-            if (!body.empty()) request_.setBody(body);
-
-            state_ = HttpRequestParseState::kGotAll;
+            // RFC 7230 3.3.3, a request without Content-Length has no body,
+            // anything after it belongs to the next request, or to HTTP/2
+            // after an upgrade.
+            string length = request_.getHeader("Content-Length");
+            size_t bodyLength =
+                length.empty() ? 0 : strtoul(length.c_str(), nullptr, 10);
+            if (buf->readableBytes() >= bodyLength) {
+                if (bodyLength > 0) {
+                    request_.setBody(buf->retrieveAsString(bodyLength));
+                }
+                state_ = HttpRequestParseState::kGotAll;
+            }
             hasMore = false;
         }
     }
@@ -0,0 +1,570 @@
+/**
+ * @file HttpProxy.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/Logger.h>
+#include <LuxUtils/Format.h>
+#include <http/HttpProxy.h>
+#include <http/HttpRequest.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>  // snprintf
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::polaris;
+
+namespace {
+const char kBadGateway[] =
+    "HTTP/1.1 502 Bad Gateway\r\nContent-Length: 0\r\n\r\n";
+const char kGatewayTimeout[] =
+    "HTTP/1.1 504 Gateway Timeout\r\nContent-Length: 0\r\n\r\n";
+
+const size_t kMaxHeaderSize = 64 * 1024;
+const size_t kMaxChunkLineSize = 1024;
+
+/// Parse all of [begin, end) as an unsigned number, nothing else may be
+/// there, no sign, no space.
+/// @return false if malformed or out of range
+bool parseNumber(const char* begin, const char* end, int base, size_t* value) {
+    if (begin == end) return false;
+    std::from_chars_result result = std::from_chars(begin, end, *value, base);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+/// Hop-by-hop headers are not forwarded, RFC 7230 6.1
+bool isHopByHop(const string& name) {
+    static const char* const kHopByHop[] = {
+        "Connection", "Keep-Alive", "Proxy-Connection",  "TE",
+        "Trailer",    "Upgrade",    "Transfer-Encoding", "Content-Length"};
+    for (const char* hop : kHopByHop) {
+        if (strcasecmp(name.c_str(), hop) == 0) return true;
+    }
+    return false;
+}
+
+void appendContentLength(size_t length, Buffer* out) {
+    char buf[format::kMaxIntegerSize];
+    out->append("Content-Length: ");
+    out->append(buf, format::formatDecimal(buf, length));
+    out->append("\r\n");
+}
+
+/// The request is already parsed, so the body is copied into @c out.
+void serializeRequest(const HttpRequest& req, const string& clientIp,
+                      Buffer* out) {
+    out->append(req.methodString());
+    out->append(" ");
+    out->append(req.path());
+    out->append(req.query());
+    out->append(" HTTP/1.1\r\n");
+
+    string forwardedFor;
+    for (const auto& header : req.headers()) {
+        if (isHopByHop(header.first)) continue;
+        if (strcasecmp(header.first.c_str(), "X-Forwarded-For") == 0) {
+            forwardedFor = header.second + ", ";
+            continue;
+        }
+        out->append(header.first);
+        out->append(": ");
+        out->append(header.second);
+        out->append("\r\n");
+    }
+    forwardedFor += clientIp;
+    out->append("X-Forwarded-For: ");
+    out->append(forwardedFor);
+    out->append("\r\nConnection: keep-alive\r\n");
+
+    const string& body = req.body();
+    if (!body.empty() || req.method() == HttpRequest::Method::kPost ||
+        req.method() == HttpRequest::Method::kPut) {
+        appendContentLength(body.size(), out);
+    }
+    out->append("\r\n");
+    out->append(body);
+}
+
+/// Write @c len bytes of @c buf to @c downstream (if still there) and
+/// retrieve them. TCPConnection::send() writes to the socket directly when
+/// nothing is queued, so there is no intermediate copy.
+void relayBytes(Buffer* buf, const TCPConnectionPtr& downstream, size_t len) {
+    if (downstream) downstream->send(StringPiece(buf->peek(), len));
+    buf->retrieve(len);
+}
+}  // namespace
+
+struct HttpProxy::Exchange {
+    // response framing, RFC 7230 3.3.3
+    enum class State {
+        kHeaders,
+        kBody,
+        kChunkSize,
+        kChunkData,
+        // the CRLF after chunk data
+        kChunkEnd,
+        kTrailer,
+        kUntilClose,
+        kDone,
+    };
+
+    std::weak_ptr<TCPConnection> downstream;
+    Buffer request;
+    bool head = false;
+    // the downstream request was HTTP/1.0
+    bool http10 = false;
+    // the downstream connection is closed after the response
+    bool close = false;
+    // safe to retry on another connection
+    bool idempotent = false;
+    bool retried = false;
+    DoneCallback done;
+    TimerId timer;
+
+    State state = State::kHeaders;
+    size_t remaining = 0;
+    // any response bytes sent to downstream
+    bool started = false;
+    // upstream won't keep the connection alive
+    bool upstreamClose = false;
+    // chunked response to an HTTP/1.0 client, only the chunk data is relayed
+    bool dechunk = false;
+
+    /// Parse the status line and header block, choose the body framing and
+    /// write the head for downstream to @c out: its HTTP version, without
+    /// the hop-by-hop headers of upstream, with its own Connection header.
+    /// @return false if malformed
+    bool parseHeader(const char* begin, const char* end, Buffer* out);
+};
+
+struct HttpProxy::Upstream {
+    std::unique_ptr<TCPClient> client;
+    TCPConnectionPtr conn;
+    // in flight, null if idle
+    ExchangePtr exchange;
+};
+
+struct HttpProxy::LoopPool {
+    EventLoop* loop;
+    std::vector<std::unique_ptr<Upstream>> upstreams;
+    std::deque<ExchangePtr> pending;
+};
+
+bool HttpProxy::Exchange::parseHeader(const char* begin, const char* end,
+                                      Buffer* out) {
+    // HTTP/1.x NNN reason
+    if (end - begin < 12 || strncmp(begin, "HTTP/1.", 7) != 0 ||
+        (begin[7] != '0' && begin[7] != '1') || begin[8] != ' ' ||
+        (begin[12] != ' ' && begin[12] != '\r')) {
+        return false;
+    }
+    size_t status = 0;
+    if (!parseNumber(begin + 9, begin + 12, 10, &status) || status < 100) {
+        return false;
+    }
+    upstreamClose = begin[7] == '0';
+
+    // headers named by Connection are hop-by-hop too, RFC 7230 6.1
+    std::vector<string> connectionOptions;
+    // the framing headers must be unambiguous, a pooled connection would be
+    // out of sync otherwise, RFC 7230 3.3.3
+    bool chunked = false;
+    bool hasLength = false;
+    size_t length = 0;
+    const char* statusLineEnd = std::find(begin, end, '\n') + 1;
+    for (const char* next = statusLineEnd; next < end;) {
+        const char* line = next;
+        const char* valueEnd = std::find(line, end, '\n');
+        next = valueEnd + 1;
+        while (valueEnd > line && isspace(valueEnd[-1])) --valueEnd;
+        // the empty line ending the block
+        if (valueEnd == line) continue;
+
+        const char* colon = std::find(line, valueEnd, ':');
+        // no obs-fold, no whitespace before the colon, RFC 7230 3.2.4
+        if (colon == valueEnd || colon == line || isspace(colon[-1]) ||
+            isspace(*line)) {
+            return false;
+        }
+        string name(line, colon);
+        const char* value = colon + 1;
+        while (value < valueEnd && isspace(*value)) ++value;
+
+        if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+            if (hasLength || !parseNumber(value, valueEnd, 10, &length)) {
+                return false;
+            }
+            hasLength = true;
+        } else if (strcasecmp(name.c_str(), "Transfer-Encoding") == 0) {
+            // only chunked alone, which the proxy can relay
+            if (chunked || valueEnd - value != 7 ||
+                strncasecmp(value, "chunked", 7) != 0) {
+                return false;
+            }
+            chunked = true;
+        } else if (strcasecmp(name.c_str(), "Connection") == 0) {
+            string v(value, valueEnd);
+            if (strcasestr(v.c_str(), "close")) upstreamClose = true;
+            if (strcasestr(v.c_str(), "keep-alive")) upstreamClose = false;
+            // comma separated tokens
+            for (size_t pos = 0; pos < v.size();) {
+                size_t comma = std::min(v.find(',', pos), v.size());
+                size_t first = v.find_first_not_of(" \t", pos);
+                size_t last = v.find_last_not_of(" \t", comma - 1);
+                if (first < comma && last != string::npos && last >= first) {
+                    connectionOptions.emplace_back(v, first, last - first + 1);
+                }
+                pos = comma + 1;
+            }
+        }
+    }
+    if (chunked && hasLength) return false;
+
+    if (status < 200) {
+        // interim response, the final one follows
+        state = State::kHeaders;
+    } else if (head || status == 204 || status == 304) {
+        state = State::kDone;
+    } else if (chunked) {
+        state = State::kChunkSize;
+        // RFC 7230 3.3.1, not to an HTTP/1.0 recipient
+        dechunk = http10;
+    } else if (hasLength) {
+        remaining = length;
+        state = length > 0 ? State::kBody : State::kDone;
+    } else {
+        state = State::kUntilClose;
+    }
+    // delimited by closing the downstream connection
+    if (state == State::kUntilClose || dechunk) close = true;
+
+    // RFC 7231 6.2, no interim response to an HTTP/1.0 client
+    if (status < 200 && http10) return true;
+
+    out->append(http10 ? "HTTP/1.0" : "HTTP/1.1");
+    out->append(begin + 8, static_cast<size_t>(statusLineEnd - begin - 8));
+    for (const char* line = statusLineEnd; line < end;) {
+        const char* next = std::find(line, end, '\n') + 1;
+        const char* colon = std::find(line, next, ':');
+        if (colon != next) {
+            string name(line, colon);
+            bool option = false;
+            for (const string& o : connectionOptions) {
+                if (strcasecmp(name.c_str(), o.c_str()) == 0) option = true;
+            }
+            if (!option && !isHopByHop(name)) {
+                out->append(line, static_cast<size_t>(next - line));
+            }
+        }
+        line = next;
+    }
+    if (status >= 200) {
+        if (chunked && !dechunk) {
+            out->append("Transfer-Encoding: chunked\r\n");
+        } else if (hasLength && !chunked) {
+            appendContentLength(length, out);
+        }
+        out->append(close ? "Connection: close\r\n"
+                          : "Connection: keep-alive\r\n");
+    }
+    out->append("\r\n");
+    return true;
+}
+
+HttpProxy::HttpProxy(const InetAddress& upstreamAddr, const string& name)
+    : upstreamAddr_(upstreamAddr),
+      name_(name),
+      maxConnections_(16),
+      timeout_(30.0) {}
+
+HttpProxy::~HttpProxy() = default;
+
+HttpProxy::LoopPool* HttpProxy::poolOf(EventLoop* loop) {
+    MutexLockGuard lock(mutex_);
+    std::unique_ptr<LoopPool>& pool = pools_[loop];
+    if (!pool) {
+        pool.reset(new LoopPool);
+        pool->loop = loop;
+    }
+    return pool.get();
+}
+
+void HttpProxy::forward(const TCPConnectionPtr& downstream,
+                        const HttpRequest& req, bool close,
+                        const DoneCallback& done) {
+    LoopPool* pool = poolOf(downstream->getLoop());
+    pool->loop->assertInLoopThread();
+
+    auto exchange = std::make_shared<Exchange>();
+    exchange->downstream = downstream;
+    exchange->head = req.method() == HttpRequest::Method::kHead;
+    exchange->http10 = req.getVersion() == HttpRequest::Version::kHttp10;
+    exchange->close = close;
+    exchange->idempotent = exchange->head ||
+                           req.method() == HttpRequest::Method::kGet;
+    exchange->done = done;
+    serializeRequest(req, downstream->peerAddress().toIp(),
+                     &exchange->request);
+
+    std::weak_ptr<Exchange> weakExchange(exchange);
+    exchange->timer = pool->loop->runAfter(
+        timeout_, std::bind(&HttpProxy::onTimeout, this, pool, weakExchange));
+
+    pool->pending.push_back(exchange);
+    dispatch(pool);
+}
+
+void HttpProxy::dispatch(LoopPool* pool) {
+    size_t connecting = 0;
+    for (auto& upstream : pool->upstreams) {
+        if (!upstream->conn) {
+            ++connecting;
+            continue;
+        }
+        if (pool->pending.empty()) return;
+        if (upstream->conn->connected() && !upstream->exchange) {
+            ExchangePtr exchange = pool->pending.front();
+            pool->pending.pop_front();
+            upstream->exchange = exchange;
+            // the request is kept for a retry
+            upstream->conn->send(StringPiece(
+                exchange->request.peek(), exchange->request.readableBytes()));
+        }
+    }
+
+    if (pool->pending.size() > connecting &&
+        pool->upstreams.size() < maxConnections_) {
+        newUpstream(pool);
+    }
+}
+
+void HttpProxy::newUpstream(LoopPool* pool) {
+    char buf[32];
+    snprintf(buf, sizeof buf, "-%zu", pool->upstreams.size());
+
+    std::unique_ptr<Upstream> upstream(new Upstream);
+    upstream->client.reset(
+        new TCPClient(pool->loop, upstreamAddr_, name_ + buf));
+    Upstream* raw = upstream.get();
+    upstream->client->setConnectionCallback(
+        std::bind(&HttpProxy::onUpstreamConnection, this, pool, raw, _1));
+    upstream->client->setMessageCallback(
+        std::bind(&HttpProxy::onUpstreamMessage, this, pool, raw, _2));
+    // reconnect with backoff, also after the upstream closes an idle one
+    upstream->client->enableRetry();
+    upstream->client->connect();
+    pool->upstreams.push_back(std::move(upstream));
+}
+
+void HttpProxy::onUpstreamConnection(LoopPool* pool, Upstream* upstream,
+                                     const TCPConnectionPtr& conn) {
+    if (conn->connected()) {
+        conn->setTcpNoDelay(true);
+        upstream->conn = conn;
+        dispatch(pool);
+        return;
+    }
+
+    upstream->conn.reset();
+    ExchangePtr exchange = std::move(upstream->exchange);
+    if (exchange) {
+        if (exchange->state == Exchange::State::kUntilClose) {
+            // the response is delimited by closing the connection
+            pool->loop->cancel(exchange->timer);
+            TCPConnectionPtr downstream = exchange->downstream.lock();
+            if (downstream) exchange->done(downstream, false);
+        } else if (!exchange->started && exchange->idempotent &&
+                   !exchange->retried) {
+            // most likely an idle connection closed by the upstream
+            exchange->retried = true;
+            exchange->state = Exchange::State::kHeaders;
+            pool->pending.push_front(exchange);
+        } else if (!exchange->started) {
+            failExchange(pool, exchange, kBadGateway);
+        } else {
+            LOG_ERROR << "HttpProxy[" << name_ << "] - truncated response";
+            pool->loop->cancel(exchange->timer);
+            TCPConnectionPtr downstream = exchange->downstream.lock();
+            if (downstream) exchange->done(downstream, false);
+        }
+    }
+    dispatch(pool);
+}
+
+void HttpProxy::onUpstreamMessage(LoopPool* pool, Upstream* upstream,
+                                  Buffer* buf) {
+    if (!upstream->exchange) {
+        LOG_WARN << "HttpProxy[" << name_ << "] - unexpected data";
+        buf->retrieveAll();
+        upstream->conn->forceClose();
+        return;
+    }
+
+    if (!relay(upstream, buf)) {
+        LOG_ERROR << "HttpProxy[" << name_ << "] - bad response";
+        ExchangePtr exchange = std::move(upstream->exchange);
+        if (!exchange->started) {
+            failExchange(pool, exchange, kBadGateway);
+        } else {
+            pool->loop->cancel(exchange->timer);
+            TCPConnectionPtr downstream = exchange->downstream.lock();
+            if (downstream) exchange->done(downstream, false);
+        }
+        buf->retrieveAll();
+        upstream->conn->forceClose();
+        return;
+    }
+
+    if (upstream->exchange->state == Exchange::State::kDone) {
+        finishExchange(pool, upstream);
+    }
+}
+
+bool HttpProxy::relay(Upstream* upstream, Buffer* buf) {
+    Exchange* exchange = upstream->exchange.get();
+    TCPConnectionPtr downstream = exchange->downstream.lock();
+    // chunk framing is relayed unless the body is dechunked
+    auto relayFraming = [&](size_t len) {
+        if (exchange->dechunk) {
+            buf->retrieve(len);
+        } else {
+            relayBytes(buf, downstream, len);
+        }
+    };
+
+    while (buf->readableBytes() > 0 &&
+           exchange->state != Exchange::State::kDone) {
+        switch (exchange->state) {
+            case Exchange::State::kHeaders: {
+                static const char kEnd[] = "\r\n\r\n";
+                const char* last = buf->peek() + buf->readableBytes();
+                const char* end = std::search(buf->peek(), last, kEnd, kEnd + 4);
+                if (end == last) return buf->readableBytes() <= kMaxHeaderSize;
+                end += 4;
+                // the head is rewritten, the body is not
+                Buffer head;
+                if (!exchange->parseHeader(buf->peek(), end, &head)) {
+                    return false;
+                }
+                buf->retrieve(static_cast<size_t>(end - buf->peek()));
+                if (head.readableBytes() > 0) {
+                    exchange->started = true;
+                    if (downstream) downstream->send(&head);
+                }
+                break;
+            }
+
+            case Exchange::State::kBody:
+            case Exchange::State::kChunkData: {
+                size_t n = std::min(buf->readableBytes(), exchange->remaining);
+                relayBytes(buf, downstream, n);
+                exchange->remaining -= n;
+                if (exchange->remaining == 0) {
+                    exchange->state =
+                        exchange->state == Exchange::State::kBody
+                            ? Exchange::State::kDone
+                            : Exchange::State::kChunkEnd;
+                }
+                break;
+            }
+
+            case Exchange::State::kChunkSize: {
+                const char* crlf = buf->findCRLF();
+                if (!crlf) return buf->readableBytes() <= kMaxChunkLineSize;
+                // chunk-size [ chunk-ext ], the extensions are ignored
+                const char* sizeEnd = std::find(buf->peek(), crlf, ';');
+                while (sizeEnd > buf->peek() &&
+                       (sizeEnd[-1] == ' ' || sizeEnd[-1] == '\t')) {
+                    --sizeEnd;
+                }
+                size_t size = 0;
+                if (!parseNumber(buf->peek(), sizeEnd, 16, &size)) {
+                    return false;
+                }
+                exchange->remaining = size;
+                exchange->state = size > 0 ? Exchange::State::kChunkData
+                                           : Exchange::State::kTrailer;
+                relayFraming(static_cast<size_t>(crlf + 2 - buf->peek()));
+                break;
+            }
+
+            case Exchange::State::kChunkEnd:
+                if (buf->readableBytes() < 2) return true;
+                if (buf->peek()[0] != '\r' || buf->peek()[1] != '\n') {
+                    return false;
+                }
+                exchange->state = Exchange::State::kChunkSize;
+                relayFraming(2);
+                break;
+
+            case Exchange::State::kTrailer: {
+                const char* crlf = buf->findCRLF();
+                if (!crlf) return buf->readableBytes() <= kMaxHeaderSize;
+                // an empty line ends the trailer
+                if (crlf == buf->peek()) {
+                    exchange->state = Exchange::State::kDone;
+                }
+                relayFraming(static_cast<size_t>(crlf + 2 - buf->peek()));
+                break;
+            }
+
+            case Exchange::State::kUntilClose:
+                relayBytes(buf, downstream, buf->readableBytes());
+                break;
+
+            case Exchange::State::kDone:
+                break;
+        }
+    }
+    return true;
+}
+
+void HttpProxy::finishExchange(LoopPool* pool, Upstream* upstream) {
+    ExchangePtr exchange = std::move(upstream->exchange);
+    pool->loop->cancel(exchange->timer);
+    if (exchange->upstreamClose) {
+        // TCPClient reconnects after the upstream closes it
+        upstream->conn->shutdown();
+    }
+
+    TCPConnectionPtr downstream = exchange->downstream.lock();
+    if (downstream) exchange->done(downstream, !exchange->close);
+    dispatch(pool);
+}
+
+void HttpProxy::failExchange(LoopPool* pool, const ExchangePtr& exchange,
+                             const char* response) {
+    pool->loop->cancel(exchange->timer);
+    TCPConnectionPtr downstream = exchange->downstream.lock();
+    if (downstream) {
+        downstream->send(response);
+        exchange->done(downstream, true);
+    }
+}
+
+void HttpProxy::onTimeout(LoopPool* pool,
+                          const std::weak_ptr<Exchange>& weakExchange) {
+    ExchangePtr exchange = weakExchange.lock();
+    if (!exchange || exchange->started) return;
+
+    LOG_WARN << "HttpProxy[" << name_ << "] - upstream "
+             << upstreamAddr_.toIpPort() << " timeout";
+    auto it = std::find(pool->pending.begin(), pool->pending.end(), exchange);
+    if (it != pool->pending.end()) {
+        pool->pending.erase(it);
+    } else {
+        // in flight, the connection can not be reused
+        for (auto& upstream : pool->upstreams) {
+            if (upstream->exchange == exchange) {
+                upstream->exchange.reset();
+                if (upstream->conn) upstream->conn->forceClose();
+            }
+        }
+    }
+    failExchange(pool, exchange, kGatewayTimeout);
+}
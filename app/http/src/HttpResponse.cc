@@ -5,22 +5,26 @@
  * @author Lux
  */
 
+#include <LuxUtils/Format.h>
 #include <http/HttpResponse.h>
 
 using namespace Lux;
 
 void http::HttpResponse::appendToBuffer(polaris::Buffer* output) const {
-    char buf[32];
-    snprintf(buf, sizeof buf, "HTTP/1.1 %d ", statusCode_);
-    output->append(buf);
+    char buf[format::kMaxIntegerSize];
+    output->append("HTTP/1.1 ");
+    int code = static_cast<int>(statusCode_);
+    output->append(buf, format::formatDecimal(buf, code));
+    output->append(" ");
     output->append(statusMessage_);
     output->append("\r\n");
 
     if (closeConnection_) {
         output->append("Connection: close\r\n");
     } else {
-        snprintf(buf, sizeof buf, "Content-Length: %zd\r\n", body_.size());
-        output->append(buf);
+        output->append("Content-Length: ");
+        output->append(buf, format::formatDecimal(buf, body_.size()));
+        output->append("\r\n");
         output->append("Connection: Keep-Alive\r\n");
     }
 
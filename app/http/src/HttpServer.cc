@@ -6,10 +6,17 @@
  */
 
 #include <LuxLog/Logger.h>
+#include <http/Http2Session.h>
+#include <http/HttpCache.h>
 #include <http/HttpContext.h>
+#include <http/HttpProxy.h>
 #include <http/HttpRequest.h>
 #include <http/HttpResponse.h>
 #include <http/HttpServer.h>
+#include <http/RateLimiter.h>
+#include <http/WebSocket.h>
+
+#include <strings.h>
 
 #include "polaris/Callbacks.h"
 
@@ -25,6 +32,21 @@ void defaultHttpCallback(const HttpRequest&, HttpResponse* resp) {
     resp->setStatusMessage("Not Found");
     resp->setCloseConnection(true);
 }
+
+bool shouldClose(const HttpRequest& req) {
+    const string& connection = req.getHeader("Connection");
+    return connection == "close" ||
+           (req.getVersion() == HttpRequest::Version::kHttp10 &&
+            connection != "Keep-Alive");
+}
+
+/// Counts a request until destroyed.
+struct InflightRequest {
+    AtomicInt32* count;
+
+    explicit InflightRequest(AtomicInt32* n) : count(n) {}
+    ~InflightRequest() { count->decrement(std::memory_order_relaxed); }
+};
 }  // namespace detail
 }  // namespace http
 }  // namespace Lux
@@ -32,54 +54,344 @@ void defaultHttpCallback(const HttpRequest&, HttpResponse* resp) {
 HttpServer::HttpServer(EventLoop* loop, const InetAddress& listenAddr,
                        const string& name, TCPServer::Option option)
     : server_(loop, listenAddr, name, option),
-      httpCallback_(detail::defaultHttpCallback) {
+      httpCallback_(detail::defaultHttpCallback),
+      webSocketPingInterval_(30.0),
+      cacheCapacity_(0),
+      maxInflightRequests_(0) {
     server_.setConnectionCallback(
         std::bind(&HttpServer::onConnection, this, _1));
     server_.setMessageCallback(
         std::bind(&HttpServer::onMessage, this, _1, _2, _3));
 }
 
+HttpServer::~HttpServer() = default;
+
+void HttpServer::setClientRateLimit(double rate, double burst) {
+    clientLimiter_.reset(new RateLimiter(rate, burst));
+}
+
+void HttpServer::addRouteRateLimit(const string& pathPrefix, double rate,
+                                   double burst) {
+    routeLimiters_.emplace_back(
+        pathPrefix, std::unique_ptr<RateLimiter>(new RateLimiter(rate, burst)));
+}
+
 void HttpServer::start() {
     LOG_WARN << "HttpServer[" << server_.name() << "] starts listening on "
              << server_.ipPort();
     server_.start();
 }
 
+// the context lives in the connection, not on the heap
+static_assert(TCPConnection::Context::storesInline<HttpContext>(),
+              "HttpContext exceeds TCPConnection::kContextSize");
+
 void HttpServer::onConnection(const TCPConnectionPtr& conn) {
     if (conn->connected()) {
-        conn->setContext(HttpContext());
+        HttpContext& context =
+            conn->getMutableContext()->emplace<HttpContext>();
+        if (cacheCapacity_ > 0) context.setCache(cacheOf(conn->getLoop()));
+    } else {
+        HttpContext* context =
+            &conn->getMutableContext()->get<HttpContext>();
+        if (context->webSocket()) context->webSocket()->onDisconnected();
     }
 }
 
 void HttpServer::onMessage(const TCPConnectionPtr& conn, Buffer* buf,
                            Timestamp receiveTime) {
-    HttpContext* context =
-        Lux::any_cast<HttpContext>(conn->getMutableContext());
+    HttpContext* context = &conn->getMutableContext()->get<HttpContext>();
 
-    // parse request
-    if (!context->parseRequest(buf, receiveTime)) {
-        conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
-        conn->shutdown();
+    // keep the data until the upstream response is done, reading is stopped
+    // meanwhile so only what came with the proxied request is buffered
+    if (context->proxying()) return;
+
+    if (context->http2Session()) {
+        context->http2Session()->onMessage(buf, receiveTime);
+        return;
     }
+    if (context->webSocket()) {
+        context->webSocket()->onMessage(buf, receiveTime);
+        return;
+    }
+
+    // HTTP/2 with prior knowledge, RFC 7540 3.4
+    if (context->expectRequestLine()) {
+        int preface = Http2Session::checkPreface(*buf);
+        if (preface == 0) return;
+        if (preface > 0) {
+            auto session = newHttp2Session(conn);
+            context->setHttp2Session(session);
+            session->start();
+            session->onMessage(buf, receiveTime);
+            return;
+        }
+    }
+
+    // parse requests, pipelined ones are answered in order
+    while (true) {
+        if (!context->parseRequest(buf, receiveTime)) {
+            conn->send("HTTP/1.1 400 Bad Request\r\n\r\n");
+            conn->shutdown();
+            return;
+        }
+        if (!context->gotAll()) return;
 
-    if (context->gotAll()) {
-        onRequest(conn, context->request());
+        // admitted as stream 1 of the session
+        if (upgradeToHttp2(conn, context)) {
+            context->reset();
+            if (buf->readableBytes() > 0) {
+                context->http2Session()->onMessage(buf, receiveTime);
+            }
+            return;
+        }
+
+        std::unique_ptr<detail::InflightRequest> inflight;
+        if (!admit(conn, context->request(), &inflight)) {
+            context->reset();
+            if (!conn->connected() || buf->readableBytes() == 0) return;
+            continue;
+        }
+
+        if (upgradeToWebSocket(conn, context)) {
+            context->reset();
+            if (context->webSocket() && buf->readableBytes() > 0) {
+                context->webSocket()->onMessage(buf, receiveTime);
+            }
+            return;
+        }
+        if (forwardToProxy(conn, context, &inflight)) {
+            context->reset();
+            return;
+        }
+
+        onRequest(conn, context->request(), context->cache());
         context->reset();
+        if (!conn->connected() || buf->readableBytes() == 0) return;
+    }
+}
+
+bool HttpServer::upgradeToHttp2(const TCPConnectionPtr& conn,
+                                HttpContext* context) {
+    // RFC 7540 3.2, HTTP/1.1 Upgrade: h2c
+    const HttpRequest& req = context->request();
+    if (req.getVersion() != HttpRequest::Version::kHttp11) return false;
+
+    // header names are case-insensitive
+    const string* upgrade = nullptr;
+    const string* settings = nullptr;
+    for (const auto& header : req.headers()) {
+        if (strcasecmp(header.first.c_str(), "Upgrade") == 0) {
+            upgrade = &header.second;
+        } else if (strcasecmp(header.first.c_str(), "HTTP2-Settings") == 0) {
+            settings = &header.second;
+        }
+    }
+    if (!upgrade || *upgrade != "h2c" || !settings) return false;
+
+    auto session = newHttp2Session(conn);
+    if (!session->upgrade(*settings, req)) return false;
+    context->setHttp2Session(session);
+    return true;
+}
+
+std::shared_ptr<Http2Session> HttpServer::newHttp2Session(
+    const TCPConnectionPtr& conn) {
+    // the session lives in the connection, which outlives it
+    return std::make_shared<Http2Session>(
+        conn.get(), std::bind(&HttpServer::onHttp2Request, this,
+                              conn->peerAddress().toIp(), _1, _2));
+}
+
+void HttpServer::onHttp2Request(const string& clientIp, const HttpRequest& req,
+                                HttpResponse* resp) {
+    std::unique_ptr<detail::InflightRequest> inflight;
+    switch (checkAdmission(clientIp, req, &inflight)) {
+        case Admission::kAdmitted:
+            httpCallback_(req, resp);
+            break;
+
+        case Admission::kRateLimited:
+            resp->setStatusCode(
+                HttpResponse::HttpStatusCode::k429TooManyRequests);
+            resp->setStatusMessage("Too Many Requests");
+            resp->addHeader("Retry-After", "1");
+            break;
+
+        case Admission::kOverloaded:
+            // other streams and the connection go on
+            resp->setStatusCode(
+                HttpResponse::HttpStatusCode::k503ServiceUnavailable);
+            resp->setStatusMessage("Service Unavailable");
+            break;
     }
 }
 
 void HttpServer::onRequest(const TCPConnectionPtr& conn,
-                           const HttpRequest& req) {
-    const string& connection = req.getHeader("Connection");
-    bool close = connection == "close" ||
-                 (req.getVersion() == HttpRequest::Version::kHttp10 &&
-                  connection != "Keep-Alive");
+                           const HttpRequest& req, HttpCache* cache) {
+    bool close = detail::shouldClose(req);
+    // the cached bytes say "Connection: Keep-Alive"
+    bool useCache = cache && !close && HttpCache::cacheable(req);
+    if (useCache) {
+        HttpCache::Bytes bytes = cache->get(req, req.receiveTime());
+        if (bytes) {
+            conn->send(*bytes);
+            return;
+        }
+    }
+
     HttpResponse response(close);
     httpCallback_(req, &response);
     Buffer buf;
     response.appendToBuffer(&buf);
+    if (useCache && response.cacheTtl() > 0 && !response.closeConnection()) {
+        cache->put(req, response.vary(), buf.toStringPiece(),
+                   response.cacheTtl(), req.receiveTime());
+    }
     conn->send(&buf);
     if (response.closeConnection()) {
         conn->shutdown();
     }
 }
+
+HttpCache* HttpServer::cacheOf(EventLoop* loop) {
+    MutexLockGuard lock(mutex_);
+    std::unique_ptr<HttpCache>& cache = caches_[loop];
+    if (!cache) cache.reset(new HttpCache(cacheCapacity_));
+    return cache.get();
+}
+
+HttpServer::Admission HttpServer::checkAdmission(
+    const string& clientIp, const HttpRequest& req,
+    std::unique_ptr<detail::InflightRequest>* inflight) {
+    if (clientLimiter_ && !clientLimiter_->allow(clientIp, req.receiveTime())) {
+        return Admission::kRateLimited;
+    }
+    for (const auto& entry : routeLimiters_) {
+        const string& prefix = entry.first;
+        if (req.path().compare(0, prefix.size(), prefix) == 0 &&
+            !entry.second->allow(prefix, req.receiveTime())) {
+            return Admission::kRateLimited;
+        }
+    }
+
+    if (maxInflightRequests_ > 0) {
+        if (inflightRequests_.incrementAndGet(std::memory_order_relaxed) >
+            maxInflightRequests_) {
+            inflightRequests_.decrement(std::memory_order_relaxed);
+            return Admission::kOverloaded;
+        }
+        inflight->reset(new detail::InflightRequest(&inflightRequests_));
+    }
+    return Admission::kAdmitted;
+}
+
+bool HttpServer::admit(const TCPConnectionPtr& conn, const HttpRequest& req,
+                       std::unique_ptr<detail::InflightRequest>* inflight) {
+    switch (checkAdmission(conn->peerAddress().toIp(), req, inflight)) {
+        case Admission::kAdmitted:
+            return true;
+
+        case Admission::kRateLimited:
+            conn->send(
+                "HTTP/1.1 429 Too Many Requests\r\n"
+                "Content-Length: 0\r\n"
+                "Retry-After: 1\r\n\r\n");
+            if (detail::shouldClose(req)) conn->shutdown();
+            return false;
+
+        case Admission::kOverloaded:
+            conn->send(
+                "HTTP/1.1 503 Service Unavailable\r\n"
+                "Content-Length: 0\r\n"
+                "Connection: close\r\n\r\n");
+            conn->shutdown();
+            return false;
+    }
+    return false;
+}
+
+bool HttpServer::upgradeToWebSocket(const TCPConnectionPtr& conn,
+                                    HttpContext* context) {
+    const HttpRequest& req = context->request();
+    if (!webSocketOpenCallback_ || !WebSocket::isUpgradeRequest(req)) {
+        return false;
+    }
+
+    // RFC 6455 4.2.1
+    string key = req.getHeaderIgnoreCase("Sec-WebSocket-Key");
+    if (key.empty() ||
+        req.getHeaderIgnoreCase("Sec-WebSocket-Version") != "13") {
+        conn->send(
+            "HTTP/1.1 400 Bad Request\r\n"
+            "Sec-WebSocket-Version: 13\r\n\r\n");
+        conn->shutdown();
+        return true;
+    }
+
+    auto webSocket = std::make_shared<WebSocket>(conn, req);
+    webSocket->setMessageCallback(webSocketMessageCallback_);
+    webSocket->setCloseCallback(webSocketCloseCallback_);
+    if (!webSocketOpenCallback_(webSocket)) {
+        conn->send("HTTP/1.1 403 Forbidden\r\n\r\n");
+        conn->shutdown();
+        return true;
+    }
+
+    Buffer buf;
+    buf.append(
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: ");
+    buf.append(websocket::acceptKey(key));
+    buf.append("\r\n\r\n");
+    conn->send(&buf);
+
+    context->setWebSocket(webSocket);
+    if (webSocketPingInterval_ > 0) {
+        webSocket->startKeepalive(webSocketPingInterval_);
+    }
+    return true;
+}
+
+bool HttpServer::forwardToProxy(
+    const TCPConnectionPtr& conn, HttpContext* context,
+    std::unique_ptr<detail::InflightRequest>* inflight) {
+    const HttpRequest& req = context->request();
+    for (const auto& entry : proxies_) {
+        const string& prefix = entry.first;
+        if (req.path().compare(0, prefix.size(), prefix) == 0) {
+            context->setProxying(true);
+            // the kernel buffer fills up and the client is throttled by TCP
+            conn->stopRead();
+            // counted until the exchange is gone, even if the downstream
+            // connection is closed before the response is done
+            std::shared_ptr<detail::InflightRequest> counted(
+                std::move(*inflight));
+            bool close = detail::shouldClose(req);
+            entry.second->forward(
+                conn, req, close,
+                [this, close, counted](const TCPConnectionPtr& downstream,
+                                       bool keepAlive) {
+                    onProxyDone(downstream, keepAlive, close);
+                });
+            return true;
+        }
+    }
+    return false;
+}
+
+void HttpServer::onProxyDone(const TCPConnectionPtr& conn, bool keepAlive,
+                             bool close) {
+    HttpContext* context = &conn->getMutableContext()->get<HttpContext>();
+    context->setProxying(false);
+    // also to see the FIN after shutdown()
+    conn->startRead();
+    if (!keepAlive || close) {
+        conn->shutdown();
+    } else if (conn->inputBuffer()->readableBytes() > 0) {
+        // pipelined requests received while waiting
+        onMessage(conn, conn->inputBuffer(), Timestamp::now());
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file RateLimiter.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <http/RateLimiter.h>
+
+#include <algorithm>
+#include <functional>
+
+using namespace Lux;
+using namespace Lux::http;
+
+const size_t RateLimiter::kShards;
+
+void TokenBucket::refill(Timestamp now) {
+    double elapsed = timeDifference(now, last_);
+    if (elapsed > 0) {
+        tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+        last_ = now;
+    }
+}
+
+bool TokenBucket::consume(Timestamp now) {
+    refill(now);
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+bool TokenBucket::full(Timestamp now) const {
+    return tokens_ + timeDifference(now, last_) * rate_ >= burst_;
+}
+
+RateLimiter::RateLimiter(double rate, double burst, size_t maxKeys)
+    : rate_(rate),
+      burst_(std::max(burst, 1.0)),
+      maxKeysPerShard_(std::max(maxKeys / kShards, static_cast<size_t>(1))) {}
+
+bool RateLimiter::allow(const string& key, Timestamp now) {
+    Shard& shard = shards_[std::hash<string>()(key) % kShards];
+    MutexLockGuard lock(shard.mutex);
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        if (shard.buckets.size() >= maxKeysPerShard_) {
+            for (auto bucket = shard.buckets.begin();
+                 bucket != shard.buckets.end();) {
+                if (bucket->second.full(now)) {
+                    bucket = shard.buckets.erase(bucket);
+                } else {
+                    ++bucket;
+                }
+            }
+            if (shard.buckets.size() >= maxKeysPerShard_) return false;
+        }
+        it = shard.buckets.emplace(key, TokenBucket(rate_, burst_, now)).first;
+    }
+    return it->second.consume(now);
+}
@@ -0,0 +1,403 @@
+/**
+ * @file WebSocket.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/Logger.h>
+#include <LuxUtils/Base64.h>
+#include <LuxUtils/SHA1.h>
+#include <http/WebSocket.h>
+#include <polaris/EventLoop.h>
+#include <polaris/TCPConnection.h>
+#include <strings.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::polaris;
+
+const size_t WebSocket::kMaxMessageSize;
+
+namespace {
+const uint8_t kFin = 0x80;
+const uint8_t kReservedBits = 0x70;
+const uint8_t kOpcodeMask = 0x0F;
+const uint8_t kMasked = 0x80;
+const uint8_t kPayloadLengthMask = 0x7F;
+const size_t kMaxControlPayload = 125;
+
+const char kGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+bool isControl(websocket::Opcode opcode) {
+    return static_cast<uint8_t>(opcode) & 0x8;
+}
+
+/// RFC 6455 7.4, the codes a peer may send in a Close frame; 1005, 1006
+/// and 1015 are never sent, 1016-2999 are not defined
+bool isValidCloseCode(uint16_t code) {
+    return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1014) ||
+           (code >= 3000 && code <= 4999);
+}
+
+/// RFC 3629, overlong forms and surrogates are rejected
+bool isValidUtf8(const char* data, size_t len) {
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    while (p < end) {
+        if (*p < 0x80) {
+            ++p;
+            continue;
+        }
+        int n;
+        uint32_t cp;
+        if ((*p & 0xE0) == 0xC0) {
+            n = 1;
+            cp = *p & 0x1F;
+        } else if ((*p & 0xF0) == 0xE0) {
+            n = 2;
+            cp = *p & 0x0F;
+        } else if ((*p & 0xF8) == 0xF0) {
+            n = 3;
+            cp = *p & 0x07;
+        } else {
+            return false;
+        }
+        if (end - p <= n) return false;
+        for (int i = 1; i <= n; ++i) {
+            if ((p[i] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[i] & 0x3F);
+        }
+        static const uint32_t kMin[] = {0, 0x80, 0x800, 0x10000};
+        if (cp < kMin[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return false;
+        }
+        p += n + 1;
+    }
+    return true;
+}
+}  // namespace
+
+websocket::ParseResult websocket::parseFrameHeader(const Buffer& buf,
+                                                   FrameHeader* header) {
+    size_t readable = buf.readableBytes();
+    if (readable < 2) return ParseResult::kIncomplete;
+
+    const auto* p = reinterpret_cast<const uint8_t*>(buf.peek());
+    // no extension is negotiated, so RSV1-3 must be 0
+    if (p[0] & kReservedBits) return ParseResult::kError;
+    header->fin = p[0] & kFin;
+    header->opcode = static_cast<Opcode>(p[0] & kOpcodeMask);
+    header->masked = p[1] & kMasked;
+
+    size_t length = 2;
+    uint64_t payloadLength = p[1] & kPayloadLengthMask;
+    if (payloadLength == 126) {
+        length += 2;
+        if (readable < length) return ParseResult::kIncomplete;
+        payloadLength = (static_cast<uint64_t>(p[2]) << 8) | p[3];
+    } else if (payloadLength == 127) {
+        length += 8;
+        if (readable < length) return ParseResult::kIncomplete;
+        payloadLength = 0;
+        for (int i = 2; i < 10; ++i) payloadLength = (payloadLength << 8) | p[i];
+        // the most significant bit must be 0
+        if (payloadLength >> 63) return ParseResult::kError;
+    }
+
+    if (header->masked) {
+        if (readable < length + 4) return ParseResult::kIncomplete;
+        memcpy(header->maskingKey, p + length, 4);
+        length += 4;
+    }
+    header->payloadLength = payloadLength;
+    header->headerLength = length;
+    return ParseResult::kComplete;
+}
+
+void websocket::unmask(char* dst, const char* src, size_t len,
+                       const uint8_t key[4]) {
+    size_t i = 0;
+    // i stays a multiple of 4 in the wide loops, so the key stays aligned
+#ifdef __SSE2__
+    int32_t key32;
+    memcpy(&key32, key, 4);
+    const __m128i mask128 = _mm_set1_epi32(key32);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_xor_si128(v, mask128));
+    }
+#endif
+    uint64_t mask64;
+    memcpy(&mask64, key, 4);
+    memcpy(reinterpret_cast<char*>(&mask64) + 4, key, 4);
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, src + i, 8);
+        v ^= mask64;
+        memcpy(dst + i, &v, 8);
+    }
+    for (; i < len; ++i) {
+        dst[i] = static_cast<char>(src[i] ^ key[i & 3]);
+    }
+}
+
+void websocket::encodeFrame(Opcode opcode, bool fin, const char* payload,
+                            size_t len, Buffer* out) {
+    uint8_t header[10];
+    size_t headerLength = 2;
+    header[0] = static_cast<uint8_t>((fin ? kFin : 0) |
+                                     static_cast<uint8_t>(opcode));
+    if (len < 126) {
+        header[1] = static_cast<uint8_t>(len);
+    } else if (len <= 0xFFFF) {
+        header[1] = 126;
+        header[2] = static_cast<uint8_t>(len >> 8);
+        header[3] = static_cast<uint8_t>(len);
+        headerLength = 4;
+    } else {
+        header[1] = 127;
+        for (int i = 0; i < 8; ++i) {
+            header[2 + i] = static_cast<uint8_t>(
+                static_cast<uint64_t>(len) >> (56 - 8 * i));
+        }
+        headerLength = 10;
+    }
+    out->ensureWritableBytes(headerLength + len);
+    out->append(header, headerLength);
+    out->append(payload, len);
+}
+
+string websocket::acceptKey(const string& key) {
+    return Base64::encode(SHA1::digest(key + kGuid));
+}
+
+bool WebSocket::isUpgradeRequest(const HttpRequest& req) {
+    return req.method() == HttpRequest::Method::kGet &&
+           req.getVersion() == HttpRequest::Version::kHttp11 &&
+           strcasecmp(req.getHeaderIgnoreCase("Upgrade").c_str(),
+                      "websocket") == 0 &&
+           strcasestr(req.getHeaderIgnoreCase("Connection").c_str(),
+                      "upgrade") != nullptr;
+}
+
+WebSocket::WebSocket(const TCPConnectionPtr& conn, const HttpRequest& req)
+    : conn_(conn),
+      loop_(conn->getLoop()),
+      request_(req),
+      messageOpcode_(Opcode::kText),
+      fragmented_(false),
+      closeSent_(false),
+      closed_(false),
+      alive_(true) {}
+
+void WebSocket::send(StringPiece text) {
+    sendFrame(Opcode::kText, text.data(), text.size());
+}
+
+void WebSocket::sendBinary(StringPiece data) {
+    sendFrame(Opcode::kBinary, data.data(), data.size());
+}
+
+void WebSocket::ping(StringPiece payload) {
+    sendFrame(Opcode::kPing, payload.data(),
+              std::min(payload.size(), kMaxControlPayload));
+}
+
+void WebSocket::close(CloseCode code, const string& reason) {
+    loop_->runInLoop(
+        std::bind(&WebSocket::closeInLoop, shared_from_this(), code, reason));
+}
+
+void WebSocket::sendFrame(Opcode opcode, const char* payload, size_t len) {
+    if (closeSent_) return;
+    TCPConnectionPtr conn = conn_.lock();
+    if (conn) {
+        Buffer buf;
+        websocket::encodeFrame(opcode, true, payload, len, &buf);
+        conn->send(&buf);
+    }
+}
+
+void WebSocket::closeInLoop(CloseCode code, const string& reason) {
+    loop_->assertInLoopThread();
+    if (closeSent_ || closed_) return;
+
+    char payload[kMaxControlPayload];
+    payload[0] = static_cast<char>(static_cast<uint16_t>(code) >> 8);
+    payload[1] = static_cast<char>(code);
+    size_t len = std::min(reason.size(), kMaxControlPayload - 2);
+    memcpy(payload + 2, reason.data(), len);
+    sendFrame(Opcode::kClose, payload, len + 2);
+    closeSent_ = true;
+
+    // no need to wait for the peer's Close, RFC 6455 7.1.1
+    TCPConnectionPtr conn = conn_.lock();
+    if (conn) conn->shutdown();
+}
+
+void WebSocket::startKeepalive(double interval) {
+    std::weak_ptr<WebSocket> weakSelf(shared_from_this());
+    pingTimer_ = loop_->runEvery(interval, [weakSelf] {
+        WebSocketPtr self = weakSelf.lock();
+        if (self) self->onPingTimer();
+    });
+}
+
+void WebSocket::onPingTimer() {
+    if (closed_) return;
+
+    // no Pong, or the closing handshake does not finish
+    if (!alive_ || closeSent_) {
+        LOG_WARN << "WebSocket " << request_.path() << " timeout, force close";
+        TCPConnectionPtr conn = conn_.lock();
+        if (conn) conn->forceClose();
+        return;
+    }
+    alive_ = false;
+    ping();
+}
+
+void WebSocket::onMessage(Buffer* buf, Timestamp) {
+    websocket::FrameHeader header;
+    while (!closed_) {
+        auto result = websocket::parseFrameHeader(*buf, &header);
+        if (result == websocket::ParseResult::kIncomplete) return;
+
+        // RFC 6455 5.1, a client must mask all the frames
+        if (result == websocket::ParseResult::kError || !header.masked) {
+            closeInLoop(CloseCode::kProtocolError, "");
+            break;
+        }
+        if (header.payloadLength > kMaxMessageSize) {
+            closeInLoop(CloseCode::kMessageTooBig, "");
+            break;
+        }
+
+        size_t frameLength =
+            header.headerLength + static_cast<size_t>(header.payloadLength);
+        if (buf->readableBytes() < frameLength) return;
+
+        alive_ = true;
+        bool ok = handleFrame(header, buf->peek() + header.headerLength);
+        buf->retrieve(frameLength);
+        if (!ok) break;
+    }
+    // closing or closed, the rest is discarded
+    buf->retrieveAll();
+}
+
+bool WebSocket::handleFrame(const websocket::FrameHeader& header,
+                            const char* payload) {
+    if (isControl(header.opcode)) return handleControlFrame(header, payload);
+
+    // after sending Close, data frames are discarded
+    if (closeSent_) return true;
+
+    if (header.opcode == Opcode::kContinuation) {
+        if (!fragmented_) {
+            closeInLoop(CloseCode::kProtocolError, "unexpected continuation");
+            return false;
+        }
+    } else if (header.opcode == Opcode::kText ||
+               header.opcode == Opcode::kBinary) {
+        if (fragmented_) {
+            closeInLoop(CloseCode::kProtocolError, "expect continuation");
+            return false;
+        }
+        messageOpcode_ = header.opcode;
+        message_.clear();
+    } else {
+        closeInLoop(CloseCode::kProtocolError, "reserved opcode");
+        return false;
+    }
+
+    auto len = static_cast<size_t>(header.payloadLength);
+    if (message_.size() + len > kMaxMessageSize) {
+        closeInLoop(CloseCode::kMessageTooBig, "");
+        return false;
+    }
+    size_t offset = message_.size();
+    message_.resize(offset + len);
+    websocket::unmask(&message_[offset], payload, len, header.maskingKey);
+
+    fragmented_ = !header.fin;
+    if (header.fin) {
+        if (messageOpcode_ == Opcode::kText &&
+            !isValidUtf8(message_.data(), message_.size())) {
+            closeInLoop(CloseCode::kInvalidPayload, "");
+            return false;
+        }
+        if (messageCallback_) {
+            messageCallback_(shared_from_this(), message_, messageOpcode_);
+        }
+        message_.clear();
+    }
+    return true;
+}
+
+bool WebSocket::handleControlFrame(const websocket::FrameHeader& header,
+                                   const char* payload) {
+    // RFC 6455 5.5, control frames can not be fragmented
+    if (!header.fin || header.payloadLength > kMaxControlPayload) {
+        closeInLoop(CloseCode::kProtocolError, "");
+        return false;
+    }
+
+    char data[kMaxControlPayload];
+    auto len = static_cast<size_t>(header.payloadLength);
+    websocket::unmask(data, payload, len, header.maskingKey);
+
+    switch (header.opcode) {
+        case Opcode::kPing:
+            sendFrame(Opcode::kPong, data, len);
+            return true;
+
+        case Opcode::kPong:
+            // alive_ has been set
+            return true;
+
+        case Opcode::kClose: {
+            if (len == 1) {
+                closeInLoop(CloseCode::kProtocolError, "");
+                return false;
+            }
+            CloseCode code = CloseCode::kNormal;
+            if (len >= 2) {
+                auto value = static_cast<uint16_t>(
+                    (static_cast<uint8_t>(data[0]) << 8) |
+                    static_cast<uint8_t>(data[1]));
+                if (!isValidCloseCode(value)) {
+                    closeInLoop(CloseCode::kProtocolError, "");
+                    return false;
+                }
+                // the reason
+                if (!isValidUtf8(data + 2, len - 2)) {
+                    closeInLoop(CloseCode::kInvalidPayload, "");
+                    return false;
+                }
+                code = static_cast<CloseCode>(value);
+            }
+            // echo the status code
+            closeInLoop(code, "");
+            closed_ = true;
+            return false;
+        }
+
+        default:
+            closeInLoop(CloseCode::kProtocolError, "reserved opcode");
+            return false;
+    }
+}
+
+void WebSocket::onDisconnected() {
+    loop_->assertInLoopThread();
+    loop_->cancel(pingTimer_);
+    closed_ = true;
+    if (closeCallback_) closeCallback_(shared_from_this());
+}
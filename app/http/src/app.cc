@@ -1,9 +1,12 @@
 #include <LuxLog/Logger.h>
 #include <LuxMySQL/MySQLConn.h>
 #include <LuxMySQL/MySQLConnPool.h>
+#include <LuxUtils/Config.h>
 #include <LuxUtils/MTQueue.h>
+#include <LuxUtils/MappedINI.h>
 #include <fcntl.h>
 #include <http/app.h>
+#include <polaris/FileWatcher.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -306,6 +309,74 @@ string Application::getHtml() {
     return readFile2String(realFile_);
 }
 
+/// [SERVER] 中运行时可修改的设置
+TCPServer::Tunables serverTunables(const INIParser::MappedINI& ini) {
+    TCPServer::Tunables tunables;
+    tunables.numThreads =
+        static_cast<int>(ini.getInt("server", "threads", 8));
+    tunables.tcpNoDelay = ini.getBool("server", "tcpNoDelay", false);
+    tunables.maxConnections =
+        static_cast<int>(ini.getInt("server", "maxConnections", 0));
+    return tunables;
+}
+
+/// [MYSQL] 中运行时可修改的设置
+MySQLConnPool::Tunables mysqlTunables(const INIParser::MappedINI& ini) {
+    MySQLConnPool::Tunables tunables;
+    tunables.capacity = static_cast<int>(ini.getInt("mysql", "capacity", 10));
+    tunables.connectTimeout =
+        static_cast<unsigned>(ini.getInt("mysql", "connectTimeout", 0));
+    tunables.waitTimeout = ini.getDouble("mysql", "waitTimeout", 0.0);
+    return tunables;
+}
+
+/// 由配置文件启动，文件被替换后重新读取可修改的设置
+int runWithConfig(const string& path) {
+    INIParser::MappedINI ini;
+    if (int err = ini.open(path)) {
+        fprintf(stderr, "Failed to open %s: %s\n", path.c_str(),
+                strerror(err));
+        return 1;
+    }
+
+    // 连接池是单例，配置要同样长寿
+    static Config<TCPServer::Tunables> serverConfig(serverTunables(ini));
+    static Config<MySQLConnPool::Tunables> mysqlConfig(mysqlTunables(ini));
+
+    // 其余设置只在启动时读取
+    string serverName(ini.get("server", "name", "LuxPolaris"));
+    string staticSrcPrefix(ini.get("server", "root", "/home/lux/Lux/app/HTML"));
+    uint16_t serverPort =
+        static_cast<uint16_t>(ini.getInt("server", "port", 5836));
+    string dbIp(ini.get("mysql", "host", "127.0.0.1"));
+    uint16_t dbPort = static_cast<uint16_t>(ini.getInt("mysql", "port", 3306));
+    string user(ini.get("mysql", "user", "lutianen"));
+    string passwd(ini.get("mysql", "passwd", "lutianen"));
+    string db(ini.get("mysql", "database", "LuxDatabase"));
+
+    EventLoop loop;
+    MySQLConnPool::getInstance()->setConfig(mysqlConfig);
+    Application app(&loop, InetAddress(serverPort), serverName,
+                    staticSrcPrefix, dbIp, dbPort, user, passwd, db);
+    app.setConfig(serverConfig);
+
+    FileWatcher watcher(&loop);
+    watcher.watch(path, [&ini](const string& changed) {
+        if (int err = ini.reload()) {
+            LOG_ERROR << "Failed to reload " << changed << ": "
+                      << strerror(err);
+            return;
+        }
+        serverConfig.publish(serverTunables(ini));
+        mysqlConfig.publish(mysqlTunables(ini));
+        LOG_INFO << "Reloaded " << changed;
+    });
+
+    app.start();
+    loop.loop();
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     string dbIp = "192.168.1.108";
     uint16_t dbPort = 3306;
@@ -317,7 +388,10 @@ int main(int argc, char* argv[]) {
     uint16_t serverPort = 5836;
     int numThreads = 8; 
 
-    if (argc > 1) {
+    if (argc == 2) {
+        benchmark = true;
+        return runWithConfig(argv[1]);
+    } else if (argc > 1) {
         benchmark = true;
 
         serverName = argv[1];
@@ -344,8 +418,9 @@ int main(int argc, char* argv[]) {
             "serverPort numThreads "
             "[IPofMySQLServer[default: 127.0.0.1] PortofMySQLServer[default: 3306] "
             "UsernameofMySQLServer[default: lutianen] PasswordofMySQLServer[default: lutianen] "
-            "DatabaseofMySQLServer[default: user]]\n",
-            argv[0]);
+            "DatabaseofMySQLServer[default: user]]\n"
+            "   or: %s server.ini\n",
+            argv[0], argv[0]);
     }
 
     return 0;
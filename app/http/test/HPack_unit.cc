@@ -0,0 +1,248 @@
+#include <assert.h>
+#include <http/HPack.h>
+#include <stdio.h>
+
+#include <string>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::http::hpack;
+
+/// "8286 8441" -> "\x82\x86\x84\x41", spaces are ignored
+std::string fromHex(const char* hex) {
+    std::string bytes;
+    int high = -1;
+    for (const char* p = hex; *p; ++p) {
+        if (*p == ' ') continue;
+        int digit = *p <= '9' ? *p - '0' : *p - 'a' + 10;
+        if (high < 0) {
+            high = digit;
+        } else {
+            bytes.push_back(static_cast<char>(high << 4 | digit));
+            high = -1;
+        }
+    }
+    return bytes;
+}
+
+HeaderList decode(Decoder* decoder, const char* hex) {
+    std::string block = fromHex(hex);
+    HeaderList headers;
+    DecodeResult result = decoder->decode(block.data(), block.size(), &headers);
+    assert(result == DecodeResult::kOk);
+    (void)result;
+    return headers;
+}
+
+std::string huffman(const std::string& str) {
+    polaris::Buffer buf;
+    huffmanEncode(str.data(), str.size(), &buf);
+    assert(buf.readableBytes() == huffmanEncodedLength(str.data(), str.size()));
+    return buf.retrieveAllAsString();
+}
+
+/// RFC 7541 C.2, one representation each
+void testFieldRepresentations() {
+    Decoder decoder;
+    assert(decode(&decoder, "400a 6375 7374 6f6d 2d6b 6579 0d63 7573 746f"
+                            "6d2d 6865 6164 6572") ==
+           HeaderList({{"custom-key", "custom-header"}}));
+    // indexed into the dynamic table, index 62
+    assert(decode(&decoder, "be") ==
+           HeaderList({{"custom-key", "custom-header"}}));
+
+    assert(decode(&decoder, "040c 2f73 616d 706c 652f 7061 7468") ==
+           HeaderList({{":path", "/sample/path"}}));
+    assert(decode(&decoder, "1008 7061 7373 776f 7264 0673 6563 7265 74") ==
+           HeaderList({{"password", "secret"}}));
+    assert(decode(&decoder, "82") == HeaderList({{":method", "GET"}}));
+
+    // the last two were not indexed
+    HeaderList headers;
+    std::string block = fromHex("bf");
+    assert(decoder.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kError);
+}
+
+/// RFC 7541 C.3 and C.4, the same requests without and with Huffman
+void testRequests(bool withHuffman) {
+    const char* const kBlocks[2][3] = {
+        {"8286 8441 0f77 7777 2e65 7861 6d70 6c65 2e63 6f6d",
+         "8286 84be 5808 6e6f 2d63 6163 6865",
+         "8287 85bf 400a 6375 7374 6f6d 2d6b 6579 0c63 7573 746f 6d2d 7661"
+         "6c75 65"},
+        {"8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff",
+         "8286 84be 5886 a8eb 1064 9cbf",
+         "8287 85bf 4088 25a8 49e9 5ba9 7d7f 8925 a849 e95b b8e8 b4bf"},
+    };
+    const char* const* blocks = kBlocks[withHuffman];
+
+    Decoder decoder;
+    assert(decode(&decoder, blocks[0]) ==
+           HeaderList({{":method", "GET"},
+                       {":scheme", "http"},
+                       {":path", "/"},
+                       {":authority", "www.example.com"}}));
+    assert(decode(&decoder, blocks[1]) ==
+           HeaderList({{":method", "GET"},
+                       {":scheme", "http"},
+                       {":path", "/"},
+                       {":authority", "www.example.com"},
+                       {"cache-control", "no-cache"}}));
+    assert(decode(&decoder, blocks[2]) ==
+           HeaderList({{":method", "GET"},
+                       {":scheme", "https"},
+                       {":path", "/index.html"},
+                       {":authority", "www.example.com"},
+                       {"custom-key", "custom-value"}}));
+}
+
+/// RFC 7541 C.6, a 256 byte table which evicts entries
+void testResponses() {
+    Decoder decoder(256);
+    const HeaderList first = {
+        {":status", "302"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"},
+    };
+    assert(decode(&decoder,
+                  "4882 6402 5885 aec3 771a 4b61 96d0 7abe 9410 54d4 44a8"
+                  "2005 9504 0b81 66e0 82a6 2d1b ff6e 919d 29ad 1718 63c7"
+                  "8f0b 97c8 e9ae 82ae 43d3") == first);
+
+    HeaderList second = first;
+    second[0].second = "307";
+    assert(decode(&decoder, "4883 640e ff c1 c0 bf") == second);
+
+    assert(decode(&decoder,
+                  "88c1 6196 d07a be94 1054 d444 a820 0595 040b 8166 e084"
+                  "a62d 1bff c05a 839b d9ab 77ad 94e7 821d d7f2 e6c7 b335"
+                  "dfdf cd5b 3960 d5af 2708 7f36 72c1 ab27 0fb5 291f 9587"
+                  "3160 65c0 03ed 4ee5 b106 3d50 07") ==
+           HeaderList({{":status", "200"},
+                       {"cache-control", "private"},
+                       {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                       {"location", "https://www.example.com"},
+                       {"content-encoding", "gzip"},
+                       {"set-cookie",
+                        "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; "
+                        "version=1"}}));
+}
+
+void testHuffman() {
+    // RFC 7541 C.4 and C.6
+    assert(huffman("www.example.com") ==
+           fromHex("f1e3 c2e5 f23a 6ba0 ab90 f4ff"));
+    assert(huffman("no-cache") == fromHex("a8eb 1064 9cbf"));
+    assert(huffman("custom-key") == fromHex("25a8 49e9 5ba9 7d7f"));
+    assert(huffman("custom-value") == fromHex("25a8 49e9 5bb8 e8b4 bf"));
+    assert(huffman("302") == fromHex("6402"));
+    assert(huffman("Mon, 21 Oct 2013 20:13:21 GMT") ==
+           fromHex("d07a be94 1054 d444 a820 0595 040b 8166 e082 a62d 1bff"));
+    assert(huffman("").empty());
+
+    // every byte value, including the 30 bit codes
+    std::string all;
+    for (int i = 0; i < 256; ++i) all.push_back(static_cast<char>(i));
+    for (size_t n = 0; n <= all.size(); ++n) {
+        std::string encoded = huffman(all.substr(0, n));
+        std::string decoded;
+        assert(huffmanDecode(encoded.data(), encoded.size(), &decoded));
+        assert(decoded == all.substr(0, n));
+    }
+
+    // padding longer than 7 bits, or not a prefix of EOS
+    std::string decoded;
+    std::string bad = fromHex("f1e3 c2e5 f23a 6ba0 ab90 f4ff ff");
+    assert(!huffmanDecode(bad.data(), bad.size(), &decoded));
+    bad = fromHex("f1e3 c2e5 f23a 6ba0 ab90 f4fe");
+    assert(!huffmanDecode(bad.data(), bad.size(), &decoded));
+}
+
+void testEncoder() {
+    Encoder encoder;
+    polaris::Buffer buf;
+    // fully indexed :status, the name of content-length indexed,
+    // "5" is not shorter with Huffman
+    encoder.encode({{":status", "200"}, {"content-length", "5"}}, &buf);
+    assert(buf.retrieveAllAsString() == fromHex("88 0f0d 0135"));
+
+    // literal name and value, both shorter with Huffman
+    encoder.encode({{"custom-key", "custom-value"}}, &buf);
+    assert(buf.retrieveAllAsString() ==
+           fromHex("00 8825a8 49e9 5ba9 7d7f 8925 a849 e95b b8e8 b4bf"));
+
+    // decoded by a fresh decoder, nothing indexed
+    const HeaderList headers = {
+        {":status", "404"},
+        {":status", "302"},
+        {"content-type", "text/html; charset=utf-8"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"x-binary", std::string("\0\x01\xff\x7f", 4)},
+        {"x-long", std::string(300, 'a')},
+        {"x-empty", ""},
+    };
+    encoder.encode(headers, &buf);
+    std::string block = buf.retrieveAllAsString();
+    Decoder decoder;
+    HeaderList decoded;
+    assert(decoder.decode(block.data(), block.size(), &decoded) ==
+           DecodeResult::kOk);
+    assert(decoded == headers);
+}
+
+/// A large field indexed, then referenced by one byte each time
+void testHeaderListSize() {
+    // "x-bomb" with 4000 bytes of value, 4038 in the header list
+    const std::string indexed = fromHex("40 06") + "x-bomb" +
+                                fromHex("7f a11e") + std::string(4000, 'a');
+    const std::string reference = fromHex("be");
+
+    // 16 * 4038 fits in the default 64 KiB
+    std::string block = indexed;
+    for (int i = 0; i < 15; ++i) block += reference;
+    Decoder decoder;
+    HeaderList headers;
+    assert(decoder.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kOk);
+    assert(headers.size() == 16);
+    assert(headers[15] == HeaderField("x-bomb", std::string(4000, 'a')));
+
+    // one more does not, decoding stops right there
+    block = indexed;
+    for (int i = 0; i < 16; ++i) block += reference;
+    Decoder fresh;
+    headers.clear();
+    assert(fresh.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kTooLarge);
+    assert(headers.size() == 16);
+
+    // a 256 KiB block would have been 1 GiB
+    block = indexed + std::string(256 * 1024, '\xbe');
+    Decoder bombed;
+    headers.clear();
+    assert(bombed.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kTooLarge);
+
+    // an explicit limit, the static table counts too
+    Decoder small(4096, 100);
+    headers.clear();
+    block = fromHex("82 86");
+    assert(small.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kOk);
+    block = fromHex("82 86 84");
+    assert(small.decode(block.data(), block.size(), &headers) ==
+           DecodeResult::kTooLarge);
+}
+
+int main() {
+    testFieldRepresentations();
+    testRequests(false);
+    testRequests(true);
+    testResponses();
+    testHuffman();
+    testEncoder();
+    testHeaderListSize();
+    printf("HPack tests passed\n");
+}
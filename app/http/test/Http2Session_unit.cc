@@ -0,0 +1,608 @@
+#include <assert.h>
+#include <http/HPack.h>
+#include <http/Http2Session.h>
+#include <http/HttpResponse.h>
+#include <polaris/EventLoop.h>
+#include <polaris/TCPConnection.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::polaris;
+
+typedef Http2Session::FrameType FrameType;
+typedef Http2Session::ErrorCode ErrorCode;
+
+const uint8_t kEndStream = 0x1;
+const uint8_t kAck = 0x1;
+const uint8_t kEndHeaders = 0x4;
+
+struct Frame {
+    FrameType type;
+    uint8_t flags;
+    uint32_t streamId;
+    std::string payload;
+};
+
+uint32_t getUint32(const std::string& s, size_t offset) {
+    const auto* u = reinterpret_cast<const uint8_t*>(s.data() + offset);
+    return (static_cast<uint32_t>(u[0]) << 24) |
+           (static_cast<uint32_t>(u[1]) << 16) |
+           (static_cast<uint32_t>(u[2]) << 8) | u[3];
+}
+
+std::string uint32(uint32_t v) {
+    std::string s(4, '\0');
+    for (int i = 0; i < 4; ++i) s[i] = static_cast<char>(v >> (24 - 8 * i));
+    return s;
+}
+
+std::string frame(FrameType type, uint8_t flags, uint32_t streamId,
+                  const std::string& payload = std::string()) {
+    std::string s(3, '\0');
+    s[0] = static_cast<char>(payload.size() >> 16);
+    s[1] = static_cast<char>(payload.size() >> 8);
+    s[2] = static_cast<char>(payload.size());
+    s.push_back(static_cast<char>(type));
+    s.push_back(static_cast<char>(flags));
+    return s + uint32(streamId) + payload;
+}
+
+std::string settings(uint16_t id, uint32_t value) {
+    std::string payload;
+    payload.push_back(static_cast<char>(id >> 8));
+    payload.push_back(static_cast<char>(id));
+    return frame(FrameType::kSettings, 0, 0, payload + uint32(value));
+}
+
+std::string headerBlock(const std::string& path) {
+    polaris::Buffer buf;
+    hpack::Encoder().encode({{":method", "POST"},
+                             {":scheme", "http"},
+                             {":path", path},
+                             {":authority", "example.com"},
+                             {"x-request", "h2"}},
+                            &buf);
+    return buf.retrieveAllAsString();
+}
+
+/// Http2Session over one end of a socketpair, the test is the client at
+/// the other end.
+class Client {
+public:
+    explicit Client(EventLoop* loop) : loop_(loop) {
+        int fds[2];
+        int rc = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+        assert(rc == 0);
+        (void)rc;
+        fd_ = fds[1];
+        conn_ = std::make_shared<TCPConnection>(loop, "Http2Session_unit",
+                                                fds[0], InetAddress(),
+                                                InetAddress());
+        conn_->setConnectionCallback([](const TCPConnectionPtr&) {});
+        conn_->setCloseCallback([loop](const TCPConnectionPtr& conn) {
+            conn->connectDestroyed();
+            loop->quit();
+        });
+        conn_->connectEstablished();
+        session_.reset(new Http2Session(
+            conn_.get(), [this](const HttpRequest& req, HttpResponse* resp) {
+                requests_.push_back(req);
+                resp->setStatusCode(HttpResponse::HttpStatusCode::k200Ok);
+                resp->addHeader("X-Response", "h2");
+                resp->setBody(responseBody_.empty() ? req.path()
+                                                    : responseBody_);
+            }));
+    }
+
+    ~Client() {
+        // closed by the peer, the connection is then destroyed in the loop;
+        // unread data would reset it instead
+        receive();
+        ::close(fd_);
+        loop_->loop();
+    }
+
+    Http2Session& session() { return *session_; }
+    const std::vector<HttpRequest>& requests() const { return requests_; }
+    void setResponseBody(const std::string& body) { responseBody_ = body; }
+
+    /// @param ok what onMessage() returns, false on connection error;
+    /// the unconsumed bytes stay in input_
+    void send(const std::string& data, bool ok = true) {
+        input_.append(data);
+        bool result = session_->onMessage(&input_, Timestamp::now());
+        assert(result == ok);
+        (void)result;
+        (void)ok;
+    }
+
+    void sendPrefaceAndSettings(bool ok = true) {
+        send(std::string(Http2Session::kPreface, Http2Session::kPrefaceLength) +
+                 frame(FrameType::kSettings, 0, 0),
+             ok);
+    }
+
+    size_t pendingInput() const { return input_.readableBytes(); }
+    /// the server shut down its side, seen by receive()
+    bool shutdown() const { return shutdown_; }
+
+    /// frames received since the last call
+    std::vector<Frame> receive() {
+        char buf[65536];
+        ssize_t n;
+        while ((n = ::read(fd_, buf, sizeof buf)) > 0) output_.append(buf, n);
+        if (n == 0) shutdown_ = true;
+
+        std::vector<Frame> frames;
+        while (output_.size() >= Http2Session::kFrameHeaderLength) {
+            const auto* u = reinterpret_cast<const uint8_t*>(output_.data());
+            size_t len = (static_cast<size_t>(u[0]) << 16) |
+                         (static_cast<size_t>(u[1]) << 8) | u[2];
+            if (output_.size() < Http2Session::kFrameHeaderLength + len) break;
+            frames.push_back(Frame{static_cast<FrameType>(u[3]), u[4],
+                                   getUint32(output_, 5) & 0x7FFFFFFF,
+                                   output_.substr(9, len)});
+            output_.erase(0, Http2Session::kFrameHeaderLength + len);
+        }
+        return frames;
+    }
+
+    /// receive() expecting the SETTINGS of the server
+    void receiveSettings() {
+        std::vector<Frame> frames = receive();
+        assert(frames.size() >= 1);
+        assert(frames[0].type == FrameType::kSettings);
+        assert(frames[0].flags == 0 && frames[0].streamId == 0);
+        // SETTINGS_MAX_CONCURRENT_STREAMS and SETTINGS_MAX_HEADER_LIST_SIZE
+        assert(frames[0].payload ==
+               std::string("\0\x03", 2) +
+                   uint32(Http2Session::kMaxConcurrentStreams) +
+                   std::string("\0\x06", 2) +
+                   uint32(Http2Session::kMaxHeaderListSize));
+        // and the ACK of ours, if sent
+        for (size_t i = 1; i < frames.size(); ++i) {
+            assert(frames[i].type == FrameType::kSettings);
+            assert(frames[i].flags == kAck && frames[i].payload.empty());
+        }
+    }
+
+    hpack::HeaderList decode(const std::string& block) {
+        hpack::HeaderList headers;
+        hpack::DecodeResult result =
+            decoder_.decode(block.data(), block.size(), &headers);
+        assert(result == hpack::DecodeResult::kOk);
+        (void)result;
+        return headers;
+    }
+
+private:
+    EventLoop* loop_;
+    int fd_;
+    TCPConnectionPtr conn_;
+    std::unique_ptr<Http2Session> session_;
+    std::vector<HttpRequest> requests_;
+    std::string responseBody_;
+    polaris::Buffer input_;
+    std::string output_;
+    bool shutdown_ = false;
+    hpack::Decoder decoder_;
+};
+
+void assertGoAway(const std::vector<Frame>& frames, ErrorCode code) {
+    assert(!frames.empty());
+    const Frame& last = frames.back();
+    assert(last.type == FrameType::kGoAway && last.streamId == 0);
+    assert(getUint32(last.payload, 4) == static_cast<uint32_t>(code));
+    (void)last;
+    (void)code;
+}
+
+void assertNothingReceived(Client* client) {
+    std::vector<Frame> frames = client->receive();
+    assert(frames.empty());
+    (void)frames;
+}
+
+void testPreface(EventLoop* loop) {
+    {
+        Client client(loop);
+        client.session().start();
+        client.receiveSettings();
+
+        // a partial preface waits for more
+        std::string preface(Http2Session::kPreface,
+                            Http2Session::kPrefaceLength);
+        client.send(preface.substr(0, 10));
+        assert(client.pendingInput() == 10);
+        assertNothingReceived(&client);
+
+        client.send(preface.substr(10) + frame(FrameType::kSettings, 0, 0));
+        std::vector<Frame> frames = client.receive();
+        assert(frames.size() == 1);
+        assert(frames[0].type == FrameType::kSettings);
+        assert(frames[0].flags == kAck);
+
+        // PING is answered
+        client.send(frame(FrameType::kPing, 0, 0, "12345678"));
+        frames = client.receive();
+        assert(frames.size() == 1);
+        assert(frames[0].type == FrameType::kPing && frames[0].flags == kAck);
+        assert(frames[0].payload == "12345678");
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.receiveSettings();
+        client.send("GET / HTTP/1.1\r\n\r\n0123456789", false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+        // ignored from now on
+        client.sendPrefaceAndSettings(false);
+        assertNothingReceived(&client);
+    }
+    {
+        // the preface must be followed by SETTINGS
+        Client client(loop);
+        client.session().start();
+        client.receiveSettings();
+        std::string preface(Http2Session::kPreface,
+                            Http2Session::kPrefaceLength);
+        client.send(preface + frame(FrameType::kPing, 0, 0, "12345678"), false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+}
+
+void testSettings(EventLoop* loop) {
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+
+        // unknown settings are ignored, ACKed
+        client.send(settings(0x4242, 1));
+        std::vector<Frame> frames = client.receive();
+        assert(frames.size() == 1 && frames[0].flags == kAck);
+
+        // the ACK of ours
+        client.send(frame(FrameType::kSettings, kAck, 0));
+        assertNothingReceived(&client);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        // SETTINGS_ENABLE_PUSH must be 0 or 1
+        client.send(settings(0x2, 2), false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        // SETTINGS_INITIAL_WINDOW_SIZE over 2^31-1
+        client.send(settings(0x4, 0x80000000), false);
+        assertGoAway(client.receive(), ErrorCode::kFlowControlError);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        // SETTINGS on a stream, or not a multiple of 6 bytes
+        client.send(frame(FrameType::kSettings, 0, 1), false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(frame(FrameType::kSettings, 0, 0, "12345"), false);
+        assertGoAway(client.receive(), ErrorCode::kFrameSizeError);
+    }
+}
+
+void testContinuation(EventLoop* loop) {
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+
+        // the header block in three pieces
+        std::string block = headerBlock("/continued");
+        size_t third = block.size() / 3;
+        client.send(
+            frame(FrameType::kHeaders, kEndStream, 1, block.substr(0, third)) +
+            frame(FrameType::kContinuation, 0, 1, block.substr(third, third)));
+        assert(client.requests().empty());
+        client.send(frame(FrameType::kContinuation, kEndHeaders, 1,
+                          block.substr(2 * third)));
+
+        assert(client.requests().size() == 1);
+        const HttpRequest& req = client.requests()[0];
+        assert(req.method() == HttpRequest::Method::kPost);
+        assert(req.path() == "/continued");
+        assert(req.getHeader("Host") == "example.com");
+        assert(req.getHeader("X-Request") == "h2");
+        assert(req.getVersion() == HttpRequest::Version::kHttp20);
+
+        std::vector<Frame> frames = client.receive();
+        assert(frames.size() == 2);
+        assert(frames[0].type == FrameType::kHeaders);
+        assert(frames[0].flags == kEndHeaders && frames[0].streamId == 1);
+        assert(client.decode(frames[0].payload) ==
+               hpack::HeaderList({{":status", "200"},
+                                  {"x-response", "h2"},
+                                  {"content-length", "10"}}));
+        assert(frames[1].type == FrameType::kData);
+        assert(frames[1].flags == kEndStream && frames[1].streamId == 1);
+        assert(frames[1].payload == "/continued");
+    }
+    {
+        // nothing may come between HEADERS and CONTINUATION
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        std::string block = headerBlock("/");
+        std::string headers =
+            frame(FrameType::kHeaders, kEndStream, 1, block.substr(0, 4));
+        client.send(headers + frame(FrameType::kPing, 0, 0, "12345678"), false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+        assert(client.requests().empty());
+    }
+    {
+        // CONTINUATION of another stream
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        std::string block = headerBlock("/");
+        std::string headers =
+            frame(FrameType::kHeaders, kEndStream, 1, block.substr(0, 4));
+        client.send(
+            headers + frame(FrameType::kContinuation, kEndHeaders, 3,
+                            block.substr(4)),
+            false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+    {
+        // a field indexed once and referenced by one byte each time, the
+        // header list expands beyond kMaxHeaderListSize
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        std::string block = std::string("\x40\x06", 2) + "x-bomb" +
+                            std::string("\x7f\xa1\x1e", 3) +
+                            std::string(4000, 'a') + std::string(1000, '\xbe');
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 1,
+                          headerBlock("/") + block),
+                    false);
+        assertGoAway(client.receive(), ErrorCode::kEnhanceYourCalm);
+        assert(client.requests().empty());
+    }
+    {
+        // CONTINUATION without HEADERS
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(
+            frame(FrameType::kContinuation, kEndHeaders, 1, headerBlock("/")),
+            false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+}
+
+void testRequestBody(EventLoop* loop) {
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+
+        client.send(
+            frame(FrameType::kHeaders, kEndHeaders, 1, headerBlock("/body")) +
+            frame(FrameType::kData, 0, 1, "hello, ") +
+            frame(FrameType::kData, kEndStream, 1, "world"));
+        assert(client.requests().size() == 1);
+        assert(client.requests()[0].body() == "hello, world");
+    }
+    {
+        // reset beyond kMaxBodySize, the connection goes on
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+
+        client.send(
+            frame(FrameType::kHeaders, kEndHeaders, 1, headerBlock("/large")));
+        const std::string chunk(16384, 'x');
+        size_t sent = 0;
+        // the session opens both windows again as the data arrives
+        while (sent <= Http2Session::kMaxBodySize) {
+            client.send(frame(FrameType::kData, 0, 1, chunk));
+            sent += chunk.size();
+        }
+        assert(client.requests().empty());
+
+        std::vector<Frame> frames = client.receive();
+        assert(!frames.empty());
+        const Frame& last = frames.back();
+        assert(last.type == FrameType::kRstStream && last.streamId == 1);
+        assert(getUint32(last.payload, 0) ==
+               static_cast<uint32_t>(ErrorCode::kEnhanceYourCalm));
+        for (size_t i = 0; i + 1 < frames.size(); ++i) {
+            assert(frames[i].type == FrameType::kWindowUpdate);
+        }
+
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 3,
+                          headerBlock("/next")));
+        assert(client.requests().size() == 1);
+        assert(client.requests()[0].path() == "/next");
+        (void)last;
+    }
+}
+
+/// DATA frames of the response, and the total of their payloads
+size_t dataSent(const std::vector<Frame>& frames, bool* endStream) {
+    size_t total = 0;
+    for (const Frame& f : frames) {
+        if (f.type != FrameType::kData) continue;
+        assert(f.payload.size() <= 16384);
+        total += f.payload.size();
+        *endStream = f.flags & kEndStream;
+    }
+    return total;
+}
+
+void testWindowUpdate(EventLoop* loop) {
+    const size_t kBodySize = 100000;
+    {
+        Client client(loop);
+        client.setResponseBody(std::string(kBodySize, 'b'));
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 1,
+                          headerBlock("/window")));
+        bool endStream = false;
+        size_t sent = 0;
+        // up to the initial window
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == 65535);
+        assert(!endStream);
+
+        // the stream window alone is not enough
+        client.send(frame(FrameType::kWindowUpdate, 0, 1, uint32(kBodySize)));
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == 0);
+
+        client.send(frame(FrameType::kWindowUpdate, 0, 0, uint32(10000)));
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == 10000);
+        assert(!endStream);
+        client.send(frame(FrameType::kWindowUpdate, 0, 0, uint32(kBodySize)));
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == kBodySize - 65535 - 10000);
+        assert(endStream);
+
+        // on a closed stream, ignored
+        client.send(frame(FrameType::kWindowUpdate, 0, 1, uint32(1)));
+        assertNothingReceived(&client);
+    }
+    {
+        // SETTINGS_INITIAL_WINDOW_SIZE before the request
+        Client client(loop);
+        client.setResponseBody(std::string(kBodySize, 'b'));
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(settings(0x4, 1000));
+        client.receive();
+
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 1,
+                          headerBlock("/window")));
+        bool endStream = false;
+        size_t sent = dataSent(client.receive(), &endStream);
+        assert(sent == 1000);
+
+        // grows the open stream by the delta
+        client.send(settings(0x4, 3000));
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == 2000);
+        assert(!endStream);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(frame(FrameType::kWindowUpdate, 0, 0, uint32(0)), false);
+        assertGoAway(client.receive(), ErrorCode::kProtocolError);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(
+            frame(FrameType::kWindowUpdate, 0, 0, uint32(0x7FFFFFFF)), false);
+        assertGoAway(client.receive(), ErrorCode::kFlowControlError);
+    }
+    {
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(frame(FrameType::kWindowUpdate, 0, 0, "123"), false);
+        assertGoAway(client.receive(), ErrorCode::kFrameSizeError);
+    }
+}
+
+void testGoAway(EventLoop* loop) {
+    const std::string goAway =
+        frame(FrameType::kGoAway, 0, 0, uint32(0) + uint32(0));
+    {
+        // what is answered in the same read is sent before the shutdown
+        Client client(loop);
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 1,
+                          headerBlock("/last")) +
+                    goAway + frame(FrameType::kPing, 0, 0, "12345678"));
+
+        std::vector<Frame> frames = client.receive();
+        assert(frames.size() == 3);
+        assert(frames[0].type == FrameType::kHeaders);
+        assert(frames[1].type == FrameType::kData);
+        assert(frames[1].payload == "/last");
+        assert(frames[2].type == FrameType::kPing && frames[2].flags == kAck);
+        assert(client.shutdown());
+    }
+    {
+        // a response held by flow control is finished first
+        Client client(loop);
+        client.setResponseBody(std::string(70000, 'b'));
+        client.session().start();
+        client.sendPrefaceAndSettings();
+        client.receiveSettings();
+        client.send(frame(FrameType::kHeaders, kEndHeaders | kEndStream, 1,
+                          headerBlock("/window")) +
+                    goAway);
+        bool endStream = false;
+        size_t sent = dataSent(client.receive(), &endStream);
+        assert(sent == 65535 && !endStream);
+        assert(!client.shutdown());
+
+        client.send(frame(FrameType::kWindowUpdate, 0, 0, uint32(10000)) +
+                    frame(FrameType::kWindowUpdate, 0, 1, uint32(10000)));
+        sent = dataSent(client.receive(), &endStream);
+        assert(sent == 70000 - 65535 && endStream);
+        assert(client.shutdown());
+    }
+}
+
+int main() {
+    EventLoop loop;
+    testPreface(&loop);
+    testSettings(&loop);
+    testContinuation(&loop);
+    testRequestBody(&loop);
+    testWindowUpdate(&loop);
+    testGoAway(&loop);
+    printf("Http2Session tests passed\n");
+}
@@ -0,0 +1,137 @@
+#include <assert.h>
+#include <http/HttpCache.h>
+#include <http/HttpRequest.h>
+#include <stdio.h>
+
+#include <string>
+
+using namespace Lux;
+using namespace Lux::http;
+
+const Timestamp kStart(1700000000LL * Timestamp::kMicroSecondsPerSecond);
+
+HttpRequest request(const std::string& method, const std::string& path,
+                    const std::string& query = "") {
+    HttpRequest req;
+    req.setMethod(method.data(), method.data() + method.size());
+    req.setPath(path.data(), path.data() + path.size());
+    req.setQuery(query.data(), query.data() + query.size());
+    return req;
+}
+
+/// The cached bytes, empty if missed
+std::string get(HttpCache* cache, const HttpRequest& req, double at) {
+    HttpCache::Bytes bytes = cache->get(req, addTime(kStart, at));
+    return bytes ? *bytes : std::string();
+}
+
+void testCacheable() {
+    assert(HttpCache::cacheable(request("GET", "/")));
+    assert(HttpCache::cacheable(request("HEAD", "/")));
+    assert(!HttpCache::cacheable(request("POST", "/")));
+    assert(!HttpCache::cacheable(request("PUT", "/")));
+    assert(!HttpCache::cacheable(request("DELETE", "/")));
+}
+
+void testTtl() {
+    HttpCache cache(1024);
+    HttpRequest req = request("GET", "/ttl");
+    cache.put(req, {}, "response", 1.0, kStart);
+    assert(cache.size() == 8);
+
+    // the same bytes are shared by every hit
+    HttpCache::Bytes first = cache.get(req, addTime(kStart, 0.5));
+    assert(first && *first == "response");
+    assert(cache.get(req, addTime(kStart, 0.6)) == first);
+    // expired after ttl, and dropped
+    assert(get(&cache, req, 1.0) == "response");
+    assert(get(&cache, req, 1.5).empty());
+    assert(cache.size() == 0);
+    // the bytes of a hit outlive the entry
+    assert(*first == "response");
+
+    // a new put replaces the entry and its ttl
+    cache.put(req, {}, "old", 1.0, kStart);
+    cache.put(req, {}, "new!", 10.0, kStart);
+    assert(cache.size() == 4);
+    assert(get(&cache, req, 5.0) == "new!");
+}
+
+void testKeys() {
+    HttpCache cache(1024);
+    cache.put(request("GET", "/a", "?x=1"), {}, "a1", 10, kStart);
+    cache.put(request("GET", "/a", "?x=2"), {}, "a2", 10, kStart);
+    cache.put(request("HEAD", "/a", "?x=1"), {}, "head", 10, kStart);
+    assert(get(&cache, request("GET", "/a", "?x=1"), 1) == "a1");
+    assert(get(&cache, request("GET", "/a", "?x=2"), 1) == "a2");
+    assert(get(&cache, request("HEAD", "/a", "?x=1"), 1) == "head");
+    assert(get(&cache, request("GET", "/a"), 1).empty());
+    assert(get(&cache, request("GET", "/b", "?x=1"), 1).empty());
+}
+
+void testVary() {
+    HttpCache cache(1024);
+    const std::vector<string> vary = {"Accept-Encoding"};
+    HttpRequest gzip = request("GET", "/vary");
+    gzip.addHeader("Accept-Encoding", "gzip");
+    HttpRequest br = request("GET", "/vary");
+    br.addHeader("Accept-Encoding", "br");
+    HttpRequest none = request("GET", "/vary");
+
+    cache.put(gzip, vary, "gzip body", 10, kStart);
+    assert(get(&cache, gzip, 1) == "gzip body");
+    assert(get(&cache, br, 1).empty());
+    assert(get(&cache, none, 1).empty());
+
+    cache.put(br, vary, "br body", 10, kStart);
+    cache.put(none, vary, "identity", 10, kStart);
+    assert(get(&cache, gzip, 1) == "gzip body");
+    assert(get(&cache, br, 1) == "br body");
+    assert(get(&cache, none, 1) == "identity");
+    assert(cache.size() == 9 + 7 + 8);
+
+    // header names are case-insensitive
+    HttpRequest lower = request("GET", "/vary");
+    lower.addHeader("accept-encoding", "gzip");
+    assert(get(&cache, lower, 1) == "gzip body");
+
+    // Vary changed, the old variants are dropped
+    cache.put(gzip, {"Accept-Language"}, "by language", 10, kStart);
+    assert(cache.size() == 11);
+    assert(get(&cache, br, 1) == "by language");
+}
+
+void testCapacity() {
+    HttpCache cache(10);
+    cache.put(request("GET", "/1"), {}, "123456", 1.0, kStart);
+    // refused, the first one has not expired
+    cache.put(request("GET", "/2"), {}, "abcdef", 1.0, addTime(kStart, 0.5));
+    assert(cache.size() == 6);
+    assert(get(&cache, request("GET", "/2"), 0.5).empty());
+    assert(get(&cache, request("GET", "/1"), 0.5) == "123456");
+
+    // the first one is purged once expired
+    cache.put(request("GET", "/2"), {}, "abcdef", 1.0, addTime(kStart, 2.0));
+    assert(cache.size() == 6);
+    assert(get(&cache, request("GET", "/2"), 2.5) == "abcdef");
+    assert(get(&cache, request("GET", "/1"), 2.5).empty());
+
+    // larger than the whole cache
+    cache.put(request("GET", "/3"), {}, "01234567890", 1.0, kStart);
+    assert(get(&cache, request("GET", "/3"), 0).empty());
+    assert(cache.size() == 6);
+
+    // filled up exactly
+    cache.put(request("GET", "/4"), {}, "wxyz", 1.0, addTime(kStart, 2.0));
+    assert(cache.size() == 10);
+    assert(get(&cache, request("GET", "/4"), 2.5) == "wxyz");
+}
+
+int main() {
+    testCacheable();
+    testTtl();
+    testKeys();
+    testVary();
+    testCapacity();
+    printf("HttpCache tests passed\n");
+}
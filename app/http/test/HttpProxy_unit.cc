@@ -0,0 +1,267 @@
+#include <assert.h>
+#include <http/HttpProxy.h>
+#include <http/HttpRequest.h>
+#include <netinet/in.h>
+#include <polaris/EventLoop.h>
+#include <polaris/TCPConnection.h>
+#include <polaris/TCPServer.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::polaris;
+
+/// Responses of the upstream by request path, sent as they are.
+/// "/close" is delimited by closing the connection.
+const std::map<std::string, std::string> kResponses = {
+    {"/length",
+     "HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: keep-alive\r\n"
+     "Keep-Alive: timeout=5\r\nX-Up: 1\r\n\r\nhello"},
+    {"/chunked",
+     "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nConnection: X-Secret\r\n"
+     "X-Secret: 1\r\nX-Up: 1\r\n\r\n5\r\nhello\r\n6\r\n world\r\n0\r\n"
+     "X-Trailer: 1\r\n\r\n"},
+    {"/close", "HTTP/1.0 200 OK\r\nX-Up: 1\r\n\r\nclose-delimited"},
+    {"/continue",
+     "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n"
+     "\r\nok"},
+    {"/chunk-extension",
+     "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+     "5 ;name=value\r\nhello\r\n0\r\n\r\n"},
+
+    // malformed
+    {"/bad-status", "HTTP/1.1 2000 OK\r\nContent-Length: 0\r\n\r\n"},
+    {"/bad-length", "HTTP/1.1 200 OK\r\nContent-Length: abc\r\n\r\nabc"},
+    {"/signed-length", "HTTP/1.1 200 OK\r\nContent-Length: +3\r\n\r\nabc"},
+    {"/length-garbage",
+     "HTTP/1.1 200 OK\r\nContent-Length: 3 3\r\n\r\nabc"},
+    {"/length-overflow",
+     "HTTP/1.1 200 OK\r\nContent-Length: 18446744073709551616\r\n\r\nabc"},
+    {"/two-lengths",
+     "HTTP/1.1 200 OK\r\nContent-Length: 3\r\nContent-Length: 5\r\n\r\n"
+     "abcde"},
+    {"/length-and-chunked",
+     "HTTP/1.1 200 OK\r\nContent-Length: 3\r\n"
+     "Transfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n"},
+    {"/gzip-chunked",
+     "HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"
+     "3\r\nabc\r\n0\r\n\r\n"},
+    {"/obs-fold",
+     "HTTP/1.1 200 OK\r\nX-Up: 1\r\n continued\r\nContent-Length: 0\r\n"
+     "\r\n"},
+    {"/space-before-colon",
+     "HTTP/1.1 200 OK\r\nContent-Length : 3\r\n\r\nabc"},
+    {"/bad-chunk-size",
+     "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+     "5x\r\nhello\r\n0\r\n\r\n"},
+    {"/bad-chunk-end",
+     "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+     "3\r\nhello\r\n0\r\n\r\n"},
+};
+
+const char kBadGateway[] =
+    "HTTP/1.1 502 Bad Gateway\r\nContent-Length: 0\r\n\r\n";
+
+/// A free port on the loopback, for the upstream TCPServer
+uint16_t freePort() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof addr;
+    int rc = ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr);
+    rc |= ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    assert(rc == 0);
+    (void)rc;
+    ::close(fd);
+    return ntohs(addr.sin_port);
+}
+
+void onUpstreamMessage(const TCPConnectionPtr& conn, Buffer* buf, Timestamp) {
+    static const char kEnd[] = "\r\n\r\n";
+    while (true) {
+        const char* last = buf->peek() + buf->readableBytes();
+        const char* end = std::search(buf->peek(), last, kEnd, kEnd + 4);
+        if (end == last) return;
+
+        // "GET /path HTTP/1.1"
+        const char* path = std::find(buf->peek(), end, ' ') + 1;
+        std::string key(path, std::find(path, end, ' '));
+        buf->retrieve(static_cast<size_t>(end + 4 - buf->peek()));
+        auto it = kResponses.find(key);
+        assert(it != kResponses.end());
+        conn->send(it->second);
+        if (key == "/close") conn->shutdown();
+    }
+}
+
+struct Result {
+    std::string response;
+    bool keepAlive;
+};
+
+/// Forward a request over a socketpair, as HttpServer does.
+Result forward(EventLoop* loop, HttpProxy* proxy, const std::string& path,
+               HttpRequest::Version version, bool close) {
+    int fds[2];
+    int rc = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+    assert(rc == 0);
+    (void)rc;
+    auto conn = std::make_shared<TCPConnection>(
+        loop, "HttpProxy_unit", fds[0], InetAddress(), InetAddress());
+    conn->setConnectionCallback([](const TCPConnectionPtr&) {});
+    conn->setCloseCallback([loop](const TCPConnectionPtr& c) {
+        c->connectDestroyed();
+        loop->quit();
+    });
+    conn->connectEstablished();
+
+    HttpRequest req;
+    const char kGet[] = "GET";
+    req.setMethod(kGet, kGet + 3);
+    req.setPath(path.data(), path.data() + path.size());
+    req.setVersion(version);
+    req.addHeader("Host", "example.com");
+
+    Result result;
+    result.keepAlive = false;
+    bool done = false;
+    proxy->forward(conn, req, close,
+                   [&](const TCPConnectionPtr&, bool keepAlive) {
+                       result.keepAlive = keepAlive;
+                       done = true;
+                       loop->quit();
+                   });
+    loop->loop();
+    assert(done);
+
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fds[1], buf, sizeof buf)) > 0) {
+        result.response.append(buf, n);
+    }
+    // closed by the peer, the connection is then destroyed in the loop
+    ::close(fds[1]);
+    loop->loop();
+    return result;
+}
+
+void testFraming(EventLoop* loop, HttpProxy* proxy) {
+    const auto kHttp11 = HttpRequest::Version::kHttp11;
+    const auto kHttp10 = HttpRequest::Version::kHttp10;
+
+    // Content-Length, the hop-by-hop Keep-Alive of upstream is not relayed
+    Result r = forward(loop, proxy, "/length", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nX-Up: 1\r\nContent-Length: 5\r\n"
+           "Connection: keep-alive\r\n\r\nhello");
+    assert(r.keepAlive);
+    // the downstream connection is to be closed, whatever upstream says
+    r = forward(loop, proxy, "/length", kHttp11, true);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nX-Up: 1\r\nContent-Length: 5\r\n"
+           "Connection: close\r\n\r\nhello");
+    assert(!r.keepAlive);
+    r = forward(loop, proxy, "/length", kHttp10, false);
+    assert(r.response ==
+           "HTTP/1.0 200 OK\r\nX-Up: 1\r\nContent-Length: 5\r\n"
+           "Connection: keep-alive\r\n\r\nhello");
+    assert(r.keepAlive);
+
+    // chunked, with the headers named by Connection removed
+    r = forward(loop, proxy, "/chunked", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nX-Up: 1\r\nTransfer-Encoding: chunked\r\n"
+           "Connection: keep-alive\r\n\r\n5\r\nhello\r\n6\r\n world\r\n0\r\n"
+           "X-Trailer: 1\r\n\r\n");
+    assert(r.keepAlive);
+    // dechunked for HTTP/1.0, delimited by closing the connection
+    r = forward(loop, proxy, "/chunked", kHttp10, false);
+    assert(r.response ==
+           "HTTP/1.0 200 OK\r\nX-Up: 1\r\nConnection: close\r\n\r\n"
+           "hello world");
+    assert(!r.keepAlive);
+
+    // delimited by closing the upstream connection
+    r = forward(loop, proxy, "/close", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nX-Up: 1\r\nConnection: close\r\n\r\n"
+           "close-delimited");
+    assert(!r.keepAlive);
+
+    // interim responses, not to an HTTP/1.0 client
+    r = forward(loop, proxy, "/continue", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\n"
+           "Content-Length: 2\r\nConnection: keep-alive\r\n\r\nok");
+    r = forward(loop, proxy, "/continue", kHttp10, false);
+    assert(r.response ==
+           "HTTP/1.0 200 OK\r\nContent-Length: 2\r\n"
+           "Connection: keep-alive\r\n\r\nok");
+    assert(r.keepAlive);
+}
+
+/// The upstream connection is closed, nothing of the response is relayed
+/// but 502 if it has not started, the connection is closed otherwise.
+void testMalformed(EventLoop* loop, HttpProxy* proxy) {
+    const auto kHttp11 = HttpRequest::Version::kHttp11;
+
+    Result r = forward(loop, proxy, "/chunk-extension", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n"
+           "Connection: keep-alive\r\n\r\n5 ;name=value\r\nhello\r\n"
+           "0\r\n\r\n");
+    assert(r.keepAlive);
+
+    for (const char* path :
+         {"/bad-status", "/bad-length", "/signed-length", "/length-garbage",
+          "/length-overflow", "/two-lengths", "/length-and-chunked",
+          "/gzip-chunked", "/obs-fold", "/space-before-colon"}) {
+        r = forward(loop, proxy, path, kHttp11, false);
+        assert(r.response == kBadGateway);
+    }
+
+    // the head is relayed already
+    const std::string head =
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n"
+        "Connection: keep-alive\r\n\r\n";
+    r = forward(loop, proxy, "/bad-chunk-size", kHttp11, false);
+    assert(r.response == head);
+    assert(!r.keepAlive);
+    r = forward(loop, proxy, "/bad-chunk-end", kHttp11, false);
+    assert(r.response == head + "3\r\nhel");
+    assert(!r.keepAlive);
+
+    // and the next one is fine
+    r = forward(loop, proxy, "/length", kHttp11, false);
+    assert(r.response ==
+           "HTTP/1.1 200 OK\r\nX-Up: 1\r\nContent-Length: 5\r\n"
+           "Connection: keep-alive\r\n\r\nhello");
+}
+
+int main() {
+    EventLoop loop;
+    InetAddress upstreamAddr("127.0.0.1", freePort());
+    HttpProxy proxy(upstreamAddr, "proxy");
+    // one connection, reused by every request but after "/close"
+    proxy.setMaxConnections(1);
+    {
+        TCPServer upstream(&loop, upstreamAddr, "upstream");
+        upstream.setMessageCallback(onUpstreamMessage);
+        upstream.start();
+        testFraming(&loop, &proxy);
+        testMalformed(&loop, &proxy);
+    }
+    // the upstream connections are closed in the loop
+    loop.runAfter(0.1, [&loop] { loop.quit(); });
+    loop.loop();
+    printf("HttpProxy tests passed\n");
+}
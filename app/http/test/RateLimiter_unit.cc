@@ -0,0 +1,95 @@
+#include <assert.h>
+#include <http/RateLimiter.h>
+#include <stdio.h>
+
+#include <functional>
+#include <string>
+
+using namespace Lux;
+using namespace Lux::http;
+
+const Timestamp kStart(1700000000LL * Timestamp::kMicroSecondsPerSecond);
+
+Timestamp at(double seconds) { return addTime(kStart, seconds); }
+
+void testTokenBucket() {
+    // 2 tokens per second, 3 at most
+    TokenBucket bucket(2, 3, kStart);
+    assert(bucket.full(kStart));
+    // the burst
+    assert(bucket.consume(kStart));
+    assert(bucket.consume(kStart));
+    assert(bucket.consume(kStart));
+    assert(!bucket.consume(kStart));
+    assert(!bucket.full(kStart));
+
+    // refilled at the rate
+    assert(!bucket.consume(at(0.25)));
+    assert(bucket.consume(at(0.5)));
+    assert(!bucket.consume(at(0.5)));
+    assert(bucket.consume(at(1.0)));
+    assert(!bucket.full(at(2.0)));
+    assert(bucket.full(at(2.5)));
+
+    // never more than the burst
+    for (int i = 0; i < 3; ++i) assert(bucket.consume(at(100)));
+    assert(!bucket.consume(at(100)));
+
+    // time going backwards adds nothing
+    assert(!bucket.consume(at(50)));
+}
+
+/// Two keys in the same shard of RateLimiter, which has 16.
+void keysInOneShard(std::string* a, std::string* b) {
+    *a = "10.0.0.1";
+    size_t shard = std::hash<std::string>()(*a) % 16;
+    for (int i = 2;; ++i) {
+        *b = "10.0.0." + std::to_string(i);
+        if (std::hash<std::string>()(*b) % 16 == shard) return;
+    }
+}
+
+void testRateLimiter() {
+    {
+        // 1 per second, 2 at most
+        RateLimiter limiter(1, 2);
+        assert(limiter.allow("a", kStart));
+        assert(limiter.allow("a", kStart));
+        assert(!limiter.allow("a", kStart));
+        // keys are independent
+        assert(limiter.allow("b", kStart));
+        assert(limiter.allow("a", at(1.0)));
+        assert(!limiter.allow("a", at(1.5)));
+    }
+    {
+        // the burst is 1 at least
+        RateLimiter limiter(1, 0);
+        assert(limiter.allow("a", kStart));
+        assert(!limiter.allow("a", kStart));
+    }
+    {
+        // one bucket per shard
+        RateLimiter limiter(1, 2, 16);
+        std::string a, b;
+        keysInOneShard(&a, &b);
+        assert(limiter.allow(a, kStart));
+
+        // refused while the bucket of a is not full
+        assert(!limiter.allow(b, kStart));
+        assert(!limiter.allow(b, at(0.5)));
+        // a is full again and dropped
+        assert(limiter.allow(b, at(1.0)));
+        // so a is a new key now, refused while b is not full
+        assert(!limiter.allow(a, at(1.0)));
+        assert(limiter.allow(a, at(2.0)));
+        // a new bucket, with the whole burst
+        assert(limiter.allow(a, at(2.0)));
+        assert(!limiter.allow(a, at(2.0)));
+    }
+}
+
+int main() {
+    testTokenBucket();
+    testRateLimiter();
+    printf("RateLimiter tests passed\n");
+}
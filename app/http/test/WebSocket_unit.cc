@@ -0,0 +1,256 @@
+#include <assert.h>
+#include <http/WebSocket.h>
+#include <polaris/EventLoop.h>
+#include <polaris/TCPConnection.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <random>
+#include <string>
+
+using namespace Lux;
+using namespace Lux::http;
+using namespace Lux::http::websocket;
+using namespace Lux::polaris;
+
+const uint8_t kKey[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+std::string bytes(std::initializer_list<int> list) {
+    std::string s;
+    for (int b : list) s.push_back(static_cast<char>(b));
+    return s;
+}
+
+ParseResult parse(const std::string& data, FrameHeader* header) {
+    Buffer buf;
+    buf.append(data);
+    return parseFrameHeader(buf, header);
+}
+
+std::string encode(Opcode opcode, bool fin, const std::string& payload) {
+    Buffer buf;
+    encodeFrame(opcode, fin, payload.data(), payload.size(), &buf);
+    return buf.retrieveAllAsString();
+}
+
+/// a frame sent by a client, masked by kKey
+std::string clientFrame(Opcode opcode, const std::string& payload) {
+    std::string frame = encode(opcode, true, payload);
+    size_t headerLength = frame.size() - payload.size();
+    frame[1] = static_cast<char>(frame[1] | 0x80);
+    frame.insert(headerLength, reinterpret_cast<const char*>(kKey), 4);
+    unmask(&frame[headerLength + 4], payload.data(), payload.size(), kKey);
+    return frame;
+}
+
+/// RFC 6455 5.7 and the length encodings of 5.2
+void testParseFrameHeader() {
+    FrameHeader header;
+    // a single-frame unmasked text message
+    std::string frame = bytes({0x81, 0x05}) + "Hello";
+    assert(parse(frame, &header) == ParseResult::kComplete);
+    assert(header.fin && header.opcode == Opcode::kText && !header.masked);
+    assert(header.payloadLength == 5 && header.headerLength == 2);
+
+    // a single-frame masked text message
+    frame = bytes({0x81, 0x85, 0x37, 0xfa, 0x21, 0x3d, 0x7f, 0x9f, 0x4d, 0x51,
+                   0x58});
+    assert(parse(frame, &header) == ParseResult::kComplete);
+    assert(header.masked && header.headerLength == 6);
+    assert(memcmp(header.maskingKey, kKey, 4) == 0);
+    std::string payload(5, '\0');
+    unmask(&payload[0], frame.data() + 6, 5, header.maskingKey);
+    assert(payload == "Hello");
+    // every prefix of the header is incomplete
+    for (size_t n = 0; n < 6; ++n) {
+        assert(parse(frame.substr(0, n), &header) == ParseResult::kIncomplete);
+    }
+
+    // a fragmented unmasked text message
+    assert(parse(bytes({0x01, 0x03}) + "Hel", &header) ==
+           ParseResult::kComplete);
+    assert(!header.fin && header.opcode == Opcode::kText);
+    assert(parse(bytes({0x80, 0x02}) + "lo", &header) ==
+           ParseResult::kComplete);
+    assert(header.fin && header.opcode == Opcode::kContinuation);
+
+    // unmasked ping
+    assert(parse(bytes({0x89, 0x05}) + "Hello", &header) ==
+           ParseResult::kComplete);
+    assert(header.opcode == Opcode::kPing && header.payloadLength == 5);
+
+    // 256 bytes binary message, the payload is not needed
+    frame = bytes({0x82, 0x7E, 0x01, 0x00});
+    assert(parse(frame, &header) == ParseResult::kComplete);
+    assert(header.opcode == Opcode::kBinary);
+    assert(header.payloadLength == 256 && header.headerLength == 4);
+    assert(parse(frame.substr(0, 3), &header) == ParseResult::kIncomplete);
+
+    // 64KiB binary message, masked
+    frame = bytes({0x82, 0xFF, 0, 0, 0, 0, 0, 1, 0, 0, 1, 2, 3, 4});
+    assert(parse(frame, &header) == ParseResult::kComplete);
+    assert(header.payloadLength == 65536 && header.headerLength == 14);
+    for (size_t n = 2; n < frame.size(); ++n) {
+        assert(parse(frame.substr(0, n), &header) == ParseResult::kIncomplete);
+    }
+
+    // the most significant bit of a 64 bit length
+    frame = bytes({0x82, 0x7F, 0x80, 0, 0, 0, 0, 0, 0, 0});
+    assert(parse(frame, &header) == ParseResult::kError);
+    // RSV1, RSV2, RSV3 without an extension
+    for (int rsv : {0x40, 0x20, 0x10}) {
+        assert(parse(bytes({0x81 | rsv, 0x00}), &header) ==
+               ParseResult::kError);
+    }
+}
+
+void testEncodeFrame() {
+    assert(encode(Opcode::kText, true, "Hello") ==
+           bytes({0x81, 0x05}) + "Hello");
+    assert(encode(Opcode::kText, false, "Hel") == bytes({0x01, 0x03}) + "Hel");
+    assert(encode(Opcode::kContinuation, true, "lo") ==
+           bytes({0x80, 0x02}) + "lo");
+    assert(encode(Opcode::kPong, true, "") == bytes({0x8A, 0x00}));
+
+    // the boundaries of the 7, 16 and 64 bit lengths
+    struct {
+        size_t len;
+        std::string header;
+    } cases[] = {
+        {125, bytes({0x82, 0x7D})},
+        {126, bytes({0x82, 0x7E, 0x00, 0x7E})},
+        {256, bytes({0x82, 0x7E, 0x01, 0x00})},
+        {65535, bytes({0x82, 0x7E, 0xFF, 0xFF})},
+        {65536, bytes({0x82, 0x7F, 0, 0, 0, 0, 0, 1, 0, 0})},
+    };
+    for (const auto& c : cases) {
+        std::string payload(c.len, 'x');
+        std::string frame = encode(Opcode::kBinary, true, payload);
+        assert(frame == c.header + payload);
+
+        // and parsed back
+        FrameHeader header;
+        assert(parse(frame, &header) == ParseResult::kComplete);
+        assert(header.payloadLength == c.len);
+        assert(header.headerLength == c.header.size());
+    }
+}
+
+/// the wide loops against the definition, at all lengths and alignments
+void testUnmask() {
+    std::mt19937 random(1);
+    std::string src(300, '\0');
+    for (char& c : src) c = static_cast<char>(random());
+    const uint8_t key[4] = {0x01, 0x80, 0xFF, 0x5A};
+
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t len = 0; len + offset <= 160; ++len) {
+            const char* in = src.data() + offset;
+            std::string expected(len, '\0');
+            for (size_t i = 0; i < len; ++i) {
+                expected[i] = static_cast<char>(in[i] ^ key[i % 4]);
+            }
+
+            // a misaligned destination
+            std::string dst(len + 3, '\0');
+            unmask(&dst[3], in, len, key);
+            assert(dst.substr(3) == expected);
+
+            // in place
+            std::string inPlace(in, len);
+            unmask(&inPlace[0], inPlace.data(), len, key);
+            assert(inPlace == expected);
+
+            // twice is the identity
+            unmask(&inPlace[0], inPlace.data(), len, key);
+            assert(inPlace == std::string(in, len));
+        }
+    }
+}
+
+void testAcceptKey() {
+    // RFC 6455 1.3
+    assert(acceptKey("dGhlIHNhbXBsZSBub25jZQ==") ==
+           "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+/// The Close frame a WebSocket answers @c frame with, empty if none.
+std::string answerTo(EventLoop* loop, const std::string& frame) {
+    int fds[2];
+    int rc = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds);
+    assert(rc == 0);
+    (void)rc;
+    auto conn = std::make_shared<TCPConnection>(
+        loop, "WebSocket_unit", fds[0], InetAddress(), InetAddress());
+    conn->setConnectionCallback([](const TCPConnectionPtr&) {});
+    conn->setCloseCallback([loop](const TCPConnectionPtr& c) {
+        c->connectDestroyed();
+        loop->quit();
+    });
+    conn->connectEstablished();
+
+    auto webSocket = std::make_shared<WebSocket>(conn, HttpRequest());
+    Buffer input;
+    input.append(frame);
+    webSocket->onMessage(&input, Timestamp::now());
+    assert(!webSocket->connected());
+
+    std::string answer;
+    char buf[1024];
+    ssize_t n;
+    while ((n = ::read(fds[1], buf, sizeof buf)) > 0) answer.append(buf, n);
+
+    // closed by the peer, the connection is then destroyed in the loop
+    ::close(fds[1]);
+    loop->loop();
+    return answer;
+}
+
+std::string closePayload(int code, const std::string& reason = "") {
+    return bytes({code >> 8, code & 0xFF}) + reason;
+}
+
+/// The WebSocket answers a Close frame of @c payload with @c code.
+void expectClose(EventLoop* loop, const std::string& payload, int code) {
+    std::string answer = answerTo(loop, clientFrame(Opcode::kClose, payload));
+    assert(answer == encode(Opcode::kClose, true, closePayload(code)));
+    (void)answer;
+}
+
+void testClose(EventLoop* loop) {
+    // the status code is echoed
+    for (int code : {1000, 1001, 1002, 1003, 1007, 1008, 1009, 1010, 1011,
+                     3000, 4999}) {
+        expectClose(loop, closePayload(code), code);
+    }
+    expectClose(loop, closePayload(1000, "bye \xc3\xa9"), 1000);
+    // no status code
+    expectClose(loop, "", 1000);
+
+    // never sent, or not defined
+    for (int code : {0, 999, 1004, 1005, 1006, 1015, 1016, 2000, 2999, 5000,
+                     65535}) {
+        expectClose(loop, closePayload(code), 1002);
+    }
+    // a one byte payload
+    expectClose(loop, bytes({0x03}), 1002);
+
+    // the reason must be UTF-8, overlong forms and surrogates are not
+    for (const char* reason :
+         {"\xff", "bye \xc3", "\xc0\xaf", "\xed\xa0\x80"}) {
+        expectClose(loop, closePayload(1000, reason), 1007);
+    }
+}
+
+int main() {
+    testParseFrameHeader();
+    testEncodeFrame();
+    testUnmask();
+    testAcceptKey();
+
+    EventLoop loop;
+    testClose(&loop);
+    printf("WebSocket tests passed\n");
+}
@@ -0,0 +1,133 @@
+/**
+ * @file LogDecoder.cc
+ * @brief Formats log files written by AsyncLogger with
+ * AsyncLogger::RecordFormat::kBinary
+ *
+ * usage: logDecoder [-j | -l] file...
+ *  Files of the same process are given in order, a site is defined only in
+ *  the file where it is logged first.
+ *  -j and -l format the records as JSON or logfmt, see Logger::RecordStyle
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/LogRecord.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+
+using namespace Lux;
+
+namespace {
+/// A decoded site and the strings it refers to
+struct DecodedSite {
+    detail::SiteRecord record;
+    std::unique_ptr<LogSite> site;
+};
+
+std::map<uint32_t, DecodedSite> g_sites;
+
+/// @return bytes of the complete records in [data, data + len)
+size_t decode(const char* data, size_t len, LogStream* stream) {
+    const char* p = data;
+    const char* end = data + len;
+    while (static_cast<size_t>(end - p) >= sizeof(detail::RecordHeader)) {
+        detail::RecordHeader header;
+        ::memcpy(&header, p, sizeof header);
+        if (header.length < sizeof header) {
+            fprintf(stderr, "malformed record at %zu\n",
+                    static_cast<size_t>(p - data));
+            return len;
+        }
+        if (static_cast<size_t>(end - p) < header.length) break;
+
+        switch (header.kind) {
+            case detail::RecordKind::kText:
+                fwrite(p + sizeof header, 1, header.length - sizeof header,
+                       stdout);
+                break;
+            case detail::RecordKind::kSite: {
+                DecodedSite decoded;
+                if (!detail::decodeSite(p, header.length, &decoded.record)) {
+                    fprintf(stderr, "malformed site at %zu\n",
+                            static_cast<size_t>(p - data));
+                    break;
+                }
+                DecodedSite& site = g_sites[decoded.record.id];
+                site.record = std::move(decoded.record);
+                site.site.reset(new LogSite(
+                    site.record.id, site.record.format.c_str(),
+                    Logger::SourceFile(site.record.file.c_str()),
+                    site.record.line, site.record.level,
+                    site.record.func.c_str()));
+                break;
+            }
+            case detail::RecordKind::kEvent: {
+                if (header.length <
+                    sizeof header + sizeof(detail::EventHeader)) {
+                    break;
+                }
+                auto it = g_sites.find(detail::eventSite(p));
+                if (it == g_sites.end()) {
+                    printf("(unknown site %u)\n", detail::eventSite(p));
+                    break;
+                }
+                stream->resetBuffer();
+                detail::formatEvent(*it->second.site, p, header.length,
+                                    stream);
+                fwrite(stream->buffer().data(), 1,
+                       static_cast<size_t>(stream->buffer().length()), stdout);
+                break;
+            }
+        }
+        p += header.length;
+    }
+    return static_cast<size_t>(p - data);
+}
+
+bool decodeFile(const char* filename) {
+    FILE* fp = ::fopen(filename, "rb");
+    if (!fp) {
+        perror(filename);
+        return false;
+    }
+
+    LogStream stream;
+    string buffer;
+    char chunk[64 * 1024];
+    size_t n;
+    while ((n = ::fread(chunk, 1, sizeof chunk, fp)) > 0) {
+        buffer.append(chunk, n);
+        buffer.erase(0, decode(buffer.data(), buffer.size(), &stream));
+    }
+    if (!buffer.empty()) {
+        fprintf(stderr, "%s: %zu bytes of a partial record\n", filename,
+                buffer.size());
+    }
+    ::fclose(fp);
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "-j") == 0) {
+        Logger::setRecordStyle(Logger::RecordStyle::kJson);
+        ++first;
+    } else if (argc > 1 && strcmp(argv[1], "-l") == 0) {
+        Logger::setRecordStyle(Logger::RecordStyle::kLogfmt);
+        ++first;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "usage: %s [-j | -l] file...\n", argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (int i = first; i < argc; ++i) {
+        ok = decodeFile(argv[i]) && ok;
+    }
+    return ok ? 0 : 1;
+}
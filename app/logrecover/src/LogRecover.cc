@@ -0,0 +1,160 @@
+/**
+ * @file LogRecover.cc
+ * @brief Writes the buffers left in a crashed process's buffer file (see
+ * AsyncLogger::setCrashRecovery()) to stdout, in the order of their first
+ * messages
+ *
+ * usage: logRecover file.buffers... > recovered.log
+ *  The buffers not yet written to the log file are recovered, the log file
+ *  may end with a part of the first one if the process crashed while writing.
+ *  If the logger kept records (AsyncLogger::RecordFormat kDeferred or
+ *  kBinary), the output is records preceded by the definitions of their
+ *  sites, decode it on its own: logDecoder recovered.log
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/LogRecord.h>
+#include <LuxLog/MappedBuffers.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Lux;
+
+namespace {
+struct Recovered {
+    int64_t firstTime;
+    const char* data;
+    size_t len;
+};
+
+/// @return bytes of the complete records in [data, data + len)
+size_t completeRecords(const char* data, size_t len) {
+    const char* p = data;
+    const char* end = data + len;
+    while (static_cast<size_t>(end - p) >= sizeof(detail::RecordHeader)) {
+        detail::RecordHeader header;
+        ::memcpy(&header, p, sizeof header);
+        if (header.length < sizeof header ||
+            static_cast<size_t>(end - p) < header.length) {
+            break;
+        }
+        p += header.length;
+    }
+    return static_cast<size_t>(p - data);
+}
+
+bool recoverFile(const char* filename) {
+    int fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(filename);
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < MappedBuffers::kHeaderSize) {
+        fprintf(stderr, "%s: not a buffer file\n", filename);
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        perror(filename);
+        return false;
+    }
+    const char* base = static_cast<const char*>(p);
+
+    MappedBuffers::FileHeader header;
+    ::memcpy(&header, base, sizeof header);
+    if (::memcmp(header.magic, MappedBuffers::kMagic, sizeof header.magic) !=
+            0 ||
+        header.version != MappedBuffers::kVersion ||
+        header.slotSize <= MappedBuffers::kSlotHeaderSize ||
+        header.numSlots > (size - MappedBuffers::kHeaderSize) /
+                              header.slotSize) {
+        fprintf(stderr, "%s: not a buffer file\n", filename);
+        ::munmap(p, size);
+        return false;
+    }
+
+    // the sites first, so the records decode without the log files
+    size_t siteBytes = 0;
+    if (header.framed &&
+        header.siteAreaSize > MappedBuffers::kSlotHeaderSize &&
+        header.siteAreaOffset <= size &&
+        header.siteAreaSize <= size - header.siteAreaOffset) {
+        const char* area = base + header.siteAreaOffset;
+        const auto* siteArea =
+            reinterpret_cast<const MappedBuffers::SiteArea*>(area);
+        uint64_t len = std::min<uint64_t>(
+            siteArea->length.load(std::memory_order_relaxed),
+            header.siteAreaSize - MappedBuffers::kSlotHeaderSize);
+        siteBytes = completeRecords(area + MappedBuffers::kSlotHeaderSize,
+                                    static_cast<size_t>(len));
+        fwrite(area + MappedBuffers::kSlotHeaderSize, 1, siteBytes, stdout);
+    }
+
+    std::vector<Recovered> buffers;
+    for (uint64_t i = 0; i < header.numSlots; ++i) {
+        const char* slot =
+            base + MappedBuffers::kHeaderSize + i * header.slotSize;
+        const auto* s = reinterpret_cast<const MappedBuffers::Slot*>(slot);
+        int64_t len = s->length.load(std::memory_order_relaxed);
+        if (len <= 0) continue;
+        if (s->dataOffset < MappedBuffers::kSlotHeaderSize ||
+            s->dataOffset + static_cast<uint64_t>(len) > header.slotSize) {
+            fprintf(stderr, "%s: slot %lu is malformed\n", filename,
+                    static_cast<unsigned long>(i));
+            continue;
+        }
+        Recovered buffer;
+        buffer.firstTime = s->firstTime;
+        buffer.data = slot + s->dataOffset;
+        buffer.len = static_cast<size_t>(len);
+        if (header.framed) {
+            buffer.len = completeRecords(buffer.data, buffer.len);
+        }
+        buffers.push_back(buffer);
+    }
+
+    // the same order as AsyncLogger writes them
+    std::stable_sort(buffers.begin(), buffers.end(),
+                     [](const Recovered& lhs, const Recovered& rhs) {
+                         return lhs.firstTime < rhs.firstTime;
+                     });
+    size_t bytes = 0;
+    for (const Recovered& buffer : buffers) {
+        fwrite(buffer.data, 1, buffer.len, stdout);
+        bytes += buffer.len;
+    }
+    fprintf(stderr, "%s: %zu buffers, %zu bytes recovered%s\n", filename,
+            buffers.size(), bytes + siteBytes,
+            header.framed ? ", records for logDecoder" : "");
+    ::munmap(p, size);
+    return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s file.buffers... > recovered.log\n",
+                argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (int i = 1; i < argc; ++i) {
+        ok = recoverFile(argv[i]) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file Coroutine.h
+ * @brief C++20 coroutines on top of the callbacks of EventLoop,
+ * TCPConnection and TCPClient
+ *
+ *  Task<T> is a lazy coroutine, it starts when awaited, spawn() starts a
+ *  Task<void> that nobody awaits. The awaitables resume the coroutine in
+ *  the callback of the EventLoop that owns the connection or timer, so a
+ *  coroutine started in a loop thread stays in that thread:
+ *
+ *      Task<void> session(TCPConnectionPtr conn) {
+ *          AsyncConnection stream(conn);
+ *          string header = co_await stream.read(4);
+ *          co_await sleep(conn->getLoop(), 0.1);
+ *          bool ok = co_await stream.write(header);
+ *      }
+ *      // in the connection callback
+ *      spawn(session(conn));
+ *
+ *  Empty when not compiled as C++20, the library itself is C++17.
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <polaris/EventLoop.h>
+#include <polaris/TCPClient.h>
+#include <polaris/TCPConnection.h>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#define LUX_HAS_COROUTINES 1
+
+namespace Lux {
+namespace polaris {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+struct TaskPromiseBase {
+    /// resumed when the task is done, by symmetric transfer
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> h) noexcept {
+            std::coroutine_handle<> next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+    }
+    T result() {
+        if (exception) std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void result() {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+}  // namespace detail
+
+/// @brief A lazy coroutine returning @c T, owns its frame. co_await runs it
+/// and resumes the awaiting coroutine when it is done, exceptions are
+/// rethrown there.
+template <typename T>
+class Task {
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle h) : handle_(h) {}
+    Task(Task&& rhs) noexcept : handle_(std::exchange(rhs.handle_, {})) {}
+    Task& operator=(Task&& rhs) noexcept {
+        if (this != &rhs) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(rhs.handle_, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+    T await_resume() { return handle_.promise().result(); }
+
+private:
+    Handle handle_;
+};
+
+namespace detail {
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(
+        std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/// runs at once and frees itself when done
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        /// like an exception escaping a thread function
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+inline Detached runDetached(Task<void> task) { co_await task; }
+}  // namespace detail
+
+/// @brief Starts @c task in the calling thread, it runs until its first
+/// suspension and frees itself when done. An exception escaping it
+/// terminates the process.
+inline void spawn(Task<void> task) { detail::runDetached(std::move(task)); }
+
+/// @brief co_await sleep(loop, seconds), resumed by a timer of @c loop.
+class SleepAwaiter {
+    EventLoop* loop_;
+    double seconds_;
+
+public:
+    SleepAwaiter(EventLoop* loop, double seconds)
+        : loop_(loop), seconds_(seconds) {}
+
+    bool await_ready() const noexcept { return seconds_ <= 0; }
+    void await_suspend(std::coroutine_handle<> h) {
+        loop_->runAfter(seconds_, [h] { h.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+inline SleepAwaiter sleep(EventLoop* loop, double seconds) {
+    return SleepAwaiter(loop, seconds);
+}
+
+/// @brief Reads and writes a TCPConnection with co_await. Takes over the
+/// message and write complete callbacks of the connection, wraps its
+/// connection callback to see the close. Created and used in the loop
+/// thread of the connection, one reader and one writer at a time.
+class AsyncConnection {
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    /// shared with the callbacks, which may outlive this object
+    struct State {
+        std::coroutine_handle<> reader;
+        /// bytes the reader waits for, 0 for any
+        size_t want = 0;
+        std::coroutine_handle<> writer;
+        bool closed = false;
+    };
+
+    TCPConnectionPtr conn_;
+    std::shared_ptr<State> state_;
+
+    bool readable(size_t want) const {
+        size_t n = conn_->inputBuffer()->readableBytes();
+        return state_->closed || (want == 0 ? n > 0 : n >= want);
+    }
+
+    static void resume(std::coroutine_handle<>& h) {
+        if (h) std::exchange(h, {}).resume();
+    }
+
+public:
+    explicit AsyncConnection(const TCPConnectionPtr& conn)
+        : conn_(conn), state_(std::make_shared<State>()) {
+        conn_->getLoop()->assertInLoopThread();
+        state_->closed = !conn_->connected();
+        std::shared_ptr<State> state = state_;
+        conn_->setMessageCallback(
+            [state](const TCPConnectionPtr&, Buffer* buf, Timestamp) {
+                size_t n = buf->readableBytes();
+                if (state->want == 0 ? n > 0 : n >= state->want) {
+                    resume(state->reader);
+                }
+            });
+        conn_->setWriteCompleteCallback(
+            [state](const TCPConnectionPtr&) { resume(state->writer); });
+        ConnectionCallback previous = conn_->connectionCallback();
+        conn_->setConnectionCallback(
+            [state, previous](const TCPConnectionPtr& c) {
+                if (previous) previous(c);
+                if (!c->connected()) {
+                    state->closed = true;
+                    resume(state->reader);
+                    resume(state->writer);
+                }
+            });
+    }
+
+    const TCPConnectionPtr& connection() const { return conn_; }
+
+    class ReadAwaiter {
+        AsyncConnection* stream_;
+        size_t want_;
+
+    public:
+        ReadAwaiter(AsyncConnection* stream, size_t want)
+            : stream_(stream), want_(want) {}
+
+        bool await_ready() const { return stream_->readable(want_); }
+        void await_suspend(std::coroutine_handle<> h) {
+            stream_->state_->reader = h;
+            stream_->state_->want = want_;
+        }
+        /// @c want bytes, fewer if the peer closed, all there is if 0
+        string await_resume() {
+            Buffer* buf = stream_->conn_->inputBuffer();
+            size_t n = buf->readableBytes();
+            if (want_ > 0 && want_ < n) n = want_;
+            return buf->retrieveAsString(n);
+        }
+    };
+
+    class WriteAwaiter {
+        AsyncConnection* stream_;
+        StringPiece data_;
+
+    public:
+        WriteAwaiter(AsyncConnection* stream, StringPiece data)
+            : stream_(stream), data_(data) {}
+
+        /// sends at once, suspends only if the kernel did not take it all
+        bool await_ready() {
+            if (stream_->state_->closed) return true;
+            stream_->conn_->send(data_);
+            return stream_->conn_->outputBuffer()->readableBytes() == 0;
+        }
+        void await_suspend(std::coroutine_handle<> h) {
+            stream_->state_->writer = h;
+        }
+        /// false if the connection is closed
+        bool await_resume() const { return !stream_->state_->closed; }
+    };
+
+    /// @brief co_await read(n), a string of n bytes, shorter if closed.
+    ReadAwaiter read(size_t n) { return ReadAwaiter(this, n); }
+    /// @brief co_await readSome(), all the data received, empty if closed.
+    ReadAwaiter readSome() { return ReadAwaiter(this, 0); }
+    /// @brief co_await write(data), resumed when written to the kernel.
+    /// @c data is copied before suspending.
+    WriteAwaiter write(StringPiece data) { return WriteAwaiter(this, data); }
+};
+
+/// @brief co_await connect(client), the connection once it is up. Replaces
+/// the connection callback of @c client, retries as the Connector does.
+class ConnectAwaiter {
+    struct State {
+        std::coroutine_handle<> waiter;
+        TCPConnectionPtr conn;
+    };
+
+    TCPClient* client_;
+    std::shared_ptr<State> state_;
+
+public:
+    explicit ConnectAwaiter(TCPClient* client)
+        : client_(client), state_(std::make_shared<State>()) {}
+
+    bool await_ready() {
+        state_->conn = client_->connection();
+        return state_->conn && state_->conn->connected();
+    }
+    void await_suspend(std::coroutine_handle<> h) {
+        state_->waiter = h;
+        std::shared_ptr<State> state = state_;
+        client_->setConnectionCallback([state](const TCPConnectionPtr& conn) {
+            if (conn->connected() && state->waiter) {
+                state->conn = conn;
+                std::exchange(state->waiter, {}).resume();
+            }
+        });
+        client_->connect();
+    }
+    /// moved out, the callback left in the connection must not keep it
+    TCPConnectionPtr await_resume() { return std::move(state_->conn); }
+};
+
+inline ConnectAwaiter connect(TCPClient* client) {
+    return ConnectAwaiter(client);
+}
+
+}  // namespace polaris
+}  // namespace Lux
+
+#endif  // __cpp_impl_coroutine
@@ -7,9 +7,10 @@
 
 #pragma once
 
+#include <LuxUtils/AdaptiveMutex.h>
 #include <LuxUtils/Any.h>
 #include <LuxUtils/CurrentThread.h>
-#include <LuxUtils/Mutex.h>
+#include <LuxUtils/MonoTime.h>
 #include <polaris/Callbacks.h>
 #include <polaris/TimerId.h>
 
@@ -46,6 +47,8 @@ private:
     int64_t iteration_;
     const pid_t threadId_;
     Timestamp pollReturnTime_;
+    /// monotonic time when poll returns, read once per iteration
+    MonoTime cachedNow_;
 
     // poller
     std::unique_ptr<Poller> poller_;
@@ -60,7 +63,8 @@ private:
     ChannelList activeChannels_;
     Channel* currentActiveChannel_;
 
-    mutable MutexLock mutex_;
+    /// held only to push or swap the vector, spins before sleeping
+    mutable AdaptiveMutex mutex_;
     std::vector<Functor> pendingFunctors_ GUARDED_BY(mutex_);
 
 private:
@@ -71,6 +75,8 @@ private:
 
     // DEBUG
     void printActiveChannels() const;
+    /// cachedNow_ inside an iteration, else the clock
+    MonoTime timerNow() const;
 
 public:
     EventLoop();
@@ -88,6 +94,11 @@ public:
     /// Time when poll returns, usually means data arrival.
     Timestamp pollReturnTime() const { return pollReturnTime_; }
 
+    /// Monotonic time when poll returned in this iteration, for the loop
+    /// thread. Callbacks of one iteration share it instead of reading the
+    /// clock, it lags behind by the time they have run.
+    MonoTime cachedNow() const { return cachedNow_; }
+
     int64_t iteration() const { return iteration_; }
 
     /// Runs callback immediately in the loop thread.
@@ -106,8 +117,13 @@ public:
 
     /// Runs callback at 'time'.
     /// Safe to call from other threads.
+    TimerId runAt(MonoTime time, TimerCallback cb);
+    /// Runs callback at wall clock 'time', converted to the monotonic clock
+    /// now, later changes of the wall clock do not move the timer.
+    /// Safe to call from other threads.
     TimerId runAt(Timestamp time, TimerCallback cb);
-    /// Runs callback after @c delay seconds.
+    /// Runs callback after @c delay seconds, counted from cachedNow() when
+    /// called in a callback of the loop.
     /// Safe to call from other threads.
     TimerId runAfter(double delay, TimerCallback cb);
     /// Runs callback every @c interval seconds.
@@ -0,0 +1,72 @@
+/**
+ * @file FileWatcher.h
+ * @brief 用 inotify 监视文件的修改，事件作为 Channel 由 EventLoop 分发,
+ * 回调在 loop 线程中执行，用于配置文件的热加载
+ *
+ * @author Lux
+ */
+
+#pragma once
+
+#include <LuxUtils/Types.h>
+#include <polaris/Channel.h>
+
+#include <functional>
+#include <map>
+
+namespace Lux {
+namespace polaris {
+
+/// @brief Forward Declare
+class EventLoop;
+
+///
+/// Calls back when a watched file is rewritten or replaced.
+///
+/// The directory of the file is watched rather than the file itself, so a
+/// new version moved into place by rename(2), which is what editors and
+/// config deployers do, is seen as well as one written in place
+/// (IN_CLOSE_WRITE). Events of one wakeup are merged, a file is called back
+/// at most once per poll.
+///
+/// Not thread safe, all methods must be called in the loop thread.
+///
+class FileWatcher {
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(FileWatcher&) = delete;
+
+public:
+    /// @param path as given to watch()
+    using Callback = std::function<void(const string& path)>;
+
+private:
+    struct Directory {
+        string path;
+        /// file name in the directory -> (path, callback)
+        std::map<string, std::pair<string, Callback>> files;
+    };
+
+    EventLoop* loop_;
+    const int inotifyfd_;
+    Channel inotifyChannel_;
+    /// watch descriptor -> directory
+    std::map<int, Directory> directories_;
+
+private:
+    // called when inotify fd is readable
+    void handleRead();
+
+public:
+    explicit FileWatcher(EventLoop* loop);
+    ~FileWatcher();
+
+    ///
+    /// Watches @c path, replacing the callback if it is watched already.
+    ///
+    /// @return false if the directory of @c path can not be watched
+    bool watch(const string& path, Callback cb);
+
+    void unwatch(const string& path);
+};
+}  // namespace polaris
+}  // namespace Lux
@@ -13,13 +13,14 @@
 
 #pragma once
 
-#include <LuxUtils/Any.h>
+#include <LuxUtils/InlineAny.h>
 #include <LuxUtils/StringPiece.h>
 #include <polaris/Buffer.h>
 #include <polaris/Callbacks.h>
 #include <polaris/InetAddress.h>
 
 #include <memory>
+#include <utility>
 
 // struct tcp_info is in <netinet/tcp.h>
 struct tcp_info;
@@ -39,6 +40,11 @@ class TCPConnection : public std::enable_shared_from_this<TCPConnection> {
     TCPConnection(const TCPConnection&) = delete;
     TCPConnection operator=(TCPConnection&) = delete;
 
+public:
+    /// room for the HttpContext of HttpServer
+    static const size_t kContextSize = 256;
+    typedef Lux::InlineAny<kContextSize> Context;
+
 private:
     enum class StateE {
         kDisconnected,
@@ -72,7 +78,7 @@ private:
     size_t highWaterMark_;
     Buffer inputBuffer_;
     Buffer outputBuffer_;  // FIXME: use list<Buffer> as output buffer.
-    Lux::any context_;
+    Context context_;
     // FIXME: creationTime_, lastReceiveTime_
     //        bytesReceived_, bytesSent_
 
@@ -137,16 +143,26 @@ public:
         return reading_;
     };  // NOT thread safe, may race with start/stopReadInLoop
 
-    inline void setContext(const Lux::any& context) { context_ = context; }
+    /// @brief Any copyable value, stored in the connection without heap
+    /// allocation if it fits in kContextSize bytes.
+    template <typename T>
+    inline void setContext(T&& context) {
+        context_ = std::forward<T>(context);
+    }
 
-    inline const Lux::any& getContext() const { return context_; }
+    inline const Context& getContext() const { return context_; }
 
-    inline Lux::any* getMutableContext() { return &context_; }
+    inline Context* getMutableContext() { return &context_; }
 
     inline void setConnectionCallback(const ConnectionCallback& cb) {
         connectionCallback_ = cb;
     }
 
+    /// for wrapping the callback, see AsyncConnection
+    inline const ConnectionCallback& connectionCallback() const {
+        return connectionCallback_;
+    }
+
     inline void setMessageCallback(const MessageCallback& cb) {
         messageCallback_ = cb;
     }
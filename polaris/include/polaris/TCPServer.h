@@ -8,6 +8,7 @@
 #pragma once
 
 #include <LuxUtils/Atomic.h>
+#include <LuxUtils/Config.h>
 #include <polaris/TCPConnection.h>
 
 #include <map>
@@ -29,6 +30,17 @@ public:
     using ThreadInitCallback = std::function<void(EventLoop*)>;
     enum class Option { kNoReusePort, kReusePort };
 
+    /// Settings that can be published while the server runs, see
+    /// setConfig().
+    struct Tunables {
+        /// I/O threads, read by start() only; -1 keeps setThreadNum()
+        int numThreads = -1;
+        /// TCP_NODELAY of new connections
+        bool tcpNoDelay = false;
+        /// new connections are closed beyond it, 0 for no limit
+        int maxConnections = 0;
+    };
+
 private:
     using ConnectionMap = std::map<std::string, TCPConnectionPtr>;
 
@@ -51,6 +63,8 @@ private:
     // always in loop thread
     int nextConnId_;
     ConnectionMap connections_;
+    // read in loop thread
+    std::unique_ptr<Config<Tunables>::Reader> config_;
 
 private:
     /// Not thread safe, but in loop
@@ -82,6 +96,11 @@ public:
     /// assigned on a round-robin basis.
     void setThreadNum(int numThreads);
 
+    /// Reads the Tunables from @c config, which must outlive the server.
+    /// Later publish() calls apply to the connections accepted after them,
+    /// without locking. Must be called before start().
+    void setConfig(const Config<Tunables>& config);
+
     inline void setThreadInitCallback(const ThreadInitCallback& cb) {
         threadInitCallback_ = cb;
     }
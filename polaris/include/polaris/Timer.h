@@ -8,7 +8,7 @@
 #pragma once
 
 #include <LuxUtils/Atomic.h>
-#include <LuxUtils/Timestamp.h>
+#include <LuxUtils/MonoTime.h>
 #include <polaris/Callbacks.h>
 
 namespace Lux {
@@ -20,26 +20,29 @@ class Timer {
     Timer& operator=(Timer&) = delete;
 
 public:
-    Timer(TimerCallback cb, Timestamp when, double interval)
+    Timer(TimerCallback cb, MonoTime when, double interval)
         : callback_(std::move(cb)),
           expiration_(when),
           interval_(interval),
           repeat_(interval > 0.0),
-          sequence_(s_numCreated_.incrementAndGet()) {}
+          sequence_(s_numCreated_.incrementAndGet(
+              std::memory_order_relaxed)) {}
 
     void run() const { callback_(); }
 
-    inline Timestamp expiration() const { return expiration_; }
+    inline MonoTime expiration() const { return expiration_; }
     inline bool repeat() const { return repeat_; }
     inline int64_t sequence() const { return sequence_; }
 
-    void restart(Timestamp now);
+    void restart(MonoTime now);
 
-    static inline int64_t numCreated() { return s_numCreated_.get(); }
+    static inline int64_t numCreated() {
+        return s_numCreated_.get(std::memory_order_relaxed);
+    }
 
 private:
     const TimerCallback callback_;
-    Timestamp expiration_;
+    MonoTime expiration_;
 
     const double interval_;
     const bool repeat_;
@@ -9,7 +9,7 @@
 
 #pragma once
 
-#include <LuxUtils/Timestamp.h>
+#include <LuxUtils/MonoTime.h>
 #include <polaris/Callbacks.h>
 #include <polaris/Channel.h>
 
@@ -35,7 +35,7 @@ private:
     // FIXME: use unique_ptr<Timer> instead of raw pointers.
     // This requires heterogeneous comparison lookup (N3465) from C++14
     // so that we can find an T* in a set<unique_ptr<T>>.
-    using Entry = std::pair<Timestamp, Timer*>;
+    using Entry = std::pair<MonoTime, Timer*>;
     using TimerList = std::set<Entry>;
     using ActiveTimer = std::pair<Timer*, int64_t>;
     using ActiveTimerSet = std::set<ActiveTimer>;
@@ -57,8 +57,8 @@ private:
     // called when timerfd alarms
     void handleRead();
     // move out all expired timers
-    std::vector<Entry> getExpired(Timestamp now);
-    void reset(const std::vector<Entry>& expired, Timestamp now);
+    std::vector<Entry> getExpired(MonoTime now);
+    void reset(const std::vector<Entry>& expired, MonoTime now);
 
     bool insert(Timer* timer);
 
@@ -71,7 +71,7 @@ public:
     /// repeats if @c interval > 0.0.
     ///
     /// Must be thread safe. Usually be called from other threads.
-    TimerId addTimer(TimerCallback cb, Timestamp when, double interval);
+    TimerId addTimer(TimerCallback cb, MonoTime when, double interval);
 
     void cancel(TimerId timerId);
 };
@@ -66,7 +66,8 @@ void Acceptor::handleRead() {
             sockets::close(connfd);
         }
     } else {  // accept failed
-        LOG_SYSERR << "in Acceptor::handleRead";
+        // fires on every wakeup while out of fds
+        LOG_EVERY_MS(SYSERR, 1000) << "in Acceptor::handleRead";
         // Read the section named "The special problem of
         // accept()ing when you can't" in libev's doc.
         // By Marc Lehmann, author of libev.
@@ -6,7 +6,6 @@
  */
 
 #include <LuxLog/Logger.h>
-#include <LuxUtils/Mutex.h>
 #include <LuxUtils/Timestamp.h>
 #include <polaris/Channel.h>
 #include <polaris/EventLoop.h>
@@ -96,6 +95,7 @@ void EventLoop::loop() {
     while (!quit_) {
         activeChannels_.clear();
         pollReturnTime_ = poller_->poll(kPollTimeMs, &activeChannels_);
+        cachedNow_ = MonoTime::now();
         ++iteration_;
         if (Logger::logLevel() <= Logger::LogLevel::TRACE) {
             printActiveChannels();
@@ -139,7 +139,7 @@ void EventLoop::runInLoop(Functor cb) {
 
 void EventLoop::queueInLoop(Functor cb) {
     {
-        MutexLockGuard lock(mutex_);
+        AdaptiveMutexGuard lock(mutex_);
         pendingFunctors_.push_back(std::move(cb));
     }
 
@@ -149,7 +149,7 @@ void EventLoop::queueInLoop(Functor cb) {
 }
 
 size_t EventLoop::queueSize() const {
-    MutexLockGuard lock(mutex_);
+    AdaptiveMutexGuard lock(mutex_);
     return pendingFunctors_.size();
 }
 
@@ -205,7 +205,7 @@ void EventLoop::doPendingFunctors() {
     callingPendingFunctors_ = true;
 
     {
-        MutexLockGuard lock(mutex_);
+        AdaptiveMutexGuard lock(mutex_);
         functors.swap(pendingFunctors_);
     }
 
@@ -221,10 +221,20 @@ void EventLoop::printActiveChannels() const {
     }
 }
 
-TimerId EventLoop::runAt(Timestamp time, TimerCallback cb) {
+MonoTime EventLoop::timerNow() const {
+    // between poll() returning and the next poll(), i.e. in a callback
+    if (looping_ && isInLoopThread()) return cachedNow_;
+    return MonoTime::now();
+}
+
+TimerId EventLoop::runAt(MonoTime time, TimerCallback cb) {
     return timerQueue_->addTimer(std::move(cb), time, 0.0);
 }
 
+TimerId EventLoop::runAt(Timestamp time, TimerCallback cb) {
+    return runAt(MonoTime::fromTimestamp(time), std::move(cb));
+}
+
 /**
  * @brief
  *
@@ -233,12 +243,12 @@ TimerId EventLoop::runAt(Timestamp time, TimerCallback cb) {
  * @return TimerId
  */
 TimerId EventLoop::runAfter(double delay, TimerCallback cb) {
-    Timestamp time(addTime(Timestamp::now(), delay));
+    MonoTime time(addTime(timerNow(), delay));
     return runAt(time, std::move(cb));
 }
 
 TimerId EventLoop::runEvery(double interval, TimerCallback cb) {
-    Timestamp time(addTime(Timestamp::now(), interval));
+    MonoTime time(addTime(timerNow(), interval));
     return timerQueue_->addTimer(std::move(cb), time, interval);
 }
 
@@ -0,0 +1,147 @@
+/**
+ * @file FileWatcher.cc
+ * @brief
+ *
+ * @author Lux
+ */
+
+#include <LuxLog/Logger.h>
+#include <errno.h>
+#include <polaris/EventLoop.h>
+#include <polaris/FileWatcher.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace Lux {
+namespace polaris {
+namespace detail {
+
+int createInotifyfd() {
+    int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        LOG_SYSFATAL << "Failed in inotify_init1";
+    }
+    return fd;
+}
+
+/// @brief Splits @c path into directory and file name.
+void splitPath(const string& path, string* dir, string* name) {
+    string::size_type slash = path.rfind('/');
+    if (slash == string::npos) {
+        *dir = ".";
+        *name = path;
+    } else {
+        *dir = slash == 0 ? "/" : path.substr(0, slash);
+        *name = path.substr(slash + 1);
+    }
+}
+
+/// 写完关闭，或由 rename(2) 替换
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+}  // namespace detail
+}  // namespace polaris
+}  // namespace Lux
+
+using namespace Lux;
+using namespace Lux::polaris;
+using namespace Lux::polaris::detail;
+
+FileWatcher::FileWatcher(EventLoop* loop)
+    : loop_(loop),
+      inotifyfd_(createInotifyfd()),
+      inotifyChannel_(loop, inotifyfd_) {
+    inotifyChannel_.setReadCallback(std::bind(&FileWatcher::handleRead, this));
+    inotifyChannel_.enableReading();
+}
+
+FileWatcher::~FileWatcher() {
+    inotifyChannel_.disableAll();
+    inotifyChannel_.remove();
+    // closing the fd removes all the watches
+    ::close(inotifyfd_);
+}
+
+bool FileWatcher::watch(const string& path, Callback cb) {
+    loop_->assertInLoopThread();
+    string dir, name;
+    splitPath(path, &dir, &name);
+
+    // the same directory gets the same watch descriptor
+    int wd = ::inotify_add_watch(inotifyfd_, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+        LOG_SYSERR << "inotify_add_watch " << dir;
+        return false;
+    }
+    Directory& directory = directories_[wd];
+    directory.path = dir;
+    directory.files[name] = std::make_pair(path, std::move(cb));
+    return true;
+}
+
+void FileWatcher::unwatch(const string& path) {
+    loop_->assertInLoopThread();
+    string dir, name;
+    splitPath(path, &dir, &name);
+
+    for (auto it = directories_.begin(); it != directories_.end(); ++it) {
+        if (it->second.path != dir) continue;
+        it->second.files.erase(name);
+        if (it->second.files.empty()) {
+            ::inotify_rm_watch(inotifyfd_, it->first);
+            directories_.erase(it);
+        }
+        return;
+    }
+}
+
+void FileWatcher::handleRead() {
+    loop_->assertInLoopThread();
+    // 一次唤醒内同一个文件只回调一次
+    std::map<string, Callback> changed;
+    alignas(struct inotify_event) char buf[4096];
+
+    while (true) {
+        ssize_t n = ::read(inotifyfd_, buf, sizeof buf);
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN) {
+                LOG_SYSERR << "FileWatcher::handleRead";
+            }
+            break;
+        }
+
+        for (char* p = buf; p < buf + n;) {
+            const struct inotify_event* event =
+                reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // events lost, every file may have changed
+                LOG_WARN << "FileWatcher inotify queue overflow";
+                for (const auto& directory : directories_) {
+                    for (const auto& file : directory.second.files) {
+                        changed[file.second.first] = file.second.second;
+                    }
+                }
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // the directory was deleted or unmounted
+                directories_.erase(event->wd);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            auto directory = directories_.find(event->wd);
+            if (directory == directories_.end()) continue;
+            auto file = directory->second.files.find(event->name);
+            if (file == directory->second.files.end()) continue;
+            changed[file->second.first] = file->second.second;
+        }
+    }
+
+    // callbacks may watch() or unwatch()
+    for (const auto& it : changed) {
+        it.second(it.first);
+    }
+}
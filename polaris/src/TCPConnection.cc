@@ -19,6 +19,8 @@
 using namespace Lux;
 using namespace Lux::polaris;
 
+const size_t TCPConnection::kContextSize;
+
 void Lux::polaris::defaultConnectionCallback(const TCPConnectionPtr& conn) {
     LOG_TRACE << conn->localAddress().toIpPort() << " -> "
               << conn->peerAddress().toIpPort() << " is "
@@ -358,7 +360,7 @@ void TCPConnection::handleWrite() {
                 }
             }
         } else /* 写入出错 */ {
-            LOG_SYSERR << "TCPConnection::handleWrite";
+            LOG_EVERY_MS(SYSERR, 1000) << "TCPConnection::handleWrite";
             // if (state_ == kDisconnecting)
             // {
             //   shutdownInLoop();
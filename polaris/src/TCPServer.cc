@@ -49,8 +49,18 @@ void TCPServer::setThreadNum(int numThreads) {
     threadPool_->setThreadNum(numThreads);
 }
 
+void TCPServer::setConfig(const Config<Tunables>& config) {
+    assert(started_.get(std::memory_order_relaxed) == 0);
+    config_.reset(new Config<Tunables>::Reader(config));
+}
+
 void TCPServer::start() {
-    if (started_.getAndSet(1) == 0) {
+    // only to start once, no data is published through it
+    if (started_.getAndSet(1, std::memory_order_relaxed) == 0) {
+        // the reader is used in the loop thread afterwards
+        if (config_ && config_->get().numThreads >= 0) {
+            setThreadNum(config_->get().numThreads);
+        }
         threadPool_->start(threadInitCallback_);
 
         assert(!acceptor_->listenning());
@@ -60,6 +70,18 @@ void TCPServer::start() {
 
 void TCPServer::newConnection(int sockfd, const InetAddress& peerAddr) {
     loop_->assertInLoopThread();
+    Tunables defaults;
+    const Tunables& tunables = config_ ? config_->get() : defaults;
+    if (tunables.maxConnections > 0 &&
+        connections_.size() >= static_cast<size_t>(tunables.maxConnections)) {
+        // fires on every accept while full
+        LOG_EVERY_MS(WARN, 1000)
+            << "TcpServer::newConnection [" << name_ << "] - reject "
+            << peerAddr.toIpPort() << ", " << connections_.size()
+            << " connections";
+        sockets::close(sockfd);
+        return;
+    }
     EventLoop* ioLoop = threadPool_->getNextLoop();
 
     char buf[64];
@@ -79,6 +101,7 @@ void TCPServer::newConnection(int sockfd, const InetAddress& peerAddr) {
     conn->setConnectionCallback(connectionCallback_);
     conn->setMessageCallback(messageCallback_);
     conn->setWriteCompleteCallback(writeCompleteCallback_);
+    if (tunables.tcpNoDelay) conn->setTcpNoDelay(true);
     conn->setCloseCallback(
         std::bind(&TCPServer::removeConnection, this, _1));  // FIXME: unsafe
     ioLoop->runInLoop(std::bind(&TCPConnection::connectEstablished, conn));
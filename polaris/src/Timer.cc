@@ -12,10 +12,10 @@ using namespace Lux::polaris;
 
 AtomicInt64 Timer::s_numCreated_;
 
-void Timer::restart(Timestamp now) {
+void Timer::restart(MonoTime now) {
     if (repeat_) {
         expiration_ = addTime(now, interval_);
     } else {
-        expiration_ = Timestamp::invalid();
+        expiration_ = MonoTime::invalid();
     }
 }
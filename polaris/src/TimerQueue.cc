@@ -36,13 +36,20 @@ int createTimerfd() {
     return timerfd;
 }
 
-struct timespec howMuchTimeFromNow(Timestamp when) {
-    int64_t microseconds = when.microSecondsSinceEpoch() -
-                           Timestamp::now().microSecondsSinceEpoch();
-    if (microseconds < 100) {
-        microseconds = 100;
-    }
+/**
+ * @brief 定时器的绝对超时时间，与 timerfd 同为 CLOCK_MONOTONIC，
+ * 不必再读一次当前时间，已经过去的时间内核会立即触发。
+ * runAt() 早于单调时钟起点的墙上时间会得到负数，timerfd_settime() 对负数
+ * 返回 EINVAL，之后的定时器都不再触发，所以钳到 1ns，即立即触发
+ */
+struct timespec toTimespec(MonoTime when) {
+    int64_t microseconds = when.microSeconds();
     struct timespec ts;
+    if (microseconds <= 0) {
+        ts.tv_sec = 0;
+        ts.tv_nsec = 1;
+        return ts;
+    }
     ts.tv_sec =
         static_cast<time_t>(microseconds / Timestamp::kMicroSecondsPerSecond);
     ts.tv_nsec = static_cast<long>(
@@ -56,7 +63,7 @@ struct timespec howMuchTimeFromNow(Timestamp when) {
  * @param timerfd
  * @param now
  */
-void readTimerfd(int timerfd, Timestamp now) {
+void readTimerfd(int timerfd, MonoTime now) {
     uint64_t howmany;
     ssize_t n = ::read(timerfd, &howmany, sizeof howmany);
     LOG_TRACE << "TimerQueue::handleRead() " << howmany << " at "
@@ -72,9 +79,9 @@ void readTimerfd(int timerfd, Timestamp now) {
  * @brief 重设定时器
  *
  * @param timerfd 定时器相关文件描述符
- * @param expiration 定时器相对超时时间
+ * @param expiration 定时器绝对超时时间
  */
-void resetTimerfd(int timerfd, Timestamp expiration) {
+void resetTimerfd(int timerfd, MonoTime expiration) {
     // wake up loop by timerfd_settime()
 
     // 当new_value.it_value非0时，用于设置定时器第一次超时时间,为0代表停止定时器
@@ -86,11 +93,12 @@ void resetTimerfd(int timerfd, Timestamp expiration) {
     memZero(&oldValue, sizeof oldValue);
 
     // - 非0时，用于设置定时器第一次超时时间,为0代表停止定时器
-    newValue.it_value = howMuchTimeFromNow(expiration);
+    newValue.it_value = toTimespec(expiration);
 
     // flags : 0 / TFD_TIMER_ABSTIME -
     // 0代表相对时间，即相对于当前时间多少，后者是绝对时间。
-    int ret = ::timerfd_settime(timerfd, 0, &newValue, &oldValue);
+    int ret =
+        ::timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &newValue, &oldValue);
     if (ret) {
         LOG_SYSERR << "timerfd_settime()";
     }
@@ -124,7 +132,7 @@ TimerQueue::~TimerQueue() {
     }
 }
 
-TimerId TimerQueue::addTimer(TimerCallback cb, Timestamp when,
+TimerId TimerQueue::addTimer(TimerCallback cb, MonoTime when,
                              double interval) {
     Timer* timer = new Timer(std::move(cb), when, interval);
     loop_->runInLoop(std::bind(&TimerQueue::addTimerInLoop, this, timer));
@@ -163,7 +171,8 @@ void TimerQueue::cancelInLoop(TimerId timerId) {
 
 void TimerQueue::handleRead() {
     loop_->assertInLoopThread();
-    Timestamp now(Timestamp::now());
+    // 本轮 poll 返回时的时间，不再读时钟
+    MonoTime now(loop_->cachedNow());
     readTimerfd(timerfd_, now);
 
     std::vector<Entry> expired = getExpired(now);
@@ -179,7 +188,7 @@ void TimerQueue::handleRead() {
     reset(expired, now);
 }
 
-std::vector<TimerQueue::Entry> TimerQueue::getExpired(Timestamp now) {
+std::vector<TimerQueue::Entry> TimerQueue::getExpired(MonoTime now) {
     assert(timers_.size() == activeTimers_.size());
     std::vector<Entry> expired;
 
@@ -201,8 +210,8 @@ std::vector<TimerQueue::Entry> TimerQueue::getExpired(Timestamp now) {
     return expired;
 }
 
-void TimerQueue::reset(const std::vector<Entry>& expired, Timestamp now) {
-    Timestamp nextExpire;
+void TimerQueue::reset(const std::vector<Entry>& expired, MonoTime now) {
+    MonoTime nextExpire;
 
     for (const Entry& it : expired) {
         ActiveTimer timer(it.second, it.second->sequence());
@@ -229,7 +238,7 @@ bool TimerQueue::insert(Timer* timer) {
     loop_->assertInLoopThread();
     assert(timers_.size() == activeTimers_.size());
     bool earliestChanged = false;
-    Timestamp when = timer->expiration();
+    MonoTime when = timer->expiration();
     TimerList::iterator it = timers_.begin();
     if (it == timers_.end() || when < it->first) {
         earliestChanged = true;
@@ -0,0 +1,82 @@
+#include <LuxLog/Logger.h>
+#include <assert.h>
+#include <polaris/Coroutine.h>
+#include <polaris/Sockets.h>
+#include <polaris/polaris.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace Lux;
+using namespace Lux::polaris;
+
+/// messages are a 4 bytes length in network order and the body
+string frame(const string& body) {
+    uint32_t be32 =
+        sockets::hostToNetwork32(static_cast<uint32_t>(body.size()));
+    string message(reinterpret_cast<const char*>(&be32), sizeof be32);
+    return message + body;
+}
+
+Task<string> readFrame(AsyncConnection& stream) {
+    string header = co_await stream.read(4);
+    if (header.size() < 4) co_return string();
+    uint32_t be32;
+    ::memcpy(&be32, header.data(), sizeof be32);
+    co_return co_await stream.read(sockets::networkToHost32(be32));
+}
+
+Task<void> echoSession(TCPConnectionPtr conn) {
+    AsyncConnection stream(conn);
+    while (true) {
+        string body = co_await readFrame(stream);
+        if (body.empty()) break;
+        co_await sleep(conn->getLoop(), 0.001);
+        if (!co_await stream.write(frame(body))) break;
+    }
+    LOG_INFO << conn->name() << " session done";
+}
+
+int g_echoed = 0;
+bool g_closed = false;
+
+Task<void> client(EventLoop* loop, TCPClient* tcpClient) {
+    TCPConnectionPtr conn = co_await connect(tcpClient);
+    AsyncConnection stream(conn);
+    for (size_t size : {1, 100, 64 * 1024, 4 * 1024 * 1024}) {
+        string body(size, static_cast<char>('a' + g_echoed % 26));
+        bool written = co_await stream.write(frame(body));
+        assert(written);
+        string echoed = co_await readFrame(stream);
+        assert(echoed == body);
+        ++g_echoed;
+    }
+
+    // the server closes after the half close, readSome() sees it
+    conn->shutdown();
+    string rest = co_await stream.readSome();
+    assert(rest.empty());
+    g_closed = true;
+    loop->quit();
+}
+
+int main() {
+    Logger::setLogLevel(Logger::LogLevel::WARN);
+    EventLoop loop;
+    InetAddress listenAddr(20443, true);
+    TCPServer server(&loop, listenAddr, "CoroutineEcho");
+    server.setConnectionCallback([](const TCPConnectionPtr& conn) {
+        if (conn->connected()) spawn(echoSession(conn));
+    });
+    server.start();
+
+    TCPClient tcpClient(&loop, listenAddr, "CoroutineClient");
+    spawn(client(&loop, &tcpClient));
+    loop.runAfter(30, [&loop] { loop.quit(); });
+    loop.loop();
+
+    assert(g_echoed == 4);
+    assert(g_closed);
+    printf("Coroutine tests passed\n");
+}
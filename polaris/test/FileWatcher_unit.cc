@@ -0,0 +1,76 @@
+#include <LuxLog/Logger.h>
+#include <LuxUtils/MappedINI.h>
+#include <assert.h>
+#include <polaris/EventLoop.h>
+#include <polaris/FileWatcher.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace Lux;
+using namespace Lux::polaris;
+
+/// a new version is written aside and renamed into place
+void replaceFile(const string& path, const string& content) {
+    string tmp = path + ".tmp";
+    FILE* fp = ::fopen(tmp.c_str(), "w");
+    assert(fp != nullptr);
+    ::fwrite(content.data(), 1, content.size(), fp);
+    ::fclose(fp);
+    ::rename(tmp.c_str(), path.c_str());
+}
+
+int main() {
+    char dir[] = "/tmp/FileWatcher_unit_XXXXXX";
+    assert(::mkdtemp(dir) != nullptr);
+    string path = string(dir) + "/server.ini";
+    replaceFile(path, "[server]\nthreads=4\n");
+
+    EventLoop loop;
+    INIParser::MappedINI ini;
+    assert(ini.open(path) == 0);
+
+    int reloads = 0;
+    FileWatcher watcher(&loop);
+    bool ok = watcher.watch(path, [&](const string& changed) {
+        assert(changed == path);
+        assert(ini.reload() == 0);
+        ++reloads;
+        LOG_INFO << "reloaded " << changed << " threads = "
+                 << string(ini.get("server", "threads"));
+        if (ini.get("server", "threads") == "16") {
+            loop.quit();
+        }
+    });
+    assert(ok);
+
+    // other files in the directory are not called back
+    loop.runAfter(0.05, [dir]() {
+        replaceFile(string(dir) + "/other.ini", "[other]\n");
+    });
+    loop.runAfter(0.1, [&path]() {
+        replaceFile(path, "[server]\nthreads=8\n");
+    });
+    // written in place
+    loop.runAfter(0.2, [&path]() {
+        FILE* fp = ::fopen(path.c_str(), "w");
+        ::fputs("[server]\nthreads=16\n", fp);
+        ::fclose(fp);
+    });
+    // no event in time
+    loop.runAfter(5.0, [&loop]() {
+        LOG_ERROR << "timeout";
+        loop.quit();
+    });
+    loop.loop();
+
+    assert(ini.get("server", "threads") == "16");
+    assert(reloads >= 1);
+
+    watcher.unwatch(path);
+    ::unlink(path.c_str());
+    ::unlink((string(dir) + "/other.ini").c_str());
+    ::rmdir(dir);
+    printf("FileWatcher tests passed\n");
+}